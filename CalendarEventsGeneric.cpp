@@ -1,6 +1,6 @@
 /* Events to scroll on clock display at specific dates of the year. */
 /* Must be customized by user and software rebuilt. */
-struct event CalendarEvent[MAX_EVENTS] =
+const struct event CalendarEvent[MAX_EVENTS] =
 {
   /*           "----------------- MAX 50 characters --------------" */
   { 0, JAN, 0, "> > > Debug"},  // if a valid date is put here, it will allow displaying useful debugging variables in "process_scroll_queue()" function.
@@ -23,6 +23,10 @@ struct event CalendarEvent[MAX_EVENTS] =
   /// { 1, MAR, JINGLE_BIRTHDAY, "> > > John's Birthday !!!"},  // JINGLE_BIRTHDAY is available when "PASSIVE_PIEZO_SUPPORT" is defined.
   {14, FEB, 0, "> > > Valentine's Day."},
   {25, DEC, 0, "> > > Merry Christmas !!"},
+
+  /* Events that move from year to year are given a recurrence rule (see recurrence.h). Day and month are then the start of the rule, in year 2000. */
+  { 1, MAY, 0, "> > > Mother's Day", "FREQ=YEARLY;BYMONTH=5;BYDAY=2SU"},
+  { 1, NOV, 0, "> > > Thanksgiving Day", "FREQ=YEARLY;BYMONTH=11;BYDAY=4TH"},
 };
 
 
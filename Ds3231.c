@@ -2,9 +2,9 @@
    Ds3231.c
    St-Louys Andre - February 2022
    astlouys@gmail.com
-   Revision 26-OCT-2022
+   Revision 18-OCT-2026
    Langage: GCC 7.3.1 arm-none-eabi
-   Version 1.01
+   Version 1.02
 
    Raspberry Pi Pico firmware to drive the Waveshare Green Clock
    From an original software version by "Yufu" on 25-JAN-2021 and
@@ -14,6 +14,7 @@
    =================
    06-FEB-2022 1.00 - Initial release.
    02-MAR-2022 1.01 - Code reformatting.
+   18-OCT-2026 1.02 - Add ds3231_aging_read() and ds3231_aging_write() to trim the TCXO frequency.
 \* ======================================================================== */
 
 
@@ -114,6 +115,67 @@ uint8_t dec_to_bcd(int DecValue)
 
 
 
+/* $PAGE */
+/* $TITLE=ds3231_aging_read() */
+/* ----------------------------------------------------------------- *\
+         Read the aging offset register of the RTC IC (signed,
+         one step is about 0.1 ppm, a positive value slows the
+                             oscillator).
+\* ----------------------------------------------------------------- */
+int8_t ds3231_aging_read(void)
+{
+  uint8_t Offset;
+  uint8_t Register;
+
+
+  Register = DS3231_REG_AGING;
+  i2c_write_blocking(I2C_PORT, DS3231_ADDRESS, &Register, 1,  true);
+  i2c_read_blocking( I2C_PORT, DS3231_ADDRESS, &Offset,   1, false);
+
+  return (int8_t)Offset;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ds3231_aging_write() */
+/* ----------------------------------------------------------------- *\
+      Write the aging offset register of the RTC IC. The TCXO only
+     uses the new value on its next temperature conversion (every
+      64 seconds), so one is forced unless one is in progress.
+\* ----------------------------------------------------------------- */
+void ds3231_aging_write(int8_t Offset)
+{
+  uint8_t Control;
+  uint8_t Status;
+  uint8_t val[2];
+
+
+  val[0] = DS3231_REG_AGING;
+  val[1] = (uint8_t)Offset;
+  i2c_write_blocking(I2C_PORT, DS3231_ADDRESS, val, 2, false);
+
+  val[0] = DS3231_REG_STATUS;
+  i2c_write_blocking(I2C_PORT, DS3231_ADDRESS, &val[0], 1,  true);
+  i2c_read_blocking( I2C_PORT, DS3231_ADDRESS, &Status, 1, false);
+  if (Status & DS3231_STA_BSY) return;
+
+  val[0] = DS3231_REG_CONTROL;
+  i2c_write_blocking(I2C_PORT, DS3231_ADDRESS, &val[0],  1,  true);
+  i2c_read_blocking( I2C_PORT, DS3231_ADDRESS, &Control, 1, false);
+
+  val[1] = Control | DS3231_CTL_CONV;
+  i2c_write_blocking(I2C_PORT, DS3231_ADDRESS, val, 2, false);
+
+  return;
+}
+
+
+
+
+
 /* $PAGE */
 /* $TITLE=ds3231_check_alarm_0() */
 /* ----------------------------------------------------------------- *\
@@ -2,9 +2,9 @@
    Ds3231.h
    St-Louys Andre - February 2022
    astlouys@gmail.com
-   Revision 31-MAR-2022
+   Revision 18-OCT-2026
    Langage: Linux gcc
-   Version 1.00
+   Version 1.01
 
    Raspberry Pi Pico firmware to drive the Waveshare green clock
    From an original software version by "Yufu" on 25-JAN-2021 and
@@ -13,6 +13,7 @@
    REVISION HISTORY:
    =================
    07-FEB-2022 1.00 - Initial release
+   18-OCT-2026 1.01 - Add access to the aging offset register.
 \* ======================================================================== */
 
 
@@ -56,10 +57,13 @@
 #define DS3231_REG_A2D      0x0D
 #define DS3231_REG_CONTROL  0X0E
 #define DS3231_REG_STATUS   0x0F
+#define DS3231_REG_AGING    0x10
 #define DS3231_REG_HTEMP    0x11
 #define DS3231_REG_LTEMP    0x12
 #define DS3231_STA_A1F      0x01
 #define DS3231_STA_A2F      0x02
+#define DS3231_STA_BSY      0x04  // a temperature conversion is in progress.
+#define DS3231_CTL_CONV     0x20  // force a temperature conversion (and TCXO update).
 #define Control_default     0x20
 
 
@@ -96,6 +100,12 @@ void byte_data(void);
 /* Convert the integer value to binary-coded-decimal. */
 uint8_t dec_to_bcd(int DecValue);
 
+/* Read the aging offset register of the RTC IC. */
+int8_t ds3231_aging_read(void);
+
+/* Write the aging offset register of the RTC IC and apply it at once. */
+void ds3231_aging_write(int8_t Offset);
+
 /* Check status of alarm 0 from the RTC IC. */
 bool ds3231_check_alarm_0();
 
@@ -2,9 +2,9 @@
    Pico-Clock-Green.c
    St-Louys, Andre - February 2022
    astlouys@gmail.com
-   Revision 01-JUN-2023
+   Revision 18-OCT-2026
    Compiler: arm-none-eabi-gcc 7.3.1
-   Version 9.02
+   Version 9.03
 
    Raspberry Pi Pico firmware to drive the Waveshare Pico-Green-Clock.
    From an original software version 1.00 by Waveshare
@@ -216,6 +216,52 @@
                      - Fix dates encoded in CalendarEventsGeneric.cpp (example Calendar Events).
                      - Add Czech language support. Thanks to KaeroDot for the excellent work and translation on this feature !
 
+   18-OCT-2026  9.03 - Raise the number of alarms from 9 to 64. Alarms are packed in 32 bits each in flash configuration
+                       (Version 9.0x alarms are converted on power-up). Alarm texts are now defined in the source code.
+                     - Compute the next alarm to ring only when alarms, time or timezone change and wake up on time with a
+                       Pico alarm, instead of checking all alarms every minute.
+                     - Calendar events and Reminders may be given a recurrence rule (RFC 5545 "RRULE" subset, see recurrence.h),
+                       for example to scroll an event on the second Sunday of May every year.
+                     - Calendar events may be read from a blob in flash, built from an iCalendar (.ics) file by the host tool
+                       tools/ics2blob (see event_blob.h), and updated without rebuilding the firmware. Built-in calendar
+                       events are now kept in flash instead of RAM.
+                     - Keep time with a single time base (Pico microsecond timer + offset, in UTC), set from the real-time
+                       clock IC or from NTP. Time and date are derived from it every second (date only when the day
+                       changes), the one-second tick is phase-locked on it, and it is compared hourly with the real-time
+                       clock IC instead of re-reading it in many places.
+                     - Date string to scroll is built once per day (or on a language change) from the time base, without
+                       reading the real-time clock IC.
+                     - Hourly and half-hour chimes, calendar events and the year change check are defined in a schedule
+                       table (ChimeSchedule[]) and performed on their exact second by a Pico alarm, instead of being checked
+                       every second with flags. CHIME_HALF_HOUR is now obeyed, and "nighttime" chime hours are fixed.
+                     - NTP time is set with usec resolution from a full SNTP exchange (offset and round-trip delay computed
+                       from the four timestamps), and copied to the real-time clock IC at the beginning of a second.
+                     - Each NTP sync now samples four pool servers, three times each. The lowest-delay sample of each server
+                       is kept and a majority of servers must agree (intersection of their error intervals) for the clock
+                       to be set, so that a single bad server can no longer set a wrong time.
+                     - The frequency error of the Pico crystal is learned from successive NTP syncs, saved to flash and applied
+                       to the time base, so that the clock keeps time between syncs. Small NTP corrections are slewed instead
+                       of stepped (time base arithmetic in time_base.c).
+                     - The drift of the real-time clock IC against NTP is measured over several syncs (up to a week) and its
+                       aging offset register is trimmed accordingly, so that it keeps accurate time when NTP is not available
+                       (see rtc_drift.c).
+                     - The NTP poll interval adapts from 64 seconds to 36 hours, growing while the clock keeps time and
+                       shrinking when it drifts. Failed syncs are retried with an exponential backoff (with some jitter) and
+                       kiss-o'-death answers from servers are honoured.
+                     - NTP syncs run by themselves from lwIP callbacks and post their result to the command queue: the
+                       main loop no longer waits for the network, and the real-time clock IC is written once, on the
+                       second, from the one-second callback.
+                     - The addresses of the NTP pool servers are cached (and saved to flash), so that syncs do not need
+                       DNS. A server that stops answering is replaced by another one from the pool.
+                     - On power-up, the Pico W joins the access point last used directly on its BSSID and channel (saved to
+                       flash) instead of scanning all channels, and uses its last DHCP lease (or the optional static IP
+                       configuration STATIC_IP_ADDRESS) as soon as the link is up. A full connection is done if this fails.
+                     - The Wi-Fi radio is powered down between NTP syncs far enough apart, and powered up again at the
+                       beginning of the next sync. The time it has been on is shown with the system idle monitor history.
+                     - Optional LAN NTP server (LAN_NTP_SERVER): the clock answers NTP requests from the local network with
+                       its own time, one stratum below its NTP server, and keeps serving from its time base held to the
+                       DS3231 when the Internet is not reachable. The Wi-Fi radio then stays on between syncs.
+
 \* ================================================================== */
 
 /* ================================================================== *\
@@ -285,7 +331,7 @@
                      "CalendarEventsGeneric.cpp".
 \* ================================================================== */
 /* Firmware version. */
-#define FIRMWARE_VERSION "9.02"  ///
+#define FIRMWARE_VERSION "9.03"  ///
 
 /* Select the language for data display. */
 #define DEFAULT_LANGUAGE ENGLISH // choices for now are FRENCH, ENGLISH, GERMAN, and SPANISH.
@@ -298,9 +344,21 @@
 /* If a Pico W is used, librairies for Wi-Fi and NTP synchronization will be merged in the executable. If PICO_W is not defined, NTP is automatically disabled. */
 #define PICO_W  ///
 
+/* Optional static IP configuration of the Pico W, so that it does not wait for DHCP when connecting to Wi-Fi. Leave the four lines commented out to use DHCP. */
+// #define STATIC_IP_ADDRESS "192.168.1.50"
+// #define STATIC_IP_NETMASK "255.255.255.0"
+// #define STATIC_IP_GATEWAY "192.168.1.1"
+// #define STATIC_IP_DNS     "192.168.1.1"
+
+/* Optional NTP server on the local network: other devices may then use the clock IP address as their NTP server. The Wi-Fi radio stays on between syncs. */
+// #define LAN_NTP_SERVER
+
 /* Flag to handle automatically the daylight saving time. List of countries are given in the User Guide. */
 #define DST_COUNTRY DST_NORTH_AMERICA
 
+/* Minutes to add to the Timezone set on the clock, for half-hour and quarter-hour timezones (for example 30 for India, 45 for Nepal, -30 for Newfoundland). */
+#define TIMEZONE_MINUTES 0
+
 /* Release or Developer Version: Make selective choices or options. */
 #define RELEASE_VERSION  ///
 
@@ -493,43 +551,64 @@
                        (in alphabetical order)
 \* ------------------------------------------------------------------ */
 /* Miscellaneous defines. */
+#define ALARM_MAX_WAIT            3600      // maximum number of seconds between two wake-ups for the next alarm (bounds drift between Pico timer and clock time).
 #define ALARM_PERIOD              5         // alarm ringer restart every x seconds (part of the whole "nine alarms algorithm").
 #define CELSIUS                   0x00
+#define CHIME_ACTION_EVENTS       0x01      // chime schedule action: scroll calendar events of today (sounding in compliance with chime settings).
+#define CHIME_ACTION_SOUND        0x00      // chime schedule action: sound the chime of the entry (in compliance with chime settings).
+#define CHIME_ACTION_YEAR         0x02      // chime schedule action: check for a year change (DST transitions and reminders of the new year).
+#define CHIME_ALL_DAYS            0xFE      // chime schedule day mask for all days of the week (bit 1 = SUN to bit 7 = SAT, as for alarms).
 #define CHIME_DAY                 0x02      // hourly chime is ON during defined daily hours (between CHIME_TIME_ON and CHIME_TIME_OFF).
 #define CHIME_OFF                 0x00      // hourly chime is OFF.
+#define CHIME_MAX_WAIT            3600      // maximum number of seconds between two wake-ups of the chime scheduler (bounds drift between Pico timer and clock time).
 #define CHIME_ON                  0x01      // hourly chime is ON.
+#define CHIME_SOUND_EVENT         0x03      // chime schedule sound: calendar event tones (and jingle of the event).
+#define CHIME_SOUND_HALF_HOUR     0x02      // chime schedule sound: half-hour double-beep.
+#define CHIME_SOUND_HOUR          0x01      // chime schedule sound: hourly chime.
+#define CHIME_SOUND_NONE          0x00      // chime schedule sound: no sound.
 #define COUNT_DOWN_DELAY          7         // number of seconds between each count-down alarm sound burst.
 #define CRC16_POLYNOM             0x1021    // different polynom values are used by different authorities. (0x8005, 0x1021, 0x1DCF, 0x755B, 0x5935, 0x3D65, 0x8BB7, 0x0589, 0xC867, 0xA02B, 0x2F15, 0x6815, 0xC599, 0x202D, 0x0805, 0x1CF5)
 #define DEFAULT_YEAR_CENTILE      20        // to be used as a default before flash configuration is read (to be displayed in debug log).
-#define DELTA_TIME                60000000ll
 #define DISPLAY_BUFFER_SIZE       248       // size of framebuffer.
-#define EVENT_MINUTE1             14        // (Must be between 0 and 57) Calendar Events will checked when minutes reach this number (should preferably be selected out of peak periods).
-#define EVENT_MINUTE2             44        // (Must be between 0 and 57) Calendar Events will checked when minutes reach this number (should preferably be selected out of peak periods).
+#define EVENT_MINUTE1             14        // (Must be between 0 and 59) Calendar Events will checked when minutes reach this number (should preferably be selected out of peak periods).
+#define EVENT_MINUTE2             44        // (Must be between 0 and 59) Calendar Events will checked when minutes reach this number (should preferably be selected out of peak periods).
+#define EVENT_LEAP_YEAR           2000      // leap year used to number the days of the calendar events index, so that 29-FEB always has its own day.
+#define EVENT_RULE_NONE           0xFFFFFFFF // day number of a calendar event rule that has no other occurrence.
 #define FAHRENHEIT                !CELSIUS  // temperature unit to display.
 #define FALSE                     0x00
 #define FLAG_OFF                  0x00      // flag is OFF.
 #define FLAG_ON                   0x01      // flag is ON.
-#define FLAG_POLL                 0x02
 #define FLAG_WAIT                 0x03      // special flag asking passive sound queue to wait for active sound queue to complete.
 #define FLASH_CONFIG_OFFSET       0x1FF000  // offset in the Pico's 2 MB where to save data. Starting at 2.00MB - 4096 bytes (very end of flash).
 #define H12                       FLAG_OFF  // 12-hours time format.
 #define H24                       FLAG_ON   // 24-hours time format.
 #define MAX_ACTIVE_SOUND_QUEUE    100       // maximum number of "sounds" in the active buzzer sound queue.
-#define MAX_ALARMS                9         // total number of alarms available.
+#define MAX_ALARMS                64        // total number of alarms available (at most 64, see AlarmReachedBitMask).
 #define MAX_LIGHT_SLOTS           24        // number of slots for ambient light level hysteresis.
 #define MAX_COMMAND_QUEUE         25        // maximim number of active commands in command queue.
 #define MAX_CORE_QUEUE            25        // maximum number of active commands in each circular buffers for inter-core communication (core0-to-core1 and core1-to-core0).
 #define MAX_COUNT_DOWN_ALARM_DURATION 30    // maximum period of time (in minutes) during which count-down alarm will ring if not reset by user (quick press on "Set" button).
 #define MAX_DHT_READINGS          100       // maximum number of "logic level changes" while reading DHT22 data stream.
-#define MAX_EVENTS                50        // maximum number of "calendar events" that can be programmed in the source code.
-#define MAX_IR_READINGS           500       // maximum number of "logic level changes" while receiving data from IR remote control.
+#define MAX_EVENTS                50        // maximum number of "calendar events" that can be programmed in the source code (lower than 0xAA, see scroll queue tags).
+#define MAX_EVENT_RULES           8         // maximum number of calendar events defined with a recurrence rule.
+#define MAX_IDLE_HISTORY          120       // number of one-minute entries kept in the system idle monitor history (2 hours).
+#define MAX_IR_READINGS           80        // maximum number of "logic level changes" captured from IR remote control (longest supported protocol is Memorex with 73).
 #define MAX_PASSIVE_SOUND_QUEUE   500       // maximum number of "sounds" in the passive buzzer sound queue.
 #define MAX_REMINDERS1            50        // maximum number of "reminders" of type 1 that can be defined.
+#define MAX_REMINDER_RULES        8         // maximum number of reminders of type 1 defined with a recurrence rule.
 #define MAX_SCROLL_QUEUE          75        // maximum number of messages in the scroll buffer queue (big enough to cover MAX_EVENTS defined for the same day + a few extra date scrolls).
+#define MAX_SCROLL_VALUES         4         // maximum number of strings waiting to be scrolled for scroll_queue_value() (debugging purposes).
 #define NIGHT_LIGHT_AUTO          0x03      // night light will turn On when ambient light is low enough
 #define NIGHT_LIGHT_NIGHT         0x02      // night light On between NightLightTimeOn and NightLightTimeOff.
 #define NIGHT_LIGHT_OFF           0x00      // night light always Off.
 #define NIGHT_LIGHT_ON            0x01      // night light always On.
+#define REMINDER_MAX_WAIT         3600      // maximum number of seconds between two wake-ups of the reminder scheduler (bounds drift between Pico timer and clock time).
+#define REMINDER_NO_RULE          0xFF      // Reminder1[].RuleSlot of a reminder without recurrence rule.
+#define STACK_MARGIN              64        // number of bytes below current stack pointer left unpainted when painting the stack that is in use.
+#define STACK_PATTERN             0x5A5AA5A5 // pattern written to unused stack space at power-up to later find the stack high-water mark.
+#define STACK_WARNING             75        // stack usage (in percent of stack size) above which a warning is issued.
+#define TIME_BASE_PHASE           2000      // timer_callback_s() is kept this number of usec after the beginning of each second of the time base.
+#define TIME_FREQ_SAVE            100       // frequency correction change (in ppb) that is worth saving to flash.
 #define TIMER_COUNT_DOWN          0x01      // timer mode is "Count Down".
 #define TIMER_COUNT_UP            0x02      // timer mode is "Count Up".
 #define TIMER_OFF                 0x00      // timer is currently OFF.
@@ -576,6 +655,13 @@
 
 /* List of commands to be processed by command queue handler (while in the "main()" thread context). */
 #define COMMAND_PLAY_JINGLE       0x01
+#define COMMAND_REMINDER_DUE      0x02      // reminder scheduler alarm has expired, ring reminders that are due.
+#define COMMAND_REMINDER_RESET    0x03      // clock time has been changed, recompute all reminders.
+#define COMMAND_ALARM_SCHEDULE    0x04      // alarms, time or timezone have been changed, find the next alarm to ring.
+#define COMMAND_TIME_CHECK        0x05      // compare the time base with the real-time clock IC (hourly).
+#define COMMAND_CHIME_SCHEDULE    0x06      // time or timezone have been changed, find the next chime schedule entry due.
+#define COMMAND_NTP_UPDATE        0x07      // an NTP sync is done, apply its result (parameter: FLAG_ON if it succeeded). Also defined in picow_ntp_client.c.
+#define COMMAND_RTC_WRITE         0x08      // beginning of a second of the time base, copy local time to the real-time clock IC.
 
 
 /* Inter-core commands / messages. */
@@ -643,6 +729,9 @@
 #define IR_POWER_ON_OFF              0x10
 #define IR_SILENCE_PERIOD            0x11
 #define IR_HI_LIMIT                  0x12
+
+/* Logic level of a given step in the IR capture buffer. Each burst begins with a Low level, so even steps are Low and odd steps are High. */
+#define IR_LEVEL(Step)               (((Step) & 0x01) ? 'H' : 'L')
 #endif
 
 
@@ -716,6 +805,8 @@
 #define TAG_QUEUE              0xEE   // tag used to display "Head", "Tail", and "Tag" of currently used scroll queue (for debugging purposes).
 #define TAG_TIMEZONE           0xED   // tag used to display Universal Coordinated Time information.
 #define TAG_VOLTAGE            0xEC   // tag used to display power supply voltage.
+#define TAG_STACK              0xEB   // tag used to display stack high-water marks of both cores.
+#define TAG_VALUE              0xEA   // tag used to scroll a string queued by scroll_queue_value() (for debugging purposes).
 
 
 #define SILENT        0
@@ -782,10 +873,13 @@
 
 /* Include files. */
 #include "bitmap.h"
+#include "civil_time.h"
 #include "ctype.h"
 #include "debug.h"
 #include "Ds3231.h"
 #include "errno.h"
+#include "event_blob.h"
+#include "event_index.h"
 #include "fcntl.h"
 #include "hardware/adc.h"
 #include "hardware/clocks.h"
@@ -798,14 +892,20 @@
 #include "hardware/sync.h"
 #include "hardware/uart.h"
 #include "math.h"
+#include "messages.h"
 #include "pico/multicore.h"
 #include "pico/platform.h"
 #include "pico/sync.h"
 #include "pico/unique_id.h"
+#include "posix_tz.h"
+#include "recurrence.h"
+#include "rtc_drift.h"
 #include "stdarg.h"
+#include "stddef.h"
 #include "stdint.h"
 #include "stdio.h"
 #include "stdlib.h"
+#include "time_base.h"
 
 #ifdef PICO_W
 #include "picow_ntp_client.h"
@@ -863,6 +963,9 @@ UINT8 SETUP_AUTO_BRIGHT =          0x13;
        3) Jingle ID (Jingle number to play while scrolling this calendar event, 0 = none) (require passive buzzer to be installed by user).
        4) Text to scroll on clock display (between "double-quotes" in the code)
           (The text is limited to 40 characters. It takes a relatively long time to read 40 characters of text on the clock scrolling display !)
+       5) Optional recurrence rule (RFC 5545 RRULE subset, see recurrence.h), for events that do not fall on the same date every year.
+          For example "FREQ=YEARLY;BYMONTH=5;BYDAY=2SU" for the second Sunday of May. Day of month and Month then give the date
+          of the first occurrence in year 2000 (or use "DTSTART=YYYYMMDD" in the rule), and must be a valid date.
 
    NOTE: Calendar events are verified twice an hour, at xxh14 and xxh44. The text configured will be scrolled on
          the clock display if the clock is in its "normal" time display mode (that is, the text will not scroll if user is in a setup operation).
@@ -879,14 +982,74 @@ struct event
   UINT8  Month;
   UINT16 Jingle;
   UCHAR  Description[51];
+  const UCHAR *Rule;  // optional recurrence rule (NULL = every year on Day and Month).
 };
 
 /* Events to scroll on clock display at specific dates. Must be setup by user. Some examples are already defined. */
 #include CALENDAR_FILENAME
 
+/* Event numbers are sent through the scroll queue as tags, so they must stay below the first special value (0xAA = empty entry). */
+#if MAX_EVENTS >= 0xAA
+#error "MAX_EVENTS must be lower than 0xAA (calendar event numbers are used as scroll queue tags)"
+#endif
+
+#if MAX_ALARMS > 64
+#error "MAX_ALARMS must not exceed 64 (one bit per alarm in AlarmReachedBitMask and AlarmNextMask)"
+#endif
+
+/* Calendar events index (built on entry by event_index_build()). Events of day-of-year "n" (0 to 365, numbered as in a leap year)
+   are EventIndex[EventDayStart[n]] to EventIndex[EventDayStart[n + 1] - 1], in the order they are defined in CalendarEvent[]. */
+UINT16 EventIndex[MAX_EVENTS];
+UINT16 EventDayStart[EVENT_INDEX_DAYS + 1];
+
+/* Calendar events defined with a recurrence rule are left out of the index above. The rule is evaluated again only when the date
+   looked at goes past its next occurrence (or before the date it was evaluated from). */
+struct event_rule
+{
+  UINT8  EventNumber;        // calendar event this rule belongs to.
+  UINT32 From;               // day number (days since 01-JAN-1970) from which Next was searched.
+  UINT32 Next;               // day number of the next occurrence on or after From (EVENT_RULE_NONE = no other occurrence).
+  struct recur_rule Rule;
+};
+struct event_rule EventRule[MAX_EVENT_RULES];
+UINT8  EventRuleCount;
+
+/* Calendar events blob read in place from flash (see event_blob.h and event_blob_check()). When there is no valid blob, EventBlob
+   is NULL and calendar events of CalendarEvent[] are used. Event numbers are then record numbers of the blob (up to EventTotal). */
+const struct event_blob_header *EventBlob;
+UINT16 EventTotal;
+#define EVENT_BLOB_RECORDS  ((const struct event_blob_record *)(EventBlob + 1))                       // records follow the header.
+#define EVENT_BLOB_STRINGS  ((const UCHAR *)(EVENT_BLOB_RECORDS + EventBlob->EventCount))            // string pool follows the records.
+
 
 /* Alarm definitions. */
 struct alarm
+{
+  UINT8 FlagStatus;
+  UINT8 Second;
+  UINT8 Minute;
+  UINT8 Hour;
+  UINT8 Day;
+};
+
+/* Alarms are saved to flash packed in 32 bits:
+   bits 0 to 5: Second   bits 6 to 11: Minute   bits 12 to 16: Hour   bits 17 to 24: Day (bit mask, bit 1 = SUN to bit 7 = SAT)   bit 25: FlagStatus.
+   Bits 26 to 31 are always 0, so that an erased flash word (0xFFFFFFFF) is recognized as an undefined alarm. */
+#define ALARM_PACK(FlagStatus, Day, Hour, Minute, Second) ((UINT32)(Second) | ((UINT32)(Minute) << 6) | ((UINT32)(Hour) << 12) | ((UINT32)(Day) << 17) | ((UINT32)((FlagStatus) == FLAG_ON) << 25))
+#define ALARM_UNDEFINED(Packed)   ((Packed) & 0xFC000000)
+#define ALARM_SECOND(Packed)      ((Packed) & 0x3F)
+#define ALARM_MINUTE(Packed)      (((Packed) >> 6) & 0x3F)
+#define ALARM_HOUR(Packed)        (((Packed) >> 12) & 0x1F)
+#define ALARM_DAY(Packed)         (((Packed) >> 17) & 0xFF)
+#define ALARM_STATUS(Packed)      ((((Packed) >> 25) & 0x01) ? FLAG_ON : FLAG_OFF)
+
+/* String to be scrolled when an alarm is triggered (ALARM TEXT). Alarms without a text here scroll "Alarm nn". */
+const UCHAR *AlarmText[MAX_ALARMS] = {"Alarm 1", "Alarm 2", "Alarm 3", "Alarm 4", "Alarm 5", "Alarm 6", "Alarm 7", "Alarm 8", "Alarm 9"};
+
+/* Alarm layout in flash configuration up to Version 9.02 (nine alarms at offset 70, following 48 reserved bytes at offset 22).
+   AlarmPacked[] is aligned on offset 24, so Version 9.02 alarms begin 46 bytes after it. Converted on power-up. */
+#define ALARM_V902_OFFSET         46
+struct alarm_v902
 {
   UINT8 FlagStatus;
   UINT8 Second;
@@ -897,6 +1060,19 @@ struct alarm
 };
 
 
+/* Chime schedule entry (cron-like, see ChimeSchedule[] and chime_schedule()). */
+struct chime_entry
+{
+  UINT8 Minute;     // minute of the hour when the entry is due.
+  UINT8 Second;     // second of the minute when the entry is due.
+  UINT8 HourFirst;  // first hour of the day when the entry applies.
+  UINT8 HourLast;   // last hour of the day when the entry applies (included, wraps around midnight if lower than HourFirst).
+  UINT8 Day;        // day-of-week bit mask (bit 1 = SUN to bit 7 = SAT, as for alarms).
+  UINT8 Action;     // CHIME_ACTION_xxx.
+  UINT8 Sound;      // CHIME_SOUND_xxx.
+};
+
+
 /* Command definitions for command queue. */
 struct command
 {
@@ -905,22 +1081,11 @@ struct command
 };
 
 
-/* Summer Time / Winter Time parameters definitions. */
-struct dst_parameters
+/* Summer Time / Winter Time rules definitions. */
+struct dst_region
 {
-  UINT8  StartMonth;
-  UINT8  StartDayOfWeek;
-  int8_t StartDayOfMonthLow;
-  int8_t StartDayOfMonthHigh;
-  UINT8  StartHour;
-  UINT16 StartDayOfYear;
-  UINT8  EndMonth;
-  UINT8  EndDayOfWeek;
-  int8_t EndDayOfMonthLow;
-  int8_t EndDayOfMonthHigh;
-  UINT8  EndHour;
-  UINT16 EndDayOfYear;
-  UINT8  ShiftMinutes;
+  const char *Rule;  // POSIX TZ string of a reference timezone of the region (see posix_tz.h).
+  UINT8 FlagUtc;      // FLAG_ON if time changes at the same UTC time in all timezones of the region.
 };
 
 
@@ -939,6 +1104,15 @@ struct human_time
 };
 
 
+/* System idle monitor statistics for a one-minute period (in number of idle loops per second). */
+struct idle_history
+{
+  UINT32 Minimum;  // lowest 5-seconds period of this minute.
+  UINT32 Average;  // average of the whole minute.
+  UINT32 Maximum;  // highest 5-seconds period of this minute.
+};
+
+
 /* NTP data structure. */
 struct ntp_data
 {
@@ -956,11 +1130,20 @@ struct ntp_data
   time_t Epoch;
   UINT8  FlagNTPResync;   // flag set to On if there is a specific reason to request an NTP update without delay.
   UINT8  FlagNTPSuccess;  // flag indicating that NTP date and time request has succeeded.
-  UINT64 NTPDelta;
+  UINT64 NTPDelta;        // time (in usec) from NTPLastUpdate to next NTP sync (poll interval, or retry interval after a failure).
   UINT32 NTPErrors;       // cumulative number of errors while trying to re-sync with NTP.
-  UINT64 NTPGetTime;
+  UINT8  NTPFailures;     // number of consecutive NTP sync failures.
+  UINT64 NTPFirstSync;    // Pico timer value (time since power-up) when the first NTP sync has been applied (0 = not yet).
+  UINT64 NTPGetTime;      // Pico timer value when last NTP answer has been received (T4).
   UINT64 NTPLastUpdate;
+  int64_t NTPOffset;      // offset given by last NTP answer: UTC time in usec is the Pico timer value + NTPOffset.
+  UINT8  NTPPoll;         // poll interval (log2 of seconds, NTP_POLL_MIN to NTP_POLL_MAX).
   UINT32 NTPReadCycles;   // total number of re-sync cycles through NTP.
+  int64_t NTPRoundTrip;   // round-trip delay of last NTP exchange (in usec), server processing time excluded.
+  UINT8  NTPState;        // state of the NTP sync (NTP_STATE_IDLE to NTP_STATE_APPLY, see picow_ntp_client.h).
+  UINT64 WiFiLinkTime;    // Pico timer value (time since power-up) when the Wi-Fi link came up (0 = no link, see ntp_init()).
+  UINT64 WiFiOnSince;     // Pico timer value when the Wi-Fi radio has been powered up (0 = powered down, see ntp_radio_sleep()).
+  UINT64 WiFiOnTime;      // cumulative time (in usec) the Wi-Fi radio has been powered up before it was last powered down.
 }NTPData;
 
 
@@ -1001,6 +1184,9 @@ struct reminder1
   UINT64 RingRepeatTime;
   UINT64 NextReminderDelay;
   UCHAR  Description[51];
+  UINT64 NextRingEpoch;  // next time this reminder will ring (local time epoch, 0 = none), maintained by the reminder scheduler.
+  const UCHAR *Rule;     // optional recurrence rule giving the beginning of each cycle instead of NextReminderDelay (NULL = none).
+  UINT8  RuleSlot;       // entry of ReminderRule[] holding the parsed Rule (REMINDER_NO_RULE = none), set by reminder_init().
 };
 
 
@@ -1047,14 +1233,26 @@ struct flash_config
   UINT8  FlagScrollEnable;    // flag indicating the clock will scroll the date and temperature at regular intervals on the display.
   UINT8  FlagSummerTime;      // flag indicating the current status (On or Off) of Daylight Saving Time / Summer Time.
   int8_t Timezone;            // (in hours) value to add to UTC time (Universal Time Coordinate) to get the local time.
-  UINT8  Reserved1[48];       // reserved for future use.
-  struct alarm Alarm[9];      // alarms 0 to 8 parameters (numbered 1 to 9 for clock users). Day is a bit mask.
+  int8_t TimezoneMinutes;     // (in minutes) value to add to Timezone for half-hour and quarter-hour timezones (same sign as Timezone).
+  UINT32 AlarmPacked[MAX_ALARMS];  // alarms 0 to 63 parameters (numbered 1 to 64 for clock users), packed as described with ALARM_PACK().
+  int32_t TimeBaseFreq;       // frequency correction of the Pico crystal (in ppb), learned from NTP syncs (see time_base_discipline()).
+  UINT32 NTPServerAddress[4]; // IPv4 addresses of the NTP pool servers last used, one per pool name (0 or 0xFFFFFFFF = none, see picow_ntp_client.c).
+  UINT8  WiFiBssid[6];        // BSSID of the Wi-Fi access point last joined.
+  UINT8  WiFiChannel;         // channel of the Wi-Fi access point last joined (1 to 14, other values = none, see ntp_init()).
+  UINT8  WiFiStatic;          // FLAG_ON if WiFiAddress is the static IP configuration (see STATIC_IP_ADDRESS), otherwise it is the last DHCP lease.
+  UINT32 WiFiAddress[4];      // IPv4 address, netmask, gateway and DNS server of the Pico W (network byte order).
+  UINT32 WiFiLeaseEnd;        // UTC time (seconds since 01-JAN-1970) when the last DHCP lease ends (0 or 0xFFFFFFFF = none).
+  UINT8  Reserved1[403 - (MAX_ALARMS * 4)];  // reserved for future use (alarms, TimeBaseFreq, NTPServerAddress, WiFi data and Reserved1 take the place of Version 9.02 Reserved1 and alarms, SSID stays at offset 475).
   UCHAR  SSID[40];            // SSID for Wi-Fi network. Note: SSID begins at position 5 of the variable string, so that a "footprint" can be confirmed prior to writing to flash.
   UCHAR  Password[70];        // password for Wi-Fi network. Note: password begins at position 5 of the variable string, for the same reason as SSID above.
   UCHAR  Reserved2[48];       // reserved for future use.
   UINT16 Crc16;               // crc16 of all data above to validate configuration.
 } FlashConfig;
 
+/* SSID, Password and Crc16 must stay where Version 9.02 had them, so that configurations are converted in place. */
+_Static_assert(offsetof(struct flash_config, SSID) == 475, "Flash configuration SSID moved from Version 9.02 offset");
+_Static_assert(offsetof(struct flash_config, Crc16) == 634, "Flash configuration Crc16 moved from Version 9.02 offset");
+
 
 #ifdef BME280_SUPPORT
 /* BME280 calibration parameters computed from data written in the device. */
@@ -1121,13 +1319,20 @@ struct dht_data
          variables whenever possible. This could be a way to improve
          the code in future releases...
 \* ------------------------------------------------------------------ */
-UINT16 AlarmReachedBitMask        = 0;         // assume no alarms are ringing on entry.
-UINT8  AlarmNumber                = 0;         // since Version 6.00, there are now 9 alarms.
+struct alarm Alarm[MAX_ALARMS];                // alarm parameters (packed into FlashConfig.AlarmPacked[] when saving to flash).
+UINT64 AlarmNextEpoch;                         // local time of the next alarm to ring (0 = no alarm to ring).
+UINT64 AlarmNextMask;                          // bit mask of the alarms ringing at AlarmNextEpoch.
+UINT64 AlarmReachedBitMask        = 0;         // assume no alarms are ringing on entry.
+UINT8  AlarmNumber                = 0;         // since Version 9.03, there are now 64 alarms.
+alarm_id_t AlarmTimerId;                       // Pico alarm waking up at AlarmNextEpoch (0 = none).
 UINT8  AlarmTargetDay             = MON;       // blinking day-of-week to be selected or unselected for current alarm setting.
 volatile UINT16 AverageLightLevel = 550;       // relative ambient light value (for clock display auto-brightness feature). Assume average light level on entry.
 
 UINT16 BottomKeyPressTime         = 0;         // keep track of the time the Down ("Bottom") key is pressed.
 
+UINT64 ChimeNextEpoch;                         // local time of the next chime schedule entries due (0 = none).
+UINT16 ChimeNextMask;                          // bit mask of the ChimeSchedule[] entries due at ChimeNextEpoch.
+alarm_id_t ChimeTimerId;                       // Pico alarm waking up at ChimeNextEpoch (0 = none).
 UINT8  ChimeTimeOffDisplay        = CHIME_TIME_OFF;  // variable formatted to display in 12-hours or 24-hours format.
 UINT8  ChimeTimeOnDisplay         = CHIME_TIME_ON;   // variable formatted to display in 12-hours or 24-hours format.
 UINT8  CommandQueueHead;                       // head of Command circular buffer.
@@ -1151,16 +1356,20 @@ volatile UINT8  CurrentSecond     = 0;         // current value of second (secon
 UINT16 CurrentYear;                            // current year (4 digits).
 UINT8  CurrentYearLowPart;                     // lowest two digits of the year (battery backed-up).
 
+UCHAR  DateString[64];                         // date string to scroll, built once per day (see get_date_string()).
+int32_t DateStringDay             = -1;        // local day number (days since 01-JAN-1970) of the date in DateString (-1 = not built yet).
+UINT8  DateStringLanguage;                     // language used to build DateString.
 UINT64 DebugBitMask;                           // bitmask of code sections to be debugged through UART (see definitions of DEBUG sections above).
 UCHAR  DisplayBuffer[DISPLAY_BUFFER_SIZE];     // framebuffer containing the bitmap of the string to be displayed / scrolled on clock display.
 UINT16 DotBlinkCount;                          // cumulate milliseconds to blink the two "middle dots" on clock display.
 
 UINT8  FlagAlarmBeeping           = FLAG_OFF;  // flag indicating an alarm is sounding.
 UINT8  FlagBlinking[20] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};  // bitmap to logically "and" with a character for blinking.
-UINT8  FlagDaylightSavingTime;                 // used to evaluate current Daylight Saving Time (DST) / Summer Timer status on clock power-up.
+UINT8  FlagDaylightSavingTime;                 // current Daylight Saving Time (DST) / Summer Time status, as given by DST rule.
 UINT8  FlagIdleCheck              = FLAG_OFF;  // if ON, we keep track of idle time to eventually declare a time-out during setting (clock, alarm or timer).
 UINT8  FlagIdleMonitor            = FLAG_OFF;  // monitor system "idle time" to see "how busy" (in fact, "how not busy") the system is. Nothing in common with "idle check" above.
 volatile UINT8 FlagIsrContext     = FLAG_OFF;  // flag used to determine if we run in ISR context.
+UINT8  FlagRtcWrite               = FLAG_OFF;  // flag indicating local time must be copied to the real-time clock IC on next second of the time base.
 UINT8  FlagScrollData             = FLAG_OFF;  // time has come to scroll data on clock display.
 UINT8  FlagScrollStart            = FLAG_OFF;  // flag indicating it is time to start scrolling.
 UINT8  FlagSetAlarm               = FLAG_OFF;  // flag indicating we are in alarm setup mode.
@@ -1183,23 +1392,29 @@ UINT16 FlashingCount = 0;                                               // cumul
 
 UCHAR  GetAddHigh = 0x11;
 UCHAR  GetAddLow  = 0x12;
-UINT64 GlobalUnixTime;        // system-wide current time based on UTC Unix Time.
+UINT64 GlobalUnixTime;        // system-wide current time based on UTC Unix Time, derived from the time base (local time is GlobalUnixTime + get_utc_offset()).
 
-UINT16 IdleArchivePacket;     // packet number being archived for debugging purposes.
-UINT64 IdleMonitor[14];       // evaluate average number of loops performed per second.
+UINT8  IdleHistoryCount;      // number of valid entries in system idle monitor history.
+UINT8  IdleHistoryHead;       // index of the next entry to be written in system idle monitor history.
+UINT32 IdleMonitor[14];       // evaluate average number of loops performed per second.
 UINT8  IdleMonitorPacket;     // idle monitor packet for current 5-seconds period.
 UINT8  LastIdleMonitorPacket; // idle monitor packet number processed in the last pass.
 UINT8  IdleNumberOfSeconds;   // keep track of the number of seconds the system has been idle.
-UINT16 IdleTimeSamples;
-UINT64 IrFinalValue[MAX_IR_READINGS];    // final timer value when receiving edge change from remote control.
-UINT64 IrInitialValue[MAX_IR_READINGS];  // initial timer value when receiving edge change from remote control.
-UCHAR  IrLevel[MAX_IR_READINGS];         // logic levels of remote control signal: 'L' (low), 'H' (high), or 'X' (undefined).
-UINT32 IrResultValue[MAX_IR_READINGS];   // duration of this logic level (Low or High) in the signal received from remote control.
+UINT32 IrLastEdge;                       // timer value (low 32 bits) of the last edge received from remote control.
+UINT16 IrPulse[MAX_IR_READINGS];         // duration (in usec) of each logic level received from remote control. Level is implied by parity (see IR_LEVEL()).
 UINT16 IrStepCount;                      // number of "logic level changes" received from IR remote control in current stream.
 
+/* Stack boundaries, as defined by the Pico SDK linker script. Interrupt handlers of core 0 run on the core 0 (main) stack. */
+extern UINT32 __StackBottom;
+extern UINT32 __StackTop;
+extern UINT32 __StackOneBottom;
+extern UINT32 __StackOneTop;
+UINT8  FlagStackWarning = FLAG_OFF;      // set to On when a stack high-water mark crosses the warning threshold.
+UINT32 StackCore0Peak;                   // core 0 stack high-water mark (in bytes), including interrupt handlers.
+UINT32 StackCore1Peak;                   // core 1 stack high-water mark (in bytes).
+UINT32 StackIsrLowest = 0xFFFFFFFF;      // lowest stack pointer value sampled when entering a callback (interrupt context).
+
 UINT16 MiddleKeyPressTime = 0;                                                // keep track of the time the Up ("Middle") key is pressed.
-UINT8  MonthDays[2][12] = {{31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},  // number of days in a month - "leap" year.
-                           {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}}; // number of days in a month - "normal" year.
 
 UINT8  NightLightTimeOffDisplay;    // to adapt to 12 or 24-hours time format.
 UINT8  NightLightTimeOnDisplay;     // to adapt to 12 or 24-hours time format.
@@ -1214,11 +1429,21 @@ UINT8  ResetSecond = 0;
 UINT8  ResetSecond = 50;
 #endif // RELEASE_VERSION
 UINT8  RowScanNumber;
+struct rtc_drift RtcDrift;               // drift measurement of the real-time clock IC against NTP (see rtc_drift_measure()).
+
+alarm_id_t ReminderAlarmId;              // Pico alarm waking up the reminder scheduler at next reminder ring time (0 = none).
+UINT16 ReminderHeap[MAX_REMINDERS1];     // binary min-heap of reminder numbers, keyed by Reminder1[].NextRingEpoch (next one to ring on top).
+UINT16 ReminderHeapCount;                // number of reminders in the heap.
+struct recur_rule ReminderRule[MAX_REMINDER_RULES];  // parsed recurrence rules of the reminders that have one.
+UINT8  ReminderRuleCount;                // number of entries used in ReminderRule[].
 
 UINT8  ScrollDotCount = 0;               // keep track of "how many dots" remain to be scrolled to the left on clock display.
 UINT8  ScrollQueue[MAX_SCROLL_QUEUE];    // circular buffer containing the tag of the next messages to be scrolled.
 UINT8  ScrollQueueHead;                  // head of Scroll circular buffer.
 UINT8  ScrollQueueTail;                  // tail of Scroll circular buffer.
+UCHAR  ScrollValue[MAX_SCROLL_VALUES][51];  // strings queued by scroll_queue_value() (for debugging purposes).
+UINT8  ScrollValueHead;                  // next entry of ScrollValue[] to be filled by scroll_queue_value().
+UINT8  ScrollValueTail;                  // next entry of ScrollValue[] to be scrolled.
 UINT8  ScrollSecondCounter = 0;          // keep track of number of seconds to reach time-to-scroll.
 UINT8  ScrollStartCount = 0;             // count the number of milliseconds before scrolling one more dot position to the left.
 UINT8  SetupSource = SETUP_SOURCE_NONE;  // indicate the source of current setup activities (alarm, clock or timer).
@@ -1229,6 +1454,8 @@ volatile UINT16 SoundActiveTail;         // tail of sound circular buffer for ac
 volatile UINT16 SoundPassiveHead;        // head of sound circular buffer for passive buzzer.
 volatile UINT16 SoundPassiveTail;        // tail of sound circular buffer for passive buzzer.
 
+struct time_base TimeBase;           // time base of the clock: Pico timer corrected for the Pico crystal frequency error and slewed by NTP (see time_base_us()).
+int32_t TimeCivilDay = -1;           // local day number (days since 01-JAN-1970) of date fields currently in CurrentDayOfMonth, CurrentMonth, etc...
 UINT8  TimerMinutes    = 0;
 UINT8  TimerMode       = TIMER_OFF;  // timer mode (0 = Off / 1 = Count down / 2 = Count up).
 UINT8  TimerSeconds    = 0;
@@ -1247,68 +1474,73 @@ semaphore_t SemSync; // semaphore used to synchronize minutes and seconds displa
 
 uart_inst_t *Uart;   // Pico's UART used to serially transfer debug data to a VT100-type monitor or to a PC.
 
-UCHAR MonthName[LANGUAGE_HI_LIMIT][13][13] =
+/* Localized string pool, built by the preprocessor from the MESSAGE_TABLE in messages.h.
+   Every string of every language is a member of this structure, so that its offset is known at compile time. */
+struct message_pool
 {
-  {{}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}},
-  {{}, {"January"},   {"February"},  {"March"},     {"April"},     {"May"},       {"June"},      {"July"},      {"August"},    {"September"}, {"October"},   {"November"},  {"December"}},
-  {{}, {"Janvier"},   {"Fevrier"},   {"Mars"},      {"Avril"},     {"Mai"},       {"Juin"},      {"Juillet"},   {"Aout"},      {"Septembre"}, {"Octobre"},   {"Novembre"},  {"Decembre"}},
-  {{}, {"Januar"},    {"Februar"},   {"Maerz"},     {"April"},     {"Mai"},       {"Juni"},      {"Juli"},      {"August"},    {"September"}, {"Oktober"},   {"November"},  {"Dezember"}},
-  {{}, {"leden"},     {"unor"},      {"brezen"},    {"duben"},     {"kveten"},    {"cerven"},    {"cervenec"},  {"srpen"},     {"zari"},      {"rijen"},     {"listopad"},  {"prosinec"}},
-  {{}, {"enero"},     {"febrero"},   {"marzo"},     {"abril"},     {"mayo"},      {"junio"},     {"julio"},     {"agosto"},    {"septiembre"},{"octubre"},   {"noviembre"}, {"diciembre"}}
+#define MESSAGE(Id, English, French, German, Czech, Spanish) \
+  char Id##_ENGLISH[sizeof(English)]; char Id##_FRENCH[sizeof(French)]; char Id##_GERMAN[sizeof(German)]; char Id##_CZECH[sizeof(Czech)]; char Id##_SPANISH[sizeof(Spanish)];
+  MESSAGE_TABLE
+#undef MESSAGE
 };
 
-
-UCHAR ShortMonth[LANGUAGE_HI_LIMIT][13][4] =
+const struct message_pool MessagePool =
 {
-  {{}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}},
-  {{}, {"JAN"},  {"FEB"},  {"MAR"},  {"APR"},  {"MAY"},  {"JUN"},  {"JUL"},  {"AUG"},  {"SEP"},  {"OCT"},  {"NOV"},  {"DEC"}},
-  {{}, {"JAN"},  {"FEV"},  {"MAR"},  {"AVR"},  {"MAI"},  {"JUN"},  {"JUL"},  {"AOU"},  {"SEP"},  {"OCT"},  {"NOV"},  {"DEC"}},
-  {{}, {"JAN"},  {"FEB"},  {"MAR"},  {"APR"},  {"MAI"},  {"JUN"},  {"JUL"},  {"AUG"},  {"SEP"},  {"OKT"},  {"NOV"},  {"DEZ"}},
-  {{}, {"led."}, {"uno."}, {"bre."}, {"dub."}, {"kve."}, {"cvn."}, {"cvc."}, {"srp."}, {"zar."}, {"rij."}, {"lis."}, {"pro."}},
-  {{}, {"ene."}, {"feb."}, {"mar."}, {"abr."}, {"may."}, {"jun."}, {"jul."}, {"ago."}, {"sep."}, {"oct."}, {"nov."}, {"dic."}}
+#define MESSAGE(Id, English, French, German, Czech, Spanish) English, French, German, Czech, Spanish,
+  MESSAGE_TABLE
+#undef MESSAGE
 };
 
-UCHAR DayName[LANGUAGE_HI_LIMIT][8][13] =
+_Static_assert(sizeof(struct message_pool) < 0x10000, "Message pool too big for 16-bits offsets");
+
+/* Offset of each message in the string pool, for each language. Untranslated (empty) messages point to the English version. */
+#define MESSAGE_OFFSET(Id, Text, Language) ((sizeof(Text) > 1) ? offsetof(struct message_pool, Id##_##Language) : offsetof(struct message_pool, Id##_ENGLISH))
+
+const UINT16 MessageOffset[MSG_HI_LIMIT][LANGUAGE_HI_LIMIT] =
 {
-  {{}, {}, {}, {}, {}, {}, {}, {}},
-  {{}, {"Sunday"},     {"Monday"},     {"Tuesday"},    {"Wednesday"}, {"Thursday"},   {"Friday"},     {"Saturday"}},
-  {{}, {"Dimanche"},   {"Lundi"},      {"Mardi"},      {"Mercredi"},  {"Jeudi"},      {"Vendredi"},   {"Samedi"}},
-  {{}, {"Sonntag"},    {"Montag"},     {"Dienstag"},   {"Mittwoch"},  {"Donnerstag"}, {"Freitag"},    {"Samstag"}},
-  {{}, {"nedele"},     {"pondeli"},    {"utery"},      {"streda"},    {"ctvrtek"},    {"patek"},      {"sobota"}},  
-  {{}, {"domingo"},    {"lunes"},      {"martes"},     {"miercoles"}, {"jueves"},     {"viernes"},    {"sabado"}}
+#define MESSAGE(Id, English, French, German, Czech, Spanish) \
+  {offsetof(struct message_pool, Id##_ENGLISH), offsetof(struct message_pool, Id##_ENGLISH), MESSAGE_OFFSET(Id, French, FRENCH), MESSAGE_OFFSET(Id, German, GERMAN), MESSAGE_OFFSET(Id, Czech, CZECH), MESSAGE_OFFSET(Id, Spanish, SPANISH)},
+  MESSAGE_TABLE
+#undef MESSAGE
 };
 
-UCHAR ShortDay[LANGUAGE_HI_LIMIT][8][10] =
+
+/* Daylight Saving Time rules for each DST_COUNTRY, taken from zoneinfo (tzdata 2024b). The standard offset of the rule is replaced by the
+   clock Timezone setting (see set_dst_rule()), so that the same rule applies to all timezones of a region. */
+const struct dst_region DstRegion[DST_HI_LIMIT] =
 {
-  {{}, {}, {}, {}, {}, {}, {}, {}},
-  {{}, {"SUN"}, {"MON"}, {"TUE"}, {"WED"}, {"THU"}, {"FRI"}, {"SAT"}},
-  {{}, {"DIM"}, {"LUN"}, {"MAR"}, {"MER"}, {"JEU"}, {"VEN"}, {"SAM"}},
-  {{}, {"SON"}, {"MON"}, {"DIE"}, {"MIT"}, {"DON"}, {"FRE"}, {"SAM"}},
-  {{}, {"ne"},  {"po"},  {"ut"},  {"st"},  {"ct"},  {"pa"},  {"so"}},
-  {{}, {"do."}, {"lu."}, {"ma."}, {"mi."}, {"ju."}, {"vi."}, {"sa."}}
+  {"UTC0",                                  FLAG_OFF},  //  0 - No DST support
+  {"AEST-10AEDT,M10.1.0,M4.1.0/3",          FLAG_OFF},  //  1 - Australia       (Australia/Sydney)
+  {"<+1030>-10:30<+11>-11,M10.1.0,M4.1.0",  FLAG_OFF},  //  2 - Australia-Howe  (Australia/Lord_Howe, 30 minutes shift)
+  {"<-04>4<-03>,M9.1.6/24,M4.1.6/24",       FLAG_OFF},  //  3 - Chile           (America/Santiago, time changes at 24h00 on Saturday)
+  {"CST5CDT,M3.2.0/0,M11.1.0/1",            FLAG_OFF},  //  4 - Cuba            (America/Havana)
+  {"CET-1CEST,M3.5.0,M10.5.0/3",            FLAG_ON},   //  5 - European Union  (Europe/Paris, time changes at 1h00 UTC)
+  {"IST-2IDT,M3.4.4/26,M10.5.0",            FLAG_OFF},  //  6 - Israel          (Asia/Jerusalem, Friday before last Sunday)
+  {"EET-2EEST,M3.5.0/0,M10.5.0/0",          FLAG_OFF},  //  7 - Lebanon         (Asia/Beirut)
+  {"EET-2EEST,M3.5.0,M10.5.0/3",            FLAG_OFF},  //  8 - Moldova         (Europe/Chisinau)
+  {"NZST-12NZDT,M9.5.0,M4.1.0/3",           FLAG_OFF},  //  9 - New-Zealand     (Pacific/Auckland)
+  {"EST5EDT,M3.2.0,M11.1.0",                FLAG_OFF},  // 10 - North America   (America/New_York)
+  {"EET-2EEST,M3.4.4/50,M10.4.4/50",        FLAG_OFF},  // 11 - Palestine       (Asia/Gaza, Saturday after fourth Thursday)
+  {"<-03>3",                                FLAG_OFF},  // 12 - Paraguay        (America/Asuncion, no DST since October 2024)
 };
 
 
-struct dst_parameters DstParameters[25] =
+/* Chime schedule: what the clock does by itself at given times of the day. The next entries due are found by chime_schedule()
+   and a Pico alarm wakes up on their exact second. Sounds comply with chime settings (Off / On / Day) at the time they are due. */
+const struct chime_entry ChimeSchedule[] =
 {
-  { 0,  0,  0,  0, 24,  0,  0,  0,  0,  0,  0,  0, 60},  //  0 - Dummy
-  {10,  1,  1,  7,  2,  0,  4,  1,  1,  7,  3,  0, 60},  //  1 - Australia
-  {10,  1,  1,  7,  2,  0,  4,  1,  1,  7,  2,  0, 30},  //  2 - Australia-Howe
-  { 9,  7,  1,  7, 24,  0,  4,  7,  1,  7, 24,  0, 60},  //  3 - Chile           (StartHour and EndHour changes at 24h00, will change at 00h00 the day after)
-  { 3,  1,  8, 14,  0,  0, 11,  1,  1,  7,  1,  0, 60},  //  4 - Cuba
-  { 3,  1, 25, 31,  1,  0, 10,  1, 25, 31,  1,  0, 60},  //  5 - European Union  (StartHour and EndHour are based on UTC time)
-  { 3,  6, 23, 29,  2,  0, 10,  1, 25, 31,  2,  0, 60},  //  6 - Israel
-  { 3,  1, 25, 31,  0,  0, 10,  1, 25, 31,  0,  0, 60},  //  7 - Lebanon
-  { 3,  1, 25, 31,  2,  0, 10,  1, 25, 31,  3,  0, 60},  //  8 - Moldova
-  { 9,  1, 24, 30,  2,  0,  4,  1,  1,  7,  2,  0, 60},  //  9 - New-Zealand     (StartHour and EndHour are based on UTC time)
-  { 3,  1,  8, 14,  2,  0, 11,  1,  1,  7,  2,  0, 60},  // 10 - North America
-  { 3,  7, 24, 30,  2,  0, 10,  7, 24, 30,  2,  0, 60},  // 11 - Palestine
-  {10,  1,  1,  7,  0,  0,  3,  1, 22, 28,  0,  0, 60},  // 12 - Paraguay
- };
-// StartMonth, StartDayOfWeek, StartDayOfMonthLow, StartDayOfMonthHigh, StartHour, StartDayOfYear,
-// EndMonth,   EndDayOfWeek,   EndDayOfMonthLow,   EndDayOfMonthHigh,   EndHour,   EndDayOfYear,
-// ShiftMinutes
-// NOTE: StartDayOfYear and EndDayOfYear will assigned to local DST parameters in "update_dst_ststus()" function.
+  /* Minute         Second  Hours    Days            Action               Sound */
+  {0,               0,      0, 23,   CHIME_ALL_DAYS, CHIME_ACTION_SOUND,  CHIME_SOUND_HOUR},       // hourly chime.
+  #if (CHIME_HALF_HOUR == FLAG_ON)
+  {30,              0,      0, 23,   CHIME_ALL_DAYS, CHIME_ACTION_SOUND,  CHIME_SOUND_HALF_HOUR},  // half-hour chime.
+  #endif  // CHIME_HALF_HOUR
+  {2,               0,      0, 23,   CHIME_ALL_DAYS, CHIME_ACTION_YEAR,   CHIME_SOUND_NONE},       // check for a year change, out of peak period.
+  {EVENT_MINUTE1,   0,      0, 23,   CHIME_ALL_DAYS, CHIME_ACTION_EVENTS, CHIME_SOUND_EVENT},      // calendar events of today.
+  {EVENT_MINUTE2,   0,      0, 23,   CHIME_ALL_DAYS, CHIME_ACTION_EVENTS, CHIME_SOUND_EVENT},      // calendar events of today.
+};
+#define MAX_CHIME_SCHEDULE  (sizeof(ChimeSchedule) / sizeof(ChimeSchedule[0]))
+
+_Static_assert(MAX_CHIME_SCHEDULE <= 16, "Too many chime schedule entries for ChimeNextMask");
 
 
 
@@ -1326,12 +1558,14 @@ struct pixel Pixel[7][22]=
 
 
 struct command         CommandQueue[MAX_COMMAND_QUEUE];
+struct idle_history    IdleHistory[MAX_IDLE_HISTORY];  // circular buffer of per-minute system idle monitor statistics.
 struct pwm             Pwm[2];
 struct repeating_timer Timer50MSec;  // sound callback.
 struct repeating_timer TimerMSec;    // clock buttons handling callback
 struct repeating_timer TimerSec;     // time keeping and overall supervision callback
 struct sound_active    SoundQueueActive[MAX_ACTIVE_SOUND_QUEUE];
 struct sound_passive   SoundQueuePassive[MAX_PASSIVE_SOUND_QUEUE];
+struct tz_cache        TzCache;      // Daylight Saving Time rule and UTC epochs of its next transitions.
 
 
 
@@ -1370,6 +1604,30 @@ float adc_read_voltage(void);
 /* If auto-brightness is On, adjust clock brightness according to average ambient light level. */
 void adjust_clock_brightness(void);
 
+/* Pico alarm callback ringing the alarms that are due. */
+int64_t alarm_callback(alarm_id_t AlarmId, void *UserData);
+
+/* Pack alarm parameters into flash configuration. */
+void alarm_pack(void);
+
+/* Find the next alarm(s) to ring after a given local time (or after current time) and wake up for it. */
+void alarm_schedule(UINT64 After);
+
+/* Unpack alarm parameters from flash configuration. */
+void alarm_unpack(void);
+
+/* Return FLAG_ON if chime settings and silence period allow sounds at the given hour. */
+UINT8 chime_allowed(UINT8 Hour);
+
+/* Pico alarm callback performing the chime schedule entries that are due. */
+int64_t chime_callback(alarm_id_t AlarmId, void *UserData);
+
+/* Find the next chime schedule entries due after a given local time (or after current time) and wake up for them. */
+void chime_schedule(UINT64 After);
+
+/* Queue the sound of a chime schedule entry. */
+void chime_sound(UINT8 Sound, UINT8 Hour);
+
 /* Clear all the leds on clock display. */
 void clear_all_leds(void);
 
@@ -1421,6 +1679,27 @@ void evaluate_blinking_time(void);
 /* Evaluate if it is time to scroll characters ("one dot left") on clock display. */
 void evaluate_scroll_time(void);
 
+/* Check for a valid calendar events blob in flash. */
+void event_blob_check(void);
+
+/* Return the text of a calendar event (from the calendar events blob if there is one). */
+const UCHAR *event_description(UINT8 EventNumber);
+
+/* Build the day-of-year index of calendar events. */
+void event_index_build(void);
+
+/* Return the jingle of a calendar event (from the calendar events blob if there is one). */
+UINT16 event_jingle(UINT8 EventNumber);
+
+/* Fill a list with the numbers of all calendar events of a given date (from the index and from recurrence rules). */
+UINT16 event_list(UINT16 Year, UINT8 Month, UINT8 DayOfMonth, UINT8 *List);
+
+/* Find calendar events of a given date in the calendar events index. */
+UINT16 event_lookup(UINT8 Month, UINT8 DayOfMonth, UINT16 *First);
+
+/* Parse the recurrence rule of a calendar event into EventRule[]. */
+void event_rule_add(UINT8 EventNumber, const UCHAR *Rule, UINT8 Month, UINT8 Day);
+
 /* Fill the virtual framebuffer with the given ASCII character, beginning at the specified column position (using 5 X 7 character bitmap). */
 UINT16 fill_display_buffer_5X7(UINT8 Column, UINT8 AsciiCharacter);
 
@@ -1460,15 +1739,15 @@ void get_date_string(UCHAR *String);
 /* Determine the day-of-year of date given in argument. */
 UINT16 get_day_of_year(UINT16 YearNumber, UINT8 MonthNumber, UINT8 DayNumber);
 
-/* Determine the day-of-year for DST start day and DST end day. */
-void get_dst_days(void);
-
 /* Determine if the microcontroller is a Pico or a Pico W. */
 UINT8 get_microcontroller_type(void);
 
 /* Return the number of days in a specific month (while checking if it is a leap year or not for February). */
 UINT8 get_month_days(UINT16 CurrentYear, UINT8 MonthNumber);
 
+/* Return current difference between local time and UTC time (in seconds), including Daylight Saving Time. */
+int32_t get_utc_offset(void);
+
 /* Read DS3231 real-time clock IC and return current time in "human_time" format. */
 void get_current_time(struct human_time *HumanTime);
 
@@ -1478,6 +1757,9 @@ void get_pico_unique_id(void);
 /* Return the day-of-week, given the day-of-month, month and year. */
 UINT8 get_day_of_week(UINT16 year_cnt, UINT8 month_cnt, UINT8 date_cnt);
 
+/* Display system idle monitor history through serial port. */
+void idle_history_display(void);
+
 /* Initialize all required GPIO ports of the Raspberry Pi Pico. */
 int init_gpio(void);
 
@@ -1490,6 +1772,17 @@ gpio_irq_callback_t isr_signal_trap(UINT8 gpio, UINT32 Events);
 /* Test clock LED matrix, column-by-column, and also all display indicators. */
 void matrix_test(UINT8 TestNumber);
 
+/* Return a localized message in the language currently selected. */
+const char *msg(UINT16 MessageId);
+
+/* Return a localized message in the specified language. */
+const char *msg_lang(UINT8 Language, UINT16 MessageId);
+
+#ifdef PICO_W
+/* Apply the result of an NTP sync (COMMAND_NTP_UPDATE). */
+void ntp_update(UINT8 FlagSuccess);
+#endif  // PICO_W
+
 /* Make pixel animation for the specified number of seconds. */
 void pixel_twinkling(UINT16 Seconds);
 
@@ -1514,9 +1807,36 @@ void pwm_set_duty_cycle(UINT8 DutyCycle);
 /* Set the frequency for the PWM used for passive buzzer. */
 void pwm_set_frequency(UINT16 Frequency);
 
+/* Program the Pico alarm for the reminder that will ring next. */
+void reminder_arm(void);
+
+/* Pico alarm callback of the reminder scheduler. */
+int64_t reminder_callback(alarm_id_t AlarmId, void *UserData);
+
+/* Move a reminder down the reminder heap until its parent rings earlier. */
+void reminder_heap_down(UINT16 Position);
+
+/* Compute the epochs of all reminders and build the reminder heap. */
+void reminder_init(void);
+
+/* Return the next ring time of a reminder, at or after the given local time. */
+UINT64 reminder_next_ring(UINT16 ReminderNumber, UINT64 LocalTime);
+
+/* Ring the reminders that are due and reschedule them. */
+void reminder_process(void);
+
 /* Reverse the bit order of the byte given in argument. */
 UINT8 reverse_bits(UINT8 InputByte);
 
+/* Measure the error of the real-time clock IC before it is written and trim its aging offset once its drift is known. */
+void rtc_drift_measure(int64_t Offset);
+
+/* Take the error of the real-time clock IC right after it has been written. */
+void rtc_drift_start(int64_t Offset);
+
+/* Copy local time of the time base to the real-time clock IC, on the second (COMMAND_RTC_WRITE). */
+void rtc_write_time(void);
+
 /* Scroll the virtual framebuffer one dot to the left. */
 void scroll_one_dot(void);
 
@@ -1528,7 +1848,7 @@ UINT8 scroll_queue(UINT8 Tag);
 UINT8 scroll_queue_value(UINT8 Tag, UCHAR *String);
 
 /* Scroll the specified string on the display. */
-void scroll_string(UINT8 StartColumn, UCHAR *String);
+void scroll_string(UINT8 StartColumn, const UCHAR *String);
 
 /* Unqueue next tag from the scroll queue. */
 UINT8 scroll_unqueue(void);
@@ -1539,6 +1859,9 @@ void send_data(UINT8 data);
 /* Request Wi-Fi SSID and password from user and save them to Pico's flash. */
 void set_and_save_credentials(void);
 
+/* Apply the DST rule of current DST country to current Timezone setting and compute its next transitions. */
+void set_dst_rule(void);
+
 /* Exit current setup mode step. */
 void set_mode_out(void);
 
@@ -1548,6 +1871,9 @@ void set_mode_timeout(void);
 /* Turn On or Off the specified pixel. */
 void set_pixel(UINT8 Row, UINT8 Column, UINT8 Flag);
 
+/* Save difference between local time and UTC time (in seconds) to Timezone and TimezoneMinutes. */
+void set_utc_offset(int32_t Offset);
+
 /* Display current alarm parameters. */
 void setup_alarm_frame(void);
 
@@ -1584,6 +1910,42 @@ UINT8 sound_unqueue_passive(UINT16 *Frequency, UINT16 *MSeconds);
 /* Sound callback function (50 milliseconds period). */
 bool sound_callback_ms(struct repeating_timer *Timer50MSec);
 
+/* Evaluate stack high-water marks of both cores and issue a warning if getting close to overflow. */
+void stack_check(void);
+
+/* Display stack high-water marks through serial port. */
+void stack_display(void);
+
+/* Paint unused stack space with a known pattern. */
+void stack_paint(UINT32 *Bottom, UINT32 *Top);
+
+/* Return the maximum number of bytes that have been used on the given stack since it has been painted. */
+UINT32 stack_peak(UINT32 *Bottom, UINT32 *Top);
+
+/* Compare the time base with the real-time clock IC and resync it if they drifted apart. */
+void time_base_check_rtc(void);
+
+/* Discipline the time base (frequency and phase) with an NTP result. */
+int64_t time_base_discipline(UINT64 UnixTimeUs, UINT64 TimerValue);
+
+/* Read the real-time clock IC and return its time as UTC Unix time. */
+UINT64 time_base_read_rtc(void);
+
+/* Set the time base so that the given UTC time (in usec) corresponds to the given Pico timer value. */
+void time_base_set(UINT64 UnixTimeUs, UINT64 TimerValue);
+
+/* Set the time base from the real-time clock IC, on its next second change. */
+void time_base_sync_rtc(void);
+
+/* Return the Pico timer duration (in usec) matching a duration of the time base beginning now. */
+UINT64 time_base_timer_us(UINT64 Duration);
+
+/* Return current UTC time in usec (time base of the clock). */
+UINT64 time_base_us(void);
+
+/* Derive GlobalUnixTime and local civil time fields from the time base. */
+void time_civil_update(void);
+
 /* One millisecond period callback function. */
 bool timer_callback_ms(struct repeating_timer *TimerMSec);
 
@@ -1602,8 +1964,8 @@ void uart_send(UINT LineNumber, UCHAR *Format, ...);
 /* Return the string representing the uint64_t parameter in binary. */
 void uint64_to_binary_string(UINT64 Value, UINT8 StringLength, UCHAR *BinaryString);
 
-/* Set DST parameters (FlagSummerTime and Timezone) according to current DST country code and current date and time. */
-void update_dst_status();
+/* Set DST parameters (FlagSummerTime and Timezone) according to current DST rule and current date and time. */
+void update_dst_status(void);
 
 /* Update indicators at the left of the clock display. */
 void update_left_indicators(void);
@@ -1712,6 +2074,7 @@ int main(void)
   UCHAR TempString3[25];
 
   UINT8  DstUnit;
+  UINT8  FlagStackCheck = FLAG_OFF;  // to make only one stack check per minute.
   
   UINT8  BitNumber;
   UINT8  Dum1UInt8;
@@ -1732,11 +2095,9 @@ int main(void)
   UINT32 Bme280UniqueId;
   UINT32 CounterHiLimit;
 
-  UINT64 ArchiveIdleMonitor[14][120];  // keep an history of idle monitorfor reference purposes (outside monitor is required).
   UINT64 CurrentTimerValue;
   UINT64 CurrentWatchDogReset;
   UINT64 DataBuffer;
-  UINT64 Dum1UInt64;
   UINT64 LastWatchDogReset;
 
   float Duration;
@@ -1745,66 +2106,22 @@ int main(void)
 
   time_t TimeStamp;
 
+  struct alarm_v902 *AlarmV902;  // alarms as saved in flash configuration up to Version 9.02.
+
   struct human_time HumanTime;
-  struct tm TmTime;
 
 
 
   /* ---------------------------------------------------------------- *\
-                   Localization of days and months.
+      Paint unused stack space to keep track of stack high-water mark.
   \* ---------------------------------------------------------------- */
+  /* Core 0 stack is in use (we are running on it) and only the part below current stack pointer will be painted. Core 1 stack is painted
+     before core 1 is launched. */
+  stack_paint(&__StackBottom, &__StackTop);
+  #ifdef DHT_SUPPORT
+  stack_paint(&__StackOneBottom, &__StackOneTop);
+  #endif  // DHT_SUPPORT
 
-  /* Add accents to some French weekdays and months. */
-  MonthName[FRENCH][FEB][1] = (UCHAR)0x90; // e - acute on fevrier.
-  MonthName[FRENCH][AUG][2] = (UCHAR)30;   // u - circumflex on aout.
-  MonthName[FRENCH][DEC][1] = (UCHAR)0x90; // e - acute on decembre.
-
-  ShortMonth[FRENCH][FEB][1] = (UCHAR)0x90; // e - acute on FEV.
-  ShortMonth[FRENCH][AUG][2] = (UCHAR)30;   // u - circumflex on AOU.
-  ShortMonth[FRENCH][DEC][1] = (UCHAR)0x90; // e - acute on DEC.
-
-
-  /* Add accents to some Czech weekdays. */
-  DayName[CZECH][MON][4] = (UCHAR)130; // e-caron
-  DayName[CZECH][MON][6] = (UCHAR)131; // i-acute
-  DayName[CZECH][TUE][0] = (UCHAR)133; // u-acute
-  DayName[CZECH][TUE][4] = (UCHAR)132; // y-acute
-  DayName[CZECH][WED][2] = (UCHAR)135; // r-caron
-  DayName[CZECH][THU][0] = (UCHAR)136; // c-caron
-  DayName[CZECH][FRI][1] = (UCHAR)129; // a-acute
-  DayName[CZECH][SUN][3] = (UCHAR)130; // e-caron
-
-  ShortDay[CZECH][TUE][0] = (UCHAR)133; // u-acute
-  ShortDay[CZECH][THU][0] = (UCHAR)136; // c-caron
-  ShortDay[CZECH][FRI][1] = (UCHAR)129; // a-acute
-  ShortDay[CZECH][SUN][3] = (UCHAR)130; // e-caron
-
-  /* Add accents to some Czech months. */
-  MonthName[CZECH][FEB][0] = (UCHAR)133; // u-acute
-  MonthName[CZECH][MAR][1] = (UCHAR)135; // r-caron
-  MonthName[CZECH][MAY][2] = (UCHAR)130; // e-caron
-  MonthName[CZECH][JUN][0] = (UCHAR)136; // c-caron
-  MonthName[CZECH][JUL][0] = (UCHAR)136; // c-caron
-  MonthName[CZECH][SEP][1] = (UCHAR)129; // a-acute
-  MonthName[CZECH][SEP][2] = (UCHAR)135; // r-caron
-  MonthName[CZECH][OCT][0] = (UCHAR)135; // r-caron
-  MonthName[CZECH][OCT][1] = (UCHAR)131; // i-acute
-
-  ShortMonth[CZECH][FEB][0] = (UCHAR)133; // u-acute
-  ShortMonth[CZECH][MAR][1] = (UCHAR)135; // r-caron
-  ShortMonth[CZECH][MAY][2] = (UCHAR)130; // e-caron
-  ShortMonth[CZECH][JUN][0] = (UCHAR)136; // c-caron
-  ShortMonth[CZECH][JUL][0] = (UCHAR)136; // c-caron
-  ShortMonth[CZECH][SEP][1] = (UCHAR)129; // a-acute
-  ShortMonth[CZECH][SEP][2] = (UCHAR)135; // r-caron
-  ShortMonth[CZECH][OCT][0] = (UCHAR)135; // r-caron
-  ShortMonth[CZECH][OCT][1] = (UCHAR)131; // i-acute
-
-  /* Add accents to some Spanish weekdays. */
-  DayName[SPANISH][TUE][2] = (UCHAR)130; // e-acute
-  DayName[SPANISH][SAT][1] = (UCHAR)129; // a-acute
-
-  ShortDay[SPANISH][SAT][1] = (UCHAR)129; // a-acute
 
 
   /* ---------------------------------------------------------------- *\
@@ -1845,18 +2162,17 @@ int main(void)
   for (Loop1UInt8 = 0; Loop1UInt8 < 14; ++Loop1UInt8)
     IdleMonitor[Loop1UInt8] = 0;
 
-  /* Reset archive values of system idle monitor to get prepared for storage. */
-  IdleTimeSamples = 120;
-  for (IdleArchivePacket = 0; IdleArchivePacket < IdleTimeSamples; ++IdleArchivePacket)
+  /* Reset system idle monitor history (one entry per minute for the last two hours). */
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_IDLE_HISTORY; ++Loop1UInt8)
   {
-    for (Loop1UInt8 = 0; Loop1UInt8 < 14; ++Loop1UInt8)
-    {
-      ArchiveIdleMonitor[Loop1UInt8][IdleArchivePacket] = 0;
-    }
+    IdleHistory[Loop1UInt8].Minimum = 0;
+    IdleHistory[Loop1UInt8].Average = 0;
+    IdleHistory[Loop1UInt8].Maximum = 0;
   }
   LastIdleMonitorPacket = 0;
   IdleMonitorPacket     = 0;
-  IdleArchivePacket     = 0;
+  IdleHistoryCount      = 0;
+  IdleHistoryHead       = 0;
 
 
 
@@ -1879,9 +2195,16 @@ int main(void)
   NTPData.NTPGetTime     = 0ll;
   NTPData.NTPLastUpdate  = 0ll;
   NTPData.NTPReadCycles  = 0l;        // reset number of NTP read cycles on entry.
-  NTPData.NTPDelta       = DstParameters[0].StartHour * DstParameters[0].ShiftMinutes * DELTA_TIME;
+  NTPData.NTPPoll        = NTP_POLL_MIN;  // poll interval will grow as the clock proves to keep time (see ntp_poll_update()).
+  NTPData.NTPDelta       = (1ULL << NTP_POLL_MIN) * 1000000ULL;
+  NTPData.NTPFailures    = 0;
+  NTPData.NTPFirstSync   = 0ll;
+  NTPData.WiFiLinkTime   = 0ll;
+  NTPData.WiFiOnSince    = 0ll;
+  NTPData.WiFiOnTime     = 0ll;
   NTPData.FlagNTPResync  = FLAG_ON;   // force NTP re-sync on power-up.
   NTPData.FlagNTPSuccess = FLAG_OFF;  // will be turned On after successful NTP answer.
+  NTPData.NTPState       = NTP_STATE_IDLE;
 
   /* Initialize the CYW43 architecture (CYW43 driver and lwIP stack). */
   init_cyw43(CYW43_COUNTRY_WORLDWIDE);
@@ -1924,8 +2247,7 @@ int main(void)
               Read UCT real-time clock IC for a first time.
   \* ---------------------------------------------------------------- */
   /* Get a first value from the real-time clock IC for debug time-stamping purposes.
-     However, callback function to update time will be initialized about 8 seconds later.
-     So, we will re-read the RTC IC later to resync. */
+     The time base will be set from the RTC IC once timezone is known (from flash configuration). */
   /***/
   get_current_time(&HumanTime);
 
@@ -1937,10 +2259,6 @@ int main(void)
   CurrentYearLowPart = HumanTime.Year - 2000;
   CurrentYear        = HumanTime.Year;
   CurrentDayOfWeek   = HumanTime.DayOfWeek;
-  get_current_time(&HumanTime);
-
-  convert_human_to_tm(&HumanTime, &TmTime);
-  GlobalUnixTime = convert_tm_to_unix(&TmTime);
 
 
 
@@ -1987,6 +2305,7 @@ int main(void)
   DebugBitMask += DEBUG_RTC;
   // DebugBitMask += DEBUG_SOUND_QUEUE;
   // DebugBitMask += DEBUG_SCROLL;
+  // DebugBitMask += DEBUG_STACK;
   // DebugBitMask += DEBUG_TEMP;
   // DebugBitMask += DEBUG_TEST;
   // DebugBitMask += DEBUG_TIMER;
@@ -2008,7 +2327,7 @@ int main(void)
     FlashConfig.Language           = DEFAULT_LANGUAGE;
 
     /* Note: Force English for month names in log file since external monitor won't show up accented characters. */
-    uart_send(__LINE__, "\r\r\r\r- - - - - = = = = = %2.2u-%s-%4.4u %2.2u:%2.2u GREEN CLOCK LOG INFO = = = = = - - - - -\r\r", CurrentDayOfMonth, MonthName[ENGLISH][CurrentMonth], CurrentYear, CurrentHour, CurrentMinute);
+    uart_send(__LINE__, "\r\r\r\r- - - - - = = = = = %2.2u-%s-%4.4u %2.2u:%2.2u GREEN CLOCK LOG INFO = = = = = - - - - -\r\r", CurrentDayOfMonth, MONTH_NAME(ENGLISH, CurrentMonth), CurrentYear, CurrentHour, CurrentMinute);
     uart_send(__LINE__, "NOTE: Parts of the time stamps below may be wrong until flash configuration has been\r");
     uart_send(__LINE__, "      read and validated, and callback to read real-time clock has been triggered.\r\r");
 
@@ -2255,8 +2574,9 @@ int main(void)
     FlashConfig.FlagScrollEnable   = FLAG_ON;
     FlashConfig.FlagSummerTime     = FLAG_OFF;
     FlashConfig.TimeDisplayMode    = H24;
+    AlarmV902 = (struct alarm_v902 *)((UINT8 *)FlashConfig.AlarmPacked + ALARM_V902_OFFSET);
     for (Loop1UInt8 = 0; Loop1UInt8 < 9; ++Loop1UInt8)
-      FlashConfig.Alarm[Loop1UInt8].FlagStatus = FLAG_OFF;
+      AlarmV902[Loop1UInt8].FlagStatus = FLAG_OFF;
     sprintf(FlashConfig.SSID,     ".;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.");                                // write specific footprint to flash memory.
     sprintf(FlashConfig.Password, ".:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.");  // write specific footprint to flash memory.
     sprintf(&FlashConfig.SSID[4],     NETWORK_NAME);
@@ -2271,6 +2591,30 @@ int main(void)
   }
 
 
+  /* -------------------- UPDATE VERSION 9.0x TO VERSION 9.03 -------------------- */
+  if ((strcmp(FlashConfig.Version, "9.00") == 0) || (strcmp(FlashConfig.Version, "9.01") == 0) || (strcmp(FlashConfig.Version, "9.02") == 0))
+  {
+    /* Alarms are now packed in 32 bits and take the place of the reserved bytes and nine 45-byte alarms of Version 9.02.
+       Packed alarm "n" is written below Version 9.02 alarm "n", over alarms already converted, so the conversion is done in place. */
+    AlarmV902 = (struct alarm_v902 *)((UINT8 *)FlashConfig.AlarmPacked + ALARM_V902_OFFSET);
+    for (Loop1UInt8 = 0; Loop1UInt8 < 9; ++Loop1UInt8)
+    {
+      if ((AlarmV902[Loop1UInt8].Hour < 24) && (AlarmV902[Loop1UInt8].Minute < 60) && (AlarmV902[Loop1UInt8].Second < 60))
+        FlashConfig.AlarmPacked[Loop1UInt8] = ALARM_PACK(AlarmV902[Loop1UInt8].FlagStatus, AlarmV902[Loop1UInt8].Day, AlarmV902[Loop1UInt8].Hour, AlarmV902[Loop1UInt8].Minute, AlarmV902[Loop1UInt8].Second);
+      else
+        FlashConfig.AlarmPacked[Loop1UInt8] = ALARM_PACK(FLAG_OFF, 0, 0, 0, 29);
+    }
+
+    for (Loop1UInt8 = 9; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
+      FlashConfig.AlarmPacked[Loop1UInt8] = ALARM_PACK(FLAG_OFF, 0, 0, 0, 29);
+
+    /* Fields following the alarms up to SSID hold Version 9.02 alarm texts, erase them (as if carved from erased Reserved1). */
+    memset(&FlashConfig.AlarmPacked[MAX_ALARMS], 0xFF, FlashConfig.SSID - (UCHAR *)&FlashConfig.AlarmPacked[MAX_ALARMS]);
+
+    sprintf(FlashConfig.Version, "9.03");   // convert to Version 9.03.
+  }
+
+
   /* -------------------- UPDATE VERSION 9.0x TO VERSION 10.00 -------------------- */
   // if (strncmp(FlashConfig.Version, "9.", 2) == 0)
   // {
@@ -2280,6 +2624,43 @@ int main(void)
   // }
 
 
+  /* Alarms are used unpacked in RAM. */
+  alarm_unpack();
+
+
+  /* TimezoneMinutes was carved from Reserved1 (erased to 0xFF) after Version 9.02. Accept only quarter-hours, with the same sign as Timezone. */
+  if ((FlashConfig.TimezoneMinutes < -45) || (FlashConfig.TimezoneMinutes > 45) || (FlashConfig.TimezoneMinutes % 15) ||
+      ((FlashConfig.TimezoneMinutes < 0) && (FlashConfig.Timezone > 0)) || ((FlashConfig.TimezoneMinutes > 0) && (FlashConfig.Timezone < 0)))
+    FlashConfig.TimezoneMinutes = TIMEZONE_MINUTES;
+
+
+  /* TimeBaseFreq was also carved from Reserved1. Apply the frequency correction learned before this reboot at once. */
+  if ((FlashConfig.TimeBaseFreq < -TIME_FREQ_MAX) || (FlashConfig.TimeBaseFreq > TIME_FREQ_MAX))
+    FlashConfig.TimeBaseFreq = 0;
+  TimeBase.Freq = FlashConfig.TimeBaseFreq;
+
+
+  #ifdef PICO_W
+  /* Wi-Fi data was also carved from Reserved1. Use the static IP configuration if one is given at the beginning of the source code,
+     otherwise forget any static configuration used before (or erased bytes) so that ntp_init() uses DHCP. */
+  #ifdef STATIC_IP_ADDRESS
+  ntp_static_ip(STATIC_IP_ADDRESS, STATIC_IP_NETMASK, STATIC_IP_GATEWAY, STATIC_IP_DNS);
+  #else
+  if (FlashConfig.WiFiStatic != FLAG_OFF)
+  {
+    FlashConfig.WiFiStatic   = FLAG_OFF;
+    FlashConfig.WiFiLeaseEnd = 0;
+  }
+  #endif  // STATIC_IP_ADDRESS
+  #endif  // PICO_W
+
+
+  /* Now that Timezone and DST country are known, compute Daylight Saving Time transitions for this year and next one.
+     RTC IC keeps local time, it can now be converted to UTC to set the time base before the per-second transition check begins. */
+  set_dst_rule();
+  time_base_sync_rtc();
+
+
   /*** One-time FlashConfig writes may be inserted below... ***/
   // NOTE: If you already ran Firmware Version 9.0x, network SSID and password will not be updated just by replacing both 
   //       #define NETWORK_NAME and #define NETWORK_PASSWORD at the beginning of the source code, instead, to set network SSID
@@ -2304,6 +2685,11 @@ int main(void)
 
   if (DebugBitMask & DEBUG_NTP)
     uart_send(__LINE__, "main() - ntp_init() return code: %d\r", ReturnCode);
+
+  #ifdef LAN_NTP_SERVER
+  /* Answer NTP requests from the local network (the server is unsynchronized until the first NTP sync). */
+  if (ReturnCode == 0) ntp_serve_start();
+  #endif  // LAN_NTP_SERVER
   #endif // PICO_W
 
 
@@ -2331,6 +2717,14 @@ int main(void)
 
 
 
+  /* ---------------------------------------------------------------- *\
+            Build calendar events index (before timers start).
+  \* ---------------------------------------------------------------- */
+  event_blob_check();
+  event_index_build();
+
+
+
   /* ---------------------------------------------------------------- *\
             Initialize sound queue for active buzzer on entry.
                (buzzer integrated in the Pico Green Clock)
@@ -2436,24 +2830,11 @@ int main(void)
 
 
   /* ---------------------------------------------------------------- *\
-      Now that the callback in charge of keeping the real time clock
-          updated is started, resync the clock with the RTC IC.
+      Time of day does not depend on the callback above: it is derived
+        every second from the time base, set from the RTC IC earlier.
   \* ---------------------------------------------------------------- */
-  get_current_time(&HumanTime);
-
-  CurrentHour        = HumanTime.Hour;
-  CurrentMinute      = HumanTime.Minute;
-  CurrentSecond      = HumanTime.Second;
-  CurrentDayOfMonth  = HumanTime.DayOfMonth;
-  CurrentMonth       = HumanTime.Month;
-  CurrentYearLowPart = HumanTime.Year - 2000;
-  CurrentYear        = HumanTime.Year;
-  CurrentDayOfWeek   = HumanTime.DayOfWeek;
-
-  convert_human_to_tm(&HumanTime, &TmTime);
-  Dum1UInt64 = convert_tm_to_unix(&TmTime);
   if (DebugBitMask & DEBUG_REMINDER)
-    uart_send(__LINE__, "Current Unix time: %llu\r", Dum1UInt64);
+    uart_send(__LINE__, "Current Unix time: %llu\r", GlobalUnixTime);
 
 
 
@@ -2732,47 +3113,18 @@ int main(void)
     uart_send(__LINE__, "=========================================================================================================\r");
 
 
-    /* Indicate if DST parameters being analyzed are for a northern or a southern country. */
-    if (DstParameters[FlashConfig.DSTCountry].StartMonth < DstParameters[FlashConfig.DSTCountry].EndMonth)  // northern countries.
-      uart_send(__LINE__, " Daylight Saving Time for a northern country\r\r");
-    else
-      uart_send(__LINE__, " Daylight Saving Time for a southern country\r\r");
- 
-
-    /* Display all DST parameters for current DST setting . */
-    uart_send(__LINE__, "     - StartDayOfMonthLow: %2u       EndDayOfMonthLow: %2u\r", DstParameters[FlashConfig.DSTCountry].StartDayOfMonthLow, DstParameters[FlashConfig.DSTCountry].EndDayOfMonthLow);
-    
-    uart_send(__LINE__, "    - StartDayOfMonthHigh: %2u      EndDayOfMonthHigh: %2u\r", DstParameters[FlashConfig.DSTCountry].StartDayOfMonthHigh, DstParameters[FlashConfig.DSTCountry].EndDayOfMonthHigh);
-    
-    uart_send(__LINE__, "         - StartDayOfWeek: %2u           EndDayOfWeek: %2u      %3.3s (%2u to %2u)    %3.3s (%2u to %2u)\r", 
-            DstParameters[FlashConfig.DSTCountry].StartDayOfWeek, DstParameters[FlashConfig.DSTCountry].EndDayOfWeek,
-            ShortDay[FlashConfig.Language][DstParameters[FlashConfig.DSTCountry].StartDayOfWeek],
-            DstParameters[FlashConfig.DSTCountry].StartDayOfMonthLow, DstParameters[FlashConfig.DSTCountry].StartDayOfMonthHigh,
-            ShortDay[FlashConfig.Language][DstParameters[FlashConfig.DSTCountry].EndDayOfWeek],
-            DstParameters[FlashConfig.DSTCountry].EndDayOfMonthLow,   DstParameters[FlashConfig.DSTCountry].EndDayOfMonthHigh );
-  
-    uart_send(__LINE__, "             - StartMonth: %2u               EndMonth: %2u          %9s         %9s\r", 
-            DstParameters[FlashConfig.DSTCountry].StartMonth, DstParameters[FlashConfig.DSTCountry].EndMonth, 
-            MonthName[ENGLISH][DstParameters[FlashConfig.DSTCountry].StartMonth], MonthName[ENGLISH][DstParameters[FlashConfig.DSTCountry].EndMonth]);
-    
-    uart_send(__LINE__, "              - StartHour: %2u                EndHour: %2u\r\r", DstParameters[FlashConfig.DSTCountry].StartHour, DstParameters[FlashConfig.DSTCountry].EndHour);
-
-    uart_send(__LINE__, "          - Shift minutes: %2u\r\r\r", DstParameters[FlashConfig.DSTCountry].ShiftMinutes);
+    /* Display DST rule for current DST setting (transitions have been displayed by set_dst_rule() when flash configuration was read). */
+    uart_send(__LINE__, " Daylight Saving Time rule: %s\r", DstRegion[FlashConfig.DSTCountry].Rule);
+    uart_send(__LINE__, " Applied to current Timezone: standard offset %ld sec   DST offset %ld sec   next transition: %lld\r\r\r", TzCache.Rule.StdOffset, TzCache.Rule.DstOffset, TzCache.Next);
   }
 
 
 
-  /* ---------------------------------------------------------------- *\
-              Find DayOfYear for DST start and end dates
-           for current country DST setting and current year.
-  \* ---------------------------------------------------------------- */
-  get_dst_days();
-
-
-  
   /* ---------------------------------------------------------------- *\
       Set DST parameters (FlagSummerTime and Timezone) according to
-       current DST country code setting and current date and time.
+         current DST rule and current date and time. Transitions
+           for this year and next one have been computed when
+                 flash configuration was read (see above).
   \* ---------------------------------------------------------------- */
   update_dst_status();
 
@@ -2791,65 +3143,14 @@ int main(void)
                                                   Handling of Reminders of type 1.
   \* ------------------------------------------------------------------------------------------------------------------------ */
 
-  /***
-  struct reminder1
-  {
-    struct human_time StartPeriod;
-    UINT64 StartPeriodEpoch;
-    struct human_time EndPeriod;
-    UINT64 EndPeriodEpoch;
-    struct human_time FirstRing;
-    UINT64 FirstRingEpoch;
-    UINT64 RingDuration;
-    UINT64 RingRepeatTime;
-    UINT64 NextReminderDelay;
-    UCHAR  Description[51];
-  };
-  ***/
-
-  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_REMINDERS1; ++Loop1UInt8)
-  {
-    if (Reminder1[Loop1UInt8].StartPeriod.Year == 0)
-    {
-      // if (DebugBitMask & DEBUG_REMINDER)
-      //   uart_send(__LINE__, "Reminder1[%2u].Year = 0: This reminder is not defined.\r", Loop1UInt8);
-
-      continue;
-    }
-
-    if (DebugBitMask & DEBUG_REMINDER)
-      uart_send(__LINE__, "Reminder1[%2u].Year != 0: This reminder is defined.... finding epoch where needed\r", Loop1UInt8);
-
-    Dum1UInt16 = Reminder1[Loop1UInt8].StartPeriod.Year;
-    if (Reminder1[Loop1UInt8].StartPeriod.Year == 9999)
-    {
-      /* Year 9999 is a placeholder to repeat the reminder for every year. */
-       Reminder1[Loop1UInt8].StartPeriod.Year == CurrentYear;
-    }
-    convert_human_to_tm(&Reminder1[Loop1UInt8].StartPeriod, &TmTime);
-    Reminder1[Loop1UInt8].StartPeriodEpoch = convert_tm_to_unix(&TmTime);
-    if (DebugBitMask & DEBUG_REMINDER)
-      uart_send(__LINE__, "Reminder1[%2u].StartPeriodEpoch found: %llu\r", Loop1UInt8, Reminder1[Loop1UInt8].StartPeriodEpoch);
-
-    /* Restore original year in case it was the 9999 placeholder and replaced temporarily. */
-    Reminder1[Loop1UInt8].StartPeriod.Year = Dum1UInt16;
+  /* Compute reminder epochs and schedule the first ring of each reminder. */
+  reminder_init();
 
+  /* Find the first alarm to ring and wake up on time for it. */
+  alarm_schedule(0);
 
-
-    Dum1UInt16 = Reminder1[Loop1UInt8].EndPeriod.Year;
-    if (Reminder1[Loop1UInt8].EndPeriod.Year == 9999)
-    {
-      /* Year 9999 is a placeholder to repeat the reminder for every year. */
-       Reminder1[Loop1UInt8].EndPeriod.Year == CurrentYear;
-    }
-    convert_human_to_tm(&Reminder1[Loop1UInt8].EndPeriod, &TmTime);
-    Reminder1[Loop1UInt8].EndPeriodEpoch = convert_tm_to_unix(&TmTime);
-    if (DebugBitMask & DEBUG_REMINDER)
-      uart_send(__LINE__, "Reminder1[%2u].EndPeriodEpoch found:   %llu\r", Loop1UInt8, Reminder1[Loop1UInt8].EndPeriodEpoch);
-
-    /* Restore original year in case it was the 9999 placeholder and replaced temporarily. */
-    Reminder1[Loop1UInt8].EndPeriod.Year = Dum1UInt16;
-  }
+  /* Find the first chime schedule entries due (hourly chime, calendar events, etc...) and wake up on time for them. */
+  chime_schedule(0);
 
   /* ------------------------------------------------------------------------------------------------------------------------ *\
                                                 End of handling of reminders of type 1
@@ -2859,25 +3160,7 @@ int main(void)
   /* ---------------------------------------------------------------- *\
                         Scroll firmware version.
   \* ---------------------------------------------------------------- */
-  switch (FlashConfig.Language)
-  {
-    case (CZECH):
-      sprintf(String, "Pico Green Clock - verze firmwaru %s    ", FIRMWARE_VERSION);
-    break;
-  
-    case (ENGLISH):
-    default:
-      sprintf(String, "Pico Green Clock - Firmware Version %s    ", FIRMWARE_VERSION);
-    break;
-
-    case (FRENCH):
-      sprintf(String, "Pico Green Clock - Microcode Version %s    ", FIRMWARE_VERSION);
-    break;
-
-    case (SPANISH):
-      sprintf(String, "Pico Green Clock - Version de Firmware %s    ", FIRMWARE_VERSION);
-    break;
-  }
+  sprintf(String, msg(MSG_FIRMWARE_VERSION), FIRMWARE_VERSION);
   scroll_string(24, String);
 
 
@@ -2887,25 +3170,7 @@ int main(void)
   \* ---------------------------------------------------------------- */
   #ifdef SOUND_DISABLED
   /* Special warning if sound has been cut-off in source code. */
-  switch (FlashConfig.Language)
-  {
-    case (CZECH):
-      scroll_string(24, "POZOR - BEZ ZVUKU!    ");
-    break;
-
-    case (FRENCH):
-      scroll_string(24, "ATTENTION - PAS DE SON    ");
-    break;
-
-    case (SPANISH):
-      scroll_string(24, "AVISO - SONIDO APAGADO    ");
-    break;
-
-    default:
-    case (ENGLISH):
-      scroll_string(24, "WARNING - SOUND CUT-OFF    ");
-    break;
-  }
+  scroll_string(24, msg(MSG_SOUND_CUT_OFF));
   #endif  // SOUND_DISABLED
 
 
@@ -2913,27 +3178,7 @@ int main(void)
            Special message if some debug options are selected.
   \* ---------------------------------------------------------------- */
   if (DebugBitMask)
-  {
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-        scroll_string(24, "DEBUG ZAPNUT!    ");
-      break;
-
-      case (FRENCH):
-        scroll_string(24, "DES DEBUG SONT ACTIFS    ");
-      break;
-
-      case (SPANISH):
-        scroll_string(24, "DEPURACION ACTIVADA    ");
-      break;
-
-      default:
-      case (ENGLISH):
-        scroll_string(24, "SOME DEBUG ON    ");
-      break;
-    }
-  }
+    scroll_string(24, msg(MSG_DEBUG_ON));
 
 
 
@@ -2946,27 +3191,7 @@ int main(void)
   Bme280Data.Bme280ReadCycles = 0l;  // reset number of read cycles on entry.
   if (bme280_init())
   {
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-        sprintf(String, "Chyba nastaveni BME280.    ");
-        String[14] = (UINT8)131; // i-acute
-        scroll_string(24, String);
-      break;
-
-      case (FRENCH):
-        scroll_string(24, "BME280 erreur d'initialisation    ");
-      break;
-
-      case (SPANISH):
-        scroll_string(24, "BME280 error de inicializacion    ");
-      break;
-
-      default:
-      case (ENGLISH):
-        scroll_string(24, "BME280 initialization error    ");
-      break;
-    }
+    scroll_string(24, msg(MSG_BME280_INIT_ERROR));
   }
   else
   {
@@ -3078,25 +3303,7 @@ int main(void)
   /* Read back answer (success or failure) from core 1. Data has been saved in a structure global to both cores. */
   if (core_unqueue(0) == CORE0_DHT_ERROR)
   {
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-         scroll_string(24, "Chyba v komunikaci s DHT22.    ");
-      break;
-
-      case (FRENCH):
-        scroll_string(24, "DHT22 erreur de communication    ");
-      break;
-
-      case (SPANISH):
-        scroll_string(24, "DHT22 error de comunicacion    ");
-      break;
-
-      default:
-      case (ENGLISH):
-        scroll_string(24, "DHT22 communication error    ");
-      break;
-    }
+    scroll_string(24, msg(MSG_DHT22_ERROR));
   }
   else
   {
@@ -3120,8 +3327,13 @@ int main(void)
     uart_send(__LINE__, "Event    Day      Month       Description\r");
     uart_send(__LINE__, "number\r");
 
-    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_EVENTS; ++Loop1UInt8)
-      uart_send(__LINE__, "  %2u      %2llu %10s (%2.2u)   [%s]\r", Loop1UInt8, CalendarEvent[Loop1UInt8].Day, MonthName[ENGLISH][CalendarEvent[Loop1UInt8].Month], CalendarEvent[Loop1UInt8].Month, CalendarEvent[Loop1UInt8].Description);
+    for (Loop1UInt8 = 0; Loop1UInt8 < EventTotal; ++Loop1UInt8)
+    {
+      if (EventBlob == NULL)
+        uart_send(__LINE__, "  %2u      %2llu %10s (%2.2u)   [%s]\r", Loop1UInt8, CalendarEvent[Loop1UInt8].Day, MONTH_NAME(ENGLISH, CalendarEvent[Loop1UInt8].Month), CalendarEvent[Loop1UInt8].Month, CalendarEvent[Loop1UInt8].Description);
+      else
+        uart_send(__LINE__, "  %2u      %2u %10s (%2.2u)   [%s]\r", Loop1UInt8, EVENT_BLOB_RECORDS[Loop1UInt8].Day, MONTH_NAME(ENGLISH, EVENT_BLOB_RECORDS[Loop1UInt8].Month), EVENT_BLOB_RECORDS[Loop1UInt8].Month, event_description(Loop1UInt8));
+    }
   }
 
 
@@ -3189,118 +3401,26 @@ int main(void)
 
 
     #ifdef PICO_W
-    /* Manage NTP resync. */
+    /* Manage NTP resync. The sync runs by itself from lwIP callbacks and posts COMMAND_NTP_UPDATE to the command queue when done (see ntp_update()). */
     CurrentTimerValue = time_us_64();
-    if ((NTPData.FlagNTPResync) || (CurrentTimerValue >= (NTPData.NTPLastUpdate + DELTA_TIME)))
+    if ((NTPData.NTPState == NTP_STATE_IDLE) && ((NTPData.FlagNTPResync) || (CurrentTimerValue >= (NTPData.NTPLastUpdate + NTPData.NTPDelta))))
     {
       if (DebugBitMask & DEBUG_NTP)
         uart_send(__LINE__, "Requesting Green Clock synchronization through NTP  (FlagNTPResync: %2.2u)\r", NTPData.FlagNTPResync);
 
-      /* Retrieve local time from NTP. */
       ntp_get_time();
+    }
+    #endif  // PICO_W
 
-      /* Wait for NTP result. */
-      for (Loop1UInt8 = 0; Loop1UInt8 < 10; ++Loop1UInt8)
-      {
-        if (NTPData.FlagNTPSuccess == FLAG_ON)
-        {
-          if (DebugBitMask & DEBUG_NTP)
-          {
-            uart_send(__LINE__, "Green Clock time before resync:\r");
-            uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r\r", DayName[FlashConfig.Language][CurrentDayOfWeek], CurrentDayOfMonth, CurrentMonth, CurrentYear, CurrentHour, CurrentMinute, CurrentSecond);
-
-
-            /* Display DS3231 current time (real-time clock IC) to visualize time drift since last NTP re-sync. */
-            Time_RTC = Read_RTC();
-
-            CurrentHour        = bcd_to_byte(Time_RTC.hour);
-            CurrentMinute      = bcd_to_byte(Time_RTC.minutes);
-            CurrentSecond      = bcd_to_byte(Time_RTC.seconds);
-            CurrentDayOfMonth  = bcd_to_byte(Time_RTC.dayofmonth);
-            CurrentMonth       = bcd_to_byte(Time_RTC.month);
-            CurrentYearLowPart = bcd_to_byte(Time_RTC.year);
-            CurrentYear        = (FlashConfig.CurrentYearCentile * 100) + CurrentYearLowPart;
-            CurrentDayOfWeek   = get_day_of_week(((FlashConfig.CurrentYearCentile * 100) + CurrentYearLowPart), CurrentMonth, CurrentDayOfMonth);
-
-            uart_send(__LINE__, "DS3231 time before resync:\r");
-            uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r\r", DayName[FlashConfig.Language][CurrentDayOfWeek], CurrentDayOfMonth, CurrentMonth, CurrentYear, CurrentHour, CurrentMinute, CurrentSecond);
-            uart_send(__LINE__, "NTP time (synchronizing clock with those values (delay: %u milliseconds).\r", 50 * Loop1UInt8);
-            uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r\r", DayName[FlashConfig.Language][NTPData.CurrentDayOfWeek], NTPData.CurrentDayOfMonth, NTPData.CurrentMonth, NTPData.CurrentYear, NTPData.CurrentHour, NTPData.CurrentMinute, NTPData.CurrentSecond);
-          }
-
-          NTPData.FlagNTPSuccess = FLAG_OFF;
-          sprintf(String, "%4.4u", CurrentYear);
-          CurrentYearLowPart = atoi(&String[2]);
-          
-          set_time(NTPData.CurrentSecond, NTPData.CurrentMinute, NTPData.CurrentHour, NTPData.CurrentDayOfWeek, NTPData.CurrentDayOfMonth, NTPData.CurrentMonth, CurrentYearLowPart);
-          show_time();  // update time display as soon as possible.
-
-          /* Read back the real-time clock IC. */
-          Time_RTC = Read_RTC();
-
-          CurrentHour        = bcd_to_byte(Time_RTC.hour);
-          CurrentMinute      = bcd_to_byte(Time_RTC.minutes);
-          CurrentSecond      = bcd_to_byte(Time_RTC.seconds);
-          CurrentDayOfMonth  = bcd_to_byte(Time_RTC.dayofmonth);
-          CurrentMonth       = bcd_to_byte(Time_RTC.month);
-          CurrentYearLowPart = bcd_to_byte(Time_RTC.year);
-          CurrentYear        = (FlashConfig.CurrentYearCentile * 100) + CurrentYearLowPart;
-          CurrentDayOfWeek   = get_day_of_week(((FlashConfig.CurrentYearCentile * 100) + CurrentYearLowPart), CurrentMonth, CurrentDayOfMonth);
-
-          if (DebugBitMask & DEBUG_NTP)
-          {
-            uart_send(__LINE__, "Real time clock, as read-back from DS3231.\r");
-            uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r", DayName[FlashConfig.Language][CurrentDayOfWeek], CurrentDayOfMonth, CurrentMonth, CurrentYear, CurrentHour, CurrentMinute, CurrentSecond);
-            uart_send(__LINE__, "NTPData.NTPGetTime: 0x%10.10llX\r", NTPData.NTPGetTime);
-            if (NTPData.NTPGetTime)
-              uart_send(__LINE__, "Time elapsed since last poll: %10lld usec.   %10lld usec.\r\r", (time_us_64() - NTPData.NTPLastUpdate), (time_us_64() - NTPData.NTPGetTime));
-          }
 
-          NTPData.FlagNTPResync = FLAG_OFF;
-          NTPData.NTPGetTime    = time_us_64();
-          NTPData.NTPLastUpdate = time_us_64();
 
-          break;  // get out of "for" loop.
-        }
-
-
-        if (NTPData.FlagNTPSuccess == FLAG_POLL)
-        {
-          if (DebugBitMask & DEBUG_NTP)
-            uart_send(__LINE__, "NTP poll succeeded\r\r");
-
-          NTPData.FlagNTPSuccess = FLAG_OFF;
-          NTPData.NTPLastUpdate  = time_us_64();
-
-          break;  // get out of "for" loop.
-        }
-
-        sleep_ms(50);
-      }
-
-
-      /* If current NTP update request failed, add one minute to update delay and retry. */
-      if (Loop1UInt8 >= 10)
-      {
-        NTPData.FlagNTPResync = FLAG_OFF;  // NTP resync error... postpone re-sync.
-        ++NTPData.NTPErrors;
-        if (DebugBitMask & DEBUG_NTP)
-          uart_send(__LINE__, "Failed to synchronize clock with NTP.\r\r");
-        
-        NTPData.NTPLastUpdate += 60000000;   // simulate that last update occured later than reality to postpone next retry.
-      }
-    }
-    #endif  // PICO_W
-
-
-
-    /* If user pressed the "Set" (top) button (detected in the callback msec function), proceed with clock setup. */
-    if (FlagSetClock == FLAG_ON)
-    {
-      FlagIdleCheck = FLAG_ON;  // keep track of inactive (idle) time to eventually declare a time-out.
-      setup_clock_frame();      // display clock template and current values.
-      FlagSetClock = FLAG_OFF;  // reset clock setup mode flag after this pass.
-    }
+    /* If user pressed the "Set" (top) button (detected in the callback msec function), proceed with clock setup. */
+    if (FlagSetClock == FLAG_ON)
+    {
+      FlagIdleCheck = FLAG_ON;  // keep track of inactive (idle) time to eventually declare a time-out.
+      setup_clock_frame();      // display clock template and current values.
+      FlagSetClock = FLAG_OFF;  // reset clock setup mode flag after this pass.
+    }
 
 
     /* If we just entered the "Alarm" setup mode (detected in the call-back function), proceed with alarm setup. */
@@ -3359,7 +3479,7 @@ int main(void)
         /***/
         // Optionally display timing for every logic level change of last received infrared burst.
         for (Loop1UInt16 = 0; Loop1UInt16 < IrStepCount; ++Loop1UInt16)
-          uart_send(__LINE__, "IR event number: %3u    IrLevel: %c   IrInitialValue: %10llu    IrFinalValue: %10llu    IrResultValue: %5lu\r", Loop1UInt16, IrLevel[Loop1UInt16], IrInitialValue[Loop1UInt16], IrFinalValue[Loop1UInt16], IrResultValue[Loop1UInt16], IrFinalValue[Loop1UInt16] - IrInitialValue[Loop1UInt16]);
+          uart_send(__LINE__, "IR event number: %3u    IrLevel: %c   IrPulse: %5u\r", Loop1UInt16, IR_LEVEL(Loop1UInt16), IrPulse[Loop1UInt16]);
 
         uart_send(__LINE__, "Total number of logic level changes (IrStepCount): %u (0 to %u)\r", IrStepCount, (IrStepCount - 1));
          printf("\r\r");
@@ -3377,21 +3497,21 @@ int main(void)
 
           /* Display two <Get ready> levels from IR burst. */
           if (Loop1UInt16 < 2)
-            uart_send(__LINE__, " [%2u]    --     %c     %5lu      %c     %5lu           <get ready>\r", Loop1UInt16, IrLevel[Loop1UInt16], IrResultValue[Loop1UInt16], IrLevel[Loop1UInt16 + 1], IrResultValue[Loop1UInt16 + 1]);
+            uart_send(__LINE__, " [%2u]    --     %c     %5u      %c     %5u           <get ready>\r", Loop1UInt16, IR_LEVEL(Loop1UInt16), IrPulse[Loop1UInt16], IR_LEVEL(Loop1UInt16 + 1), IrPulse[Loop1UInt16 + 1]);
           
           
           /* Display 32 data bits. */
           if ((BitNumber > 0) && (BitNumber <= 32))
           {
             DataBuffer <<= 1;
-            if (IrResultValue[Loop1UInt16 + 1] > 1400) ++DataBuffer;
-            uart_send(__LINE__, " [%2u]   %3u     %c     %5lu      %c     %5lu      Data: 0x%8.8X\r", Loop1UInt16, BitNumber, IrLevel[Loop1UInt16], IrResultValue[Loop1UInt16], IrLevel[Loop1UInt16 + 1], IrResultValue[Loop1UInt16 + 1], DataBuffer);
+            if (IrPulse[Loop1UInt16 + 1] > 1400) ++DataBuffer;
+            uart_send(__LINE__, " [%2u]   %3u     %c     %5u      %c     %5u      Data: 0x%8.8X\r", Loop1UInt16, BitNumber, IR_LEVEL(Loop1UInt16), IrPulse[Loop1UInt16], IR_LEVEL(Loop1UInt16 + 1), IrPulse[Loop1UInt16 + 1], DataBuffer);
           }
 
 
           /* Display extra bits. */
           if (BitNumber > 32)
-            uart_send(__LINE__, " [%2u]    --     %c     %5lu      %c     %5lu\r", Loop1UInt16, IrLevel[Loop1UInt16], IrResultValue[Loop1UInt16], IrLevel[Loop1UInt16 + 1], IrResultValue[Loop1UInt16 + 1]);
+            uart_send(__LINE__, " [%2u]    --     %c     %5u      %c     %5u\r", Loop1UInt16, IR_LEVEL(Loop1UInt16), IrPulse[Loop1UInt16], IR_LEVEL(Loop1UInt16 + 1), IrPulse[Loop1UInt16 + 1]);
         }
         printf("\r\r");
       }
@@ -3454,31 +3574,35 @@ int main(void)
     /* Re-evaluate System Idle Monitor every minute, at xxm35s. */
     if ((CurrentSecond == 35) && (FlagIdleMonitor == FLAG_OFF))
     {
-      if (DebugBitMask & DEBUG_IDLE_MONITOR)
-      {
-        for (Loop1UInt8 = 0; Loop1UInt8 < 14; ++Loop1UInt8)
-        {
-          ArchiveIdleMonitor[Loop1UInt8][IdleArchivePacket] = IdleMonitor[Loop1UInt8];
-        }
-        ++IdleArchivePacket;
-      }
-
-      /* Calculate average System Idle Monitor for last 60-seconds period. */
+      /* Calculate average System Idle Monitor for last 60-seconds period, along with the lowest and highest 5-seconds periods. */
       IdleMonitor[13] = 0;
+      IdleHistory[IdleHistoryHead].Minimum = 0xFFFFFFFF;
+      IdleHistory[IdleHistoryHead].Maximum = 0;
       for (Loop1UInt8 = 0; Loop1UInt8 < 12; ++Loop1UInt8)
       {
         IdleMonitor[13] += IdleMonitor[Loop1UInt8];
+
+        if ((IdleMonitor[Loop1UInt8] / 5) < IdleHistory[IdleHistoryHead].Minimum) IdleHistory[IdleHistoryHead].Minimum = IdleMonitor[Loop1UInt8] / 5;
+        if ((IdleMonitor[Loop1UInt8] / 5) > IdleHistory[IdleHistoryHead].Maximum) IdleHistory[IdleHistoryHead].Maximum = IdleMonitor[Loop1UInt8] / 5;
       }
 
       IdleMonitor[13] = IdleMonitor[13] / 60;
 
+      /* Archive this minute in system idle monitor history. */
+      IdleHistory[IdleHistoryHead].Average = IdleMonitor[13];
+      if (++IdleHistoryHead >= MAX_IDLE_HISTORY) IdleHistoryHead = 0;
+      if (IdleHistoryCount < MAX_IDLE_HISTORY) ++IdleHistoryCount;
+
       if (DebugBitMask & DEBUG_IDLE_MONITOR)
       {
         for (Loop1UInt8 = 0; Loop1UInt8 < 12; ++Loop1UInt8)
-          uart_send(__LINE__, "IdleMonitor[%2.2u] = %8llu  (%2.2u to %2.2u))\r", Loop1UInt8, IdleMonitor[Loop1UInt8], (Loop1UInt8 * 5), ((Loop1UInt8 * 5) + 5));
+          uart_send(__LINE__, "IdleMonitor[%2.2u] = %8lu  (%2.2u to %2.2u))\r", Loop1UInt8, IdleMonitor[Loop1UInt8], (Loop1UInt8 * 5), ((Loop1UInt8 * 5) + 5));
 
-        uart_send(__LINE__, "Current period: IdleMonitor[12] = %llu\r", IdleMonitor[12]);
-        uart_send(__LINE__, "Resulting system idle monitor   = %llu\r\r\r", IdleMonitor[13]);
+        uart_send(__LINE__, "Current period: IdleMonitor[12] = %lu\r", IdleMonitor[12]);
+        uart_send(__LINE__, "Resulting system idle monitor   = %lu\r\r\r", IdleMonitor[13]);
+
+        /* Display whole history every two hours. */
+        if (IdleHistoryHead == 0) idle_history_display();
       }
 
       FlagIdleMonitor = FLAG_ON; // only one calculation per 5-seconds period.
@@ -3488,22 +3612,17 @@ int main(void)
     if ((CurrentSecond == 36) && (FlagIdleMonitor == FLAG_ON))
       FlagIdleMonitor = FLAG_OFF;
 
-    if (DebugBitMask & DEBUG_IDLE_MONITOR)
-    {
-      if (IdleArchivePacket >= IdleTimeSamples)
-      {
-        for (IdleArchivePacket = 0; IdleArchivePacket < IdleTimeSamples; ++IdleArchivePacket)
-        {
-          for (Loop1UInt8 = 0; Loop1UInt8 < 12; ++Loop1UInt8)
-            uart_send(__LINE__, "ArchiveIdleMonitor[%2.2u][%3.3u] = %8llu)\r", Loop1UInt8, IdleArchivePacket, ArchiveIdleMonitor[Loop1UInt8][IdleArchivePacket]);
 
-          uart_send(__LINE__, "\r");
-          uart_send(__LINE__, "ArchiveIdleMonitor[12][%3.3u] = %8llu (current period)\r\r", IdleArchivePacket, ArchiveIdleMonitor[12][IdleArchivePacket]);
-          uart_send(__LINE__, "System idle monitor   [%3.3u] = %8llu\r\r\r", IdleArchivePacket, ArchiveIdleMonitor[13][IdleArchivePacket]);
-        }
-        IdleArchivePacket = 0;
-      }
+
+    /* Check stack high-water marks every minute, at xxm40s. */
+    if ((CurrentSecond == 40) && (FlagStackCheck == FLAG_OFF))
+    {
+      stack_check();
+      FlagStackCheck = FLAG_ON;
     }
+
+    if ((CurrentSecond == 41) && (FlagStackCheck == FLAG_ON))
+      FlagStackCheck = FLAG_OFF;
   }
 }
 
@@ -3749,6 +3868,208 @@ void adjust_clock_brightness(void)
 
 
 
+/* $PAGE */
+/* $TITLE=alarm_callback() */
+/* ------------------------------------------------------------------ *\
+         Pico alarm callback for the next alarm. UserData points
+          to the mask of alarms to ring, or is NULL when a long
+           wait has been split in shorter ones (ALARM_MAX_WAIT).
+\* ------------------------------------------------------------------ */
+int64_t alarm_callback(alarm_id_t AlarmId, void *UserData)
+{
+  UCHAR String[16];
+
+  UINT8 Loop1UInt8;
+
+
+  AlarmTimerId = 0;
+
+  if (UserData == NULL)
+  {
+    command_queue(COMMAND_ALARM_SCHEDULE, 0);
+    return 0;  // one-shot alarm.
+  }
+
+  /* Set the bits of the alarms reached in the alarm bit mask. They will ring from timer_callback_s(). */
+  AlarmReachedBitMask |= AlarmNextMask;
+
+  if (DebugBitMask & DEBUG_ALARMS)
+    uart_send(__LINE__, "-Alarms reached at %llu   BitMask: 0x%16.16llX\r\r", AlarmNextEpoch, AlarmReachedBitMask);
+
+  /* Scroll the string associated with each alarm reached. */
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
+  {
+    if ((AlarmNextMask & (1ULL << Loop1UInt8)) == 0) continue;
+
+    if (AlarmText[Loop1UInt8] != NULL)
+    {
+      if (AlarmText[Loop1UInt8][0] != 0x00)
+        scroll_string(24, AlarmText[Loop1UInt8]);
+    }
+    else
+    {
+      sprintf(String, "Alarm %u", Loop1UInt8 + 1);
+      scroll_string(24, String);
+    }
+  }
+
+  /* Wait for the alarm(s) following the ones that just rang. */
+  alarm_schedule(AlarmNextEpoch);
+
+  return 0;  // one-shot alarm.
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=alarm_pack() */
+/* ------------------------------------------------------------------ *\
+          Pack alarm parameters into flash configuration.
+\* ------------------------------------------------------------------ */
+void alarm_pack(void)
+{
+  UINT8 Loop1UInt8;
+
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
+    FlashConfig.AlarmPacked[Loop1UInt8] = ALARM_PACK(Alarm[Loop1UInt8].FlagStatus, Alarm[Loop1UInt8].Day, Alarm[Loop1UInt8].Hour, Alarm[Loop1UInt8].Minute, Alarm[Loop1UInt8].Second);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=alarm_schedule() */
+/* ------------------------------------------------------------------ *\
+     Find the alarm(s) that will ring next, strictly after the local
+      time given (or after current local time if it is later), and
+     program a Pico alarm for the exact second tick when it is due.
+      Must be called again when alarms, time or timezone change.
+\* ------------------------------------------------------------------ */
+void alarm_schedule(UINT64 After)
+{
+  UINT8  DayOfWeek;
+  UINT8  Loop1UInt8;
+  UINT8  Loop2UInt8;
+
+  UINT32 AlarmSecond;
+  UINT32 Days;
+  UINT32 SecondOfDay;
+
+  UINT64 Elapsed;
+  UINT64 Epoch;
+  UINT64 LocalTime;
+  UINT64 NextEpoch;
+  UINT64 NextMask;
+  UINT64 Now;
+  UINT64 Wait;
+
+
+  if (AlarmTimerId > 0)
+  {
+    cancel_alarm(AlarmTimerId);
+    AlarmTimerId = 0;
+  }
+
+  /* Time elapsed since the beginning of current second is given by the time base. */
+  Now       = time_base_us();
+  LocalTime = (Now / 1000000ULL) + get_utc_offset();
+  Elapsed   = Now % 1000000ULL;
+
+  if (After < LocalTime) After = LocalTime;
+  Days        = After / CIVIL_SECONDS_PER_DAY;
+  SecondOfDay = After % CIVIL_SECONDS_PER_DAY;
+
+  /* Check the rest of today, then the next 7 days (an alarm set for today's day-of-week at an earlier time rings in 7 days). */
+  NextEpoch = 0;
+  NextMask  = 0;
+  for (Loop1UInt8 = 0; (Loop1UInt8 < 8) && (NextMask == 0); ++Loop1UInt8)
+  {
+    DayOfWeek = civil_weekday(Days + Loop1UInt8) + 1;  // 1 = SUN to 7 = SAT, as in the alarm day mask.
+
+    for (Loop2UInt8 = 0; Loop2UInt8 < MAX_ALARMS; ++Loop2UInt8)
+    {
+      if ((Alarm[Loop2UInt8].FlagStatus != FLAG_ON) || ((Alarm[Loop2UInt8].Day & (1 << DayOfWeek)) == 0)) continue;
+
+      AlarmSecond = (Alarm[Loop2UInt8].Hour * 3600) + (Alarm[Loop2UInt8].Minute * 60) + Alarm[Loop2UInt8].Second;
+      if ((Loop1UInt8 == 0) && (AlarmSecond <= SecondOfDay)) continue;
+
+      Epoch = ((UINT64)(Days + Loop1UInt8) * CIVIL_SECONDS_PER_DAY) + AlarmSecond;
+      if ((NextMask == 0) || (Epoch < NextEpoch))
+      {
+        NextEpoch = Epoch;
+        NextMask  = 0;
+      }
+      if (Epoch == NextEpoch) NextMask |= (1ULL << Loop2UInt8);
+    }
+  }
+
+  AlarmNextEpoch = NextEpoch;
+  AlarmNextMask  = NextMask;
+
+  if (NextMask == 0)
+  {
+    if (DebugBitMask & DEBUG_ALARMS)
+      uart_send(__LINE__, "No alarm to ring.\r");
+
+    return;
+  }
+
+  /* Long waits are split in shorter ones, so that a drift of the Pico timer against clock time never delays an alarm by much. */
+  Wait = NextEpoch - LocalTime;
+  if (Wait > ALARM_MAX_WAIT)
+    AlarmTimerId = add_alarm_in_us(time_base_timer_us((ALARM_MAX_WAIT * 1000000ULL) - Elapsed), alarm_callback, NULL, true);
+  else
+    AlarmTimerId = add_alarm_in_us(time_base_timer_us((Wait * 1000000ULL) - Elapsed), alarm_callback, &AlarmNextMask, true);
+
+  if (DebugBitMask & DEBUG_ALARMS)
+    uart_send(__LINE__, "Next alarm at %llu (in %llu sec)   Mask: 0x%16.16llX\r", NextEpoch, Wait, NextMask);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=alarm_unpack() */
+/* ------------------------------------------------------------------ *\
+        Unpack alarm parameters from flash configuration. Alarms
+        undefined or out-of-range in flash are set Off (0:00:29).
+\* ------------------------------------------------------------------ */
+void alarm_unpack(void)
+{
+  UINT8 Loop1UInt8;
+
+  UINT32 Packed;
+
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
+  {
+    Packed = FlashConfig.AlarmPacked[Loop1UInt8];
+    if (ALARM_UNDEFINED(Packed) || (ALARM_HOUR(Packed) > 23) || (ALARM_MINUTE(Packed) > 59) || (ALARM_SECOND(Packed) > 59))
+      Packed = ALARM_PACK(FLAG_OFF, 0, 0, 0, 29);
+
+    Alarm[Loop1UInt8].FlagStatus = ALARM_STATUS(Packed);
+    Alarm[Loop1UInt8].Day        = ALARM_DAY(Packed);
+    Alarm[Loop1UInt8].Hour       = ALARM_HOUR(Packed);
+    Alarm[Loop1UInt8].Minute     = ALARM_MINUTE(Packed);
+    Alarm[Loop1UInt8].Second     = ALARM_SECOND(Packed);
+  }
+
+  return;
+}
+
+
+
+
+
 #ifdef BME280_SUPPORT
 /* $PAGE */
 /* $TITLE=bme280_compute_calib_param() */
@@ -4396,23 +4717,43 @@ UINT32 bme280_read_unique_id()
 
 
 /* $PAGE */
-/* $TITLE=clear_all_leds() */
+/* $TITLE=chime_allowed() */
 /* ------------------------------------------------------------------ *\
-                  Clear all the leds on clock display.
-          This is useful before reading DHT22 and / or before
-      programming Pico's flash memory, since we disable interrupts
-             when doing so and this would make glitches 
-                      on clock display otherwise.
+        Return FLAG_ON if chime settings allow to sound a chime or
+          calendar event tones at the given hour (and if user has
+                   not requested a silence period).
 \* ------------------------------------------------------------------ */
-void clear_all_leds(void)
+UINT8 chime_allowed(UINT8 Hour)
 {
-  UINT8 Loop1UInt8;
+  /* Hourly chime will never sound if set to Off and will always sound if set to On (except if user requested a silence period - see remote control).
+     However, if Hourly chime is set to Day "OI" ("On, Intermittent" in clock setup), here is what happens:
+
+     "Daytime workers":
+     Hourly chime "normal behavior": When "Chime time On" is smaller than "Chime time Off".
+     For example: "Chime time On" = 9h00 and "Chime time Off" is 21h00. Chime will sound between (and including) 9h00 and 21h00 as we would expect (and will be silent otherwise).
 
+     "Nighttime workers":
+     Hourly chime "special behavior": When "Chime time On" is greater than "Chime time Off".
+     For example: "Chime time On" = 21h00 and "Chime time Off" is 9h00. Chime will sound from 21h00 and up to 9h00 (and will be silent otherwise).
+     (That is, will not sound between 9h00 and 21h00). */
+  if (SilencePeriod != 0)
+    return FLAG_OFF;
 
-  for (Loop1UInt8 = 0; Loop1UInt8 < 24; ++Loop1UInt8)
-    DisplayBuffer[Loop1UInt8] = 0x00;
- 
-  return;
+  if (FlashConfig.ChimeMode == CHIME_ON)
+    return FLAG_ON;
+
+  if (FlashConfig.ChimeMode == CHIME_DAY)
+  {
+    /* "Normal behavior" for daytime workers. */
+    if ((FlashConfig.ChimeTimeOn < FlashConfig.ChimeTimeOff) && (Hour >= FlashConfig.ChimeTimeOn) && (Hour <= FlashConfig.ChimeTimeOff))
+      return FLAG_ON;
+
+    /* "Special behavior" for nighttime workers. */
+    if ((FlashConfig.ChimeTimeOff < FlashConfig.ChimeTimeOn) && ((Hour >= FlashConfig.ChimeTimeOn) || (Hour <= FlashConfig.ChimeTimeOff)))
+      return FLAG_ON;
+  }
+
+  return FLAG_OFF;
 }
 
 
@@ -4420,61 +4761,98 @@ void clear_all_leds(void)
 
 
 /* $PAGE */
-/* $TITLE=clear_framebuffer() */
+/* $TITLE=chime_callback() */
 /* ------------------------------------------------------------------ *\
-                 Clear the clock virtual framebuffer
-                starting at the given column position.
-           If the start column is inside the "real" display,
-               then the closk display will be cleared.
-            NOTE: Top and left indicators are not cleared.
+        Pico alarm callback for the next chime schedule entries.
+          UserData points to the mask of entries due, or is NULL
+         when a long wait has been split in shorter ones (CHIME_MAX_WAIT).
 \* ------------------------------------------------------------------ */
-void clear_framebuffer(UINT8 StartColumn)
+int64_t chime_callback(alarm_id_t AlarmId, void *UserData)
 {
-  do
+  UINT8 EventList[MAX_EVENTS];
+  UINT8 EventNumber;
+  UINT8 Hour;
+  UINT8 Loop1UInt8;
+
+  UINT16 EventCount;
+  UINT16 Loop1UInt16;
+  static UINT16 PreviousYear;
+
+
+  ChimeTimerId = 0;
+
+  if (UserData == NULL)
   {
-    fill_display_buffer_4X7(StartColumn, ' ');
-    StartColumn += 8;
-  } while (StartColumn < sizeof(DisplayBuffer));
+    command_queue(COMMAND_CHIME_SCHEDULE, 0);
+    return 0;  // one-shot alarm.
+  }
 
-  return;
-}
+  /* We wake up on the exact second, possibly before timer_callback_s() for the same second: derive time fields now. */
+  time_civil_update();
+  Hour = (ChimeNextEpoch % CIVIL_SECONDS_PER_DAY) / 3600;
 
+  if (DebugBitMask & DEBUG_CHIME)
+    uart_send(__LINE__, "Chime schedule entries due at %llu   Mask: 0x%4.4X   Hour: %2u\r", ChimeNextEpoch, ChimeNextMask, Hour);
 
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_CHIME_SCHEDULE; ++Loop1UInt8)
+  {
+    if ((ChimeNextMask & (1 << Loop1UInt8)) == 0) continue;
 
+    switch (ChimeSchedule[Loop1UInt8].Action)
+    {
+      case (CHIME_ACTION_SOUND):
+        /* Chimes are not sounded while user is setting minutes. */
+        if ((FlagSetupClock[SETUP_MINUTE] == FLAG_OFF) && (chime_allowed(Hour) == FLAG_ON))
+          chime_sound(ChimeSchedule[Loop1UInt8].Sound, Hour);
+      break;
 
+      case (CHIME_ACTION_EVENTS):
+        /* Only events of today are looked at, through the calendar events index and the next occurrence of recurrence rules. */
+        EventCount = event_list(CurrentYear, CurrentMonth, CurrentDayOfMonth, EventList);
+        for (Loop1UInt16 = 0; Loop1UInt16 < EventCount; ++Loop1UInt16)
+        {
+          EventNumber = EventList[Loop1UInt16];
 
-/* $PAGE */
-/* $TITLE=command_queue() */
-/* ------------------------------------------------------------------ *\
-        Queue a command to be processed while in main context.
-              This allows triggering an "heavy" process
-                while in interrupt (callback) context.
-\* ------------------------------------------------------------------ */
-UINT8 command_queue(UINT8 Command, UINT16 Parameter)
-{
-  UCHAR String[256];
+          /* Scroll text corresponding to this event on clock display. */
+          scroll_queue(EventNumber);  // when Tag number is lower than MAX_EVENTS, it means to scroll the Calendar Event Text.
 
+          /* Sound "event tones" in compliance with clock Chime settings. */
+          if (chime_allowed(Hour) == FLAG_ON)
+          {
+            chime_sound(ChimeSchedule[Loop1UInt8].Sound, Hour);
 
-  /* Check if the command circular buffer is full. */
-  if (((CommandQueueTail > 0) && (CommandQueueHead == CommandQueueTail - 1)) || ((CommandQueueTail == 0) && (CommandQueueHead == MAX_COMMAND_QUEUE - 1)))
-  {
-    /* Command queue is full, return error code. */
-    return MAX_COMMAND_QUEUE;
-  }
+            #ifdef PASSIVE_PIEZO_SUPPORT
+            /* Calendar Event sounds with passive buzzer if one has been installed by user, and if a jingle is defined with this Calendar Event. */
+            if (event_jingle(EventNumber) != 0)
+            {
+              sound_queue_passive(SILENT, WAIT_4_ACTIVE);  // jingle should begin only after active buzzer has completed.
+              play_jingle(event_jingle(EventNumber));
+            }
+            #endif  // PASSIVE_PIEZO_SUPPORT
+          }
+        }
+      break;
 
-  /* If there is at least one slot available in the queue, insert the command to be processed. */
-  CommandQueue[CommandQueueHead].Command   = Command;
-  CommandQueue[CommandQueueHead].Parameter = Parameter;
-  ++CommandQueueHead;
+      case (CHIME_ACTION_YEAR):
+        if (CurrentYear != PreviousYear)
+        {
+          /* We just changed year, compute Daylight Saving Time transitions for this year and next one. */
+          tz_prepare(&TzCache, CurrentYear);
+          update_dst_status();
 
-  if (DebugBitMask & DEBUG_COMMAND_QUEUE)
-    uart_send(__LINE__, "- Command queueing: %3u   %3u\r", Command, Parameter);
+          /* Reminders with the 9999 year placeholder now apply to the new year. */
+          command_queue(COMMAND_REMINDER_RESET, 0);
 
-  /* Revert to zero when reaching out-of-bound. */
-  if (CommandQueueHead >= MAX_COMMAND_QUEUE)
-    CommandQueueHead = 0;
+          PreviousYear = CurrentYear;
+        }
+      break;
+    }
+  }
 
-  return 0;
+  /* Wait for the entries following the ones that were just performed. */
+  chime_schedule(ChimeNextEpoch);
+
+  return 0;  // one-shot alarm.
 }
 
 
@@ -4482,27 +4860,284 @@ UINT8 command_queue(UINT8 Command, UINT16 Parameter)
 
 
 /* $PAGE */
-/* $TITLE=command_unqueue() */
+/* $TITLE=chime_schedule() */
 /* ------------------------------------------------------------------ *\
-             Unqueue next command from the command queue.
+      Find the chime schedule entries due next, strictly after the
+       local time given (or after current local time if it is later),
+      and program a Pico alarm for the exact second when they are due.
+        Must be called again when time or timezone change.
 \* ------------------------------------------------------------------ */
-UINT8 command_unqueue(UINT8 *Command, UINT16 *Parameter)
+void chime_schedule(UINT64 After)
 {
-  UCHAR String[256];
+  UINT8  DayOfWeek;
+  UINT8  Hour;
+  UINT8  Loop1UInt8;
 
+  UINT16 Loop1UInt16;
+  UINT16 NextMask;
 
-  /* Check if the command queue is empty. */
-  if (CommandQueueHead == CommandQueueTail)
-  {
-    /* In case of empty queue or queue error, return queue head and queue tail instead. */
-    *Command   = CommandQueueHead;
-    *Parameter = CommandQueueTail;
+  UINT32 Hours;
 
-    return 0xFF;
-  }
+  UINT64 Elapsed;
+  UINT64 Epoch;
+  UINT64 LocalTime;
+  UINT64 NextEpoch;
+  UINT64 Now;
+  UINT64 Wait;
 
-  /* Extract data for next command to process. */
-  *Command   = CommandQueue[CommandQueueTail].Command;
+  const struct chime_entry *Entry;
+
+
+  if (ChimeTimerId > 0)
+  {
+    cancel_alarm(ChimeTimerId);
+    ChimeTimerId = 0;
+  }
+
+  /* Time elapsed since the beginning of current second is given by the time base. */
+  Now       = time_base_us();
+  LocalTime = (Now / 1000000ULL) + get_utc_offset();
+  Elapsed   = Now % 1000000ULL;
+
+  if (After < LocalTime) After = LocalTime;
+
+  /* Check the hours one after the other, beginning with the current one, until one of them has entries due (at most 8 days ahead,
+     since an entry applies to at least one hour of one day of the week). */
+  NextEpoch = 0;
+  NextMask  = 0;
+  for (Loop1UInt16 = 0; (Loop1UInt16 < (8 * 24)) && (NextMask == 0); ++Loop1UInt16)
+  {
+    Hours     = (After / 3600) + Loop1UInt16;
+    Hour      = Hours % 24;
+    DayOfWeek = civil_weekday(Hours / 24) + 1;  // 1 = SUN to 7 = SAT, as in the chime schedule day mask.
+
+    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_CHIME_SCHEDULE; ++Loop1UInt8)
+    {
+      Entry = &ChimeSchedule[Loop1UInt8];
+
+      if ((Entry->Day & (1 << DayOfWeek)) == 0) continue;
+      if ((Entry->HourFirst <= Entry->HourLast) && ((Hour < Entry->HourFirst) || (Hour > Entry->HourLast))) continue;
+      if ((Entry->HourFirst >  Entry->HourLast) && ((Hour < Entry->HourFirst) && (Hour > Entry->HourLast))) continue;
+
+      Epoch = ((UINT64)Hours * 3600) + (Entry->Minute * 60) + Entry->Second;
+      if (Epoch <= After) continue;
+
+      if ((NextMask == 0) || (Epoch < NextEpoch))
+      {
+        NextEpoch = Epoch;
+        NextMask  = 0;
+      }
+      if (Epoch == NextEpoch) NextMask |= (1 << Loop1UInt8);
+    }
+  }
+
+  ChimeNextEpoch = NextEpoch;
+  ChimeNextMask  = NextMask;
+
+  if (NextMask == 0)
+  {
+    if (DebugBitMask & DEBUG_CHIME)
+      uart_send(__LINE__, "No chime schedule entry due.\r");
+
+    return;
+  }
+
+  /* Long waits are split in shorter ones, so that a drift of the Pico timer against clock time never delays a chime by much. */
+  Wait = NextEpoch - LocalTime;
+  if (Wait > CHIME_MAX_WAIT)
+    ChimeTimerId = add_alarm_in_us(time_base_timer_us((CHIME_MAX_WAIT * 1000000ULL) - Elapsed), chime_callback, NULL, true);
+  else
+    ChimeTimerId = add_alarm_in_us(time_base_timer_us((Wait * 1000000ULL) - Elapsed), chime_callback, &ChimeNextMask, true);
+
+  if (DebugBitMask & DEBUG_CHIME)
+    uart_send(__LINE__, "Next chime schedule entries at %llu (in %llu sec)   Mask: 0x%4.4X\r", NextEpoch, Wait, NextMask);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=chime_sound() */
+/* ------------------------------------------------------------------ *\
+           Queue the sound of a chime schedule entry (CHIME_SOUND_xxx).
+         Hour is used when hourly chime beeps the hour (CHIME_HOUR_COUNT).
+\* ------------------------------------------------------------------ */
+void chime_sound(UINT8 Sound, UINT8 Hour)
+{
+  UINT8 Dum1UInt8;
+  UINT8 Loop1UInt8;
+
+
+  switch (Sound)
+  {
+    case (CHIME_SOUND_HOUR):
+      if (DebugBitMask & DEBUG_CHIME)
+        uart_send(__LINE__, "Queueing hourly chime...\r");
+
+      /* If user select option where hourly chime to be equivalent to hour value. */
+      if (CHIME_HOUR_COUNT)
+      {
+        /* Number of "beeps" correspond to hour value in 12-hour format. */
+        Dum1UInt8 = Hour;
+        if (Hour > 12) Dum1UInt8 -= 12;
+        for (Loop1UInt8 = 0; Loop1UInt8 < Dum1UInt8; ++Loop1UInt8)
+        {
+          sound_queue_active(CHIME_HOUR_COUNT_BEEP_DURATION, 1);
+          sound_queue_active(CHIME_HOUR_COUNT_BEEP_DURATION, SILENT);
+        }
+      }
+      else
+      {
+        /* If CHIME_HOUR_COUNT is Off, use normal hourly chime. */
+        for (Loop1UInt8 = 0; Loop1UInt8 < TONE_CHIME_REPEAT2; ++Loop1UInt8)  // second repeat level.
+        {
+          sound_queue_active(TONE_CHIME_DURATION, TONE_CHIME_REPEAT1);       // first repeat level.
+          sound_queue_active(50, SILENT);
+        }
+        sound_queue_active(100, SILENT);
+      }
+
+      #ifdef PASSIVE_PIEZO_SUPPORT
+      /* Let the time to complete the active buzzer hourly chime. */
+      sound_queue_passive(SILENT, WAIT_4_ACTIVE);
+
+      /* Close encounter of the third kind. */
+      play_jingle(JINGLE_ENCOUNTER);
+      #endif  // PASSIVE_PIEZO_SUPPORT
+    break;
+
+    case (CHIME_SOUND_HALF_HOUR):
+      sound_queue_active(50, 2);
+    break;
+
+    case (CHIME_SOUND_EVENT):
+      /* Calendar Event sounds with active buzzer. */
+      for (Loop1UInt8 = 0; Loop1UInt8 < TONE_EVENT_REPEAT2; ++Loop1UInt8)
+      {
+        sound_queue_active(TONE_EVENT_DURATION, TONE_EVENT_REPEAT1);
+        sound_queue_active(100, SILENT);
+      }
+    break;
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=clear_all_leds() */
+/* ------------------------------------------------------------------ *\
+                  Clear all the leds on clock display.
+          This is useful before reading DHT22 and / or before
+      programming Pico's flash memory, since we disable interrupts
+             when doing so and this would make glitches 
+                      on clock display otherwise.
+\* ------------------------------------------------------------------ */
+void clear_all_leds(void)
+{
+  UINT8 Loop1UInt8;
+
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < 24; ++Loop1UInt8)
+    DisplayBuffer[Loop1UInt8] = 0x00;
+ 
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=clear_framebuffer() */
+/* ------------------------------------------------------------------ *\
+                 Clear the clock virtual framebuffer
+                starting at the given column position.
+           If the start column is inside the "real" display,
+               then the closk display will be cleared.
+            NOTE: Top and left indicators are not cleared.
+\* ------------------------------------------------------------------ */
+void clear_framebuffer(UINT8 StartColumn)
+{
+  do
+  {
+    fill_display_buffer_4X7(StartColumn, ' ');
+    StartColumn += 8;
+  } while (StartColumn < sizeof(DisplayBuffer));
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=command_queue() */
+/* ------------------------------------------------------------------ *\
+        Queue a command to be processed while in main context.
+              This allows triggering an "heavy" process
+                while in interrupt (callback) context.
+\* ------------------------------------------------------------------ */
+UINT8 command_queue(UINT8 Command, UINT16 Parameter)
+{
+  UCHAR String[256];
+
+
+  /* Check if the command circular buffer is full. */
+  if (((CommandQueueTail > 0) && (CommandQueueHead == CommandQueueTail - 1)) || ((CommandQueueTail == 0) && (CommandQueueHead == MAX_COMMAND_QUEUE - 1)))
+  {
+    /* Command queue is full, return error code. */
+    return MAX_COMMAND_QUEUE;
+  }
+
+  /* If there is at least one slot available in the queue, insert the command to be processed. */
+  CommandQueue[CommandQueueHead].Command   = Command;
+  CommandQueue[CommandQueueHead].Parameter = Parameter;
+  ++CommandQueueHead;
+
+  if (DebugBitMask & DEBUG_COMMAND_QUEUE)
+    uart_send(__LINE__, "- Command queueing: %3u   %3u\r", Command, Parameter);
+
+  /* Revert to zero when reaching out-of-bound. */
+  if (CommandQueueHead >= MAX_COMMAND_QUEUE)
+    CommandQueueHead = 0;
+
+  return 0;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=command_unqueue() */
+/* ------------------------------------------------------------------ *\
+             Unqueue next command from the command queue.
+\* ------------------------------------------------------------------ */
+UINT8 command_unqueue(UINT8 *Command, UINT16 *Parameter)
+{
+  UCHAR String[256];
+
+
+  /* Check if the command queue is empty. */
+  if (CommandQueueHead == CommandQueueTail)
+  {
+    /* In case of empty queue or queue error, return queue head and queue tail instead. */
+    *Command   = CommandQueueHead;
+    *Parameter = CommandQueueTail;
+
+    return 0xFF;
+  }
+
+  /* Extract data for next command to process. */
+  *Command   = CommandQueue[CommandQueueTail].Command;
   *Parameter = CommandQueue[CommandQueueTail].Parameter;
 
   /* And reset this slot in the command queue. */
@@ -4651,7 +5286,7 @@ void convert_tm_to_human(struct tm *TmTime, struct human_time *HumanTime)
 \* ------------------------------------------------------------------ */
 UINT64 convert_tm_to_unix(struct tm *TmTime)
 {
-  return mktime(TmTime);
+  return ((UINT64)civil_days(TmTime->tm_year + 1900, TmTime->tm_mon + 1, TmTime->tm_mday) * CIVIL_SECONDS_PER_DAY) + (TmTime->tm_hour * 3600UL) + (TmTime->tm_min * 60UL) + TmTime->tm_sec;
 }
 
 
@@ -4666,11 +5301,33 @@ UINT64 convert_tm_to_unix(struct tm *TmTime)
 \* ------------------------------------------------------------------ */
 void convert_unix_to_tm(time_t UnixTime, struct tm *TmTime, UINT8 FlagLocalTime)
 {
+  UINT8 DayOfMonth;
+  UINT8 Month;
+
+  UINT16 Year;
+
+  UINT32 Seconds;
+
+  int32_t Days;
+
+
   /* If asked for local time, take Timezone into account. */
   if (FlagLocalTime == FLAG_ON)
-    UnixTime += (FlashConfig.Timezone * 60 * 60);
-
-  TmTime = localtime(&UnixTime);
+    UnixTime += get_utc_offset();
+
+  Days    = (int32_t)(UnixTime / CIVIL_SECONDS_PER_DAY);
+  Seconds = (UINT32)(UnixTime % CIVIL_SECONDS_PER_DAY);
+  civil_from_days(Days, &Year, &Month, &DayOfMonth);
+
+  TmTime->tm_hour  = Seconds / 3600;
+  TmTime->tm_min   = (Seconds / 60) % 60;
+  TmTime->tm_sec   = Seconds % 60;
+  TmTime->tm_mday  = DayOfMonth;
+  TmTime->tm_mon   = Month - 1;
+  TmTime->tm_year  = Year - 1900;
+  TmTime->tm_wday  = civil_weekday(Days);
+  TmTime->tm_yday  = civil_day_of_year(Year, Month, DayOfMonth) - 1;
+  TmTime->tm_isdst = ((FlagLocalTime == FLAG_ON) && (FlashConfig.FlagSummerTime == FLAG_ON)) ? 1 : 0;
 
   if (DebugBitMask & DEBUG_RTC)
   {
@@ -4995,7 +5652,7 @@ void date_stamp(UCHAR *String)
     YearCentile = 20;
 
   /* NOTE: Use English month names since accents don't show up on external terminal. */
-  sprintf(String, "[%2.2u-%s-%4.4u %2.2u:%2.2u:%2.2u] - ", CurrentDayOfMonth, ShortMonth[ENGLISH][CurrentMonth], CurrentYear, CurrentHour, CurrentMinute, CurrentSecond);
+  sprintf(String, "[%2.2u-%s-%4.4u %2.2u:%2.2u:%2.2u] - ", CurrentDayOfMonth, SHORT_MONTH(ENGLISH, CurrentMonth), CurrentYear, CurrentHour, CurrentMinute, CurrentSecond);
 
   return;
 }
@@ -5177,7 +5834,7 @@ void evaluate_blinking_time(void)
           /* Turn On day-of-week indicators for days already selected... */
           for (Loop1UInt8 = SUN; Loop1UInt8 <= SAT; ++Loop1UInt8)
           {
-            if (FlashConfig.Alarm[AlarmNumber].Day & (1 << Loop1UInt8))
+            if (Alarm[AlarmNumber].Day & (1 << Loop1UInt8))
               update_top_indicators(Loop1UInt8, FLAG_ON);
             else
               update_top_indicators(Loop1UInt8, FLAG_OFF);
@@ -5330,59 +5987,343 @@ void evaluate_scroll_time(void)
 
 
 /* $PAGE */
-/* $TITLE=fill_display_buffer_5X7() */
+/* $TITLE=event_blob_check() */
 /* ------------------------------------------------------------------ *\
-      Set the display framebuffer with the given ASCII character
-              beginning at the given column position.
-          Character width is also passed as an argument.
-      NOTE: left-most column visible on clock display is column 2
-            columns 0 and 1 are used by indicators.
-      This function returns the position of the next free column.
+        Check for a calendar events blob in flash (built from an
+      iCalendar file by tools/ics2blob, see event_blob.h). If one is
+     found and valid, calendar events are read from it in place (XIP
+      flash), otherwise those of CalendarEvent[] are used. Must be
+                 called before event_index_build().
 \* ------------------------------------------------------------------ */
-UINT16 fill_display_buffer_5X7(UINT8 Column, UINT8 AsciiCharacter)
+void event_blob_check(void)
 {
-  UINT8 ColumnInSection;
-  UINT8 RowNumber;
-  UINT8 SectionNumber;
+  const struct event_blob_header *Header;
 
-  UINT16 TableOffset;
-  UINT16 Width;
 
+  EventBlob  = NULL;
+  EventTotal = MAX_EVENTS;
 
-  /* If column number given as an argument is out-of-bound, return DISPLAY_BUFFER_SIZE. */
-  if (Column > DISPLAY_BUFFER_SIZE) return DISPLAY_BUFFER_SIZE;
+  Header = (const struct event_blob_header *)(XIP_BASE + EVENT_BLOB_OFFSET);
 
+  if (Header->Magic != EVENT_BLOB_MAGIC)
+  {
+    if (DebugBitMask & DEBUG_EVENT)
+      uart_send(__LINE__, "No calendar events blob at flash offset 0x%6.6X, using calendar events of the firmware.\r", EVENT_BLOB_OFFSET);
 
-  /* First 2 columns are reserved for indicators. */
-  if (Column < 2) Column = 2;
+    return;
+  }
 
+  if ((Header->Version != EVENT_BLOB_VERSION) || (Header->Size > EVENT_BLOB_AREA) ||
+      (Header->EventCount > EVENT_BLOB_MAX_EVENTS) || (Header->IndexedCount > Header->EventCount) || (Header->DayStart[EVENT_BLOB_DAYS] != Header->IndexedCount) ||
+      (Header->Size != sizeof(struct event_blob_header) + (Header->EventCount * sizeof(struct event_blob_record)) + Header->StringSize) ||
+      (Header->Crc16 != crc16((UINT8 *)&Header->Size, Header->Size - offsetof(struct event_blob_header, Size))))
+  {
+    if (DebugBitMask & DEBUG_EVENT)
+      uart_send(__LINE__, "Invalid calendar events blob at flash offset 0x%6.6X (version %u, size %lu), using calendar events of the firmware.\r", EVENT_BLOB_OFFSET, Header->Version, Header->Size);
 
-  SectionNumber   = Column / 8;
-  ColumnInSection = Column % 8;
+    return;
+  }
 
+  EventBlob  = Header;
+  EventTotal = Header->EventCount;
 
-  /* Special handling of character 0x00 used to blink characters on the display. */
-  if (AsciiCharacter == 0x00) AsciiCharacter = 32; // blank ("space") character.
+  if (DebugBitMask & DEBUG_EVENT)
+    uart_send(__LINE__, "Calendar events blob found at flash offset 0x%6.6X: %u events, %lu bytes.\r", EVENT_BLOB_OFFSET, Header->EventCount, Header->Size);
 
+  return;
+}
 
-  /* Determine the digit bitmap corresponding to the character we want to display. */
-  if ((AsciiCharacter >= 0x1E) && (AsciiCharacter <= 0x91))
-  {
-    TableOffset = (UINT16)((AsciiCharacter - 0x1E) * 7);
-    Width       = CharWidth[AsciiCharacter - 0x1E];
-  }
-  else
-  {
-    /* If ASCII character is out-of-bound, replace it with "?". */
-    TableOffset = (UINT16)((0x3F - 0x1E) * 7);
-    Width       = CharWidth[AsciiCharacter - 0x3F];
-  }
 
 
-  for (RowNumber = 1; RowNumber < 8; ++RowNumber)
-  {
-    if (ColumnInSection > 0)
-    {
+
+
+/* $PAGE */
+/* $TITLE=event_description() */
+/* ------------------------------------------------------------------ *\
+       Return the text of a calendar event, from the calendar events
+           blob if there is one, from CalendarEvent[] otherwise.
+\* ------------------------------------------------------------------ */
+const UCHAR *event_description(UINT8 EventNumber)
+{
+  if (EventNumber >= EventTotal) return (const UCHAR *)"";
+
+  if (EventBlob == NULL) return CalendarEvent[EventNumber].Description;
+
+  if (EVENT_BLOB_RECORDS[EventNumber].Description >= EventBlob->StringSize) return (const UCHAR *)"";
+
+  return &EVENT_BLOB_STRINGS[EVENT_BLOB_RECORDS[EventNumber].Description];
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=event_index_build() */
+/* ------------------------------------------------------------------ *\
+           Build the day-of-year index of calendar events.
+      Events are sorted by day-of-year by event_index_sort(), which
+      keeps the events of a same day in the order they are defined.
+       Events with an invalid date are left out of the index (and
+      will never be scrolled). Events with a recurrence rule are put
+       in EventRule[] instead of the index. A calendar events blob
+          brings its own index, only its rules are parsed here.
+\* ------------------------------------------------------------------ */
+void event_index_build(void)
+{
+  UINT8 Loop1UInt8;
+
+  UINT16 DayNumber[MAX_EVENTS];
+
+
+  EventRuleCount = 0;
+
+  if (EventBlob != NULL)
+  {
+    for (Loop1UInt8 = EventBlob->IndexedCount; Loop1UInt8 < EventBlob->EventCount; ++Loop1UInt8)
+    {
+      if (EVENT_BLOB_RECORDS[Loop1UInt8].Rule >= EventBlob->StringSize) continue;
+
+      event_rule_add(Loop1UInt8, &EVENT_BLOB_STRINGS[EVENT_BLOB_RECORDS[Loop1UInt8].Rule], EVENT_BLOB_RECORDS[Loop1UInt8].Month, EVENT_BLOB_RECORDS[Loop1UInt8].Day);
+    }
+
+    if (DebugBitMask & DEBUG_EVENT)
+      uart_send(__LINE__, "Calendar events blob: %u events in the day index, %u with a recurrence rule.\r", EventBlob->IndexedCount, EventRuleCount);
+
+    return;
+  }
+
+  /* Day-of-year of each event, EVENT_INDEX_NONE for those left out of the index. */
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_EVENTS; ++Loop1UInt8)
+  {
+    DayNumber[Loop1UInt8] = EVENT_INDEX_NONE;
+
+    if ((CalendarEvent[Loop1UInt8].Month < 1) || (CalendarEvent[Loop1UInt8].Month > 12)) continue;
+    if ((CalendarEvent[Loop1UInt8].Day < 1) || (CalendarEvent[Loop1UInt8].Day > get_month_days(EVENT_LEAP_YEAR, CalendarEvent[Loop1UInt8].Month))) continue;
+
+    if (CalendarEvent[Loop1UInt8].Rule != NULL)
+    {
+      event_rule_add(Loop1UInt8, CalendarEvent[Loop1UInt8].Rule, CalendarEvent[Loop1UInt8].Month, CalendarEvent[Loop1UInt8].Day);
+      continue;
+    }
+
+    DayNumber[Loop1UInt8] = get_day_of_year(EVENT_LEAP_YEAR, CalendarEvent[Loop1UInt8].Month, CalendarEvent[Loop1UInt8].Day) - 1;
+  }
+
+  event_index_sort(DayNumber, MAX_EVENTS, EventDayStart, EventIndex);
+
+  if (DebugBitMask & DEBUG_EVENT)
+    uart_send(__LINE__, "Calendar events index built: %u events out of %u have a valid date, %u more have a recurrence rule.\r", EventDayStart[EVENT_INDEX_DAYS], MAX_EVENTS, EventRuleCount);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=event_jingle() */
+/* ------------------------------------------------------------------ *\
+        Return the jingle of a calendar event (0 = none), from the
+      calendar events blob if there is one, from CalendarEvent[]
+                            otherwise.
+\* ------------------------------------------------------------------ */
+UINT16 event_jingle(UINT8 EventNumber)
+{
+  if (EventNumber >= EventTotal) return 0;
+
+  if (EventBlob == NULL) return CalendarEvent[EventNumber].Jingle;
+
+  return EVENT_BLOB_RECORDS[EventNumber].Jingle;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=event_list() */
+/* ------------------------------------------------------------------ *\
+      Fill List (MAX_EVENTS entries) with the numbers of all calendar
+      events of a given date: first those of the calendar events index,
+       then those defined with a recurrence rule. Return the number of
+     events found. The next occurrence of a rule is searched only when
+       the date goes past the one kept in EventRule[], so that a rule
+         is evaluated about once per occurrence, not once per call.
+\* ------------------------------------------------------------------ */
+UINT16 event_list(UINT16 Year, UINT8 Month, UINT8 DayOfMonth, UINT8 *List)
+{
+  UINT8 Loop1UInt8;
+
+  UINT16 Count;
+  UINT16 First;
+  UINT16 Found;
+  UINT16 Loop1UInt16;
+
+  UINT32 DayNumber;
+
+  int64_t Next;
+
+
+  Count = 0;
+  Found = event_lookup(Month, DayOfMonth, &First);
+  for (Loop1UInt16 = First; (Loop1UInt16 < (First + Found)) && (Count < MAX_EVENTS); ++Loop1UInt16)
+  {
+    if (EventBlob == NULL)
+    {
+      List[Count++] = (UINT8)EventIndex[Loop1UInt16];
+    }
+    else
+    {
+      /* Records of the blob are already sorted by day. One-time events (Year != 0) are scrolled in their own year only. */
+      if ((EVENT_BLOB_RECORDS[Loop1UInt16].Year == 0) || (EVENT_BLOB_RECORDS[Loop1UInt16].Year == Year))
+        List[Count++] = (UINT8)Loop1UInt16;
+    }
+  }
+
+  if (EventRuleCount == 0) return Count;
+
+  DayNumber = civil_days(Year, Month, DayOfMonth);
+  for (Loop1UInt8 = 0; Loop1UInt8 < EventRuleCount; ++Loop1UInt8)
+  {
+    if ((DayNumber < EventRule[Loop1UInt8].From) || (DayNumber > EventRule[Loop1UInt8].Next))
+    {
+      Next = recur_next(&EventRule[Loop1UInt8].Rule, ((int64_t)DayNumber * CIVIL_SECONDS_PER_DAY) - 1);
+      EventRule[Loop1UInt8].From = DayNumber;
+      EventRule[Loop1UInt8].Next = (Next == RECUR_NONE) ? EVENT_RULE_NONE : (UINT32)(Next / CIVIL_SECONDS_PER_DAY);
+
+      if (DebugBitMask & DEBUG_EVENT)
+        uart_send(__LINE__, "Calendar event %u: next occurrence on day %lu (from day %lu)\r", EventRule[Loop1UInt8].EventNumber, EventRule[Loop1UInt8].Next, DayNumber);
+    }
+
+    if ((EventRule[Loop1UInt8].Next == DayNumber) && (Count < MAX_EVENTS))
+      List[Count++] = EventRule[Loop1UInt8].EventNumber;
+  }
+
+  return Count;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=event_lookup() */
+/* ------------------------------------------------------------------ *\
+        Find calendar events of a given date in the calendar events
+      index (the one of the calendar events blob if there is one).
+      Return the number of events for this date and, in First, the
+     position of the first one in EventIndex[] (or its record number
+                         in the blob).
+\* ------------------------------------------------------------------ */
+UINT16 event_lookup(UINT8 Month, UINT8 DayOfMonth, UINT16 *First)
+{
+  UINT16 DayNumber;
+
+  const UINT16 *DayStart;
+
+
+  *First = 0;
+
+  if ((Month < 1) || (Month > 12) || (DayOfMonth < 1) || (DayOfMonth > get_month_days(EVENT_LEAP_YEAR, Month)))
+    return 0;
+
+  DayStart  = (EventBlob != NULL) ? EventBlob->DayStart : EventDayStart;
+  DayNumber = get_day_of_year(EVENT_LEAP_YEAR, Month, DayOfMonth) - 1;
+  *First    = DayStart[DayNumber];
+
+  return (DayStart[DayNumber + 1] - DayStart[DayNumber]);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=event_rule_add() */
+/* ------------------------------------------------------------------ *\
+       Parse the recurrence rule of a calendar event into EventRule[].
+     The rule starts on Day and Month of year 2000, at 00h00, unless
+     it gives its own DTSTART. Events with an invalid rule (or beyond
+               MAX_EVENT_RULES) will never be scrolled.
+\* ------------------------------------------------------------------ */
+void event_rule_add(UINT8 EventNumber, const UCHAR *Rule, UINT8 Month, UINT8 Day)
+{
+  if ((EventRuleCount < MAX_EVENT_RULES) &&
+      (recur_parse((const char *)Rule, (int64_t)civil_days(EVENT_LEAP_YEAR, Month, Day) * CIVIL_SECONDS_PER_DAY, &EventRule[EventRuleCount].Rule) == 0))
+  {
+    EventRule[EventRuleCount].EventNumber = EventNumber;
+    EventRule[EventRuleCount].From        = EVENT_RULE_NONE;  // force evaluation on first lookup.
+    EventRule[EventRuleCount].Next        = 0;
+    ++EventRuleCount;
+  }
+  else if (DebugBitMask & DEBUG_EVENT)
+  {
+    uart_send(__LINE__, "Calendar event %u: invalid recurrence rule or more than %u rules, event ignored [%s]\r", EventNumber, MAX_EVENT_RULES, Rule);
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=fill_display_buffer_5X7() */
+/* ------------------------------------------------------------------ *\
+      Set the display framebuffer with the given ASCII character
+              beginning at the given column position.
+          Character width is also passed as an argument.
+      NOTE: left-most column visible on clock display is column 2
+            columns 0 and 1 are used by indicators.
+      This function returns the position of the next free column.
+\* ------------------------------------------------------------------ */
+UINT16 fill_display_buffer_5X7(UINT8 Column, UINT8 AsciiCharacter)
+{
+  UINT8 ColumnInSection;
+  UINT8 RowNumber;
+  UINT8 SectionNumber;
+
+  UINT16 TableOffset;
+  UINT16 Width;
+
+
+  /* If column number given as an argument is out-of-bound, return DISPLAY_BUFFER_SIZE. */
+  if (Column > DISPLAY_BUFFER_SIZE) return DISPLAY_BUFFER_SIZE;
+
+
+  /* First 2 columns are reserved for indicators. */
+  if (Column < 2) Column = 2;
+
+
+  SectionNumber   = Column / 8;
+  ColumnInSection = Column % 8;
+
+
+  /* Special handling of character 0x00 used to blink characters on the display. */
+  if (AsciiCharacter == 0x00) AsciiCharacter = 32; // blank ("space") character.
+
+
+  /* Determine the digit bitmap corresponding to the character we want to display. */
+  if ((AsciiCharacter >= 0x1E) && (AsciiCharacter <= 0x91))
+  {
+    TableOffset = (UINT16)((AsciiCharacter - 0x1E) * 7);
+    Width       = CharWidth[AsciiCharacter - 0x1E];
+  }
+  else
+  {
+    /* If ASCII character is out-of-bound, replace it with "?". */
+    TableOffset = (UINT16)((0x3F - 0x1E) * 7);
+    Width       = CharWidth[AsciiCharacter - 0x3F];
+  }
+
+
+  for (RowNumber = 1; RowNumber < 8; ++RowNumber)
+  {
+    if (ColumnInSection > 0)
+    {
       DisplayBuffer[(SectionNumber * 8) + RowNumber] = (DisplayBuffer[(SectionNumber * 8) + RowNumber] & (0xFF >> (8 - ColumnInSection))) | ((reverse_bits(CharMap[TableOffset + RowNumber - 1])) << ColumnInSection);
       if (SectionNumber < (sizeof(DisplayBuffer) / 8) - 1)
       {
@@ -5493,6 +6434,9 @@ void flash_check_config(void)
   UINT16 Crc16;
 
 
+  /* Alarms may have been changed in RAM. */
+  alarm_pack();
+
   /* Calculate CRC16 for current active clock configuration. */
   Crc16 = crc16((UINT8 *)&FlashConfig, (UINT32)&FlashConfig.Crc16 - (UINT32)&FlashConfig.Version);
 
@@ -5624,6 +6568,7 @@ UINT8 flash_display_config(void)
   uart_send(__LINE__, "[%X] Language:                  %3u     (01 = Eng   02 = Fre  03 = Ger  04 - Cze)\r", &FlashConfig.Language, FlashConfig.Language);
   uart_send(__LINE__, "[%X] DSTCountry:                %3u     ( 0 = No DST support   Refer to user guide for all others)\r", &FlashConfig.DSTCountry, FlashConfig.DSTCountry);
   uart_send(__LINE__, "[%X] Timezone:                  %3d\r", &FlashConfig.Timezone, FlashConfig.Timezone);
+  uart_send(__LINE__, "[%X] TimezoneMinutes:           %3d\r", &FlashConfig.TimezoneMinutes, FlashConfig.TimezoneMinutes);
   uart_send(__LINE__, "[%X] Flag Summer Time status:  0x%2.2X   (0x00 = inactive   0x01 = active)\r", &FlashConfig.FlagSummerTime, FlashConfig.FlagSummerTime);
   uart_send(__LINE__, "[%X] TemperatureUnit:          0x%2.2X   (0x00 = Celsius    0x01 = Fahrenheit)\r", &FlashConfig.TemperatureUnit, FlashConfig.TemperatureUnit);
   uart_send(__LINE__, "[%X] TimeDisplayMode:          0x%2.2X   (0x00 = 12Hours    0x01 = 24Hours)\r", &FlashConfig.TimeDisplayMode, FlashConfig.TimeDisplayMode);
@@ -5636,6 +6581,12 @@ UINT8 flash_display_config(void)
   uart_send(__LINE__, "[%X] FlagAutoBrightness:       0x%2.2X     (00 = Off   01 = On)\r", &FlashConfig.FlagAutoBrightness, FlashConfig.FlagAutoBrightness);
   uart_send(__LINE__, "[%X] FlagKeyclick:             0x%2.2X     (00 = Off   01 = On)\r", &FlashConfig.FlagKeyclick, FlashConfig.FlagKeyclick);
   uart_send(__LINE__, "[%X] FlagScrollEnable:         0x%2.2X     (00 = Off   01 = On)\r", &FlashConfig.FlagScrollEnable, FlashConfig.FlagScrollEnable);
+  uart_send(__LINE__, "[%X] TimeBaseFreq:         %7ld     (ppb)\r", &FlashConfig.TimeBaseFreq, FlashConfig.TimeBaseFreq);
+  uart_send(__LINE__, "[%X] NTPServerAddress:   0x%8.8lX 0x%8.8lX 0x%8.8lX 0x%8.8lX\r", &FlashConfig.NTPServerAddress, FlashConfig.NTPServerAddress[0], FlashConfig.NTPServerAddress[1], FlashConfig.NTPServerAddress[2], FlashConfig.NTPServerAddress[3]);
+  uart_send(__LINE__, "[%X] WiFiBssid:   %2.2X:%2.2X:%2.2X:%2.2X:%2.2X:%2.2X   Channel: %3u\r", &FlashConfig.WiFiBssid, FlashConfig.WiFiBssid[0], FlashConfig.WiFiBssid[1], FlashConfig.WiFiBssid[2], FlashConfig.WiFiBssid[3], FlashConfig.WiFiBssid[4], FlashConfig.WiFiBssid[5], FlashConfig.WiFiChannel);
+  uart_send(__LINE__, "[%X] WiFiStatic:               0x%2.2X     (00 = DHCP lease   01 = static IP)\r", &FlashConfig.WiFiStatic, FlashConfig.WiFiStatic);
+  uart_send(__LINE__, "[%X] WiFiAddress:        0x%8.8lX 0x%8.8lX 0x%8.8lX 0x%8.8lX\r", &FlashConfig.WiFiAddress, FlashConfig.WiFiAddress[0], FlashConfig.WiFiAddress[1], FlashConfig.WiFiAddress[2], FlashConfig.WiFiAddress[3]);
+  uart_send(__LINE__, "[%X] WiFiLeaseEnd:       %10lu     (UTC seconds)\r", &FlashConfig.WiFiLeaseEnd, FlashConfig.WiFiLeaseEnd);
 
 
   /* Display Reserved1 data. */
@@ -5658,31 +6609,34 @@ UINT8 flash_display_config(void)
 
     /* Force English if flash configuration has not already been read. */
     if ((FlashConfig.Language > LANGUAGE_LO_LIMIT) && (FlashConfig.Language < LANGUAGE_HI_LIMIT))
-      sprintf(&String[strlen(String)], "   %s\r", DayName[FlashConfig.Language][Loop1UInt16]);
+      sprintf(&String[strlen(String)], "   %s\r", DAY_NAME(FlashConfig.Language, Loop1UInt16));
     else
-      sprintf(&String[strlen(String)], "   %s\r", DayName[ENGLISH][Loop1UInt16]);
+      sprintf(&String[strlen(String)], "   %s\r", DAY_NAME(ENGLISH, Loop1UInt16));
     uart_send(__LINE__, String);
   }
   uart_send(__LINE__, "\r");
 
 
-  /* Scan and display all alarms (0 to 8) -> (1 to 9 for clock user). */
-  for (Loop1UInt16 = 0; Loop1UInt16 < 9; ++Loop1UInt16)
+  /* Scan and display all alarms (0 to 63) -> (1 to 64 for clock user), as packed in flash configuration. Undefined alarms are not displayed. */
+  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
   {
-    uart_send(__LINE__, "[%X] Alarm[%2.2u].Status:         0x%2.2X     (00 = Off   01 = On)\r", &FlashConfig.Alarm[Loop1UInt16].FlagStatus, Loop1UInt16, FlashConfig.Alarm[Loop1UInt16].FlagStatus);
-    uart_send(__LINE__, "[%X] Alarm[%2.2u].Hour:            %3u\r", &FlashConfig.Alarm[Loop1UInt16].Hour, Loop1UInt16, FlashConfig.Alarm[Loop1UInt16].Hour);
-    uart_send(__LINE__, "[%X] Alarm[%2.2u].Minute:          %3u\r", &FlashConfig.Alarm[Loop1UInt16].Minute, Loop1UInt16, FlashConfig.Alarm[Loop1UInt16].Minute);
-    uart_send(__LINE__, "[%X] Alarm[%2.2u].Second:          %3u\r", &FlashConfig.Alarm[Loop1UInt16].Second, Loop1UInt16, FlashConfig.Alarm[Loop1UInt16].Second);
+    if (ALARM_UNDEFINED(FlashConfig.AlarmPacked[Loop1UInt16])) continue;
+
+    uart_send(__LINE__, "[%X] AlarmPacked[%2.2u]:          0x%8.8X\r", &FlashConfig.AlarmPacked[Loop1UInt16], Loop1UInt16, FlashConfig.AlarmPacked[Loop1UInt16]);
+    uart_send(__LINE__, "           Alarm[%2.2u].Status:         0x%2.2X     (00 = Off   01 = On)\r", Loop1UInt16, ALARM_STATUS(FlashConfig.AlarmPacked[Loop1UInt16]));
+    uart_send(__LINE__, "           Alarm[%2.2u].Hour:            %3u\r", Loop1UInt16, ALARM_HOUR(FlashConfig.AlarmPacked[Loop1UInt16]));
+    uart_send(__LINE__, "           Alarm[%2.2u].Minute:          %3u\r", Loop1UInt16, ALARM_MINUTE(FlashConfig.AlarmPacked[Loop1UInt16]));
+    uart_send(__LINE__, "           Alarm[%2.2u].Second:          %3u\r", Loop1UInt16, ALARM_SECOND(FlashConfig.AlarmPacked[Loop1UInt16]));
     
-    uint64_to_binary_string(FlashConfig.Alarm[Loop1UInt16].Day, 8, DayMask);
-    sprintf(String, "[%8.8X] Alarm[%2.2u].DayMask:    %s     (0x%2.2X) ", &FlashConfig.Alarm[Loop1UInt16].Day, Loop1UInt16, DayMask, FlashConfig.Alarm[Loop1UInt16].Day);
+    uint64_to_binary_string(ALARM_DAY(FlashConfig.AlarmPacked[Loop1UInt16]), 8, DayMask);
+    sprintf(String, "           Alarm[%2.2u].DayMask:    %s     (0x%2.2X) ", Loop1UInt16, DayMask, (UINT8)ALARM_DAY(FlashConfig.AlarmPacked[Loop1UInt16]));
 
     for (Loop2UInt16 = 1; Loop2UInt16 < 8; ++Loop2UInt16)
     {
-      if (FlashConfig.Alarm[Loop1UInt16].Day & (1 << Loop2UInt16))
+      if (ALARM_DAY(FlashConfig.AlarmPacked[Loop1UInt16]) & (1 << Loop2UInt16))
       {
         Dum1UInt8 = strlen(String);
-        sprintf(&String[strlen(String)], "%s", DayName[FlashConfig.Language][Loop2UInt16]);
+        sprintf(&String[strlen(String)], "%s", DAY_NAME(FlashConfig.Language, Loop2UInt16));
         String[Dum1UInt8 + 3] = 0x20;  // space separator.
         String[Dum1UInt8 + 4] = 0x00;  // keep first 3 characters of day name.
       }
@@ -5880,6 +6834,17 @@ UINT8 flash_read_config(void)
   FlashConfig.Language           = DEFAULT_LANGUAGE;      // hourly chime will begin at this hour.
   FlashConfig.DSTCountry         = DST_COUNTRY;           // specifies how to handle the daylight saving time depending of country (see User Guide).
   FlashConfig.Timezone           = 0;                     // time difference between local time and Universal Coordinated Time.
+  FlashConfig.TimezoneMinutes    = TIMEZONE_MINUTES;      // additional minutes for half-hour and quarter-hour timezones.
+  FlashConfig.TimeBaseFreq       = 0;                     // Pico crystal frequency correction will be learned from NTP.
+  for (Loop1UInt16 = 0; Loop1UInt16 < 4; ++Loop1UInt16)
+    FlashConfig.NTPServerAddress[Loop1UInt16] = 0;        // NTP server addresses will be given by DNS on first sync.
+  for (Loop1UInt16 = 0; Loop1UInt16 < 6; ++Loop1UInt16)
+    FlashConfig.WiFiBssid[Loop1UInt16] = 0;               // access point will be found by a full scan on first connection.
+  FlashConfig.WiFiChannel        = 0;
+  FlashConfig.WiFiStatic         = FLAG_OFF;              // DHCP, unless STATIC_IP_ADDRESS is defined (see main()).
+  for (Loop1UInt16 = 0; Loop1UInt16 < 4; ++Loop1UInt16)
+    FlashConfig.WiFiAddress[Loop1UInt16] = 0;
+  FlashConfig.WiFiLeaseEnd       = 0;                     // no DHCP lease yet.
   FlashConfig.FlagSummerTime     = FLAG_OFF;              // system will evaluate and overwrite this value on next power-up sequence.
   FlashConfig.TemperatureUnit    = TEMPERATURE_DEFAULT;   // CELSIUS or FAHRENHEIT default value (see clock options above).
   FlashConfig.TimeDisplayMode    = TIME_DISPLAY_DEFAULT;  // H24 or H12 default value (see clock options above).
@@ -5899,70 +6864,71 @@ UINT8 flash_read_config(void)
     FlashConfig.Reserved1[Loop1UInt16] = 0xFF;
   }
 
-  /* Default configuration for 9 alarms. Text may be changed for another 40-characters max string. */
-
-  FlashConfig.Alarm[0].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[0].Day    = (1 << MON) + (1 << TUE) + (1 << WED) + (1 << THU) + (1 << FRI);
-  FlashConfig.Alarm[0].Hour   = 8;
-  FlashConfig.Alarm[0].Minute = 00;
-  FlashConfig.Alarm[0].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[0].Text, "Alarm 1"); // string to be scrolled when alarm 1 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[1].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[1].Day    = (1 << SAT) + (1 << SUN);
-  FlashConfig.Alarm[1].Hour   = 14;
-  FlashConfig.Alarm[1].Minute = 37;
-  FlashConfig.Alarm[1].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[1].Text, "Alarm 2"); // string to be scrolled when alarm 2 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[2].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[2].Day    = (1 << MON);
-  FlashConfig.Alarm[2].Hour   = 14;
-  FlashConfig.Alarm[2].Minute = 36;
-  FlashConfig.Alarm[2].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[2].Text, "Alarm 3"); // string to be scrolled when alarm 3 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[3].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[3].Day    = (1 << TUE);
-  FlashConfig.Alarm[3].Hour   = 14;
-  FlashConfig.Alarm[3].Minute = 35;
-  FlashConfig.Alarm[3].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[3].Text, "Alarm 4"); // string to be scrolled when alarm 4 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[4].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[4].Day    = (1 << WED);
-  FlashConfig.Alarm[4].Hour   = 14;
-  FlashConfig.Alarm[4].Minute = 34;
-  FlashConfig.Alarm[4].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[4].Text, "Alarm 5"); // string to be scrolled when alarm 5 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[5].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[5].Day    = (1 << THU);
-  FlashConfig.Alarm[5].Hour   = 14;
-  FlashConfig.Alarm[5].Minute = 33;
-  FlashConfig.Alarm[5].Second = 29;
-  sprintf(FlashConfig.Alarm[5].Text, "Alarm 6"); // string to be scrolled when alarm 6 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[6].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[6].Day    = (1 << FRI);
-  FlashConfig.Alarm[6].Hour   = 14;
-  FlashConfig.Alarm[6].Minute = 32;
-  FlashConfig.Alarm[6].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[6].Text, "Alarm 7"); // string to be scrolled when alarm 7 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[7].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[7].Day    = (1 << SAT);
-  FlashConfig.Alarm[7].Hour   = 14;
-  FlashConfig.Alarm[7].Minute = 31;
-  FlashConfig.Alarm[7].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[7].Text, "Alarm 8"); // string to be scrolled when alarm 8 is triggered (ALARM TEXT).
-
-  FlashConfig.Alarm[8].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
-  FlashConfig.Alarm[8].Day    = (1 << SUN);
-  FlashConfig.Alarm[8].Hour   = 14;
-  FlashConfig.Alarm[8].Minute = 30;
-  FlashConfig.Alarm[8].Second = 29;              // not used for now... 29 is hardcoded in source code to offload the clock during busy periods.
-  sprintf(FlashConfig.Alarm[8].Text, "Alarm 9"); // string to be scrolled when alarm 9 is triggered (ALARM TEXT).
+  /* Default configuration for the first 9 alarms. Alarm texts are defined in AlarmText[]. */
+
+  Alarm[0].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[0].Day    = (1 << MON) + (1 << TUE) + (1 << WED) + (1 << THU) + (1 << FRI);
+  Alarm[0].Hour   = 8;
+  Alarm[0].Minute = 00;
+  Alarm[0].Second = 29;
+
+  Alarm[1].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[1].Day    = (1 << SAT) + (1 << SUN);
+  Alarm[1].Hour   = 14;
+  Alarm[1].Minute = 37;
+  Alarm[1].Second = 29;
+
+  Alarm[2].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[2].Day    = (1 << MON);
+  Alarm[2].Hour   = 14;
+  Alarm[2].Minute = 36;
+  Alarm[2].Second = 29;
+
+  Alarm[3].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[3].Day    = (1 << TUE);
+  Alarm[3].Hour   = 14;
+  Alarm[3].Minute = 35;
+  Alarm[3].Second = 29;
+
+  Alarm[4].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[4].Day    = (1 << WED);
+  Alarm[4].Hour   = 14;
+  Alarm[4].Minute = 34;
+  Alarm[4].Second = 29;
+
+  Alarm[5].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[5].Day    = (1 << THU);
+  Alarm[5].Hour   = 14;
+  Alarm[5].Minute = 33;
+  Alarm[5].Second = 29;
+
+  Alarm[6].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[6].Day    = (1 << FRI);
+  Alarm[6].Hour   = 14;
+  Alarm[6].Minute = 32;
+  Alarm[6].Second = 29;
+
+  Alarm[7].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[7].Day    = (1 << SAT);
+  Alarm[7].Hour   = 14;
+  Alarm[7].Minute = 31;
+  Alarm[7].Second = 29;
+
+  Alarm[8].FlagStatus = FLAG_OFF; // all alarms set to Off in default configuration.
+  Alarm[8].Day    = (1 << SUN);
+  Alarm[8].Hour   = 14;
+  Alarm[8].Minute = 30;
+  Alarm[8].Second = 29;
+
+  /* Other alarms are Off, with no day-of-week selected. */
+  for (Loop1UInt16 = 9; Loop1UInt16 < MAX_ALARMS; ++Loop1UInt16)
+  {
+    Alarm[Loop1UInt16].FlagStatus = FLAG_OFF;
+    Alarm[Loop1UInt16].Day        = 0;
+    Alarm[Loop1UInt16].Hour       = 0;
+    Alarm[Loop1UInt16].Minute     = 0;
+    Alarm[Loop1UInt16].Second     = 29;
+  }
 
   sprintf(FlashConfig.SSID,     ".;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.;.");                                // write specific footprint to flash memory.
   sprintf(FlashConfig.Password, ".:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.:.");  // write specific footprint to flash memory.
@@ -5997,6 +6963,9 @@ UINT8 flash_save_config(void)
   UINT16 Loop1UInt16;
 
 
+  /* Alarms are saved packed. */
+  alarm_pack();
+
   /* Calculate CRC16 to include it in the packet being flashed. */
   FlashConfig.Crc16 = crc16((UINT8 *)&FlashConfig, (UINT32)&FlashConfig.Crc16 - (UINT32)&FlashConfig.Version);
 
@@ -6174,41 +7143,12 @@ void format_temp(UCHAR *TempString, UCHAR *PreString, float Temperature, float H
 
   if (Humidity != 0)
   {
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-        sprintf(&TempString[strlen(TempString)], "  vlh: %2.2f%%", Humidity);
-      break;
-
-      case (ENGLISH):
-      case (FRENCH):
-      default:
-        sprintf(&TempString[strlen(TempString)], "  Hum: %2.2f%%", Humidity);
-      break;
-    }
+    sprintf(&TempString[strlen(TempString)], msg(MSG_HUMIDITY), Humidity);
   }
 
   if (Pressure != 0)
   {
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-        sprintf(&TempString[strlen(TempString)], "  tlak: %2.2f%% hPa.", Pressure);
-      break;
-
-      case (FRENCH):
-        sprintf(&TempString[strlen(TempString)], "  Pression: %2.2f%% hPa", Pressure);
-      break;
-
-      case (SPANISH):
-        sprintf(&TempString[strlen(TempString)], "  Presion: %2.2f%% hPa", Pressure);
-      break;
-
-      default:
-      case (ENGLISH):
-        sprintf(&TempString[strlen(TempString)], "  Pressure: %2.2f%% hPa", Pressure);
-      break;
-    }
+    sprintf(&TempString[strlen(TempString)], msg(MSG_PRESSURE), Pressure);
   }
 
   return;
@@ -6315,56 +7255,59 @@ void get_current_time(struct human_time *HumanTime)
 /* $PAGE */
 /* $TITLE=get_date_string() */
 /* ------------------------------------------------------------------ *\
-                Build the string containing the date
-                  to be scrolled on clock display.
+                Return the string containing the date
+                   to be scrolled on clock display.
+       The string is built from the date fields derived from the
+      time base, and kept in DateString until the day or language
+            changes, so that periodic scrolls start at once.
 \* ------------------------------------------------------------------ */
 void get_date_string(UCHAR *String)
 {
   UCHAR Suffix[3];
 
-  UINT8 DumDayOfMonth;
-  UINT8 DumMonth;
-  UINT8 DumYearLowPart;
-  UINT8 TemperatureF;
+  int32_t Day;
 
-  UINT16 Loop1UInt16;
 
+  /* Date fields are derived for this day (read it first, so that a day change while building the string triggers a rebuild). */
+  Day = TimeCivilDay;
+
+  if ((DateStringDay == Day) && (DateStringDay >= 0) && (DateStringLanguage == FlashConfig.Language))
+  {
+    /* Date string already built for this day and language. */
+    strcpy(String, DateString);
+    return;
+  }
+
+  if (DebugBitMask & DEBUG_SCROLL)
+    uart_send(__LINE__, "Building date string for day %ld (language: %u)\r", Day, FlashConfig.Language);
 
   /* Wipe string on entry. */
-  for (Loop1UInt16 = 0; Loop1UInt16 < sizeof(String); ++Loop1UInt16)
-    String[Loop1UInt16] = 0x00;
+  DateString[0] = 0x00;
 
-  /* Read the real-time clock IC DS3231. */
-  Time_RTC         = Read_RTC();
-  DumMonth         = bcd_to_byte(Time_RTC.month);
-  DumDayOfMonth    = bcd_to_byte(Time_RTC.dayofmonth);
-  DumYearLowPart   = bcd_to_byte(Time_RTC.year);
-  CurrentDayOfWeek = get_day_of_week(((FlashConfig.CurrentYearCentile * 100) + DumYearLowPart), DumMonth, DumDayOfMonth);
 
-  
   if (FlashConfig.Language == CZECH)
   {
     /* Day-of-week name. */
-    sprintf(String, "%s ", DayName[FlashConfig.Language][CurrentDayOfWeek]);
+    sprintf(DateString, "%s ", DAY_NAME(FlashConfig.Language, CurrentDayOfWeek));
 
     /* Add Day-of-month. */
-    sprintf(&String[strlen(String)], "%X.", Time_RTC.dayofmonth);
+    sprintf(&DateString[strlen(DateString)], "%u.", CurrentDayOfMonth);
 
     /* Add month number. */
-    sprintf(&String[strlen(String)], "%u.", DumMonth);
+    sprintf(&DateString[strlen(DateString)], "%u.", CurrentMonth);
 
     /* Add 4-digits year. */
-    sprintf(&String[strlen(String)], "%2.2u%2.2u  ", FlashConfig.CurrentYearCentile, CurrentYearLowPart);
+    sprintf(&DateString[strlen(DateString)], "%4.4u  ", CurrentYear);
   }
-  
-  
+
+
   if (FlashConfig.Language == ENGLISH)
   {
     /* DayOfWeek and month name. */
-    sprintf(String, "%s %s", DayName[FlashConfig.Language][CurrentDayOfWeek], MonthName[FlashConfig.Language][DumMonth]);
+    sprintf(DateString, "%s %s", DAY_NAME(FlashConfig.Language, CurrentDayOfWeek), MONTH_NAME(FlashConfig.Language, CurrentMonth));
 
     /* Find suffix to add to day-of-month. */
-    switch (DumDayOfMonth)
+    switch (CurrentDayOfMonth)
     {
       case (1):
       case (21):
@@ -6388,38 +7331,43 @@ void get_date_string(UCHAR *String)
     }
 
     /* DayOfMonth and its suffix, then the 4-digits year. */
-    sprintf(&String[strlen(String)], " %X%s %2.2u%2.2u ", Time_RTC.dayofmonth, Suffix, FlashConfig.CurrentYearCentile, CurrentYearLowPart);
+    sprintf(&DateString[strlen(DateString)], " %u%s %4.4u ", CurrentDayOfMonth, Suffix, CurrentYear);
   }
 
 
   if ((FlashConfig.Language == FRENCH) || (FlashConfig.Language == SPANISH))
   {
     /* Day-of-week name. */
-    sprintf(String, "%s ", DayName[FlashConfig.Language][CurrentDayOfWeek]);
+    sprintf(DateString, "%s ", DAY_NAME(FlashConfig.Language, CurrentDayOfWeek));
 
     /* Add Day-of-month. */
-    if (Time_RTC.dayofmonth == 1)
-      sprintf(&String[strlen(String)], "%Xer ", Time_RTC.dayofmonth);  // first of month.
+    if (CurrentDayOfMonth == 1)
+      sprintf(&DateString[strlen(DateString)], "%uer ", CurrentDayOfMonth);  // first of month.
     else
-      sprintf(&String[strlen(String)], "%X ", Time_RTC.dayofmonth);    // other dates.
+      sprintf(&DateString[strlen(DateString)], "%u ", CurrentDayOfMonth);    // other dates.
 
     /* Add month name. */
-    sprintf(&String[strlen(String)], "%s ", MonthName[FlashConfig.Language][DumMonth]);
+    sprintf(&DateString[strlen(DateString)], "%s ", MONTH_NAME(FlashConfig.Language, CurrentMonth));
 
     /* Add 4-digits year. */
-    sprintf(&String[strlen(String)], " %2.2u%2.2u  ", FlashConfig.CurrentYearCentile, CurrentYearLowPart);
+    sprintf(&DateString[strlen(DateString)], " %4.4u  ", CurrentYear);
   }
 
 
   if (FlashConfig.Language == GERMAN)
   {
     /* DayOfWeek and month name. */
-    sprintf(String, "%s %X. %s", DayName[FlashConfig.Language][CurrentDayOfWeek], Time_RTC.dayofmonth, MonthName[FlashConfig.Language][DumMonth]);
+    sprintf(DateString, "%s %u. %s", DAY_NAME(FlashConfig.Language, CurrentDayOfWeek), CurrentDayOfMonth, MONTH_NAME(FlashConfig.Language, CurrentMonth));
 
     /* Add 4-digits year. */
-    sprintf(&String[strlen(String)], " %2.2u%2.2u  ", FlashConfig.CurrentYearCentile, CurrentYearLowPart);
+    sprintf(&DateString[strlen(DateString)], " %4.4u  ", CurrentYear);
   }
 
+  DateStringDay      = Day;
+  DateStringLanguage = FlashConfig.Language;
+
+  strcpy(String, DateString);
+
   return;
 }
 
@@ -6433,23 +7381,10 @@ void get_date_string(UCHAR *String)
                        Return the DayOfWeek,
                given the day-of-month, month and year
       SUN: 1   MON: 2   TUE: 3   WED: 4   THU: 5   FRI: 6   SAT: 7
-   
-   https://en.wikipedia.org/wiki/Determination_of_the_day_of_the_week#Implementation-dependent_methods
 \* ------------------------------------------------------------------ */
 UINT8 get_day_of_week(UINT16 Year, UINT8 Month, UINT8 DayOfMonth)
 {
-  UINT8 DayOfWeek;
-
-
-  if (Month == 1 || Month == 2)
-  {
-    Month += 12;
-    --Year;
-  }
-
-  DayOfWeek = (DayOfMonth + 1 + 2 * Month + 3 * (Month + 1) / 5 + Year + Year / 4 - Year / 100 + Year / 400) % 7;
-
-  return DayOfWeek + 1;
+  return civil_weekday(civil_days(Year, Month, DayOfMonth)) + 1;
 }
 
 
@@ -6463,187 +7398,24 @@ UINT8 get_day_of_week(UINT16 Year, UINT8 Month, UINT8 DayOfMonth)
 \* ------------------------------------------------------------------ */
 UINT16 get_day_of_year(UINT16 YearNumber, UINT8 MonthNumber, UINT8 DayNumber)
 {
-  UCHAR String[256];
+  return civil_day_of_year(YearNumber, MonthNumber, DayNumber);
+}
 
-  UINT8 Loop1UInt8;
 
-  UINT16 TargetDayNumber;
 
 
-  /* Initializations. */
-  TargetDayNumber = 0;
 
+/* $PAGE */
+/* $TITLE=get_microcontroller_type() */
+/* ------------------------------------------------------------------ *\
+         Determine if the microcontroller is a Pico or a Pico W
+\* ------------------------------------------------------------------ */
+UINT8 get_microcontroller_type(void)
+{
+  UCHAR String[128];
 
-  /* Add up all complete months. */
-  for (Loop1UInt8 = 1; Loop1UInt8 < MonthNumber; ++Loop1UInt8)
-  {
-    TargetDayNumber += get_month_days(YearNumber, Loop1UInt8);
-    
-    if (DebugBitMask & DEBUG_DST)
-    {
-      // uart_send(__LINE__, "Adding month %u [%3s] TargetDayNumber += %u (cumulative: %u)\r", Loop1UInt8, ShortMonth[ENGLISH][Loop1UInt8], get_month_days(YearNumber, Loop1UInt8), TargetDayNumber);
-    }
-  }
-
-  /* Then add days of the last, partial month. */
-  if (DebugBitMask & DEBUG_DST)
-  {
-    // uart_send(__LINE__, "Final DayNumber after adding final partial month: (%u + %u)\r\r\r", TargetDayNumber, DayNumber, TargetDayNumber + DayNumber);
-  }
-
-  TargetDayNumber += DayNumber;
-
-  return TargetDayNumber;
-}
-
-
-
-
-/* $PAGE */
-/* $TITLE=get_dst_days() */
-/* ------------------------------------------------------------------ *\
-      Determine the day-of-year for DST start day and DST end day.
-\* ------------------------------------------------------------------ */
-void get_dst_days(void)
-{
-  UCHAR String[256];
-
-  UINT8 DaysInMonth;
-  UINT8 Loop1UInt8;
-  UINT8 Loop2UInt8;
-  UINT8 TargetDayOfWeek;
-
-
-  /* ------------------------------------------------------------------------ *\
-                    Calculate DayOfYear for DST start date.
-  \* ------------------------------------------------------------------------ */
-  /* Total number of days in target month. */
-  DaysInMonth = get_month_days(CurrentYear, DstParameters[FlashConfig.DSTCountry].StartMonth);
-
-  if (DebugBitMask & DEBUG_DST)
-  {
-    uart_send(__LINE__, "Calculating DST start day number for %s (%u to %u) %s-%u \r", 
-            DayName[ENGLISH][DstParameters[FlashConfig.DSTCountry].StartDayOfWeek], 
-            DstParameters[FlashConfig.DSTCountry].StartDayOfMonthLow, 
-            DstParameters[FlashConfig.DSTCountry].StartDayOfMonthHigh, 
-            ShortMonth[ENGLISH][DstParameters[FlashConfig.DSTCountry].StartMonth], 
-            CurrentYear);
-    
-    uart_send(__LINE__, "DST start month is %s and contains %u days\r", MonthName[ENGLISH][DstParameters[FlashConfig.DSTCountry].StartMonth], DaysInMonth);
-  }
-
-
-  /* Find the DayOfMonth when DST starts. */
-  for (Loop1UInt8 = 1; Loop1UInt8 <= DaysInMonth; ++Loop1UInt8)
-  {
-    TargetDayOfWeek = get_day_of_week(CurrentYear, DstParameters[FlashConfig.DSTCountry].StartMonth, Loop1UInt8);
-    
-    if (DebugBitMask & DEBUG_DST)
-      uart_send(__LINE__, "Checking day of month: %2u   day of week: %u [%8s]\r", Loop1UInt8, TargetDayOfWeek, DayName[ENGLISH][TargetDayOfWeek]);
-
-
-    if ((Loop1UInt8 >= DstParameters[FlashConfig.DSTCountry].StartDayOfMonthLow) && (Loop1UInt8 <= DstParameters[FlashConfig.DSTCountry].StartDayOfMonthHigh) && (TargetDayOfWeek == DstParameters[FlashConfig.DSTCountry].StartDayOfWeek))
-    {
-      if (DebugBitMask & DEBUG_DST)
-        uart_send(__LINE__, "Found the starting DayOfMonth: %2u\r", Loop1UInt8);
-
-      break;  // get out of "for" loop when we found DST start day.
-    }
-  }
-  
-  
-  /* Evaluate the DayOfYear for DST starting date. */
-  DstParameters[FlashConfig.DSTCountry].StartDayOfYear = get_day_of_year(CurrentYear, DstParameters[FlashConfig.DSTCountry].StartMonth, Loop1UInt8);
-
-  if (DebugBitMask & DEBUG_DST)
-  {
-    sprintf(String, "Total number of days:  ");
-    for (Loop2UInt8 = 1; Loop2UInt8 < DstParameters[FlashConfig.DSTCountry].StartMonth; ++Loop2UInt8)
-    {
-      sprintf(&String[strlen(String)], "%u + ", get_month_days(CurrentYear, Loop2UInt8));
-    }
-    sprintf(&String[strlen(String)], "%u\r", Loop1UInt8);
-    uart_send(__LINE__, String);
-
-    uart_send(__LINE__, " ----------> StartDayOfYear for DST: %u   %s %2u-%s-%4.4u\r\r\r", DstParameters[FlashConfig.DSTCountry].StartDayOfYear, ShortDay[FlashConfig.Language][DstParameters[FlashConfig.DSTCountry].StartDayOfWeek], Loop1UInt8, ShortMonth[ENGLISH][DstParameters[FlashConfig.DSTCountry].StartMonth], CurrentYear);
-  }
-
-
-
-
-
-  /* ------------------------------------------------------------------------ *\
-                    Calculate DayOfYear for DST end date.
-  \* ------------------------------------------------------------------------ */
-  /* Total number of days in target month. */
-  DaysInMonth = get_month_days(CurrentYear, DstParameters[FlashConfig.DSTCountry].EndMonth);
-
-  if (DebugBitMask & DEBUG_DST)
-  {
-    uart_send(__LINE__, "Calculating DST end day number for %s (%u to %u) %s-%4.4u \r", 
-            DayName[FlashConfig.Language][DstParameters[FlashConfig.DSTCountry].EndDayOfWeek], 
-            DstParameters[FlashConfig.DSTCountry].EndDayOfMonthLow, 
-            DstParameters[FlashConfig.DSTCountry].EndDayOfMonthHigh, 
-            ShortMonth[ENGLISH][DstParameters[FlashConfig.DSTCountry].EndMonth], 
-            CurrentYear);
-
-    uart_send(__LINE__, "DST end month is %s and contains %u days\r", MonthName[FlashConfig.Language][DstParameters[FlashConfig.DSTCountry].EndMonth], DaysInMonth);
-  }
-
-
-  /* Find the DayOfMonth when DST ends. */
-  for (Loop1UInt8 = 1; Loop1UInt8 <= DaysInMonth; ++Loop1UInt8)
-  {
-    TargetDayOfWeek = get_day_of_week(CurrentYear, DstParameters[FlashConfig.DSTCountry].EndMonth, Loop1UInt8);
-    
-    if (DebugBitMask & DEBUG_DST)
-      uart_send(__LINE__, "Checking day of month: %2u  day of week: %u [%8s]\r", Loop1UInt8, TargetDayOfWeek, DayName[FlashConfig.Language][TargetDayOfWeek]);
-
-    if ((Loop1UInt8 >= DstParameters[FlashConfig.DSTCountry].EndDayOfMonthLow) && (Loop1UInt8 <= DstParameters[FlashConfig.DSTCountry].EndDayOfMonthHigh) && (TargetDayOfWeek == DstParameters[FlashConfig.DSTCountry].EndDayOfWeek))
-    {
-      if (DebugBitMask & DEBUG_DST)
-        uart_send(__LINE__, "Found the ending DayOfMonth: %2u\r", Loop1UInt8);
-
-      break;  // get out of "for" loop when we found DST end day.
-    }
-  }
-  
-  
-  /* Evaluate the DayOfYear for DST ending date. */
-  DstParameters[FlashConfig.DSTCountry].EndDayOfYear = get_day_of_year(CurrentYear, DstParameters[FlashConfig.DSTCountry].EndMonth, Loop1UInt8);
-
-  if (DebugBitMask & DEBUG_DST)
-  {
-    sprintf(String, "Total number of days:  ");
-    for (Loop2UInt8 = 1; Loop2UInt8 < DstParameters[FlashConfig.DSTCountry].EndMonth; ++Loop2UInt8)
-    {
-      sprintf(&String[strlen(String)], "%u + ", get_month_days(CurrentYear, Loop2UInt8));
-    }
-    sprintf(&String[strlen(String)], "%u\r", Loop1UInt8);
-    uart_send(__LINE__, String);
-
-    uart_send(__LINE__, " ----------> EndDayOfYear for DST: %u   %s %2u-%s-%4.4u\r", DstParameters[FlashConfig.DSTCountry].EndDayOfYear, ShortDay[FlashConfig.Language][DstParameters[FlashConfig.DSTCountry].EndDayOfWeek], Loop1UInt8, ShortMonth[ENGLISH][DstParameters[FlashConfig.DSTCountry].EndMonth], CurrentYear);
-    uart_send(__LINE__, "=========================================================================================================\r\r\r");
-  }
-
-  return;
-}
-
-
-
-
-
-/* $PAGE */
-/* $TITLE=get_microcontroller_type() */
-/* ------------------------------------------------------------------ *\
-         Determine if the microcontroller is a Pico or a Pico W
-\* ------------------------------------------------------------------ */
-UINT8 get_microcontroller_type(void)
-{
-  UCHAR String[128];
-
-  UINT16 AdcValue1;
-  UINT16 AdcValue2;
+  UINT16 AdcValue1;
+  UINT16 AdcValue2;
 
   float Volts1;
   float Volts2;
@@ -6699,112 +7471,7 @@ UINT8 get_microcontroller_type(void)
 \* ------------------------------------------------------------------ */
 UINT8 get_month_days(UINT16 CurrentYear, UINT8 MonthNumber)
 {
-  if (((CurrentYear % 4 == 0) && (CurrentYear % 100 != 0)) || (CurrentYear % 400 == 0))
-  {
-    switch (MonthNumber)
-    {
-      case 1:
-        return MonthDays[0][0];
-      break;
-    
-      case 2:
-        return MonthDays[0][1];
-      break;
-    
-      case 3:
-        return MonthDays[0][2];
-      break;
-    
-      case 4:
-        return MonthDays[0][3];
-      break;
-    
-      case 5:
-        return MonthDays[0][4];
-      break;
-    
-      case 6:
-        return MonthDays[0][5];
-      break;
-    
-      case 7:
-        return MonthDays[0][6];
-      break;
-    
-      case 8:
-        return MonthDays[0][7];
-      break;
-    
-      case 9:
-        return MonthDays[0][8];
-      break;
-    
-      case 10:
-        return MonthDays[0][9];
-      break;
-    
-      case 11:
-        return MonthDays[0][10];
-      break;
-    
-      case 12:
-        return MonthDays[0][11];
-      break;
-    }
-  }
-  else
-  {
-    switch (MonthNumber)
-    {
-      case 1:
-        return MonthDays[1][0];
-      break;
-    
-      case 2:
-        return MonthDays[1][1];
-      break;
-    
-      case 3:
-        return MonthDays[1][2];
-      break;
-    
-      case 4:
-        return MonthDays[1][3];
-      break;
-    
-      case 5:
-        return MonthDays[1][4];
-      break;
-    
-      case 6:
-        return MonthDays[1][5];
-      break;
-    
-      case 7:
-        return MonthDays[1][6];
-      break;
-    
-      case 8:
-        return MonthDays[1][7];
-      break;
-    
-      case 9:
-        return MonthDays[1][8];
-      break;
-    
-      case 10:
-        return MonthDays[1][9];
-      break;
-    
-      case 11:
-        return MonthDays[1][10];
-      break;
-    
-      case 12:
-        return MonthDays[1][11];
-      break;
-    }
-  }
+  return civil_month_days(CurrentYear, MonthNumber);
 }
 
 
@@ -6843,6 +7510,60 @@ void get_pico_unique_id(void)
 
 
 
+/* $PAGE */
+/* $TITLE=get_utc_offset() */
+/* ------------------------------------------------------------------ *\
+       Return current difference between local time and UTC time
+           (in seconds), including Daylight Saving Time shift.
+\* ------------------------------------------------------------------ */
+int32_t get_utc_offset(void)
+{
+  return ((FlashConfig.Timezone * 3600L) + (FlashConfig.TimezoneMinutes * 60L));
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=idle_history_display() */
+/* ------------------------------------------------------------------ *\
+       Display system idle monitor history through serial port.
+\* ------------------------------------------------------------------ */
+void idle_history_display(void)
+{
+  UINT8 Index;
+  UINT8 Loop1UInt8;
+
+  UINT64 WiFiOnTime;
+
+
+  uart_send(__LINE__, "System idle monitor history (loops per second) - %u minutes, oldest first:\r", IdleHistoryCount);
+  uart_send(__LINE__, "Minute    Minimum    Average    Maximum\r");
+
+  /* Start with the oldest entry in the circular buffer. */
+  Index = (IdleHistoryCount < MAX_IDLE_HISTORY) ? 0 : IdleHistoryHead;
+  for (Loop1UInt8 = 0; Loop1UInt8 < IdleHistoryCount; ++Loop1UInt8)
+  {
+    uart_send(__LINE__, " [%3u]  %8lu   %8lu   %8lu\r", Loop1UInt8, IdleHistory[Index].Minimum, IdleHistory[Index].Average, IdleHistory[Index].Maximum);
+    if (++Index >= MAX_IDLE_HISTORY) Index = 0;
+  }
+
+  #ifdef PICO_W
+  /* Wi-Fi radio is powered down between NTP syncs far enough apart (see ntp_radio_sleep()). */
+  WiFiOnTime = NTPData.WiFiOnTime;
+  if (NTPData.WiFiOnSince) WiFiOnTime += (time_us_64() - NTPData.WiFiOnSince);
+  uart_send(__LINE__, "Wi-Fi radio on for %llu sec out of %llu sec since power-up (currently %s).\r", WiFiOnTime / 1000000ULL, time_us_64() / 1000000ULL, NTPData.WiFiOnSince ? "on" : "off");
+  #endif  // PICO_W
+  printf("\r\r");
+
+  return;
+}
+
+
+
+
+
 /* $PAGE */
 /* $TITLE=init_gpio() */
 /* ------------------------------------------------------------------ *\
@@ -7067,16 +7788,28 @@ void input_string(UCHAR *String)
 \* ----------------------------------------------------------------- */
 gpio_irq_callback_t isr_signal_trap(UINT8 gpio, UINT32 Events)
 {
+  UINT32 CurrentEdge;
+  UINT32 Duration;
+
+
   if (gpio == IR_RX)
   {
+    /* Only the low 32 bits of the timer are kept. Unsigned subtraction below takes care of the wrap-around (every 71 minutes). */
+    CurrentEdge = time_us_32();
+    Duration    = CurrentEdge - IrLastEdge;
+    if (Duration > 0xFFFF) Duration = 0xFFFF;  // saturate to fit in the 16-bits capture buffer.
+
+
     /* IR line goes from Low to High. */
     if (Events & GPIO_IRQ_EDGE_RISE)
     {
-      IrFinalValue[IrStepCount]   = time_us_64();                                                       // this is the final timer value for current Low level.
-      IrResultValue[IrStepCount]  = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of current Low level.
-      IrLevel[IrStepCount]        = 'L';                                                                // identify  as Low level.
-      ++IrStepCount;                                                                                    // start next logic level change.
-      IrInitialValue[IrStepCount] = time_us_64();                                                       // this is also start timer of next High level.
+      /* End of a Low level. Low levels always go to even step numbers. Extra edges beyond the capture buffer are ignored. */
+      if (((IrStepCount & 0x01) == 0) && (IrStepCount < MAX_IR_READINGS))
+      {
+        IrPulse[IrStepCount] = (UINT16)Duration;  // duration of current Low level.
+        ++IrStepCount;                            // start next logic level change.
+      }
+      IrLastEdge = CurrentEdge;                   // this is also start timer of next High level.
 
       gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_RISE);
    }
@@ -7085,14 +7818,13 @@ gpio_irq_callback_t isr_signal_trap(UINT8 gpio, UINT32 Events)
     /* IR line goes from High to Low. */
     if (Events & GPIO_IRQ_EDGE_FALL)
     {
-      if (IrStepCount > 0)
+      /* End of a High level. The first falling edge only marks the beginning of the burst (nothing to record). */
+      if ((IrStepCount & 0x01) && (IrStepCount < MAX_IR_READINGS))
       {
-        IrFinalValue[IrStepCount]  =  time_us_64();                                                      // this is the final timer value for current High level.
-        IrResultValue[IrStepCount] = (UINT32)(IrFinalValue[IrStepCount] - IrInitialValue[IrStepCount]);  // calculate duration of current High level.
-        IrLevel[IrStepCount]       = 'H';                                                                // identify as High level.
-        ++IrStepCount;                                                                                   // start next logic level change.
+        IrPulse[IrStepCount] = (UINT16)Duration;  // duration of current High level.
+        ++IrStepCount;                            // start next logic level change.
       }
-      IrInitialValue[IrStepCount]  = time_us_64();                                                       // this is also start timer of next Low level.
+      IrLastEdge = CurrentEdge;                   // this is also start timer of next Low level.
       
       gpio_acknowledge_irq(IR_RX, GPIO_IRQ_EDGE_FALL);
     }
@@ -7412,76 +8144,209 @@ void matrix_test(UINT8 TestNumber)
 
 
 /* $PAGE */
-/* $TITLE=pixel_twinkling() */
+/* $TITLE=msg() */
 /* ------------------------------------------------------------------ *\
-                       Make some pixel animation.
+        Return a localized message in the language currently
+          selected (English if message has not been translated).
 \* ------------------------------------------------------------------ */
-void pixel_twinkling(UINT16 Seconds)
+const char *msg(UINT16 MessageId)
 {
-  UINT8 DumFrame;
-  UINT8 DumBit;
-  UINT8 Status[24][8];
+  return msg_lang(FlashConfig.Language, MessageId);
+}
 
-  UINT16 Frequency;
-  UINT16 Loop1UInt16;
 
-  UINT64 StartTime;
 
 
-  /* If there is something scrolling on clock display, wait for the scrolling to complete.  */
-  while (ScrollDotCount);
 
-  /* Make sure double dots don't blink on clock display. */
-  CurrentClockMode = MODE_TEST;
+/* $PAGE */
+/* $TITLE=msg_lang() */
+/* ------------------------------------------------------------------ *\
+            Return a localized message in the specified language
+              (English if message has not been translated).
+\* ------------------------------------------------------------------ */
+const char *msg_lang(UINT8 Language, UINT16 MessageId)
+{
+  if (MessageId >= MSG_HI_LIMIT) return "";
+  if (Language >= LANGUAGE_HI_LIMIT) Language = ENGLISH;
 
-  /* All pixels are Off on entry. Set their status accordingly. */
-  for (DumFrame = 0; DumFrame < 24; ++DumFrame)
-    for (DumBit = 0; DumBit < 8; ++DumBit)
-      Status[DumFrame][DumBit] = FLAG_OFF;
+  return (const char *)&MessagePool + MessageOffset[MessageId][Language];
+}
 
 
 
-  /* Make sure sounds do not begin before pixel twinkling. */
-  #ifdef PASSIVE_PIEZO_SUPPORT
-  sound_queue_passive(SILENT, 50);
 
-  /* Make random sounds while playing with pixels (50 msec per sound - one callback duration). */
-  for (Loop1UInt16 = 1; Loop1UInt16 < (Seconds * 1000 / 95); ++Loop1UInt16)
-  {
-    Frequency = (rand() % 7000) + 300;
 
-    /* Add a new sound in sound queue. If sound queue is full, stop adding sounds. */
-    if (sound_queue_passive(Frequency, 50) == MAX_PASSIVE_SOUND_QUEUE)
-      break;
-  }
-  #endif  // PASSIVE_PIEZO_SUPPORT
+#ifdef PICO_W
+/* $PAGE */
+/* $TITLE=ntp_update() */
+/* ------------------------------------------------------------------ *\
+       Apply the result of an NTP sync, posted by the NTP client as
+       COMMAND_NTP_UPDATE when it is done. On success, the time base
+       is disciplined and the real-time clock IC will be written on
+       next second (see rtc_write_time()), so that nothing here waits
+       for the network or the clock. On failure, the next try is
+            delayed (see ntp_poll_failed()).
+\* ------------------------------------------------------------------ */
+void ntp_update(UINT8 FlagSuccess)
+{
+  UCHAR String[256];
 
+  int64_t Phase;
 
 
-  StartTime = time_us_64();
-  while (time_us_64() < (StartTime + (1000000 * Seconds)))
+  if (FlagSuccess == FLAG_ON)
   {
-    /* Generate a Framebuffer, excluding 8 and 16 that are reserved. */
-    do
+    if (DebugBitMask & DEBUG_NTP)
     {
-      DumFrame = rand() % 24;
-    } while ((DumFrame == 0) || (DumFrame == 8) || (DumFrame == 16));
+      uart_send(__LINE__, "Green Clock time before resync:\r");
+      uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r\r", DAY_NAME(FlashConfig.Language, CurrentDayOfWeek), CurrentDayOfMonth, CurrentMonth, CurrentYear, CurrentHour, CurrentMinute, CurrentSecond);
+      uart_send(__LINE__, "NTP time (synchronizing clock with those values).\r");
+      uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r\r", DAY_NAME(FlashConfig.Language, NTPData.CurrentDayOfWeek), NTPData.CurrentDayOfMonth, NTPData.CurrentMonth, NTPData.CurrentYear, NTPData.CurrentHour, NTPData.CurrentMinute, NTPData.CurrentSecond);
+    }
 
-    /* Generate a bitnumber. */
-    DumBit = rand() % 8;
+    NTPData.FlagNTPSuccess = FLAG_OFF;
 
-    /* Exclude bit numbers that are reserved. */
-    if ((DumFrame < 9) && ((DumBit == 0) || (DumBit == 1)))
-      continue;
+    /* NTP gives the offset between UTC and the Pico timer, corrected for network delay (see ntp_recv()): discipline the time base.
+       Local time derived from it is copied to the real-time clock IC at the beginning of next second, since the DS3231
+       starts counting a new second when its seconds register is written. */
+    Phase = time_base_discipline(NTPData.NTPGetTime + NTPData.NTPOffset, NTPData.NTPGetTime);
 
-    /* Check status of generated bit and toggle it. */
-    if (Status[DumFrame][DumBit] == FLAG_OFF)
+    /* The real-time clock IC keeps its own time between two writes (at least RTC_DRIFT_INTERVAL_MIN apart), so that its drift
+       can be measured at each of them, unless the time base has just been stepped. */
+    if ((Phase > TIME_STEP_THRESHOLD) || (Phase < -TIME_STEP_THRESHOLD) || rtc_drift_due(&RtcDrift, time_us_64()))
+      FlagRtcWrite = FLAG_ON;
+
+    show_time();  // update time display as soon as possible.
+
+    /* Check Daylight Saving Time status with the new time and reschedule reminders. */
+    update_dst_status();
+    command_queue(COMMAND_REMINDER_RESET, 0);
+    command_queue(COMMAND_ALARM_SCHEDULE, 0);
+    command_queue(COMMAND_CHIME_SCHEDULE, 0);
+
+    if (DebugBitMask & DEBUG_NTP)
     {
-      /* This bit is turned Off, turn it On. */
-      DisplayBuffer[DumFrame] |= (1 << DumBit);
-      Status[DumFrame][DumBit] = FLAG_ON;
+      uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r", DAY_NAME(FlashConfig.Language, CurrentDayOfWeek), CurrentDayOfMonth, CurrentMonth, CurrentYear, CurrentHour, CurrentMinute, CurrentSecond);
+      uart_send(__LINE__, "NTPData.NTPGetTime: 0x%10.10llX   Offset: %lld usec   Round-trip delay: %lld usec\r", NTPData.NTPGetTime, NTPData.NTPOffset, NTPData.NTPRoundTrip);
+      if (NTPData.NTPGetTime)
+        uart_send(__LINE__, "Time elapsed since last poll: %10lld usec.   %10lld usec.\r\r", (time_us_64() - NTPData.NTPLastUpdate), (time_us_64() - NTPData.NTPGetTime));
     }
-    else
+
+    /* Time from power-up to the first sync, and to the Wi-Fi link before it (see ntp_init()). */
+    if (NTPData.NTPFirstSync == 0)
+    {
+      NTPData.NTPFirstSync = time_us_64();
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "First NTP sync applied %llu msec after power-up (Wi-Fi link up after %llu msec).\r", NTPData.NTPFirstSync / 1000, NTPData.WiFiLinkTime / 1000);
+    }
+
+    /* Next sync comes sooner or later, depending on how well the clock kept time since last one. */
+    ntp_poll_update(Phase);
+
+    /* Servers that answered and agreed are used first after a reboot (see ntp_init()). */
+    ntp_server_save();
+
+    NTPData.FlagNTPResync = FLAG_OFF;
+    NTPData.NTPGetTime    = time_us_64();
+    NTPData.NTPLastUpdate = time_us_64();
+  }
+  else
+  {
+    /* NTP sync failed, retry later (exponential backoff). */
+    NTPData.FlagNTPResync = FLAG_OFF;  // NTP resync error... postpone re-sync.
+    ++NTPData.NTPErrors;
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "Failed to synchronize clock with NTP.\r\r");
+
+    ntp_poll_failed();
+    NTPData.NTPLastUpdate = time_us_64();
+  }
+
+  /* Nothing else uses the network, the Wi-Fi radio may be powered down until next sync. */
+  ntp_radio_sleep();
+
+  /* Result applied, a new sync may begin. */
+  NTPData.NTPState = NTP_STATE_IDLE;
+
+  return;
+}
+#endif  // PICO_W
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=pixel_twinkling() */
+/* ------------------------------------------------------------------ *\
+                       Make some pixel animation.
+\* ------------------------------------------------------------------ */
+void pixel_twinkling(UINT16 Seconds)
+{
+  UINT8 DumFrame;
+  UINT8 DumBit;
+  UINT8 Status[24][8];
+
+  UINT16 Frequency;
+  UINT16 Loop1UInt16;
+
+  UINT64 StartTime;
+
+
+  /* If there is something scrolling on clock display, wait for the scrolling to complete.  */
+  while (ScrollDotCount);
+
+  /* Make sure double dots don't blink on clock display. */
+  CurrentClockMode = MODE_TEST;
+
+  /* All pixels are Off on entry. Set their status accordingly. */
+  for (DumFrame = 0; DumFrame < 24; ++DumFrame)
+    for (DumBit = 0; DumBit < 8; ++DumBit)
+      Status[DumFrame][DumBit] = FLAG_OFF;
+
+
+
+  /* Make sure sounds do not begin before pixel twinkling. */
+  #ifdef PASSIVE_PIEZO_SUPPORT
+  sound_queue_passive(SILENT, 50);
+
+  /* Make random sounds while playing with pixels (50 msec per sound - one callback duration). */
+  for (Loop1UInt16 = 1; Loop1UInt16 < (Seconds * 1000 / 95); ++Loop1UInt16)
+  {
+    Frequency = (rand() % 7000) + 300;
+
+    /* Add a new sound in sound queue. If sound queue is full, stop adding sounds. */
+    if (sound_queue_passive(Frequency, 50) == MAX_PASSIVE_SOUND_QUEUE)
+      break;
+  }
+  #endif  // PASSIVE_PIEZO_SUPPORT
+
+
+
+  StartTime = time_us_64();
+  while (time_us_64() < (StartTime + (1000000 * Seconds)))
+  {
+    /* Generate a Framebuffer, excluding 8 and 16 that are reserved. */
+    do
+    {
+      DumFrame = rand() % 24;
+    } while ((DumFrame == 0) || (DumFrame == 8) || (DumFrame == 16));
+
+    /* Generate a bitnumber. */
+    DumBit = rand() % 8;
+
+    /* Exclude bit numbers that are reserved. */
+    if ((DumFrame < 9) && ((DumBit == 0) || (DumBit == 1)))
+      continue;
+
+    /* Check status of generated bit and toggle it. */
+    if (Status[DumFrame][DumBit] == FLAG_OFF)
+    {
+      /* This bit is turned Off, turn it On. */
+      DisplayBuffer[DumFrame] |= (1 << DumBit);
+      Status[DumFrame][DumBit] = FLAG_ON;
+    }
+    else
     {
       /* This bit is turned On, turn it Off. */
       DisplayBuffer[DumFrame] &= ~(1 << DumBit);
@@ -7663,6 +8528,36 @@ void process_command_queue(void)
         
           play_jingle(Parameter);
         break;
+
+        case (COMMAND_REMINDER_DUE):
+          reminder_process();
+        break;
+
+        case (COMMAND_REMINDER_RESET):
+          reminder_init();
+        break;
+
+        case (COMMAND_ALARM_SCHEDULE):
+          alarm_schedule(0);
+        break;
+
+        case (COMMAND_TIME_CHECK):
+          time_base_check_rtc();
+        break;
+
+        case (COMMAND_CHIME_SCHEDULE):
+          chime_schedule(0);
+        break;
+
+        #ifdef PICO_W
+        case (COMMAND_NTP_UPDATE):
+          ntp_update((UINT8)Parameter);
+        break;
+        #endif  // PICO_W
+
+        case (COMMAND_RTC_WRITE):
+          rtc_write_time();
+        break;
       }
     }
   }
@@ -7703,12 +8598,15 @@ void process_ir_command(UINT8 IrCommand)
   UINT8 DumFrame;
   UINT8 DumMonth;
   UINT8 DumRow;
+  UINT8 EventList[MAX_EVENTS];
+  UINT8 EventNumber;
   UINT8 Loop1UInt8;
   UINT8 Loop2UInt8;
   UINT8 PmFlag;
   UINT8 Status[24][8];
 
   UINT16 DumYear;
+  UINT16 EventCount;
   UINT16 Frequency;
   UINT16 Loop1UInt16;
 
@@ -8359,6 +9257,7 @@ void process_ir_command(UINT8 IrCommand)
     scroll_queue(TAG_VOLTAGE);          // power supply voltage.
     scroll_queue(TAG_BME280_DEVICE_ID); // BME280 device ID if one has been installed by user.
     scroll_queue(TAG_IDLE_MONITOR);     // system idle time monitor.
+    scroll_queue(TAG_STACK);            // stack high-water marks.
     #ifdef PICO_W
     scroll_queue(TAG_NTP_ERRORS);       // scroll number of error in NTP requests.
     #endif  // PICO_W
@@ -8389,37 +9288,10 @@ void process_ir_command(UINT8 IrCommand)
 
     SilencePeriod += (SILENCE_PERIOD_UNIT * 60);
 
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-        if ((int)(SilencePeriod / 60) == 1)
-        {
-          sprintf(String, "Obdobi klidu: %u minuta.", (int)(SilencePeriod / 60));
-          String[5] = (UINT8)131; // i-acute
-        }
-        else
-        {
-          sprintf(String, "Obdobi klidu: %u minut.", (int)(SilencePeriod / 60));
-          String[5] = (UINT8)131; // i-acute
-        }
-      break;
- 
-      case (FRENCH):
-        sprintf(String, "Periode de silence: %u minutes", (int)(SilencePeriod / 60));
-        String[1] = (UINT8)31; // e - acute.
-      break;
- 
-      case (SPANISH):
-        sprintf(String, "Periodo de silencio: %u minutos", (int)(SilencePeriod / 60));
-        String[3] = (UINT8)131; // i - acute.
-      break;
- 
-      case (ENGLISH):
-      case (GERMAN):
-      default:
-        sprintf(String, "Silence period: %u minutes", (int)(SilencePeriod / 60));
-      break;
-    }
+    if ((int)(SilencePeriod / 60) == 1)
+      sprintf(String, msg(MSG_SILENCE_PERIOD_ONE), (int)(SilencePeriod / 60));
+    else
+      sprintf(String, msg(MSG_SILENCE_PERIOD), (int)(SilencePeriod / 60));
     scroll_string(24, String);
   }
 
@@ -8496,186 +9368,25 @@ void process_ir_command(UINT8 IrCommand)
 
         case (0x07):  // SETUP_KEYCLICK
           /* Beep (keyclick). */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              if (FlashConfig.FlagKeyclick == FLAG_ON)
-              {
-                sprintf(String, "opakovani");
-                String[6] = (UINT8)129; // a-acute
-                String[8] = (UINT8)131; // i-acute
-                sprintf(String, "Zvuk klaves zapnut - doba %u ms, %s 1: %u %s 2: %u.", TONE_KEYCLICK_DURATION, String, TONE_KEYCLICK_REPEAT1, String, TONE_KEYCLICK_REPEAT2);
-                String[7] = (UINT8)129; // a-acute
-              }
-              else
-              {
-                sprintf(String, "Zvuk klaves vypnut.");
-                String[7] = (UINT8)129; // a-acute
-              }
-            break;
-
-            case (FRENCH):
-              if (FlashConfig.FlagKeyclick == FLAG_ON)
-              {
-                sprintf(String, "Keyclick On - Duree %u ms Repeat1: %u Repeat2: %u", TONE_KEYCLICK_DURATION, TONE_KEYCLICK_REPEAT1, TONE_KEYCLICK_REPEAT2);
-                String[17] = (UINT8)0x90; // e - acute.
-              }
-              else
-              {
-                sprintf(String, "Keyclick Off");
-              }
-            break;
-
-            case (SPANISH):
-              if (FlashConfig.FlagKeyclick == FLAG_ON)
-              {
-                sprintf(String, "Clic en clave activado - Duracion %u ms Repeat1: %u Repeat2: %u", TONE_KEYCLICK_DURATION, TONE_KEYCLICK_REPEAT1, TONE_KEYCLICK_REPEAT2);
-                String[31] = (UINT8)139; // o - acute.
-              }
-              else
-              {
-                sprintf(String, "Clic en clave desactivado");
-              }
-            break;
-
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.FlagKeyclick == FLAG_ON)
-              {
-                sprintf(String, "Keyclick On - Duration: %u ms Repeat1: %u Repeat2: %u", TONE_KEYCLICK_DURATION, TONE_KEYCLICK_REPEAT1, TONE_KEYCLICK_REPEAT2);
-              }
-              else
-              {
-                sprintf(String, "Keyclick Off");
-              }
-            break;
-
-            scroll_string(24, String);
-          }
+          if (FlashConfig.FlagKeyclick == FLAG_ON)
+            sprintf(String, msg(MSG_KEYCLICK_ON), TONE_KEYCLICK_DURATION, TONE_KEYCLICK_REPEAT1, TONE_KEYCLICK_REPEAT2);
+          else
+            strcpy(String, msg(MSG_KEYCLICK_OFF));
+          scroll_string(24, String);
         break;
 
         case (0x08):  // SETUP_SCROLLING
           /* Display scroll. */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              if (FlashConfig.FlagScrollEnable == FLAG_ON)
-              {
-                sprintf(String, "tecek: %u ms.", SCROLL_DOT_TIME);
-                String[2] = (UINT8)136; // c-caron
-                sprintf(String, "Posuv zapnut - opakovani: %u minut   rychlost %s", SCROLL_PERIOD_MINUTE, String);
-                String[17] = (UINT8)129; // a-acute
-                String[24] = (UINT8)131; // i-acute
-              }
-              else
-              {
-                 sprintf(String, "Posuv vypnut.");
-              }
-            break;
-          
-            case (FRENCH):
-              if (FlashConfig.FlagScrollEnable == FLAG_ON)
-              {
-                sprintf(String, "Scrolling On - Periode: %u minutes   Vitesse des dots: %u msec.", SCROLL_PERIOD_MINUTE, SCROLL_DOT_TIME);
-                String[16] = (UINT8)31;  // e accent aigu.
-              }
-              else
-              {
-                sprintf(String, "Scrolling OFF.");
-              }
-            break;
-          
-            case (SPANISH):
-              if (FlashConfig.FlagScrollEnable == FLAG_ON)
-              {
-                sprintf(String, "Desplazamiento activado - Duracion: %u minutos   Velodicad de los dots: %u msec.", SCROLL_PERIOD_MINUTE, SCROLL_DOT_TIME);
-                String[32] = (UINT8)139;  // o-acute.
-              }
-              else
-              {
-                sprintf(String, "Desplazamiento desactivado.");
-              }
-            break;
-          
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.FlagScrollEnable == FLAG_ON)
-              {
-                sprintf(String, "Scrolling On - Frequency: %u minutes   Dot speed: %u msec.", SCROLL_PERIOD_MINUTE, SCROLL_DOT_TIME);
-              }
-              else
-              {
-                sprintf(String, "Scrolling Off.");
-              }
-            break;
-          }
+          if (FlashConfig.FlagScrollEnable == FLAG_ON)
+            sprintf(String, msg(MSG_SCROLLING_ON), SCROLL_PERIOD_MINUTE, SCROLL_DOT_TIME);
+          else
+            strcpy(String, msg(MSG_SCROLLING_OFF));
           scroll_string(24, String);
         break;
 
         case (0x09):  // SETUP_TEMP_UNIT
           /* Temperature unit. */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              if (FlashConfig.TemperatureUnit == CELSIUS)
-              {
-                sprintf(String, "Jedn. teploty: Celsius.   ");
-                String[4]  = (UINT8)31;  // e accent aigu.
-                String[13] = (UINT8)31;  // e accent aigu.
-              }
-              else
-              {
-                sprintf(String, "Jedn. teploty: Fahrenheit.   ");
-                String[4]  = (UINT8)31;  // e accent aigu.
-                String[13] = (UINT8)31;  // e accent aigu.
-              }
-            break;
-
-            case (FRENCH):
-              if (FlashConfig.TemperatureUnit == CELSIUS)
-              {
-                sprintf(String, "Unite de temperature: Celsius   ");
-                String[4]  = (UINT8)31;  // e accent aigu.
-                String[13] = (UINT8)31;  // e accent aigu.
-              }
-              else
-              {
-                sprintf(String, "Unite de temperature: Fahrenheit   ");
-                String[4]  = (UINT8)31;  // e accent aigu.
-                String[13] = (UINT8)31;  // e accent aigu.
-              }
-            break;
-
-            case (SPANISH):
-              if (FlashConfig.TemperatureUnit == CELSIUS)
-              {
-                sprintf(String, "Unidad de temperatura: Celsius   ");
-                String[4]  = (UINT8)31;  // e accent aigu.
-                String[13] = (UINT8)31;  // e accent aigu.
-              }
-              else
-              {
-                sprintf(String, "Unidad de temperatura: Fahrenheit   ");
-                String[4]  = (UINT8)31;  // e accent aigu.
-                String[13] = (UINT8)31;  // e accent aigu.
-              }
-            break;
-
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.TemperatureUnit == CELSIUS)
-              {
-                sprintf(String, "Temperature unit is Celsius   ");
-              }
-              else
-              {
-                sprintf(String, "Temperature unit is Fahrenheit   ");
-              }
-            break;
-          }
+          sprintf(String, msg(MSG_TEMPERATURE_UNIT), (FlashConfig.TemperatureUnit == CELSIUS) ? "Celsius" : "Fahrenheit");
           scroll_string(24, String);
 
           scroll_queue(TAG_DS3231_TEMP);
@@ -8685,333 +9396,47 @@ void process_ir_command(UINT8 IrCommand)
 
         case (0x0A): // SETUP_LANGUAGE
           /* Language. */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              sprintf(String, "Jazyk je cestina   ");
-              String[9] = (UINT8)136;
-            break;
-
-            case (ENGLISH):
-              sprintf(String, "Language is English   ");
-            break;
-
-            case (FRENCH):
-              sprintf(String, "La langue est le francais   ");
-            break;
-
-            case (SPANISH):
-              sprintf(String, "La lengua es el espanol   ");
-              String[20] = (UINT8)140; // n-tilde
-            break;
-
-            case (GERMAN):
-              sprintf(String, "Language is German   ");
-            break;
-
-            default:
-              sprintf(String, "Undefined language   ");
-            break;
-          }
+          strcpy(String, msg(MSG_LANGUAGE));
           scroll_string(24, String);
 
         break;
 
         case (0x0B): // SETUP_TIME_FORMAT
           /* Time display format. */
-          switch (FlashConfig.Language)
-          {
-           case (CZECH):
-              if (FlashConfig.TimeDisplayMode == H12)
-              {
-                sprintf(String, "12hodinove zobrazeni casu.");
-                String[9] = (UINT8)138; // e-acute
-                String[19] = (UINT8)131; // i-acute
-                String[21] = (UINT8)136; // c-caron
-              }
-              else
-              {
-                sprintf(String, "24hodinove zobrazeni casu.");
-                String[9] = (UINT8)138; // e-acute
-                String[19] = (UINT8)131; // i-acute
-                String[21] = (UINT8)136; // c-caron
-              }
-            break;
-
-            case (FRENCH):
-              if (FlashConfig.TimeDisplayMode == H12)
-              {
-                sprintf(String, "Format d'affichage de l'heure: 12 heures");
-              }
-              else
-              {
-                sprintf(String, "Format d'affichage de l'heure: 24 heures");
-              }
-            break;
-
-            case (SPANISH):
-              if (FlashConfig.TimeDisplayMode == H12)
-              {
-                sprintf(String, "Formato de visualizacion de la hora: 12 horas");
-                String[22] = (UINT8)139; // o-acute
-              }
-              else
-              {
-                sprintf(String, "Formato de visualizacion de la hora: 24 horas");
-                String[22] = (UINT8)139; // o-acute
-              }
-            break;
-
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.TimeDisplayMode == H12)
-              {
-                sprintf(String, "Time display format: 12-hours");
-              }
-              else
-              {
-                sprintf(String, "Time display format: 24-hours");
-              }
-            break;
-          }
+          sprintf(String, msg(MSG_TIME_FORMAT), (FlashConfig.TimeDisplayMode == H12) ? 12 : 24);
           scroll_string(24, String);
         break;
 
         case (0x0C): // SETUP_HOURLY_CHIME
           /* Hourly chime. */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              if (FlashConfig.ChimeMode == CHIME_OFF)
-              {
-                sprintf(String, "Hodinovy zvuk je vypnut.");
-                String[7] = (UINT8)132; // y-acute
-              }
-              else if (FlashConfig.ChimeMode == CHIME_ON)
-              {
-                sprintf(String, "Hodinovy zvuk je zapnut.");
-                String[7] = (UINT8)132; // y-acute
-              }
-              else if (FlashConfig.ChimeMode == CHIME_DAY)
-              {
-                sprintf(String, "Hodinovy zvuk zapnut jen od %u:00 do %u:00.", FlashConfig.ChimeTimeOn, FlashConfig.ChimeTimeOff);
-                String[7] = (UINT8)132; // y-acute
-              }
-            break;
-
-            case (FRENCH):
-              if (FlashConfig.ChimeMode == CHIME_OFF)
-              {
-                sprintf(String, "Le signal horaire est a Off");
-              }
-              else if (FlashConfig.ChimeMode == CHIME_ON)
-              {
-                sprintf(String, "Le signal horaire est a On");
-              }
-              else if (FlashConfig.ChimeMode == CHIME_DAY)
-              {
-                sprintf(String, "Le signal horaire est intermittent, de %u:00 a %u:00", FlashConfig.ChimeTimeOn, FlashConfig.ChimeTimeOff);
-              }
-            break;
-
-            case (SPANISH):
-              if (FlashConfig.ChimeMode == CHIME_OFF)
-              {
-                sprintf(String, "El timbre cada hora esta desactivado");
-                String[23] = (UINT8)129; // a-acute
-              }
-              else if (FlashConfig.ChimeMode == CHIME_ON)
-              {
-                sprintf(String, "El timbre cada hora esta activado");
-                String[23] = (UINT8)129; // a-acute
-              }
-              else if (FlashConfig.ChimeMode == CHIME_DAY)
-              {
-                sprintf(String, "El timbre cada hora esta en intermitente, de %u:00 a %u:00", FlashConfig.ChimeTimeOn, FlashConfig.ChimeTimeOff);
-                String[23] = (UINT8)129; // a-acute
-              }
-            break;
-
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.ChimeMode == CHIME_OFF)
-              {
-                sprintf(String, "Hourly chime is Off");
-              }
-              else if (FlashConfig.ChimeMode == CHIME_ON)
-              {
-                sprintf(String, "Hourly chime is On");
-              }
-              else if (FlashConfig.ChimeMode == CHIME_DAY)
-              {
-                sprintf(String, "Hourly chime is intermittent, from %u:00 to %u:00", FlashConfig.ChimeTimeOn, FlashConfig.ChimeTimeOff);
-              }
-            break;
-          }
+          if (FlashConfig.ChimeMode == CHIME_OFF)
+            strcpy(String, msg(MSG_CHIME_OFF));
+          else if (FlashConfig.ChimeMode == CHIME_ON)
+            strcpy(String, msg(MSG_CHIME_ON));
+          else if (FlashConfig.ChimeMode == CHIME_DAY)
+            sprintf(String, msg(MSG_CHIME_DAY), FlashConfig.ChimeTimeOn, FlashConfig.ChimeTimeOff);
           scroll_string(24, String);
         break;
 
         case (0x0F): // SETUP_NIGHT_LIGHT
           /* Night light. */
-          switch (FlashConfig.Language)
-          {
-           case (CZECH):
-              if (FlashConfig.NightLightMode == NIGHT_LIGHT_OFF)
-              {
-                sprintf(String, "Nocni svetlo je vypnuto.");
-                String[3] = (UINT8)136; // c-caron
-                String[4] = (UINT8)131; // i-acute
-                String[8] = (UINT8)130; // e-caron
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_ON)
-              {
-                sprintf(String, "Nocni svetlo je zapnuto.");
-                String[3] = (UINT8)136; // c-caron
-                String[4] = (UINT8)131; // i-acute
-                String[8] = (UINT8)130; // e-caron
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_NIGHT)
-              {
-                sprintf(String, "Nocni svetlo zapnuto jen od %u:00 do %u:00.", FlashConfig.NightLightTimeOn, FlashConfig.NightLightTimeOff);
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_AUTO)
-              {
-                sprintf(String, "Nocni svetlo je zapnuto automaticky.");
-              }
-            break;
- 
-           case (FRENCH):
-              if (FlashConfig.NightLightMode == NIGHT_LIGHT_OFF)
-              {
-                sprintf(String, "La veilleuse de nuit est a Off");
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_ON)
-              {
-                sprintf(String, "La veilleuse de nuit est a On");
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_NIGHT)
-              {
-                sprintf(String, "La veilleuse de nuit est intermittente, de %u:00 a %u:00", FlashConfig.NightLightTimeOn, FlashConfig.NightLightTimeOff);
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_AUTO)
-              {
-                sprintf(String, "La veilleuse de nuit est automatique");
-              }
-            break;
- 
-           case (SPANISH):
-              if (FlashConfig.NightLightMode == NIGHT_LIGHT_OFF)
-              {
-                sprintf(String, "La luz nocturna esta desactivado");
-                String[19] = (UINT8)129; // a-acute
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_ON)
-              {
-                sprintf(String, "La luz nocturna esta activado");
-                String[19] = (UINT8)129; // a-acute
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_NIGHT)
-              {
-                sprintf(String, "La luz nocturna esta en intermitente, de %u:00 a %u:00", FlashConfig.NightLightTimeOn, FlashConfig.NightLightTimeOff);
-                String[19] = (UINT8)129; // a-acute
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_AUTO)
-              {
-                sprintf(String, "La luz nocturna esta en automatica");
-                String[19] = (UINT8)129; // a-acute
-                String[29] = (UINT8)129; // a-acute
-              }
-            break;
- 
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.NightLightMode == NIGHT_LIGHT_OFF)
-              {
-                sprintf(String, "Night light is Off");
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_ON)
-              {
-                sprintf(String, "Night light is On");
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_NIGHT)
-              {
-                sprintf(String, "Night light is intermittent, from %u:00 to %u:00", FlashConfig.NightLightTimeOn, FlashConfig.NightLightTimeOff);
-              }
-              else if (FlashConfig.NightLightMode == NIGHT_LIGHT_AUTO)
-              {
-                sprintf(String, "Night light is automatic");
-              }
-            break;
-          }
+          if (FlashConfig.NightLightMode == NIGHT_LIGHT_OFF)
+            strcpy(String, msg(MSG_NIGHT_LIGHT_OFF));
+          else if (FlashConfig.NightLightMode == NIGHT_LIGHT_ON)
+            strcpy(String, msg(MSG_NIGHT_LIGHT_ON));
+          else if (FlashConfig.NightLightMode == NIGHT_LIGHT_NIGHT)
+            sprintf(String, msg(MSG_NIGHT_LIGHT_NIGHT), FlashConfig.NightLightTimeOn, FlashConfig.NightLightTimeOff);
+          else if (FlashConfig.NightLightMode == NIGHT_LIGHT_AUTO)
+            strcpy(String, msg(MSG_NIGHT_LIGHT_AUTO));
           scroll_string(24, String);
         break;
 
         case (0x12): // SETUP_AUTO_BRIGHT
           /* Light level. */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              if (FlashConfig.FlagAutoBrightness == FLAG_ON)
-              {
-                sprintf(String, "zobrazeni");
-                String[9] = (UINT8)131;  // i-acute
-                sprintf(String, "Automaticke nastaveni jasu je zapnuto. Jas: %u   hystereze: %u   %s: %u%c.", adc_read_light(), AverageLightLevel, String, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-                String[10] = (UINT8)138;  // e-acute
-                String[20] = (UINT8)131;  // i-acute
-              }
-              else
-              {
-                sprintf(String, "Automaticke nastaveni jasu je vypnuto.");
-                String[10] = (UINT8)138;  // e-acute
-                String[20] = (UINT8)131;  // i-acute
-              }
-            break;
- 
-            case (FRENCH):
-              if (FlashConfig.FlagAutoBrightness == FLAG_ON)
-              {
-                sprintf(String, "Intensite automatique est a On   Luminosite: %u   Hysteresis: %u   Affichage: %u%c", adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-                String[8]  = (UINT8)31;  // e accent aigu.
-                String[41] = (UINT8)31;  // e accent aigu.
-              }
-              else
-              {
-                sprintf(String, "Intensite automatique est a Off");
-                String[8] = (UINT8)31; // e accent aigu.
-              }
-            break;
- 
-            case (SPANISH):
-              if (FlashConfig.FlagAutoBrightness == FLAG_ON)
-              {
-                sprintf(String, "Intensidad automatica esta activada   Luminosidad: %u   Hysteresis: %u   Monitor: %u%c", adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-                String[16] = (UINT8)129; // a-acute
-                String[25] = (UINT8)129; // a-acute
-              }
-              else
-              {
-                sprintf(String, "Intensidad automatica esta desactivada");
-                String[16] = (UINT8)129; // a-acute
-                String[25] = (UINT8)129; // a-acute
-              }
-            break;
- 
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.FlagAutoBrightness == FLAG_ON)
-              {
-                sprintf(String, "Auto brightness is On   Light level: %u   Hysteresis: %u   Display: %u%c", adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-              }
-              else
-              {
-                sprintf(String, "Auto brightness is Off");
-              }
-            break;
-         }
+          if (FlashConfig.FlagAutoBrightness == FLAG_ON)
+            sprintf(String, msg(MSG_AUTO_BRIGHTNESS_ON), adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle);
+          else
+            strcpy(String, msg(MSG_AUTO_BRIGHTNESS_OFF));
          scroll_string(24, String);
 
         break;
@@ -9023,113 +9448,34 @@ void process_ir_command(UINT8 IrCommand)
   if (IrCommand == IR_DISPLAY_EVENTS_TODAY)
   {
     // scroll_string(24, "Button 'Over': Events today");
-    Dum1UInt8 = 0;
-    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_EVENTS; ++Loop1UInt8)
+    Dum1UInt8 = event_list(CurrentYear, CurrentMonth, CurrentDayOfMonth, EventList);
+    for (Loop1UInt16 = 0; Loop1UInt16 < Dum1UInt8; ++Loop1UInt16)
     {
-      if ((CalendarEvent[Loop1UInt8].Month == CurrentMonth) && (CalendarEvent[Loop1UInt8].Day == CurrentDayOfMonth))
-      {
-        ++Dum1UInt8;
+      EventNumber = EventList[Loop1UInt16];
 
-        switch (FlashConfig.Language)
-        {
-          case (ENGLISH):
-          case (GERMAN):
-          default:
-            sprintf(String, "%s %u: %s   /   ", MonthName[FlashConfig.Language][CurrentMonth], CurrentDayOfMonth, CalendarEvent[Loop1UInt8].Description);
-          break;
+      switch (FlashConfig.Language)
+      {
+        case (ENGLISH):
+        case (GERMAN):
+        default:
+          sprintf(String, "%s %u: %s   /   ", MONTH_NAME(FlashConfig.Language, CurrentMonth), CurrentDayOfMonth, event_description(EventNumber));
+        break;
 
-          case (CZECH):
-          case (FRENCH):
-          case (SPANISH):
-            sprintf(String, "%u %s: %s   /   ", CurrentDayOfMonth, MonthName[FlashConfig.Language][CurrentMonth], CalendarEvent[Loop1UInt8].Description);
-          break;
-        }
-        scroll_string(24, String);
+        case (CZECH):
+        case (FRENCH):
+        case (SPANISH):
+          sprintf(String, "%u %s: %s   /   ", CurrentDayOfMonth, MONTH_NAME(FlashConfig.Language, CurrentMonth), event_description(EventNumber));
+        break;
       }
+      scroll_string(24, String);
     }
 
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-        if (Dum1UInt8 == 0)
-        {
-          sprintf(String, "Dnes zadna udalost.");
-          String[5]  = (UINT8)137;  // z-caron
-          String[6]  = (UINT8)129;  // a-acute
-          String[9]  = (UINT8)129;  // a-acute
-          String[13] = (UINT8)129;  // a-acute
-        }
-        else
-        {
-          if (Dum1UInt8 == 1)
-          {
-            sprintf(String, "Dnes 1 udalost.");
-            String[9] = (UINT8)129; // a-acute
-          }
-          else
-          {
-            sprintf(String, "udalosti");
-            String[2] = (UINT8)129; // a-acute
-            sprintf(String, "Dnes %u %s.", Dum1UInt8, String);
-          }
-        }
-      break;
-
-      case (FRENCH):
-        if (Dum1UInt8 == 0)
-        {
-          sprintf(String, "Aucun evenement aujourd'hui");
-          String[6] = (UCHAR)31; // e accent aigu.
-          String[8] = (UCHAR)31; // e accent aigu
-        }
-        else
-        {
-          if (Dum1UInt8 == 1)
-          {
-            sprintf(String, "1 evenement aujourd'hui");
-            String[2] = (UCHAR)31; // e accent aigu.
-            String[4] = (UCHAR)31; // e accent aigu
-          }
-          else
-          {
-            sprintf(String, "%u evenements aujourd'hui", Dum1UInt8);
-            String[strlen(String) - 20] = (UCHAR)31; // e accent aigu.
-            String[strlen(String) - 22] = (UCHAR)31; // e accent aigu
-          }
-        }
-      break;
-
-      case (SPANISH):
-        if (Dum1UInt8 == 0)
-        {
-          sprintf(String, "No hay eventos hoy");
-        }
-        else
-        {
-          if (Dum1UInt8 == 1)
-          {
-            sprintf(String, "Un evento hoy");
-          }
-          else
-          {
-            sprintf(String, "%u eventos hoy", Dum1UInt8);
-          }
-        }
-      break;
-
-      case (ENGLISH):
-      case (GERMAN):
-      default:
-        if (Dum1UInt8 == 0)
-          sprintf(String, "No event today");
-        else if (Dum1UInt8 == 1)
-          sprintf(String, "1 event today");
-        else
-        {
-          sprintf(String, "%u events today", Dum1UInt8);
-        }
-      break;
-    }
+    if (Dum1UInt8 == 0)
+      strcpy(String, msg(MSG_EVENTS_TODAY_NONE));
+    else if (Dum1UInt8 == 1)
+      strcpy(String, msg(MSG_EVENTS_TODAY_ONE));
+    else
+      sprintf(String, msg(MSG_EVENTS_TODAY), Dum1UInt8);
     scroll_string(24, String);
   }
 
@@ -9142,7 +9488,7 @@ void process_ir_command(UINT8 IrCommand)
     Dum1UInt8 = get_day_of_week(CurrentYear, CurrentMonth, CurrentDayOfMonth);
 
     if (DebugBitMask & DEBUG_EVENT)
-      uart_send(__LINE__, "Today is %s [DayOfWeek %u] %2u-%s-%4.4u\r", DayName[FlashConfig.Language][Dum1UInt8], Dum1UInt8, CurrentDayOfMonth, MonthName[FlashConfig.Language][CurrentMonth], CurrentYear);
+      uart_send(__LINE__, "Today is %s [DayOfWeek %u] %2u-%s-%4.4u\r", DAY_NAME(FlashConfig.Language, Dum1UInt8), Dum1UInt8, CurrentDayOfMonth, MONTH_NAME(FlashConfig.Language, CurrentMonth), CurrentYear);
     
     DumDayOfMonth = CurrentDayOfMonth;
     DumMonth      = CurrentMonth;
@@ -9167,13 +9513,13 @@ void process_ir_command(UINT8 IrCommand)
         Dum1UInt8 = get_day_of_week(DumYear, DumMonth, DumDayOfMonth);
         
         if (DebugBitMask & DEBUG_EVENT)
-          uart_send(__LINE__, "Back one day, to %8s [%u] %2u-%s-%4.4u\r", DayName[FlashConfig.Language][Dum1UInt8], Dum1UInt8, DumDayOfMonth, MonthName[FlashConfig.Language][DumMonth], DumYear);
+          uart_send(__LINE__, "Back one day, to %8s [%u] %2u-%s-%4.4u\r", DAY_NAME(FlashConfig.Language, Dum1UInt8), Dum1UInt8, DumDayOfMonth, MONTH_NAME(FlashConfig.Language, DumMonth), DumYear);
       } while (Dum1UInt8 != SUN);
     }
 
     /* Display date of the first day of the week (Sunday) that has been found. */
     if (DebugBitMask & DEBUG_EVENT)
-      uart_send(__LINE__, "Week beginning: %2u-%s-%4u\r", DumDayOfMonth, MonthName[FlashConfig.Language][DumMonth], DumYear);
+      uart_send(__LINE__, "Week beginning: %2u-%s-%4u\r", DumDayOfMonth, MONTH_NAME(FlashConfig.Language, DumMonth), DumYear);
 
     /* And display all events for each of the next seven days, starting with this Sunday. */
     Dum1UInt8 = 0;
@@ -9182,37 +9528,34 @@ void process_ir_command(UINT8 IrCommand)
     for (Loop1UInt8 = 0; Loop1UInt8 < 7; ++Loop1UInt8)
     {
       if (DebugBitMask & DEBUG_EVENT)
-        uart_send(__LINE__, "Checking date:  %2u-%s-%4.4u\r", DumDayOfMonth, MonthName[ENGLISH][DumMonth], DumYear);
+        uart_send(__LINE__, "Checking date:  %2u-%s-%4.4u\r", DumDayOfMonth, MONTH_NAME(ENGLISH, DumMonth), DumYear);
 
-      /* Check every calendar event to find a match with date under evaluation. */
-      for (Loop2UInt8 = 0; Loop2UInt8 < MAX_EVENTS; ++Loop2UInt8)
+      /* Get calendar events of the date under evaluation (calendar events index and recurrence rules). */
+      EventCount = event_list(DumYear, DumMonth, DumDayOfMonth, EventList);
+      for (Loop1UInt16 = 0; Loop1UInt16 < EventCount; ++Loop1UInt16)
       {
+        EventNumber = EventList[Loop1UInt16];
+
         if (DebugBitMask & DEBUG_EVENT)
-          uart_send(__LINE__, "Checking event number %2u  %2llu %10s [%s]\r", Loop2UInt8, CalendarEvent[Loop2UInt8].Day, MonthName[ENGLISH][CalendarEvent[Loop2UInt8].Month], CalendarEvent[Loop2UInt8].Description);
+          uart_send(__LINE__, "Match found: event number %2u  %2u-%s [%s]\r", EventNumber, DumDayOfMonth, MONTH_NAME(ENGLISH, DumMonth), event_description(EventNumber));
 
-        if ((CalendarEvent[Loop2UInt8].Month == DumMonth) && (CalendarEvent[Loop2UInt8].Day == DumDayOfMonth))
+        switch (FlashConfig.Language)
         {
-          if (DebugBitMask & DEBUG_EVENT)
-            uart_send(__LINE__, "Match found !\r");
-
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-            case (FRENCH):
-            case (SPANISH):
-              sprintf(String, "%u %s: %s   /   ", DumDayOfMonth, MonthName[FlashConfig.Language][DumMonth], CalendarEvent[Loop2UInt8].Description);
-            break;
- 
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              sprintf(String, "%s %u: %s   /   ", MonthName[FlashConfig.Language][DumMonth], DumDayOfMonth, CalendarEvent[Loop2UInt8].Description);
-            break;
-          }
-          scroll_string(24, String);
+          case (CZECH):
+          case (FRENCH):
+          case (SPANISH):
+            sprintf(String, "%u %s: %s   /   ", DumDayOfMonth, MONTH_NAME(FlashConfig.Language, DumMonth), event_description(EventNumber));
+          break;
 
-          ++Dum1UInt8;
+          case (ENGLISH):
+          case (GERMAN):
+          default:
+            sprintf(String, "%s %u: %s   /   ", MONTH_NAME(FlashConfig.Language, DumMonth), DumDayOfMonth, event_description(EventNumber));
+          break;
         }
+        scroll_string(24, String);
+
+        ++Dum1UInt8;
       }
 
       /* Check next date. */
@@ -9229,98 +9572,12 @@ void process_ir_command(UINT8 IrCommand)
       }
     }
 
-    switch (FlashConfig.Language)
-    {
-      case (CZECH):
-        if (Dum1UInt8 == 0)
-        {
-          sprintf(String, "   Tento tyden zadna udalost.");
-          String[10] = (UINT8)132; // y-acute
-          String[15] = (UINT8)137; // z-caron
-          String[16] = (UINT8)129; // a-acute
-          String[19] = (UINT8)129; // a-acute
-          String[23] = (UINT8)129; // a-acute
-        }
-        else
-        {
-          if (Dum1UInt8 == 1)
-          {
-            sprintf(String, "   Tento tyden 1 udalost.");
-            String[10] = (UINT8)132; // y-acute
-            String[15] = (UINT8)137; // z-caron
-            String[19] = (UINT8)129; // a-acute
-          }
-          else
-          {
-            sprintf(String, "udalosti");
-            String[2] = (UINT8)129; // a-acute
-            String[8] = (UINT8)131; // i-acute
-            sprintf(String, "   Tento tyden %u %s.", Dum1UInt8, String);
-            String[10] = (UINT8)132; // y-acute
-         }
-        }
-      break;
-
-      case (FRENCH):
-        if (Dum1UInt8 == 0)
-        {
-          sprintf(String, "   Aucun evenement cette semaine");
-          String[9]  = (UCHAR)31; // e accent aigu.
-          String[11] = (UCHAR)31; // e accent aigu
-        }
-        else
-        {
-          if (Dum1UInt8 == 1)
-          {
-            sprintf(String, "   1 evenement cette semaine");
-            String[5] = (UCHAR)31; // e accent aigu.
-            String[7] = (UCHAR)31; // e accent aigu
-          }
-          else
-          {
-            sprintf(String, "   %u evenements cette semaine", Dum1UInt8);
-            String[strlen(String) - 22] = (UCHAR)31; // e accent aigu.
-            String[strlen(String) - 24] = (UCHAR)31; // e accent aigu
-          }
-        }
-      break;
-
-      case (SPANISH):
-        if (Dum1UInt8 == 0)
-        {
-          sprintf(String, "   No hay eventos esta semana");
-        }
-        else
-        {
-          if (Dum1UInt8 == 1)
-          {
-            sprintf(String, "   1 evento esta semana");
-          }
-          else
-          {
-            sprintf(String, "   %u eventos esta semana", Dum1UInt8);
-          }
-        }
-      break;
-
-      case (ENGLISH):
-      case (GERMAN):
-      default:
-        if (Dum1UInt8 == 0)
-          sprintf(String, "   No event this week");
-        else
-        {
-          if (Dum1UInt8 == 1)
-          {
-            sprintf(String, "   1 event this week");
-          }
-          else
-          {
-            sprintf(String, "   %u events this week", Dum1UInt8);
-          }
-        }
-      break;
-    }
+    if (Dum1UInt8 == 0)
+      strcpy(String, msg(MSG_EVENTS_WEEK_NONE));
+    else if (Dum1UInt8 == 1)
+      strcpy(String, msg(MSG_EVENTS_WEEK_ONE));
+    else
+      sprintf(String, msg(MSG_EVENTS_WEEK), Dum1UInt8);
     scroll_string(24, String);
   }
 
@@ -9387,6 +9644,10 @@ void process_scroll_queue(void)
 
   UINT16 Loop1UInt16;
 
+  UINT32 Dum1UInt32;
+  UINT32 Dum2UInt32;
+  UINT32 Dum3UInt32;
+
   UINT64 CurrentTimeStamp;
 
   int Dum1Int;
@@ -9418,14 +9679,14 @@ void process_scroll_queue(void)
              exists with a description "Info", this code will not interfere with normal clock behavior. This tag may be
              triggered while running in ISR context and execution will executed in main() context, giving more time to
              execute whatever process we want to perform. The same apply to TAG_DEBUG who may be called from ISR's. */
-    if (strcmp(CalendarEvent[Tag].Description, "Info") == 0) Tag = TAG_INFO;
+    if ((Tag < EventTotal) && (strcmp(event_description(Tag), "Info") == 0)) Tag = TAG_INFO;
 
     
-    /* When Tag number is lower than MAX_EVENTS, it means to scroll a Calendar Event. */
-    if (Tag < MAX_EVENTS)
+    /* When Tag number is lower than the number of calendar events, it means to scroll a Calendar Event. */
+    if (Tag < EventTotal)
     {
       /* We must scroll a Calendar Event. */
-      scroll_string(24, CalendarEvent[Tag].Description);
+      scroll_string(24, event_description(Tag));
       
       while (ScrollDotCount)
         sleep_ms(100);  // wait until scrolling is over.
@@ -9437,27 +9698,7 @@ void process_scroll_queue(void)
       {
           case (TAG_AMBIENT_LIGHT):
           /* If we are not currently in setup mode, display ambient light. */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              sprintf(String, "Jas: %u   hystereze: %u   displej: %u%c.    ", adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-            break;
-
-            case (FRENCH):
-              sprintf(String, "Luminosite: %u   Hysteresis: %u   Affichage: %u%c    ", adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-              String[9] = (UINT8)31; // e accent aigu.
-            break;
-
-            case (SPANISH):
-              sprintf(String, "Luminosidad: %u   Hysteresis: %u   Monitor: %u%c    ", adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-            break;
-
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              sprintf(String, "Ambient light: %u   Hysteresis: %u   Display: %u%c    ", adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle, '%');
-            break;
-          }
+          sprintf(String, msg(MSG_AMBIENT_LIGHT), adc_read_light(), AverageLightLevel, Pwm[PWM_BRIGHTNESS].DutyCycle);
           scroll_string(24, String);
         break;
 
@@ -9487,56 +9728,11 @@ void process_scroll_queue(void)
           \* -------------------------------------------------------------------- */
           if (bme280_get_temp() == 0)
           {
-            // Build-up the string to be scrolled, first with temperature...
+            // Build-up the string to be scrolled, with temperature in Celsius or in Fahrenheit.
             if (FlashConfig.TemperatureUnit == CELSIUS)
-            {
-              // ...in Celsius.
-              switch (FlashConfig.Language)
-              {
-                case (CZECH):
-                  sprintf(String, "Venku: %2.2f %cC, %2.2f %%, %4.2f hPa.", Bme280Data.TemperatureC, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                 break;
-
-                case (FRENCH):
-                  sprintf(String, "Ext: %2.2f%cC  Hum: %2.2f%%  Pression: %4.2f hPa ", Bme280Data.TemperatureC, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                break;
-
-                case (SPANISH):
-                  sprintf(String, "Ext: %2.2f%cC  Hum: %2.2f%%  Presion: %4.2f hPa ", Bme280Data.TemperatureC, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                  String[34] = (UINT8)139; // o-acute
-                break;
-
-                case (ENGLISH):
-                default:
-                  sprintf(String, "Out: %2.2f%cC  Hum: %2.2f%%  Pressure: %4.2f hPa ", Bme280Data.TemperatureC, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                break;
-
-              }
-            }
+              sprintf(String, msg(MSG_BME280_TEMP), Bme280Data.TemperatureC, 0x80, 'C', Bme280Data.Humidity, Bme280Data.Pressure);
             else
-            {
-              // ...or in Fahrenheit.
-              switch (FlashConfig.Language)
-              {
-                case (CZECH):
-                  sprintf(String, "Venku: %2.2f %cF, %2.2f %%, %4.2f hPa.", Bme280Data.TemperatureF, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                break;
-
-                case (FRENCH):
-                  sprintf(String, "Ext: %2.2f%cF  Hum: %2.2f%%  Pression: %4.2f hPa ", Bme280Data.TemperatureF, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                break;
-
-                case (SPANISH):
-                  sprintf(String, "Ext: %2.2f%cF  Hum: %2.2f%%  Presion: %4.2f hPa ", Bme280Data.TemperatureF, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                  String[34] = (UINT8)139; // o-acute
-                break;
-
-                case (ENGLISH):
-                default:
-                  sprintf(String, "Out: %2.2f%cF  Hum: %2.2f%%  Pressure: %4.2f hPa ", Bme280Data.TemperatureF, 0x80, Bme280Data.Humidity, Bme280Data.Pressure);
-                break;
-              }
-            }
+              sprintf(String, msg(MSG_BME280_TEMP), Bme280Data.TemperatureF, 0x80, 'F', Bme280Data.Humidity, Bme280Data.Pressure);
 
 
             if (DebugBitMask & DEBUG_BME280)
@@ -9701,336 +9897,19 @@ void process_scroll_queue(void)
              No support = No DST support at all.
              Inactive   = DST is supported, but we are not during DST period of the year.
              Active     = DST is supported and we are during DST period of the year. */
-          switch (FlashConfig.Language)
+          if (FlashConfig.DSTCountry == DST_NONE)
           {
-            case (CZECH):
-              if (FlashConfig.DSTCountry == DST_NONE)
-              {
-                sprintf(String, "Funkce letniho casu je vypnuta.");
-                String[11] = (UINT8)131; // i-acute
-                String[15] = (UINT8)136; // c-caron
-              }
-              else
-              {
-                switch(FlashConfig.DSTCountry)
-                {
-                  case (DST_AUSTRALIA):
-                    sprintf(String, "Letni cas: Australie");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                    String[16] = (UINT8)129; // a-acute
-                  break;
-
-                  case (DST_AUSTRALIA_HOWE):
-                    sprintf(String, "Letni cas: Australie Howe");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                    String[16] = (UINT8)129; // a-acute
-                  break;
-
-                  case (DST_CHILE):
-                    sprintf(String, "Letni cas: Cile");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                    String[12] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_CUBA):
-                    sprintf(String, "Letni cas: Kuba");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_EUROPE):
-                    sprintf(String, "Letni cas: Evropa");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_ISRAEL):
-                    sprintf(String, "Letni cas: Izrael");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_LEBANON):
-                    sprintf(String, "Letni cas: Libanon");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_MOLDOVA):
-                    sprintf(String, "Letni cas: Moldavie");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_NEW_ZEALAND):
-                    sprintf(String, "Letni cas: Novy Zeland");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_NORTH_AMERICA):
-                    sprintf(String, "Letni cas: Severni Amerika");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-
-                  case (DST_PALESTINE):
-                    sprintf(String, "Letni cas: Palestina");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                 break;
-
-                  case (DST_PARAGUAY):
-                    sprintf(String, "Letni cas: Paraguay");
-                    String[4] = (UINT8)131; // i-acute
-                    String[6] = (UINT8)136; // c-caron
-                  break;
-                }
- 
-                /* Announce if Daylight Saving Time ("DST") is currently active or inactive, depending of current date. */
-                if (FlashConfig.FlagSummerTime == FLAG_ON)
-                {
-                  strcat(String, " - je letni cas    ");
-                  String[10] = (UINT8)131; // i-acute
-                  String[12] = (UINT8)136; // c-caron
-                }
-                else
-                {
-                  strcat(String, " - neni letni cas    ");
-                  String[6] = (UINT8)131; // i-acute
-                  String[12] = (UINT8)131; // i-acute
-                  String[14] = (UINT8)136; // c-caron
-                }
-              }
-            break;
- 
-            case (FRENCH):
-              if (FlashConfig.DSTCountry == DST_NONE)
-              {
-                sprintf(String, "Heure avancee non supportee    ");
-                String[11] = (UINT8)31;  // e accent aigu.
-                String[25] = (UINT8)31;  // e accent aigu.
-              }
-              else
-              {
-                switch(FlashConfig.DSTCountry)
-                {
-                  case (DST_AUSTRALIA):
-                    sprintf(String, "Heure avancee: Australie");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_AUSTRALIA_HOWE):
-                    sprintf(String, "Heure avancee: Australie Howe");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_CHILE):
-                    sprintf(String, "Heure avancee: Chili");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                   break;
-
-                  case (DST_CUBA):
-                    sprintf(String, "Heure avancee: Cuba");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_EUROPE):
-                    sprintf(String, "Heure avancee: Europe");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_ISRAEL):
-                    sprintf(String, "Heure avancee: Israel");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_LEBANON):
-                    sprintf(String, "Heure avancee: Liban");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_MOLDOVA):
-                    sprintf(String, "Heure avancee: Moldavie");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_NEW_ZEALAND):
-                    sprintf(String, "Heure avancee: Nouvelle-Zelande");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                    String[25] = (UINT8)31;  // e accent aigu.
-                 break;
-
-                  case (DST_NORTH_AMERICA):
-                    sprintf(String, "Heure avancee: Amerique du Nord");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                    String[17] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_PALESTINE):
-                    sprintf(String, "Heure avancee: Palestine");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-
-                  case (DST_PARAGUAY):
-                    sprintf(String, "Heure avancee: Paraguay");
-                    String[11] = (UINT8)31;  // e accent aigu.
-                  break;
-                }
- 
-                /* Announce if Daylight Saving Time ("DST") is currently active or inactive, depending of current date. */
-                if (FlashConfig.FlagSummerTime == FLAG_ON)
-                {
-                  strcat(String, "- active    ");
-                }
-                else
-                {
-                  strcat(String, "- inactive    ");
-                }
-              }
-            break;
- 
-            case (SPANISH):
-              if (FlashConfig.DSTCountry == DST_NONE)
-              {
-                sprintf(String, "Horario de verano no compatible    ");
-              }
-              else
-              {
-                switch(FlashConfig.DSTCountry)
-                {
-                  case (DST_AUSTRALIA):
-                    sprintf(String, "Horario de verano: Australia");
-                  break;
-
-                  case (DST_AUSTRALIA_HOWE):
-                    sprintf(String, "Horario de verano: Australia Howe");
-                  break;
-
-                  case (DST_CHILE):
-                    sprintf(String, "Horario de verano: Chile");
-                   break;
-
-                  case (DST_CUBA):
-                    sprintf(String, "Horario de verano: Cuba");
-                  break;
-
-                  case (DST_EUROPE):
-                    sprintf(String, "Horario de verano: Europa");
-                  break;
-
-                  case (DST_ISRAEL):
-                    sprintf(String, "Horario de verano: Israel");
-                  break;
-
-                  case (DST_LEBANON):
-                    sprintf(String, "Horario de verano: Libano");
-                    String[20] = (UINT8)131;  // i-acute.
-                  break;
-
-                  case (DST_MOLDOVA):
-                    sprintf(String, "Horario de verano: Moldova");
-                  break;
-
-                  case (DST_NEW_ZEALAND):
-                    sprintf(String, "Horario de verano: Nueva Zelandia");
-                 break;
-
-                  case (DST_NORTH_AMERICA):
-                    sprintf(String, "Horario de verano: America del Norte");
-                    String[21] = (UINT8)31;  // e-acute
-                  break;
-
-                  case (DST_PALESTINE):
-                    sprintf(String, "Horario de verano: Palestina");
-                  break;
-
-                  case (DST_PARAGUAY):
-                    sprintf(String, "Horario de verano: Paraguay");
-                  break;
-                }
- 
-                /* Announce if Daylight Saving Time ("DST") is currently active or inactive, depending of current date. */
-                if (FlashConfig.FlagSummerTime == FLAG_ON)
-                {
-                  strcat(String, "- activado    ");
-                }
-                else
-                {
-                  strcat(String, "- desactivado    ");
-                }
-              }
-            break;
- 
-            case (ENGLISH):
-            default:
-              if (FlashConfig.DSTCountry == DST_NONE)
-              {
-                sprintf(String, "No support for daylight saving time    ");
-              }
-              else
-              {
-                switch(FlashConfig.DSTCountry)
-                {
-                  case (DST_AUSTRALIA):
-                    sprintf(String, "DST setting: Australia");
-                  break;
-
-                  case (DST_AUSTRALIA_HOWE):
-                    sprintf(String, "DST setting: Australia Howe");
-                  break;
-
-                  case (DST_CHILE):
-                    sprintf(String, "DST setting: Chile");
-                  break;
-
-                  case (DST_CUBA):
-                    sprintf(String, "DST setting: Cuba");
-                  break;
-
-                  case (DST_EUROPE):
-                    sprintf(String, "DST setting: Europe");
-                  break;
-
-                  case (DST_ISRAEL):
-                    sprintf(String, "DST setting: Israel");
-                  break;
-
-                  case (DST_LEBANON):
-                    sprintf(String, "DST setting: Lebanon");
-                  break;
-
-                  case (DST_MOLDOVA):
-                    sprintf(String, "DST setting: Moldova");
-                  break;
-
-                  case (DST_NEW_ZEALAND):
-                    sprintf(String, "DST setting: New Zealand");
-                  break;
-
-                  case (DST_NORTH_AMERICA):
-                    sprintf(String, "DST setting: North America");
-                  break;
-
-                  case (DST_PALESTINE):
-                    sprintf(String, "DST setting: Palestine");
-                  break;
-
-                  case (DST_PARAGUAY):
-                    sprintf(String, "DST setting: Paraguay");
-                  break;
-                }
+            strcpy(String, msg(MSG_DST_NONE));
+          }
+          else
+          {
+            sprintf(String, msg(MSG_DST_SETTING), DST_NAME(FlashConfig.Language, FlashConfig.DSTCountry));
 
-                /* Announce if Daily Saving Time ("DST") is currently active or inactive, depending of current date. */
-                if (FlashConfig.FlagSummerTime == FLAG_ON)
-                  strcat(String, " - DST active    ");
-                else
-                  strcat(String, " - DST inactive    ");
-              }
-            break;
+            /* Announce if Daylight Saving Time ("DST") is currently active or inactive, depending of current date. */
+            if (FlashConfig.FlagSummerTime == FLAG_ON)
+              strcat(String, msg(MSG_DST_ACTIVE));
+            else
+              strcat(String, msg(MSG_DST_INACTIVE));
           }
           scroll_string(24, String);
         break;
@@ -10038,51 +9917,31 @@ void process_scroll_queue(void)
 
 
         case (TAG_FIRMWARE_VERSION):
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              sprintf(String, "UPico Green Clock - verze firmwaru %s    ", FIRMWARE_VERSION);
-            break;
-
-            case (ENGLISH):
-            case (GERMAN):
-            default:
-              sprintf(String, "Pico Green Clock - Firmware Version %s    ", FIRMWARE_VERSION);
-            break;
-
-            case (FRENCH):
-              sprintf(String, "Pico Green Clock - Microcode Version %s    ", FIRMWARE_VERSION);
-            break;
-
-            case (SPANISH):
-              sprintf(String, "Pico Green Clock - Version del firmware %s    ", FIRMWARE_VERSION);
-              String[24] = (UINT8)139; // o-acute
-            break;
-          }
+          sprintf(String, msg(MSG_FIRMWARE_VERSION), FIRMWARE_VERSION);
           scroll_string(24, String);
         break;
 
 
 
         case (TAG_IDLE_MONITOR):
-          switch (FlashConfig.Language)
+          /* Evaluate lowest, average and highest system idle monitor over the history available (up to two hours). */
+          Dum1UInt32 = 0xFFFFFFFF;
+          Dum2UInt32 = 0;
+          Dum3UInt32 = 0;
+          for (Loop1UInt8 = 0; Loop1UInt8 < IdleHistoryCount; ++Loop1UInt8)
           {
-            case (CZECH):
-              sprintf(String, "Vytizeni: %llu    ", IdleMonitor[13]);
-              String[3] = (UINT8)131; // i-acute
-              String[4] = (UINT8)137; // z-caron
-              String[8] = (UINT8)131; // i-acute
-            break;
-            case (SPANISH):
-              sprintf(String, "Monitor del tiempo de inactividad del sistema: %llu    ", IdleMonitor[13]);
-            break;
-            case (ENGLISH):
-            case (FRENCH):
-            case (GERMAN):
-            default:
-              sprintf(String, "System idle monitor: %llu    ", IdleMonitor[13]);
-            break;
+            if (IdleHistory[Loop1UInt8].Minimum < Dum1UInt32) Dum1UInt32 = IdleHistory[Loop1UInt8].Minimum;
+            if (IdleHistory[Loop1UInt8].Maximum > Dum3UInt32) Dum3UInt32 = IdleHistory[Loop1UInt8].Maximum;
+            Dum2UInt32 += IdleHistory[Loop1UInt8].Average;
           }
+          if (IdleHistoryCount == 0)
+            Dum1UInt32 = 0;
+          else
+            Dum2UInt32 /= IdleHistoryCount;
+
+          if (DebugBitMask & DEBUG_IDLE_MONITOR) idle_history_display();
+
+          sprintf(String, msg(MSG_IDLE_MONITOR), IdleMonitor[13], IdleHistoryCount, Dum1UInt32, Dum2UInt32, Dum3UInt32);
           scroll_string(24, String);
         break;
 
@@ -10105,38 +9964,38 @@ void process_scroll_queue(void)
                 else
                   strcat(String, "0");
               }
-              sprintf(&String[strlen(String)], "   %s\r", DayName[FlashConfig.Language][Loop1UInt8]);
+              sprintf(&String[strlen(String)], "   %s\r", DAY_NAME(FlashConfig.Language, Loop1UInt8));
               uart_send(__LINE__, String);
             }
 
 
-            /* Scan all alarms (0 to 8). */
-            for (Loop1UInt8 = 0; Loop1UInt8 < 9; ++Loop1UInt8)
+            /* Scan all alarms (0 to 63). */
+            for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
             {
-              uart_send(__LINE__, "[%X] Alarm[%2.2u].Status:         0x%2.2X     (00 = Off   FF = On)\r", &FlashConfig.Alarm[Loop1UInt8].FlagStatus, Loop1UInt8, FlashConfig.Alarm[Loop1UInt8].FlagStatus);
-              uart_send(__LINE__, "[%X] Alarm[%2.2u].Hour:            %3u\r", &FlashConfig.Alarm[Loop1UInt8].Hour, Loop1UInt8, FlashConfig.Alarm[Loop1UInt8].Hour);
-              uart_send(__LINE__, "[%X] Alarm[%2.2u].Minute:          %3u\r", &FlashConfig.Alarm[Loop1UInt8].Minute, Loop1UInt8, FlashConfig.Alarm[Loop1UInt8].Minute);
-              uart_send(__LINE__, "[%X] Alarm[%2.2u].Second:          %3u\r", &FlashConfig.Alarm[Loop1UInt8].Second, Loop1UInt8, FlashConfig.Alarm[Loop1UInt8].Second);
+              uart_send(__LINE__, "[%X] Alarm[%2.2u].Status:         0x%2.2X     (00 = Off   01 = On)\r", &Alarm[Loop1UInt8].FlagStatus, Loop1UInt8, Alarm[Loop1UInt8].FlagStatus);
+              uart_send(__LINE__, "[%X] Alarm[%2.2u].Hour:            %3u\r", &Alarm[Loop1UInt8].Hour, Loop1UInt8, Alarm[Loop1UInt8].Hour);
+              uart_send(__LINE__, "[%X] Alarm[%2.2u].Minute:          %3u\r", &Alarm[Loop1UInt8].Minute, Loop1UInt8, Alarm[Loop1UInt8].Minute);
+              uart_send(__LINE__, "[%X] Alarm[%2.2u].Second:          %3u\r", &Alarm[Loop1UInt8].Second, Loop1UInt8, Alarm[Loop1UInt8].Second);
           
               /* Identify all day-of-week targets for each alarm. */
               DayMask[0] = 0x00;  // initialize string as null.
               for (Loop2UInt8 = 7; Loop2UInt8 > 0; --Loop2UInt8)
               {
-                if (FlashConfig.Alarm[Loop1UInt8].Day & (1 << Loop2UInt8))
+                if (Alarm[Loop1UInt8].Day & (1 << Loop2UInt8))
                   strcat(DayMask, "1");
                 else
                   strcat(DayMask, "0");
               }
               strcat(DayMask, "0");  // add bit 0 since days-of-week go from 1 to 7 (1 being SUN and 7 being SAT)
-              sprintf(String, "[%X] Alarm[%2.2u].DayMask:     %s     (%X) ", &FlashConfig.Alarm[Loop1UInt8].Day, Loop1UInt8, DayMask, FlashConfig.Alarm[Loop1UInt8].Day);
+              sprintf(String, "[%X] Alarm[%2.2u].DayMask:     %s     (%X) ", &Alarm[Loop1UInt8].Day, Loop1UInt8, DayMask, Alarm[Loop1UInt8].Day);
 
               
               for (Loop2UInt8 = 1; Loop2UInt8 < 8; ++Loop2UInt8)
               {
-                if (FlashConfig.Alarm[Loop1UInt8].Day & (1 << Loop2UInt8))
+                if (Alarm[Loop1UInt8].Day & (1 << Loop2UInt8))
                 {
                   Dum1UInt8 = strlen(String);
-                  sprintf(&String[strlen(String)], "%s", DayName[FlashConfig.Language][Loop2UInt8]);
+                  sprintf(&String[strlen(String)], "%s", DAY_NAME(FlashConfig.Language, Loop2UInt8));
                   String[Dum1UInt8 + 3] = 0x20;  // space separator.
                   String[Dum1UInt8 + 4] = 0x00;  // keep first 3 characters of day name.
                 }
@@ -10155,25 +10014,7 @@ void process_scroll_queue(void)
           /* Scroll total number of NTP errors so far. */
           if (NTPData.NTPErrors)
           {
-            switch (FlashConfig.Language)
-            {
-              case (CZECH):
-                sprintf(String, "Chyba NTP: %lu/%lu.   ", NTPData.NTPErrors);
-              break;
-
-              case (FRENCH):
-                sprintf(String, "Erreurs NTP: %lu/%lu   ", NTPData.NTPErrors);
-              break;
-
-              case (SPANISH):
-                sprintf(String, "Errores NTP: %lu/%lu   ", NTPData.NTPErrors);
-              break;
-
-              case (ENGLISH):
-              default:
-                sprintf(String, "NTP errors: %lu   ", NTPData.NTPErrors);
-              break;
-            }
+            sprintf(String, msg(MSG_NTP_ERRORS), NTPData.NTPErrors);
             scroll_string(24, String);
           }
         break;
@@ -10185,25 +10026,7 @@ void process_scroll_queue(void)
         #ifdef DEVELOPER_VERSION
         case (TAG_NTP_STATUS):
           /* Scroll total number of NTP request failures so far. */
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              sprintf(String, "Stav NTP: %lu/%lu.   ", NTPData.NTPErrors, NTPData.NTPReadCycles);
-            break;
-
-            case (FRENCH):
-              sprintf(String, "Statut NTP: %lu/%lu   ", NTPData.NTPErrors, NTPData.NTPReadCycles);
-            break;
-
-            case (SPANISH):
-              sprintf(String, "Status NTP: %lu/%lu   ", NTPData.NTPErrors, NTPData.NTPReadCycles);
-            break;
-
-            case (ENGLISH):
-            default:
-              sprintf(String, "NTP status: %lu/%lu   ", NTPData.NTPErrors, NTPData.NTPReadCycles);
-            break;
-          }
+          sprintf(String, msg(MSG_NTP_STATUS), NTPData.NTPErrors, NTPData.NTPReadCycles);
           scroll_string(24, String);
         break;
         #endif  // DEVELOPER_VERSION
@@ -10211,104 +10034,19 @@ void process_scroll_queue(void)
 
 
 
-        case (TAG_PICO_TEMP):
-          adc_read_pico_temp(&DegreeC, &DegreeF);
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              if (FlashConfig.TemperatureUnit == CELSIUS)
-              {
-                /* ...in Celsius. */
-                sprintf(String, "Pico tep.: %2.2f %cC    ", DegreeC, 0x80);
-              }    
-              else
-              {
-                /* ...or in Fahrenheit. */
-                sprintf(String, "Pico tep: %2.2f%cF    ", DegreeF, 0x80);
-              }
-            break;
-
-            case (SPANISH):
-              if (FlashConfig.TemperatureUnit == CELSIUS)
-              {
-                /* ...in Celsius. */
-                sprintf(String, "Temp. de la Pico: %2.2f%cC    ", DegreeC, 0x80);
-              }    
-              else
-              {
-                /* ...or in Fahrenheit. */
-                sprintf(String, "Temp de la Pico: %2.2f%cF    ", DegreeF, 0x80);
-              }
-            break;
-
-            case (ENGLISH):
-            case (FRENCH):
-            case (GERMAN):
-            default:
-              if (FlashConfig.TemperatureUnit == CELSIUS)
-              {
-                /* ...in Celsius. */
-                sprintf(String, "Pico temp: %2.2f%cC    ", DegreeC, 0x80);
-              }    
-              else
-              {
-                /* ...or in Fahrenheit. */
-                sprintf(String, "Pico temp: %2.2f%cF    ", DegreeF, 0x80);
-              }
-            break;
-          }
+        case (TAG_PICO_TEMP):
+          adc_read_pico_temp(&DegreeC, &DegreeF);
+          if (FlashConfig.TemperatureUnit == CELSIUS)
+            sprintf(String, msg(MSG_PICO_TEMP), DegreeC, 0x80, 'C');
+          else
+            sprintf(String, msg(MSG_PICO_TEMP), DegreeF, 0x80, 'F');
          scroll_string(24, String);
         break;
 
 
 
         case (TAG_PICO_TYPE):
-          if (PicoType == TYPE_PICO)
-          {
-            switch (FlashConfig.Language)
-            {
-              case (CZECH):
-                sprintf(String, "mikrokontroler: Pico.    ");
-                String[12] = (UINT8)138; // e-acute
-              break;
- 
-              case (FRENCH):
-                sprintf(String, "Microcontroleur: Pico    ");
-              break;
- 
-              case (SPANISH):
-                sprintf(String, "Microcontrolador: Pico    ");
-              break;
- 
-              case (ENGLISH):
-              default:
-                sprintf(String, "Microcontroller: Pico    ");
-              break;
-            }
-          }
-          else
-          {
-            switch (FlashConfig.Language)
-            {
-              case (CZECH):
-                sprintf(String, "mikrokontroler: Pico W    ");
-                String[12] = (UINT8)138; // e-acute
-              break;
-
-              case (FRENCH):
-                sprintf(String, "Microcontroleur: Pico W    ");
-              break;
-
-              case (SPANISH):
-                sprintf(String, "Microcontrolador: Pico W   ");
-              break;
- 
-              case (ENGLISH):
-              default:
-                sprintf(String, "Microcontroller: Pico W    ");
-              break;
-            }
-          }
+          sprintf(String, msg(MSG_MICROCONTROLLER), (PicoType == TYPE_PICO) ? "Pico" : "Pico W");
           scroll_string(24, String);
         break;
 
@@ -10350,26 +10088,29 @@ void process_scroll_queue(void)
 
 
 
-       case (TAG_TIMEZONE):
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              sprintf(String, "casova zona: %d    ", FlashConfig.Timezone);
-              String[0] = (UINT8)136; // c-caron
-              String[5] = (UINT8)129; // a-acute
-              String[8] = (UINT8)139; // o-acute
-            break;
+        case (TAG_STACK):
+          /* For debug purposes. Display stack high-water marks (in bytes used / bytes available). */
+          stack_check();
+          if (DebugBitMask & DEBUG_STACK) stack_display();
 
-            case (SPANISH):
-              sprintf(String, "Zona horaria: %d    ", FlashConfig.Timezone);
-            break;
+          #ifdef DHT_SUPPORT
+          sprintf(String, "%sStack core0: %lu / %lu   core1: %lu / %lu    ", (FlagStackWarning == FLAG_ON) ? "!!! " : "", StackCore0Peak, (UINT32)&__StackTop - (UINT32)&__StackBottom, StackCore1Peak, (UINT32)&__StackOneTop - (UINT32)&__StackOneBottom);
+          #else  // DHT_SUPPORT
+          sprintf(String, "%sStack core0: %lu / %lu    ", (FlagStackWarning == FLAG_ON) ? "!!! " : "", StackCore0Peak, (UINT32)&__StackTop - (UINT32)&__StackBottom);
+          #endif  // DHT_SUPPORT
+          scroll_string(24, String);
+        break;
 
-            case (ENGLISH):
-            case (FRENCH):
-            default:
-              sprintf(String, "Timezone: %d    ", FlashConfig.Timezone);
-            break;
-          }
+
+
+       case (TAG_TIMEZONE):
+          /* Half-hour and quarter-hour timezones are shown as hours:minutes. */
+          if (FlashConfig.TimezoneMinutes == 0)
+            sprintf(TempString, "%d", FlashConfig.Timezone);
+          else
+            sprintf(TempString, "%s%d:%2.2d", ((FlashConfig.Timezone < 0) || (FlashConfig.TimezoneMinutes < 0)) ? "-" : "", abs(FlashConfig.Timezone), abs(FlashConfig.TimezoneMinutes));
+
+          sprintf(String, msg(MSG_TIMEZONE), TempString);
           scroll_string(24, String);
         break;
 
@@ -10378,27 +10119,22 @@ void process_scroll_queue(void)
         /*** Voltaqe reading function from Pico's ADC to be reviewed / debugged. */
         case (TAG_VOLTAGE):
           Volts = adc_read_voltage();
-          switch (FlashConfig.Language)
-          {
-            case (CZECH):
-              sprintf(String, "%2.2f V    ", Volts);
-            break;
-
-            case (SPANISH):
-              sprintf(String, "%2.2f voltios  ", Volts);
-            break;
-
-            case (ENGLISH):
-            case (FRENCH):
-            default:
-             sprintf(String, "%2.2f Volts    ", Volts);
-            break;
-          }
+          sprintf(String, msg(MSG_VOLTAGE), Volts);
           scroll_string(24, String);
          break;
 
 
 
+        case (TAG_VALUE):
+          /* For debug purposes. Scroll the next string queued by scroll_queue_value(). */
+          scroll_string(24, ScrollValue[ScrollValueTail]);
+          ++ScrollValueTail;
+          if (ScrollValueTail >= MAX_SCROLL_VALUES)
+            ScrollValueTail = 0;
+        break;
+
+
+
         default:
           /* Out-of-bound, do nothing. */
           return;
@@ -11074,16 +10810,388 @@ UINT8 read_dht(float *Temperature, float *Humidity)
   /* Decode relative humidity. */
   *Humidity = (float)((((Byte[0] & 0x7F) << 8) | Byte[1]) / 10.0);
 
-  if (FlashConfig.TemperatureUnit == FAHRENHEIT)
-    *Temperature = ((*Temperature * 9 / 5) + 32);
+  if (FlashConfig.TemperatureUnit == FAHRENHEIT)
+    *Temperature = ((*Temperature * 9 / 5) + 32);
+
+
+  if ((DebugBitMask & DEBUG_DHT) || (DebugBitMask & DEBUG_CORE))
+    uart_send(__LINE__, "===##### SUCCESS #####===   Temperature: %2.3f C   Humidity:    %2.3f %c\r\r\r", *Temperature, *Humidity, 0x25);
+
+  return 0x00;
+}
+#endif  // DHT_SUPPORT
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=reminder_arm() */
+/* ------------------------------------------------------------------ *\
+      Program the Pico alarm for the reminder that will ring next.
+      The wait is limited to REMINDER_MAX_WAIT so that a drift of the
+       Pico timer against clock time never delays a reminder by much.
+\* ------------------------------------------------------------------ */
+void reminder_arm(void)
+{
+  UINT64 LocalTime;
+  UINT64 Wait;
+
+
+  if (ReminderAlarmId > 0)
+  {
+    cancel_alarm(ReminderAlarmId);
+    ReminderAlarmId = 0;
+  }
+
+  if (ReminderHeapCount == 0) return;
+
+  LocalTime = GlobalUnixTime + get_utc_offset();
+
+  Wait = 0;
+  if (Reminder1[ReminderHeap[0]].NextRingEpoch > LocalTime)
+    Wait = Reminder1[ReminderHeap[0]].NextRingEpoch - LocalTime;
+  if (Wait > REMINDER_MAX_WAIT)
+    Wait = REMINDER_MAX_WAIT;
+
+  /* A zero wait still goes through the alarm, so that the reminder is processed in main() context. */
+  ReminderAlarmId = add_alarm_in_us(time_base_timer_us(Wait * 1000000ULL) + 1000, reminder_callback, NULL, true);
+
+  if (DebugBitMask & DEBUG_REMINDER)
+    uart_send(__LINE__, "Reminder scheduler: Reminder1[%2u] rings next at %llu (in %llu sec)\r", ReminderHeap[0], Reminder1[ReminderHeap[0]].NextRingEpoch, Wait);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=reminder_callback() */
+/* ------------------------------------------------------------------ *\
+         Pico alarm callback of the reminder scheduler. Reminders
+        are rung from main() context, through the command queue.
+\* ------------------------------------------------------------------ */
+int64_t reminder_callback(alarm_id_t AlarmId, void *UserData)
+{
+  ReminderAlarmId = 0;
+  command_queue(COMMAND_REMINDER_DUE, 0);
+
+  return 0;  // one-shot alarm.
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=reminder_heap_down() */
+/* ------------------------------------------------------------------ *\
+       Move a reminder down the reminder heap until its parent rings
+        earlier (or at the same time) than it. O(log n) reminders
+                             are looked at.
+\* ------------------------------------------------------------------ */
+void reminder_heap_down(UINT16 Position)
+{
+  UINT16 Child;
+  UINT16 ReminderNumber;
+
+
+  ReminderNumber = ReminderHeap[Position];
+
+  while ((Child = (Position * 2) + 1) < ReminderHeapCount)
+  {
+    /* Pick the child that rings first. */
+    if (((Child + 1) < ReminderHeapCount) && (Reminder1[ReminderHeap[Child + 1]].NextRingEpoch < Reminder1[ReminderHeap[Child]].NextRingEpoch))
+      ++Child;
+
+    if (Reminder1[ReminderNumber].NextRingEpoch <= Reminder1[ReminderHeap[Child]].NextRingEpoch) break;
+
+    ReminderHeap[Position] = ReminderHeap[Child];
+    Position = Child;
+  }
+  ReminderHeap[Position] = ReminderNumber;
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=reminder_init() */
+/* ------------------------------------------------------------------ *\
+        Compute the epochs of all reminders (local time) and build
+       the reminder heap with the next ring time of each of them.
+     Called on power-up and whenever clock time is changed. The state
+     of a reminder is entirely given by its definition and current
+       time, so there is nothing to save in flash across reboots.
+\* ------------------------------------------------------------------ */
+void reminder_init(void)
+{
+  UINT16 Dum1UInt16;
+  UINT16 Loop1UInt16;
+
+  UINT64 LocalTime;
+
+  struct tm TmTime;
+
+
+  LocalTime         = GlobalUnixTime + get_utc_offset();
+  ReminderHeapCount = 0;
+  ReminderRuleCount = 0;
+
+  for (Loop1UInt16 = 0; Loop1UInt16 < MAX_REMINDERS1; ++Loop1UInt16)
+  {
+    Reminder1[Loop1UInt16].NextRingEpoch = 0;
+    Reminder1[Loop1UInt16].RuleSlot      = REMINDER_NO_RULE;
+
+    if (Reminder1[Loop1UInt16].StartPeriod.Year == 0)
+    {
+      // if (DebugBitMask & DEBUG_REMINDER)
+      //   uart_send(__LINE__, "Reminder1[%2u].Year = 0: This reminder is not defined.\r", Loop1UInt16);
+
+      continue;
+    }
+
+    if (DebugBitMask & DEBUG_REMINDER)
+      uart_send(__LINE__, "Reminder1[%2u].Year != 0: This reminder is defined.... finding epoch where needed\r", Loop1UInt16);
+
+    Dum1UInt16 = Reminder1[Loop1UInt16].StartPeriod.Year;
+    if (Reminder1[Loop1UInt16].StartPeriod.Year == 9999)
+    {
+      /* Year 9999 is a placeholder to repeat the reminder for every year. */
+      Reminder1[Loop1UInt16].StartPeriod.Year = CurrentYear;
+    }
+    convert_human_to_tm(&Reminder1[Loop1UInt16].StartPeriod, &TmTime);
+    Reminder1[Loop1UInt16].StartPeriodEpoch = convert_tm_to_unix(&TmTime);
+    if (DebugBitMask & DEBUG_REMINDER)
+      uart_send(__LINE__, "Reminder1[%2u].StartPeriodEpoch found: %llu\r", Loop1UInt16, Reminder1[Loop1UInt16].StartPeriodEpoch);
+
+    /* Restore original year in case it was the 9999 placeholder and replaced temporarily. */
+    Reminder1[Loop1UInt16].StartPeriod.Year = Dum1UInt16;
+
+
+
+    Dum1UInt16 = Reminder1[Loop1UInt16].EndPeriod.Year;
+    if (Reminder1[Loop1UInt16].EndPeriod.Year == 9999)
+    {
+      /* Year 9999 is a placeholder to repeat the reminder for every year. */
+      Reminder1[Loop1UInt16].EndPeriod.Year = CurrentYear;
+    }
+    convert_human_to_tm(&Reminder1[Loop1UInt16].EndPeriod, &TmTime);
+    Reminder1[Loop1UInt16].EndPeriodEpoch = convert_tm_to_unix(&TmTime);
+    if (DebugBitMask & DEBUG_REMINDER)
+      uart_send(__LINE__, "Reminder1[%2u].EndPeriodEpoch found:   %llu\r", Loop1UInt16, Reminder1[Loop1UInt16].EndPeriodEpoch);
+
+    /* Restore original year in case it was the 9999 placeholder and replaced temporarily. */
+    Reminder1[Loop1UInt16].EndPeriod.Year = Dum1UInt16;
+
+
+
+    Dum1UInt16 = Reminder1[Loop1UInt16].FirstRing.Year;
+    if (Reminder1[Loop1UInt16].FirstRing.Year == 9999)
+    {
+      /* Year 9999 is a placeholder to repeat the reminder for every year. */
+      Reminder1[Loop1UInt16].FirstRing.Year = CurrentYear;
+    }
+    convert_human_to_tm(&Reminder1[Loop1UInt16].FirstRing, &TmTime);
+    Reminder1[Loop1UInt16].FirstRingEpoch = convert_tm_to_unix(&TmTime);
+    if (DebugBitMask & DEBUG_REMINDER)
+      uart_send(__LINE__, "Reminder1[%2u].FirstRingEpoch found:   %llu\r", Loop1UInt16, Reminder1[Loop1UInt16].FirstRingEpoch);
+
+    /* Restore original year in case it was the 9999 placeholder and replaced temporarily. */
+    Reminder1[Loop1UInt16].FirstRing.Year = Dum1UInt16;
+
+
+
+    /* Recurrence rule, if any, starts at FirstRingEpoch (unless the rule gives its own DTSTART). */
+    if (Reminder1[Loop1UInt16].Rule != NULL)
+    {
+      if ((ReminderRuleCount >= MAX_REMINDER_RULES) ||
+          (recur_parse((const char *)Reminder1[Loop1UInt16].Rule, (int64_t)Reminder1[Loop1UInt16].FirstRingEpoch, &ReminderRule[ReminderRuleCount]) != 0))
+      {
+        if (DebugBitMask & DEBUG_REMINDER)
+          uart_send(__LINE__, "Reminder1[%2u]: invalid recurrence rule or more than %u rules, reminder ignored [%s]\r", Loop1UInt16, MAX_REMINDER_RULES, Reminder1[Loop1UInt16].Rule);
+
+        continue;
+      }
+      Reminder1[Loop1UInt16].RuleSlot = ReminderRuleCount++;
+    }
+
+
+
+    /* Put the reminder in the heap if it has still something to ring. */
+    Reminder1[Loop1UInt16].NextRingEpoch = reminder_next_ring(Loop1UInt16, LocalTime);
+    if (Reminder1[Loop1UInt16].NextRingEpoch != 0)
+      ReminderHeap[ReminderHeapCount++] = Loop1UInt16;
+  }
+
+  /* Build the heap bottom-up (O(n)). */
+  for (Loop1UInt16 = ReminderHeapCount / 2; Loop1UInt16 > 0; --Loop1UInt16)
+    reminder_heap_down(Loop1UInt16 - 1);
+
+  if (DebugBitMask & DEBUG_REMINDER)
+    uart_send(__LINE__, "Reminder scheduler: %u reminders scheduled.\r", ReminderHeapCount);
+
+  reminder_arm();
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=reminder_next_ring() */
+/* ------------------------------------------------------------------ *\
+        Return the next ring time of a reminder (local time epoch),
+      at or after LocalTime, or 0 if the reminder will never ring
+        again. The reminder rings at FirstRingEpoch, then every
+      RingRepeatTime during RingDuration, and the same again every
+        NextReminderDelay, while inside StartPeriod and EndPeriod.
+     When the reminder has a recurrence rule, cycles begin at each
+        occurrence of the rule instead of every NextReminderDelay.
+\* ------------------------------------------------------------------ */
+UINT64 reminder_next_ring(UINT16 ReminderNumber, UINT64 LocalTime)
+{
+  UINT64 CycleStart;
+  UINT64 NextRing;
+  UINT64 Offset;
+  UINT64 RingCount;
+
+  int64_t NextCycle;
+
+  struct reminder1 *Reminder;
+
+
+  Reminder = &Reminder1[ReminderNumber];
+
+  if (LocalTime < Reminder->StartPeriodEpoch)
+    LocalTime = Reminder->StartPeriodEpoch;
+
+  if (Reminder->RuleSlot != REMINDER_NO_RULE)
+  {
+    /* Earliest cycle that may still have a ring at or after LocalTime (cycles are not expected to overlap). */
+    NextCycle = recur_next(&ReminderRule[Reminder->RuleSlot], (int64_t)(LocalTime - Reminder->RingDuration) - 1);
+    if (NextCycle == RECUR_NONE) return 0;
+    CycleStart = (UINT64)NextCycle;
+
+    NextRing = 0;
+    if (CycleStart >= LocalTime)
+    {
+      NextRing = CycleStart;
+    }
+    else if (Reminder->RingRepeatTime != 0)
+    {
+      RingCount = (LocalTime - CycleStart + Reminder->RingRepeatTime - 1) / Reminder->RingRepeatTime;
+      if ((RingCount * Reminder->RingRepeatTime) < Reminder->RingDuration)
+        NextRing = CycleStart + (RingCount * Reminder->RingRepeatTime);
+    }
+
+    /* Otherwise, first ring of next cycle. */
+    if (NextRing == 0)
+    {
+      NextCycle = recur_next(&ReminderRule[Reminder->RuleSlot], (int64_t)CycleStart);
+      if (NextCycle == RECUR_NONE) return 0;
+      NextRing = (UINT64)NextCycle;
+    }
+  }
+  else if (LocalTime <= Reminder->FirstRingEpoch)
+  {
+    NextRing = Reminder->FirstRingEpoch;
+  }
+  else
+  {
+    /* Beginning of the reminder cycle LocalTime falls into. */
+    CycleStart = Reminder->FirstRingEpoch;
+    if (Reminder->NextReminderDelay != 0)
+      CycleStart += ((LocalTime - Reminder->FirstRingEpoch) / Reminder->NextReminderDelay) * Reminder->NextReminderDelay;
+    Offset = LocalTime - CycleStart;
+
+    /* Next repeat ring in this cycle, if still within RingDuration. */
+    NextRing = 0;
+    if (Reminder->RingRepeatTime != 0)
+    {
+      RingCount = (Offset + Reminder->RingRepeatTime - 1) / Reminder->RingRepeatTime;
+      if ((RingCount == 0) || ((RingCount * Reminder->RingRepeatTime) < Reminder->RingDuration))
+        NextRing = CycleStart + (RingCount * Reminder->RingRepeatTime);
+    }
+    else if (Offset == 0)
+    {
+      NextRing = CycleStart;
+    }
+
+    /* Otherwise, first ring of next cycle. */
+    if (NextRing == 0)
+    {
+      if (Reminder->NextReminderDelay == 0) return 0;
+      NextRing = CycleStart + Reminder->NextReminderDelay;
+    }
+  }
+
+  if (NextRing > Reminder->EndPeriodEpoch) return 0;
+
+  return NextRing;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=reminder_process() */
+/* ------------------------------------------------------------------ *\
+        Ring the reminders that are due and reschedule them in the
+      reminder heap (O(log n) each). Then program the Pico alarm for
+                  the reminder that will ring next.
+\* ------------------------------------------------------------------ */
+void reminder_process(void)
+{
+  UINT8 Loop1UInt8;
+
+  UINT16 ReminderNumber;
+
+  UINT64 LocalTime;
+
+
+  LocalTime = GlobalUnixTime + get_utc_offset();
+
+  while ((ReminderHeapCount > 0) && (Reminder1[ReminderHeap[0]].NextRingEpoch <= LocalTime))
+  {
+    ReminderNumber = ReminderHeap[0];
+
+    if (DebugBitMask & DEBUG_REMINDER)
+      uart_send(__LINE__, "Reminder1[%2u] rings (%llu) [%s]\r", ReminderNumber, Reminder1[ReminderNumber].NextRingEpoch, Reminder1[ReminderNumber].Description);
+
+    /* Sound the reminder and scroll its description, if any. */
+    if (SilencePeriod == 0)
+    {
+      for (Loop1UInt8 = 0; Loop1UInt8 < TONE_EVENT_REPEAT2; ++Loop1UInt8)
+      {
+        sound_queue_active(TONE_EVENT_DURATION, TONE_EVENT_REPEAT1);
+        sound_queue_active(100, SILENT);
+      }
+    }
+    if (Reminder1[ReminderNumber].Description[0] != 0x00)
+      scroll_string(24, Reminder1[ReminderNumber].Description);
 
+    /* Reschedule the reminder, or take it out of the heap if it will not ring anymore. */
+    Reminder1[ReminderNumber].NextRingEpoch = reminder_next_ring(ReminderNumber, LocalTime + 1);
+    if (Reminder1[ReminderNumber].NextRingEpoch == 0)
+      ReminderHeap[0] = ReminderHeap[--ReminderHeapCount];
 
-  if ((DebugBitMask & DEBUG_DHT) || (DebugBitMask & DEBUG_CORE))
-    uart_send(__LINE__, "===##### SUCCESS #####===   Temperature: %2.3f C   Humidity:    %2.3f %c\r\r\r", *Temperature, *Humidity, 0x25);
+    if (ReminderHeapCount > 0)
+      reminder_heap_down(0);
+  }
 
-  return 0x00;
+  reminder_arm();
+
+  return;
 }
-#endif  // DHT_SUPPORT
 
 
 
@@ -11116,6 +11224,135 @@ UINT8 reverse_bits(UINT8 InputByte)
 
 
 
+/* $PAGE */
+/* $TITLE=rtc_drift_measure() */
+/* ------------------------------------------------------------------ *\
+       Measure the error of the real-time clock IC against NTP before
+       it is written, and trim its aging offset register in closed
+       loop once its drift has been measured long enough (see
+       rtc_drift.c), so that it keeps accurate time when NTP is not
+       available. "Offset" is the NTP offset: UTC time in usec is the
+       Pico timer value + Offset. Since the RTC IC gives whole seconds
+       only, its next second change is waited for (at most one
+                              second).
+\* ------------------------------------------------------------------ */
+void rtc_drift_measure(int64_t Offset)
+{
+  UCHAR String[128];
+
+  int8_t Aging;
+
+  UINT8 Status;
+
+  int64_t Error;
+
+  UINT64 Edge;
+  UINT64 Start;
+  UINT64 TimeOut;
+  UINT64 UnixTime;
+
+  struct rtc_drift_trim Trim;
+
+
+  if (RtcDrift.Timer == 0) return;
+
+  Start   = time_base_read_rtc();
+  TimeOut = time_us_64() + 1100000ULL;
+  do
+  {
+    UnixTime = time_base_read_rtc();
+    Edge     = time_us_64();
+  } while ((UnixTime == Start) && (Edge < TimeOut));
+
+  if (UnixTime == Start)
+  {
+    if (DebugBitMask & DEBUG_RTC)
+      uart_send(__LINE__, "Real-time clock IC is not counting, drift not measured.\r");
+    RtcDrift.Timer = 0;
+    return;
+  }
+
+  /* Error of the RTC IC at its second change (positive when the RTC IC is fast). */
+  Error  = ((int64_t)UnixTime * 1000000LL) - ((int64_t)Edge + Offset);
+  Aging  = ds3231_aging_read();
+  Status = rtc_drift_update(&RtcDrift, Error, Edge, Aging, &Trim);
+
+  if (Status == RTC_DRIFT_NONE)
+  {
+    if (DebugBitMask & DEBUG_RTC)
+      uart_send(__LINE__, "Real-time clock IC error: %lld usec   Drift measured for %lld sec\r", Error, Trim.Interval / 1000000LL);
+    return;
+  }
+
+  if (Status == RTC_DRIFT_REJECTED)
+  {
+    if (DebugBitMask & DEBUG_RTC)
+      uart_send(__LINE__, "Real-time clock IC drift out of range (%lld ppb), ignored.\r", Trim.Drift);
+    return;
+  }
+
+  if (Status == RTC_DRIFT_TRIMMED) ds3231_aging_write(Trim.Aging);
+
+  if (DebugBitMask & DEBUG_RTC)
+    uart_send(__LINE__, "Real-time clock IC drift: %lld ppb over %lld sec   Aging offset: %d -> %d\r", Trim.Drift, Trim.Interval / 1000000LL, Aging, Trim.Aging);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=rtc_drift_start() */
+/* ------------------------------------------------------------------ *\
+       Take the error of the real-time clock IC right after it has
+       been written, at the beginning of a second of the time base
+       (its second countdown restarts when its seconds register is
+       written). It is taken at the time it is written, so that a
+       late write does not bias the measurement. "Offset" is the NTP
+       offset, the same as for rtc_drift_measure() before the write.
+\* ------------------------------------------------------------------ */
+void rtc_drift_start(int64_t Offset)
+{
+  UINT64 Now;
+
+
+  Now = time_us_64();
+  rtc_drift_written(&RtcDrift, (((int64_t)time_base_us() / 1000000LL) * 1000000LL) - ((int64_t)Now + Offset), Now);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=rtc_write_time() */
+/* ------------------------------------------------------------------ *\
+       Copy local time of the time base to the real-time clock IC.
+       Requested by ntp_update() and queued by timer_callback_s() at
+       the beginning of next second, since the DS3231 starts counting
+       a new second when its seconds register is written. The error
+       of the RTC IC is measured before and after it is written, for
+              its drift measurement (see rtc_drift.c).
+\* ------------------------------------------------------------------ */
+void rtc_write_time(void)
+{
+  rtc_drift_measure(NTPData.NTPOffset);
+
+  time_civil_update();
+  set_time(CurrentSecond, CurrentMinute, CurrentHour, CurrentDayOfWeek, CurrentDayOfMonth, CurrentMonth, CurrentYearLowPart);
+  rtc_drift_start(NTPData.NTPOffset);
+
+  return;
+}
+
+
+
+
+
 /* $PAGE */
 /* $TITLE=scroll_one_dot() */
 /* ------------------------------------------------------------------ *\
@@ -11203,32 +11440,26 @@ UINT8 scroll_queue(UINT8 Tag)
 /* ------------------------------------------------------------------ *\
            Put a specific value in the queue so that we can
             check for a specific event even inside an ISR.
-   MUST BE USED ONLY FOR DEBUG PURPOSES SINCE IT INTERFERES WITH
-                        CALENDAR EVENTS.
+                  MUST BE USED ONLY FOR DEBUG PURPOSES.
 \* ------------------------------------------------------------------ */
 UINT8 scroll_queue_value(UINT8 Tag, UCHAR *String)
 {
-  static UINT8 EventNumber;
-
-
-  /* NOTE: We overwrite a calendar event ("Description") with data of
-           interest (variable, setting, marker, etc...) and then,
-           we write this event number as a tag in the scroll queue.
-           Since the tag is between 0 and MAX_EVENTS, it will be handled
-           by process_scroll() as a Calendar event and will be scrolled
-           on the display (altough not in real time. The function begins
-           by overwriting Calendar event 0 and goes on overwriting all
-           Calendar events as we need more of them to display info. It
-           returns the next event number in case we have more data to be
-           displayed). */
-
-  sprintf(CalendarEvent[EventNumber].Description, "%s", String);
-  scroll_queue(EventNumber);
-  ++EventNumber;
-  if (EventNumber >= MAX_EVENTS)
-    EventNumber = 0;
-
-  return EventNumber;
+  /* NOTE: Calendar events are now read-only (in flash), so the data of
+           interest (variable, setting, marker, etc...) is copied into
+           the next entry of ScrollValue[] and TAG_VALUE is written in
+           the scroll queue. Since the scroll queue is handled in order,
+           process_scroll_queue() scrolls the entries in the same order
+           (altough not in real time). When more than MAX_SCROLL_VALUES
+           values are waiting, the oldest ones are overwritten. Return
+           the next entry to be used. */
+
+  snprintf(ScrollValue[ScrollValueHead], sizeof(ScrollValue[0]), "%s", String);
+  scroll_queue(TAG_VALUE);
+  ++ScrollValueHead;
+  if (ScrollValueHead >= MAX_SCROLL_VALUES)
+    ScrollValueHead = 0;
+
+  return ScrollValueHead;
 }
 
 
@@ -11240,7 +11471,7 @@ UINT8 scroll_queue_value(UINT8 Tag, UCHAR *String)
 /* ------------------------------------------------------------------ *\
             Scroll the specified string on clock display.
 \* ------------------------------------------------------------------ */
-void scroll_string(UINT8 StartColumn, UCHAR *StringToScroll)
+void scroll_string(UINT8 StartColumn, const UCHAR *StringToScroll)
 {
   UCHAR String[256];
 
@@ -11626,6 +11857,62 @@ void set_and_save_credentials(void)
 
 
 
+/* $PAGE */
+/* $TITLE=set_dst_rule() */
+/* ------------------------------------------------------------------ *\
+       Apply the DST rule of current DST country to current Timezone
+         setting and compute its transitions for current year and
+                              next year.
+\* ------------------------------------------------------------------ */
+void set_dst_rule(void)
+{
+  UINT8 Loop1UInt8;
+
+  int32_t StdOffset;
+
+  time_t LocalTime;
+
+  struct tm TmTime;
+
+
+  /* Make sure DST country is within DstRegion[] limits. */
+  if (FlashConfig.DSTCountry >= DST_HI_LIMIT) FlashConfig.DSTCountry = DST_NONE;
+
+  tz_parse(DstRegion[FlashConfig.DSTCountry].Rule, &TzCache.Rule);
+
+  /* Timezone setting includes the Daylight Saving Time shift while Summer Time is active. */
+  StdOffset = get_utc_offset();
+  if ((FlashConfig.FlagSummerTime == FLAG_ON) && (TzCache.Rule.FlagDst))
+    StdOffset -= (TzCache.Rule.DstOffset - TzCache.Rule.StdOffset);
+
+  /* Same rule for all timezones of the region, with the standard offset of the clock. */
+  tz_rebase(&TzCache.Rule, StdOffset, DstRegion[FlashConfig.DSTCountry].FlagUtc);
+  tz_prepare(&TzCache, CurrentYear);
+
+  if (DebugBitMask & DEBUG_DST)
+  {
+    uart_send(__LINE__, "set_dst_rule(): DST country: %u   Rule: %s\r", FlashConfig.DSTCountry, DstRegion[FlashConfig.DSTCountry].Rule);
+    uart_send(__LINE__, "Standard offset: %ld sec   DST offset: %ld sec\r", TzCache.Rule.StdOffset, TzCache.Rule.DstOffset);
+
+    for (Loop1UInt8 = 0; Loop1UInt8 < TzCache.Count; ++Loop1UInt8)
+    {
+      /* Display transitions in local time, just before the change. */
+      LocalTime = TzCache.Transition[Loop1UInt8] + TzCache.Offset[Loop1UInt8];
+      convert_unix_to_tm(LocalTime, &TmTime, FLAG_OFF);
+      uart_send(__LINE__, "Transition %u: UTC epoch %lld   %s %2u-%s-%4.4u %2.2u:%2.2u:%2.2u   offset %ld -> %ld sec\r", Loop1UInt8, TzCache.Transition[Loop1UInt8],
+                SHORT_DAY(ENGLISH, TmTime.tm_wday + 1), TmTime.tm_mday, SHORT_MONTH(ENGLISH, TmTime.tm_mon + 1), TmTime.tm_year + 1900,
+                TmTime.tm_hour, TmTime.tm_min, TmTime.tm_sec, TzCache.Offset[Loop1UInt8], TzCache.Offset[Loop1UInt8 + 1]);
+    }
+    uart_send(__LINE__, "\r");
+  }
+
+  return;
+}
+
+
+
+
+
 /* $PAGE */
 /* $TITLE=set_mode_out() */
 /* ------------------------------------------------------------------ *\
@@ -11673,8 +11960,8 @@ void set_mode_out(void)
 
   if (FlagSetupAlarm[SETUP_ALARM_MINUTE] == FLAG_ON)
   {
-    fill_display_buffer_4X7(13, (FlashConfig.Alarm[AlarmNumber].Minute / 10 + '0') & FlagBlinking[4]);
-    fill_display_buffer_4X7(18, (FlashConfig.Alarm[AlarmNumber].Minute % 10 + '0') & FlagBlinking[4]);
+    fill_display_buffer_4X7(13, (Alarm[AlarmNumber].Minute / 10 + '0') & FlagBlinking[4]);
+    fill_display_buffer_4X7(18, (Alarm[AlarmNumber].Minute % 10 + '0') & FlagBlinking[4]);
   }
 
   /***
@@ -11688,6 +11975,13 @@ void set_mode_out(void)
 
   IdleNumberOfSeconds = 0; // reset number of seconds the system has been idle.
   FlagTone = FLAG_OFF;     // reset flag tone.
+  /* Time set by hand is not a drift of the Pico crystal nor of the RTC IC, drifts can only be measured from next NTP sync on. */
+  if (FlagSetupRTC == FLAG_ON)
+  {
+    RtcDrift.Timer     = 0;
+    TimeBase.SyncTimer = 0;
+  }
+
   FlagSetupRTC = FLAG_OFF; // reset flag indicating time settings have changed.
 
   /* Reset all alarm setup member flags. */
@@ -11728,12 +12022,20 @@ void set_mode_timeout(void)
   FlagSetTimer        = FLAG_OFF;  // reset timer setup mode flag when timed-out.
   FlagUpdateTime      = FLAG_ON;   // let's display current time on the clock, now.
 
-  /* Determine the day-of-year for DST start day and DST end day (in case we just change CurrentYear). */
-  get_dst_days();
+  /* Apply DST rule to Timezone setting (DST country or Timezone may have been changed). */
+  set_dst_rule();
+
+  /* Time or date may have been changed in the RTC IC (and the RTC IC keeps local time, so a Timezone change moves UTC time). */
+  time_base_check_rtc();
 
   /* Check for an eventual change in Daylight Saving Time status. */
   update_dst_status();
 
+  /* Time, date or timezone may have been changed, reschedule reminders, alarms and chimes. */
+  command_queue(COMMAND_REMINDER_RESET, 0);
+  command_queue(COMMAND_ALARM_SCHEDULE, 0);
+  command_queue(COMMAND_CHIME_SCHEDULE, 0);
+
   /* Request a NTP re-sync if clock setup has been changed (Time, Date, or Timezone may have been changed). */
   NTPData.FlagNTPResync = FLAG_ON;
 
@@ -11781,6 +12083,25 @@ void set_pixel(UINT8 PixelRow, UINT8 PixelColumn, UINT8 Flag)
 
 
 
+/* $PAGE */
+/* $TITLE=set_utc_offset() */
+/* ------------------------------------------------------------------ *\
+       Save difference between local time and UTC time (in seconds)
+            to FlashConfig.Timezone and FlashConfig.TimezoneMinutes.
+\* ------------------------------------------------------------------ */
+void set_utc_offset(int32_t Offset)
+{
+  /* Division truncates toward zero, so that hours and minutes keep the same sign. */
+  FlashConfig.Timezone        = Offset / 3600;
+  FlashConfig.TimezoneMinutes = (Offset % 3600) / 60;
+
+  return;
+}
+
+
+
+
+
 /* $PAGE */
 /* $TITLE=setup_alarm_frame() */
 /* ------------------------------------------------------------------ *\
@@ -11818,16 +12139,24 @@ void setup_alarm_frame(void)
 
 
 
-    /* Display first digit on clock display ("A" for "Alarm").
-       NOTE: Alarm number if 1 to 9 for user, but 0 to 8 for firmware. */
-    fill_display_buffer_4X7(0, 'A');
-    fill_display_buffer_4X7(5, ('1' + AlarmNumber) & FlagBlinking[1]);
+    /* Display first digit on clock display ("A" for "Alarm"), or the first digit of alarm numbers 10 and above.
+       NOTE: Alarm number if 1 to 64 for user, but 0 to 63 for firmware. */
+    if (AlarmNumber < 9)
+    {
+      fill_display_buffer_4X7(0, 'A');
+      fill_display_buffer_4X7(5, ('1' + AlarmNumber) & FlagBlinking[1]);
+    }
+    else
+    {
+      fill_display_buffer_4X7(0, ('0' + ((AlarmNumber + 1) / 10)) & FlagBlinking[1]);
+      fill_display_buffer_4X7(5, ('0' + ((AlarmNumber + 1) % 10)) & FlagBlinking[1]);
+    }
 
     /* Display double dots as display separator. */
     fill_display_buffer_4X7(10, ':');
 
     fill_display_buffer_4X7(13, '0' & FlagBlinking[2]);
-    if (FlashConfig.Alarm[AlarmNumber].FlagStatus == FLAG_ON)
+    if (Alarm[AlarmNumber].FlagStatus == FLAG_ON)
     {
       /* If this alarm is enabled, display "ON" on clock display. */
       fill_display_buffer_4X7(18, 'N' & FlagBlinking[2]);
@@ -11864,14 +12193,14 @@ void setup_alarm_frame(void)
     /* Display current alarm hour and minute on clock display. */
     if (FlashConfig.TimeDisplayMode == H12)
     {
-      AlarmHourDisplay = convert_h24_to_h12(FlashConfig.Alarm[AlarmNumber].Hour, &AmFlag, &PmFlag);
+      AlarmHourDisplay = convert_h24_to_h12(Alarm[AlarmNumber].Hour, &AmFlag, &PmFlag);
       (AmFlag == FLAG_ON) ? (DisplayBuffer[4] |= (1 << 0)) : (DisplayBuffer[4] &= ~(1 << 0));
       (PmFlag == FLAG_ON) ? (DisplayBuffer[4] |= (1 << 1)) : (DisplayBuffer[4] &= ~(1 << 1));
     }
     else
     {
       /* We are in "24-hours" display mode. */
-      AlarmHourDisplay = FlashConfig.Alarm[AlarmNumber].Hour;
+      AlarmHourDisplay = Alarm[AlarmNumber].Hour;
     }
 
 
@@ -11885,8 +12214,8 @@ void setup_alarm_frame(void)
 
     fill_display_buffer_4X7(5, (AlarmHourDisplay % 10 + '0') & FlagBlinking[3]);
     fill_display_buffer_4X7(10, ':');
-    fill_display_buffer_4X7(13, (FlashConfig.Alarm[AlarmNumber].Minute / 10 + '0') & FlagBlinking[4]);
-    fill_display_buffer_4X7(18, (FlashConfig.Alarm[AlarmNumber].Minute % 10 + '0') & FlagBlinking[4]);
+    fill_display_buffer_4X7(13, (Alarm[AlarmNumber].Minute / 10 + '0') & FlagBlinking[4]);
+    fill_display_buffer_4X7(18, (Alarm[AlarmNumber].Minute % 10 + '0') & FlagBlinking[4]);
 
     /* Clean the non visible part of the display when done. */
     clear_framebuffer(26);
@@ -11908,15 +12237,15 @@ void setup_alarm_frame(void)
   {
     /* OBSOLETE PIECE OF CODE. Nine (9) alarms are now kept in Pico's flash.
     // If alarm #1 is turned on, write it to the RTC IC.
-    if ((AlarmNumber == 0) && (FlashConfig.Alarm[0].FlagStatus == FLAG_ON))
+    if ((AlarmNumber == 0) && (Alarm[0].FlagStatus == FLAG_ON))
     {
-      set_alarm1_clock(ALARM_MODE_HOUR_MIN_SEC_MATCHED, 00, FlashConfig.Alarm[0].Minute, FlashConfig.Alarm[0].Hour, FlashConfig.Alarm[0].Day);
+      set_alarm1_clock(ALARM_MODE_HOUR_MIN_SEC_MATCHED, 00, Alarm[0].Minute, Alarm[0].Hour, Alarm[0].Day);
     }
 
     // If alarm #2 is turned on, write it to the RTC IC.
-    if ((AlarmNumber == 1) && (FlashConfig.Alarm[1].FlagStatus == FLAG_ON))
+    if ((AlarmNumber == 1) && (Alarm[1].FlagStatus == FLAG_ON))
     {
-      set_alarm2_clock(FlashConfig.Alarm[1].Minute, FlashConfig.Alarm[1].Hour, FlashConfig.Alarm[1].Day);
+      set_alarm2_clock(Alarm[1].Minute, Alarm[1].Hour, Alarm[1].Day);
     }
     */
 
@@ -11933,6 +12262,9 @@ void setup_alarm_frame(void)
     /* Reset all alarm setup member flags. */
     for (Loop1UInt8 = SETUP_NONE; Loop1UInt8 < SETUP_ALARM_HI_LIMIT; ++Loop1UInt8)
       FlagSetupAlarm[Loop1UInt8] = FLAG_OFF;
+
+    /* Alarm may have been changed, find the next alarm to ring. */
+    command_queue(COMMAND_ALARM_SCHEDULE, 0);
   }
 
   return;
@@ -11966,27 +12298,27 @@ void setup_alarm_variables(UINT8 FlagButtonSelect)
     {
       /* Increment alarm number. */
       ++AlarmNumber;
-      if (AlarmNumber > 8) AlarmNumber = 0;
+      if (AlarmNumber >= MAX_ALARMS) AlarmNumber = 0;
     }
     else
     {
       --AlarmNumber;
-      if (AlarmNumber > 8) AlarmNumber = 8;
+      if (AlarmNumber >= MAX_ALARMS) AlarmNumber = MAX_ALARMS - 1;
     }
   }
 
   /* Toggle alarm On / Off. */
   if (FlagSetupAlarm[SETUP_ALARM_ON_OFF] == FLAG_ON)
   {
-    if (FlashConfig.Alarm[AlarmNumber].FlagStatus == FLAG_ON)
-      FlashConfig.Alarm[AlarmNumber].FlagStatus = FLAG_OFF;
+    if (Alarm[AlarmNumber].FlagStatus == FLAG_ON)
+      Alarm[AlarmNumber].FlagStatus = FLAG_OFF;
     else
-      FlashConfig.Alarm[AlarmNumber].FlagStatus = FLAG_ON;
+      Alarm[AlarmNumber].FlagStatus = FLAG_ON;
 
-    /* We now have 9 alarms available... Check if at least one alarm is On and if ever the case, turn On both alarm indocators. */
+    /* We now have 64 alarms available... Check if at least one alarm is On and if ever the case, turn On both alarm indocators. */
     Dum1UInt8 = 0;
-    for (Loop1UInt8 = 0; Loop1UInt8 < 9; ++Loop1UInt8)
-      if (FlashConfig.Alarm[Loop1UInt8].FlagStatus == FLAG_ON)
+    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
+      if (Alarm[Loop1UInt8].FlagStatus == FLAG_ON)
         Dum1UInt8 = 1;
 
     if (Dum1UInt8)
@@ -12007,16 +12339,16 @@ void setup_alarm_variables(UINT8 FlagButtonSelect)
     if (FlagButtonSelect == FLAG_UP)
     {
       /* User pressed the "Up" (middle) button while in "Alarm Hour" set mode. */
-      ++FlashConfig.Alarm[AlarmNumber].Hour;
-      if (FlashConfig.Alarm[AlarmNumber].Hour == 24)
-        FlashConfig.Alarm[AlarmNumber].Hour = 0;  // reset to zero when reaching out-of-bound.
+      ++Alarm[AlarmNumber].Hour;
+      if (Alarm[AlarmNumber].Hour == 24)
+        Alarm[AlarmNumber].Hour = 0;  // reset to zero when reaching out-of-bound.
     }
     else
     {
       /* User pressed the "Down" (bottom) button while in "Alarm Hour" set mode. */
-      --FlashConfig.Alarm[AlarmNumber].Hour;
-      if (FlashConfig.Alarm[AlarmNumber].Hour == 255)
-        FlashConfig.Alarm[AlarmNumber].Hour = 23;  // reset to 23 when reaching out-of-bound.
+      --Alarm[AlarmNumber].Hour;
+      if (Alarm[AlarmNumber].Hour == 255)
+        Alarm[AlarmNumber].Hour = 23;  // reset to 23 when reaching out-of-bound.
     }
   }
 
@@ -12026,16 +12358,16 @@ void setup_alarm_variables(UINT8 FlagButtonSelect)
     if (FlagButtonSelect == FLAG_UP)
     {
       /* User pressed the "Up" (middle) button while in "Alarm Minute" set mode. */
-      ++FlashConfig.Alarm[AlarmNumber].Minute;
-      if (FlashConfig.Alarm[AlarmNumber].Minute == 60)
-        FlashConfig.Alarm[AlarmNumber].Minute = 0;  // reset to zero when reaching out-of-bound.
+      ++Alarm[AlarmNumber].Minute;
+      if (Alarm[AlarmNumber].Minute == 60)
+        Alarm[AlarmNumber].Minute = 0;  // reset to zero when reaching out-of-bound.
     }
     else
     {
       /* User pressed the "Down" (bottom) button while in "Alarm Minute" set mode. */
-      --FlashConfig.Alarm[AlarmNumber].Minute;
-      if (FlashConfig.Alarm[AlarmNumber].Minute == 255)
-        FlashConfig.Alarm[AlarmNumber].Minute = 59;  // reset to 59 when reaching out-of-bound.
+      --Alarm[AlarmNumber].Minute;
+      if (Alarm[AlarmNumber].Minute == 255)
+        Alarm[AlarmNumber].Minute = 59;  // reset to 59 when reaching out-of-bound.
     }
   }
 
@@ -12064,7 +12396,7 @@ void setup_alarm_variables(UINT8 FlagButtonSelect)
 
     if (FlagButtonSelect == FLAG_LONG_UP)
     {
-      FlashConfig.Alarm[AlarmNumber].Day |= (1 << AlarmTargetDay);
+      Alarm[AlarmNumber].Day |= (1 << AlarmTargetDay);
 
       if (DebugBitMask & DEBUG_ALARMS)
         uart_send(__LINE__, "Received FLAG_LONG_UP\r");
@@ -12072,7 +12404,7 @@ void setup_alarm_variables(UINT8 FlagButtonSelect)
 
     if (FlagButtonSelect == FLAG_LONG_DOWN)
     {
-      FlashConfig.Alarm[AlarmNumber].Day &= (~(1 << AlarmTargetDay));
+      Alarm[AlarmNumber].Day &= (~(1 << AlarmTargetDay));
 
       if (DebugBitMask & DEBUG_ALARMS)
         uart_send(__LINE__, "Received FLAG_LONG_DOWN\r");
@@ -12081,26 +12413,26 @@ void setup_alarm_variables(UINT8 FlagButtonSelect)
 
   if (DebugBitMask & DEBUG_ALARMS)
   {
-    uart_send(__LINE__, "AlarmTargetDay = %u   (%s)\r", AlarmTargetDay, DayName[FlashConfig.Language][AlarmTargetDay]);
+    uart_send(__LINE__, "AlarmTargetDay = %u   (%s)\r", AlarmTargetDay, DAY_NAME(FlashConfig.Language, AlarmTargetDay));
 
     /* Identify all days-of-week targets for current alarm. */
     DayMask[0] = 0x00;  // initialize bitmask.
     for (Loop1UInt8 = 7; Loop1UInt8 > 0; --Loop1UInt8)
     {
-      if (FlashConfig.Alarm[AlarmNumber].Day & (1 << Loop1UInt8))
+      if (Alarm[AlarmNumber].Day & (1 << Loop1UInt8))
         strcat(DayMask, "1");
       else
         strcat(DayMask, "0");
     }
     strcat(DayMask, "0");  // add bit 0 since days-of-week go from 1 to 7 (1 being SUN and 7 being SAT)
-    sprintf(String, "[%X] Alarm[%2.2u].DayMask:     %s     (%X) ", &FlashConfig.Alarm[AlarmNumber].Day, AlarmNumber, DayMask, FlashConfig.Alarm[AlarmNumber].Day);
+    sprintf(String, "[%X] Alarm[%2.2u].DayMask:     %s     (%X) ", &Alarm[AlarmNumber].Day, AlarmNumber, DayMask, Alarm[AlarmNumber].Day);
 
     for (Loop1UInt8 = 1; Loop1UInt8 < 8; ++Loop1UInt8)
     {
-      if (FlashConfig.Alarm[AlarmNumber].Day & (1 << Loop1UInt8))
+      if (Alarm[AlarmNumber].Day & (1 << Loop1UInt8))
       {
         Dum1UInt8 = strlen(String);
-        sprintf(&String[strlen(String)], "%s", DayName[FlashConfig.Language][Loop1UInt8]);
+        sprintf(&String[strlen(String)], "%s", DAY_NAME(FlashConfig.Language, Loop1UInt8));
         String[Dum1UInt8 + 3] = 0x20;  // space separator.
         String[Dum1UInt8 + 4] = 0x00;  // keep first 3 characters of day name.
       }
@@ -12129,6 +12461,7 @@ void setup_clock_frame(void)
 
   UINT8 AmFlag;
   UINT8 PmFlag;
+  UINT8 DisplayMinute;
   UINT8 Dum1UChar;
   UINT8 DumDayOfMonth;
   UINT8 DumMonth;
@@ -12201,8 +12534,10 @@ void setup_clock_frame(void)
 
     fill_display_buffer_4X7(5, (CurrentHour % 10 + '0') & FlagBlinking[SETUP_HOUR]);
     fill_display_buffer_4X7(10, 0x3A); // slim ":"
-    fill_display_buffer_4X7(12, (CurrentMinute / 10 + '0') & FlagBlinking[SETUP_MINUTE]);
-    fill_display_buffer_4X7(17, (CurrentMinute % 10 + '0') & FlagBlinking[SETUP_MINUTE]);
+    /* Minutes being set are displayed from the setting, since CurrentMinute is re-derived from the time base every second. */
+    DisplayMinute = (FlagSetupClock[SETUP_MINUTE] == FLAG_ON) ? CurrentMinuteSetting : CurrentMinute;
+    fill_display_buffer_4X7(12, (DisplayMinute / 10 + '0') & FlagBlinking[SETUP_MINUTE]);
+    fill_display_buffer_4X7(17, (DisplayMinute % 10 + '0') & FlagBlinking[SETUP_MINUTE]);
   }
 
 
@@ -12509,38 +12844,8 @@ void setup_clock_frame(void)
     fill_display_buffer_5X7(7, 'G');
     /// fill_display_buffer_4X7(11, ':');
 
-    switch (FlashConfig.Language)
-    {
-      default:
-      case (CZECH):
-        /// fill_display_buffer_5X7(15, ('C' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(13, ('C' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(19, ('Z' & FlagBlinking[SETUP_LANGUAGE]));
-       break;
-
-      case (ENGLISH):
-        /// fill_display_buffer_5X7(15, ('E' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(13, ('E' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(19, ('N' & FlagBlinking[SETUP_LANGUAGE]));
-       break;
-
-      case (FRENCH):
-        /// fill_display_buffer_5X7(15, ('F' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(13, ('F' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(19, ('R' & FlagBlinking[SETUP_LANGUAGE]));
-      break;
-
-      case (GERMAN):
-        /// fill_display_buffer_5X7(15, ('G' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(13, ('G' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(19, ('E' & FlagBlinking[SETUP_LANGUAGE]));
-      break;
-
-      case (SPANISH):
-        fill_display_buffer_5X7(13, ('S' & FlagBlinking[SETUP_LANGUAGE]));
-        fill_display_buffer_5X7(19, ('P' & FlagBlinking[SETUP_LANGUAGE]));
-      break;
-    }
+    fill_display_buffer_5X7(13, (msg(MSG_LANGUAGE_CODE)[0] & FlagBlinking[SETUP_LANGUAGE]));
+    fill_display_buffer_5X7(19, (msg(MSG_LANGUAGE_CODE)[1] & FlagBlinking[SETUP_LANGUAGE]));
 
     /* Clear the clock framebuffer. */
     clear_framebuffer(26);
@@ -13578,7 +13883,7 @@ void setup_timer_variables(UINT8 FlagButtonSelect)
 /* $PAGE */
 /* $TITLE=show_time() */
 /* ------------------------------------------------------------------ *\
-            Read the real-time clock IC and display time.
+        Display time (derived from the time base every second).
 \* ------------------------------------------------------------------ */
 void show_time(void)
 {
@@ -13586,46 +13891,36 @@ void show_time(void)
   char TimeBuffer[4];
 
   UINT8 AmFlag;
+  UINT8 DisplayHour;
   UINT8 PmFlag;
 
 
-  /* Read the real-time clock IC. */
-  Time_RTC = Read_RTC();
-
-  CurrentHourSetting = bcd_to_byte(Time_RTC.hour);  // use CurrentHourSetting until we convert to H12 or H24 if required.
-  CurrentMinute      = bcd_to_byte(Time_RTC.minutes);
-  CurrentSecond      = bcd_to_byte(Time_RTC.seconds);
-  CurrentDayOfMonth  = bcd_to_byte(Time_RTC.dayofmonth);
-  CurrentMonth       = bcd_to_byte(Time_RTC.month);
-  CurrentYearLowPart = bcd_to_byte(Time_RTC.year);
-  CurrentYear        = ((FlashConfig.CurrentYearCentile * 100) + CurrentYearLowPart);
-  CurrentDayOfWeek   = get_day_of_week(CurrentYear, CurrentMonth, CurrentDayOfMonth);
+  CurrentHourSetting = CurrentHour;  // hour is always kept in 24-hours format, CurrentHourSetting is the default for clock setup.
 
 
   /* Check if we are in 12-hours or 24-hours time format. */
   if (FlashConfig.TimeDisplayMode == H12)
   {
-    CurrentHour = convert_h24_to_h12(CurrentHourSetting, &AmFlag, &PmFlag);
+    DisplayHour = convert_h24_to_h12(CurrentHourSetting, &AmFlag, &PmFlag);
     (AmFlag == FLAG_ON) ? (DisplayBuffer[4] |= (1 << 0)) : (DisplayBuffer[4] &= ~(1 << 0));
     (PmFlag == FLAG_ON) ? (DisplayBuffer[4] |= (1 << 1)) : (DisplayBuffer[4] &= ~(1 << 1));
   }
   else
   {
-    /* We are in "24-hours" display mode, nothing to do since RTC keep hours in 24-hours mode. */
-    CurrentHour = CurrentHourSetting;
+    /* We are in "24-hours" display mode, nothing to convert. */
+    DisplayHour = CurrentHourSetting;
   }
 
 
   /* When in 12-hour time display format, first digit is not displayed if it is zero. */
-  if ((FlashConfig.TimeDisplayMode == H12) && (CurrentHour < 10))
+  if ((FlashConfig.TimeDisplayMode == H12) && (DisplayHour < 10))
     TimeBuffer[0] = (' ');  // hours first digit.
   else
-    TimeBuffer[0] = ((CurrentHour / 10) + '0');     // hours first digit.
+    TimeBuffer[0] = ((DisplayHour / 10) + '0');     // hours first digit.
 
-  TimeBuffer[1] = ((CurrentHour % 10) + '0');       // hours second digit.
-  TimeBuffer[2] = ((Time_RTC.minutes / 16) + '0');  // minutes first digit.
-  TimeBuffer[3] = ((Time_RTC.minutes % 16) + '0');  // minutes second digit.
-  CurrentSecond = ((float)Time_RTC.seconds) / 1.5;
+  TimeBuffer[1] = ((DisplayHour % 10) + '0');       // hours second digit.
+  TimeBuffer[2] = ((CurrentMinute / 10) + '0');     // minutes first digit.
+  TimeBuffer[3] = ((CurrentMinute % 10) + '0');     // minutes second digit.
 
 
   /* Display "time of day" if we are not scrolling some data. */
@@ -13679,6 +13974,10 @@ bool sound_callback_ms(struct repeating_timer *Timer50MSec)
   UINT64 Timer2;
 
 
+  /* Keep track of the deepest stack pointer seen in interrupt context. */
+  if ((UINT32)&String[0] < StackIsrLowest) StackIsrLowest = (UINT32)&String[0];
+
+
   Timer1 = time_us_64();
 
 
@@ -14179,69 +14478,193 @@ UINT8 sound_unqueue_passive(UINT16 *Frequency, UINT16 *MSeconds)
     {
       uart_send(__LINE__, "- P-NotEmpty:            %5u   %5u\r", SoundPassiveHead, SoundPassiveTail);
 
-      // uart_send(__LINE__, "- P-Unqueuing:   [%3u]   %5u   %5u\r", SoundPassiveTail, SoundQueuePassive[SoundPassiveTail].Freq, SoundQueuePassive[SoundPassiveTail].MSec);
-    }
+      // uart_send(__LINE__, "- P-Unqueuing:   [%3u]   %5u   %5u\r", SoundPassiveTail, SoundQueuePassive[SoundPassiveTail].Freq, SoundQueuePassive[SoundPassiveTail].MSec);
+    }
+
+
+    /* Extract data for next sound to play. */
+    *Frequency = SoundQueuePassive[SoundPassiveTail].Freq;
+    *MSeconds  = SoundQueuePassive[SoundPassiveTail].MSec;
+
+
+    /* And reset this slot in the sound queue. */
+    SoundQueuePassive[SoundPassiveTail].Freq = 0;
+    SoundQueuePassive[SoundPassiveTail].MSec = 0;
+
+  
+    if ((*Frequency >= 60) && (*Frequency <= 8000) && (*MSeconds != 0) || (*Frequency == SILENT) || (*MSeconds == WAIT_4_ACTIVE))
+    {
+      /* The sound found in this slot is valid. */
+      ++SoundPassiveTail;
+
+      /* If reaching out-of-bound, revert to zero. */
+      if (SoundPassiveTail >= MAX_PASSIVE_SOUND_QUEUE) SoundPassiveTail = 0;
+
+      /***
+      if  (DebugBitMask & DEBUG_SOUND_QUEUE)
+        uart_send(__LINE__, "- P-Adjust Tail to:         %5u\r", SoundPassiveTail);
+      ***/
+
+      return 0;
+    }
+    else
+    {
+      /* If this slot was corrupted, make some housekeeping. */
+      if  (DebugBitMask & DEBUG_SOUND_QUEUE)
+        uart_send(__LINE__, "- P-Housekeeping from %u   Freq: %5u   MSec: %5u\r", SoundPassiveTail, *Frequency, *MSeconds);
+  
+      CurrentTail = SoundPassiveTail; // keep track of starting position in the queue.
+
+      /* In case of empty queue or queue error, return 0 as Frequency and Duration. */
+      *Frequency = 0;
+      *MSeconds  = 0;
+
+      do
+      {
+        SoundQueuePassive[SoundPassiveTail].Freq = 0;
+        SoundQueuePassive[SoundPassiveTail].MSec = 0;
+
+        /* Advance to next slot. */
+        ++SoundPassiveTail;
+
+        // If reaching out-of-bound, revert to zero.
+        if (SoundPassiveTail >= MAX_PASSIVE_SOUND_QUEUE) SoundPassiveTail = 0;
+      } while (SoundPassiveTail != CurrentTail);  // if we come back to where we started from, sound queue is now empty.
+
+      SoundPassiveHead = SoundPassiveTail;
+
+      if (DebugBitMask & DEBUG_SOUND_QUEUE)
+        uart_send(__LINE__, "- P-Done:             %5u   %5u\r", SoundPassiveHead, SoundPassiveTail);
+    }
+
+    return 0xFF;
+  }
+}
+#endif
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=stack_check() */
+/* ------------------------------------------------------------------ *\
+           Evaluate stack high-water marks of both cores and
+             issue a warning if getting close to overflow.
+\* ------------------------------------------------------------------ */
+void stack_check(void)
+{
+  UINT32 Core0Size;
+  UINT32 Core1Size;
+  UINT32 Peak;
+
+
+  Core0Size = (UINT32)&__StackTop - (UINT32)&__StackBottom;
+
+  /* Core 0 stack is shared between main() and all interrupt handlers (callbacks) of core 0. */
+  Peak = stack_peak(&__StackBottom, &__StackTop);
+  if (Peak > StackCore0Peak)
+  {
+    StackCore0Peak = Peak;
+
+    if ((StackCore0Peak * 100) > (Core0Size * STACK_WARNING))
+    {
+      FlagStackWarning = FLAG_ON;
+      uart_send(__LINE__, "WARNING: core 0 stack high-water mark is %lu bytes out of %lu (%lu%%)\r", StackCore0Peak, Core0Size, (StackCore0Peak * 100) / Core0Size);
+    }
+  }
+
+  /* Core 1 is only used when a DHT22 has been installed. */
+  #ifdef DHT_SUPPORT
+  Core1Size = (UINT32)&__StackOneTop - (UINT32)&__StackOneBottom;
+  Peak = stack_peak(&__StackOneBottom, &__StackOneTop);
+  if (Peak > StackCore1Peak)
+  {
+    StackCore1Peak = Peak;
+
+    if ((StackCore1Peak * 100) > (Core1Size * STACK_WARNING))
+    {
+      FlagStackWarning = FLAG_ON;
+      uart_send(__LINE__, "WARNING: core 1 stack high-water mark is %lu bytes out of %lu (%lu%%)\r", StackCore1Peak, Core1Size, (StackCore1Peak * 100) / Core1Size);
+    }
+  }
+  #endif  // DHT_SUPPORT
+
+  if (DebugBitMask & DEBUG_STACK) stack_display();
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=stack_display() */
+/* ------------------------------------------------------------------ *\
+          Display stack high-water marks through serial port.
+\* ------------------------------------------------------------------ */
+void stack_display(void)
+{
+  uart_send(__LINE__, "Core 0 stack: 0x%8.8X to 0x%8.8X   High-water mark: %5lu bytes out of %5lu\r", (UINT32)&__StackBottom, (UINT32)&__StackTop, StackCore0Peak, (UINT32)&__StackTop - (UINT32)&__StackBottom);
+  if (StackIsrLowest != 0xFFFFFFFF)
+    uart_send(__LINE__, "Deepest callback entry (interrupt context): 0x%8.8X  (%lu bytes below top of core 0 stack)\r", StackIsrLowest, (UINT32)&__StackTop - StackIsrLowest);
+  #ifdef DHT_SUPPORT
+  uart_send(__LINE__, "Core 1 stack: 0x%8.8X to 0x%8.8X   High-water mark: %5lu bytes out of %5lu\r", (UINT32)&__StackOneBottom, (UINT32)&__StackOneTop, StackCore1Peak, (UINT32)&__StackOneTop - (UINT32)&__StackOneBottom);
+  #endif  // DHT_SUPPORT
+
+  return;
+}
+
+
 
 
-    /* Extract data for next sound to play. */
-    *Frequency = SoundQueuePassive[SoundPassiveTail].Freq;
-    *MSeconds  = SoundQueuePassive[SoundPassiveTail].MSec;
 
+/* $PAGE */
+/* $TITLE=stack_paint() */
+/* ------------------------------------------------------------------ *\
+              Paint unused stack space with a known pattern.
+     NOTE: If the stack given is the one currently in use, only the
+           part below current stack pointer (minus a safety margin)
+           is painted.
+\* ------------------------------------------------------------------ */
+void stack_paint(UINT32 *Bottom, UINT32 *Top)
+{
+  UINT32 *CurrentStack;
+  volatile UINT32 StackPointer;
 
-    /* And reset this slot in the sound queue. */
-    SoundQueuePassive[SoundPassiveTail].Freq = 0;
-    SoundQueuePassive[SoundPassiveTail].MSec = 0;
 
-  
-    if ((*Frequency >= 60) && (*Frequency <= 8000) && (*MSeconds != 0) || (*Frequency == SILENT) || (*MSeconds == WAIT_4_ACTIVE))
-    {
-      /* The sound found in this slot is valid. */
-      ++SoundPassiveTail;
+  /* Address of a local variable gives a good approximation of current stack pointer. */
+  CurrentStack = (UINT32 *)(((UINT32)&StackPointer - STACK_MARGIN) & ~0x03);
+  if ((CurrentStack > Bottom) && (CurrentStack < Top)) Top = CurrentStack;
 
-      /* If reaching out-of-bound, revert to zero. */
-      if (SoundPassiveTail >= MAX_PASSIVE_SOUND_QUEUE) SoundPassiveTail = 0;
+  while (Bottom < Top)
+    *Bottom++ = STACK_PATTERN;
 
-      /***
-      if  (DebugBitMask & DEBUG_SOUND_QUEUE)
-        uart_send(__LINE__, "- P-Adjust Tail to:         %5u\r", SoundPassiveTail);
-      ***/
+  return;
+}
 
-      return 0;
-    }
-    else
-    {
-      /* If this slot was corrupted, make some housekeeping. */
-      if  (DebugBitMask & DEBUG_SOUND_QUEUE)
-        uart_send(__LINE__, "- P-Housekeeping from %u   Freq: %5u   MSec: %5u\r", SoundPassiveTail, *Frequency, *MSeconds);
-  
-      CurrentTail = SoundPassiveTail; // keep track of starting position in the queue.
 
-      /* In case of empty queue or queue error, return 0 as Frequency and Duration. */
-      *Frequency = 0;
-      *MSeconds  = 0;
 
-      do
-      {
-        SoundQueuePassive[SoundPassiveTail].Freq = 0;
-        SoundQueuePassive[SoundPassiveTail].MSec = 0;
 
-        /* Advance to next slot. */
-        ++SoundPassiveTail;
 
-        // If reaching out-of-bound, revert to zero.
-        if (SoundPassiveTail >= MAX_PASSIVE_SOUND_QUEUE) SoundPassiveTail = 0;
-      } while (SoundPassiveTail != CurrentTail);  // if we come back to where we started from, sound queue is now empty.
+/* $PAGE */
+/* $TITLE=stack_peak() */
+/* ------------------------------------------------------------------ *\
+       Return the maximum number of bytes that have been used on
+            the given stack since it has been painted.
+\* ------------------------------------------------------------------ */
+UINT32 stack_peak(UINT32 *Bottom, UINT32 *Top)
+{
+  UINT32 *Scan;
 
-      SoundPassiveHead = SoundPassiveTail;
 
-      if (DebugBitMask & DEBUG_SOUND_QUEUE)
-        uart_send(__LINE__, "- P-Done:             %5u   %5u\r", SoundPassiveHead, SoundPassiveTail);
-    }
+  /* Stack grows downward. Find the lowest address where the pattern has been overwritten. */
+  for (Scan = Bottom; Scan < Top; ++Scan)
+    if (*Scan != STACK_PATTERN) break;
 
-    return 0xFF;
-  }
+  return ((UINT32)Top - (UINT32)Scan);
 }
-#endif
 
 
 
@@ -16780,95 +17203,360 @@ Test18:
 
 
 
-  /* Clear framebuffer when done. */
-  clear_framebuffer(0);
+  /* Clear framebuffer when done. */
+  clear_framebuffer(0);
+
+
+
+  /* -------------------------- Snowflakes animation. -------------------------- */
+  /* Initialize Up and Down limits. */
+  for (Loop1UInt16 = 0; Loop1UInt16 < 23; ++Loop1UInt16)
+  {
+    ColumnUp[Loop1UInt16]   = 0;
+    ColumnDown[Loop1UInt16] = 0;
+  }
+
+
+  /* Perform animation for the specified number of seconds. */
+  DurationSeconds = 15;
+  StartTimer = (UINT64)time_us_64();
+  while ((CurrentTimer = (UINT64)time_us_64()) < (StartTimer + (DurationSeconds * 1000000)))
+  {
+    do
+    {
+      Column = ((rand() % 22) + 1);
+    } while (Column % 2);
+  
+    if (DebugBitMask & DEBUG_TEMP)
+      uart_send(__LINE__, "Random Column: %2u   ColumnUp[%2u]: %u   ColumnDown[%2u]: %u ", Column, Column, ColumnUp[Column], Column, ColumnDown[Column]);
+
+
+    if (CurrentTimer < (StartTimer + ((DurationSeconds - 3) * 1000000)))
+      uart_send(__LINE__, "- Not the time to purge yet...\r");
+    else
+      uart_send(__LINE__, "- Time to purge NOW...\r");
+
+
+    if ((ColumnUp[Column] == 0) && (CurrentTimer < (StartTimer + ((DurationSeconds - 3) * 1000000))))
+    {
+      /* Empty column, set the up and down limits for it. */
+      Row = ((rand() % 3) + 1);
+      ColumnUp[Column]   = Row;
+      ColumnDown[Column] = Row;
+    
+      set_pixel(ColumnDown[Column], Column, FLAG_ON);
+
+      if (DebugBitMask & DEBUG_TEMP)
+        uart_send(__LINE__, "- Empty column - Random Row: %u   Turn  On pixel %u, %2u\r", Row, Row, Column);
+    }
+    else
+    {
+      /* Column already occupied or five seconds before end of animation... check current down position. */
+      if (DebugBitMask & DEBUG_TEMP)
+        uart_send(__LINE__, "- Occupied - Up[%2u]: %u   Down[%2u]: %u ", Column, ColumnUp[Column], Column, ColumnDown[Column]);
+
+      if ((ColumnDown[Column] < 7) && (ColumnDown[Column] != 0))
+      {
+        ++ColumnDown[Column];
+        set_pixel(ColumnDown[Column], Column, FLAG_ON);
+        
+        if (DebugBitMask & DEBUG_TEMP)
+          uart_send(__LINE__, "- Turn  On pixel %u, %2u\r", ColumnDown[Column], Column);
+      }
+      else
+      {
+        /* We already reached the lowest down mark, erase falling flake. */
+        if (DebugBitMask & DEBUG_TEMP)
+          uart_send(__LINE__, "- Turn Off pixel %u, %2u\r", ColumnUp[Column], Column);
+
+        set_pixel(ColumnUp[Column], Column, FLAG_OFF);
+        ++ColumnUp[Column];
+
+        /* If this column is totally erased, re-initialize it. */
+        if (ColumnUp[Column] == 8)
+        {
+          ColumnUp[Column]   = 0;
+          ColumnDown[Column] = 0;
+        }
+      }
+    }
+    sleep_ms(10);
+  }
+  
+  /* Return to normal time display mode. */
+  show_time();
+
+  return;
+  /* ------------------------------------------------------------------ *\
+          END - Test 18 - PWM tests for clock display brightness.
+  \* ------------------------------------------------------------------ */
+}
+#endif
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_check_rtc() */
+/* ------------------------------------------------------------------ *\
+       Compare the time base with the real-time clock IC and resync
+      the time base if they are more than one second apart (the Pico
+      crystal drifts more than the DS3231, and the RTC IC is set by
+      clock setup). Date fields are derived again in any case, since
+              clock setup may have changed them directly.
+\* ------------------------------------------------------------------ */
+void time_base_check_rtc(void)
+{
+  int64_t Delta;
+  int64_t Step;
+
+
+  Delta = (int64_t)time_base_read_rtc() - (int64_t)(time_base_us() / 1000000ULL);
+
+  if (DebugBitMask & DEBUG_RTC)
+    uart_send(__LINE__, "Time base check: RTC IC - time base = %lld sec\r", Delta);
+
+  /* One second apart may only be the phase between both second ticks. */
+  if ((Delta > 1) || (Delta < -1))
+  {
+    /* Keep track of the step, it is part of the drift seen by next NTP sync (see time_base_discipline()). */
+    Step = (int64_t)time_base_us() - (int64_t)time_us_64();
+    time_base_sync_rtc();
+    TimeBase.SyncSteps += ((int64_t)time_base_us() - (int64_t)time_us_64()) - Step;
+
+    /* Local time moved, reschedule what waits for a given local time. Confirm with NTP without waiting for the poll interval. */
+    command_queue(COMMAND_REMINDER_RESET, 0);
+    command_queue(COMMAND_ALARM_SCHEDULE, 0);
+    command_queue(COMMAND_CHIME_SCHEDULE, 0);
+    NTPData.FlagNTPResync = FLAG_ON;
+  }
+  else
+  {
+    TimeCivilDay = -1;  // force date fields to be derived again.
+    time_civil_update();
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_discipline() */
+/* ------------------------------------------------------------------ *\
+       Discipline the time base with an NTP result: UTC time
+       "UnixTimeUs" (in usec since 01-JAN-1970) at Pico timer value
+       "TimerValue". The frequency error of the Pico crystal is
+       learned and the phase error is slewed or stepped by
+       time_base_adjust() (see time_base.c). The frequency correction
+       is saved to flash, so that the clock keeps time after a
+                             reboot.
+                   Return the phase error (in usec).
+\* ------------------------------------------------------------------ */
+int64_t time_base_discipline(UINT64 UnixTimeUs, UINT64 TimerValue)
+{
+  UINT32 InterruptMask;
+
+  struct time_base_sync Sync;
+
+
+  /* The time base is read by timer_callback_s(), make sure it never sees half of it. */
+  InterruptMask = save_and_disable_interrupts();
+  time_base_adjust(&TimeBase, UnixTimeUs, TimerValue, time_us_64(), &Sync);
+  if (Sync.FlagStep) TimeCivilDay = -1;  // force date fields to be derived again.
+  restore_interrupts(InterruptMask);
+
+  if (Sync.FreqStatus == TIME_BASE_FREQ_REJECTED)
+  {
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "Frequency error out of range (%lld ppb), ignored.\r", Sync.FreqError);
+  }
+  else if (Sync.FreqStatus == TIME_BASE_FREQ_UPDATED)
+  {
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "Frequency error: %lld ppb over %lld sec   Frequency correction: %ld ppb\r", Sync.FreqError, Sync.Interval / 1000000LL, TimeBase.Freq);
+
+    /* Saved to flash by flash_check_config() (only if it changed enough, to spare flash). */
+    if (((TimeBase.Freq - FlashConfig.TimeBaseFreq) >= TIME_FREQ_SAVE) || ((FlashConfig.TimeBaseFreq - TimeBase.Freq) >= TIME_FREQ_SAVE))
+      FlashConfig.TimeBaseFreq = TimeBase.Freq;
+  }
+
+  time_civil_update();
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "Time base %s: phase error %lld usec\r", (Sync.FlagStep) ? "stepped" : "slewed", Sync.Phase);
+
+  return Sync.Phase;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_read_rtc() */
+/* ------------------------------------------------------------------ *\
+        Read the real-time clock IC (that keeps local time) and
+                 return its time as UTC Unix time.
+\* ------------------------------------------------------------------ */
+UINT64 time_base_read_rtc(void)
+{
+  int64_t LocalTime;
+
+  TIME_RTC RealTimeClock;
+
+
+  RealTimeClock = Read_RTC();
+
+  LocalTime = ((int64_t)civil_days((FlashConfig.CurrentYearCentile * 100) + bcd_to_byte(RealTimeClock.year), bcd_to_byte(RealTimeClock.month), bcd_to_byte(RealTimeClock.dayofmonth)) * CIVIL_SECONDS_PER_DAY) +
+              (bcd_to_byte(RealTimeClock.hour) * 3600L) + (bcd_to_byte(RealTimeClock.minutes) * 60L) + bcd_to_byte(RealTimeClock.seconds);
+
+  return (UINT64)(LocalTime - get_utc_offset());
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_set() */
+/* ------------------------------------------------------------------ *\
+       Set the time base so that UTC time "UnixTimeUs" (in usec since
+       01-JAN-1970) corresponds to Pico timer value "TimerValue" (in
+          usec), and derive civil time fields again. The one-second
+         callback re-phases itself on the new time base on its next
+                              call.
+\* ------------------------------------------------------------------ */
+void time_base_set(UINT64 UnixTimeUs, UINT64 TimerValue)
+{
+  UINT32 InterruptMask;
+
+
+  /* The time base is read by timer_callback_s(), make sure it never sees half of it. The frequency correction is kept, a slew in progress is dropped. */
+  InterruptMask = save_and_disable_interrupts();
+  time_base_origin(&TimeBase, UnixTimeUs, TimerValue);
+  TimeCivilDay  = -1;  // force date fields to be derived again.
+  restore_interrupts(InterruptMask);
+
+  time_civil_update();
+
+  if (DebugBitMask & DEBUG_RTC)
+    uart_send(__LINE__, "Time base set: UTC %llu usec at timer %llu usec   Frequency correction: %ld ppb\r", UnixTimeUs, TimerValue, TimeBase.Freq);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_sync_rtc() */
+/* ------------------------------------------------------------------ *\
+        Set the time base from the real-time clock IC. Since the RTC
+      IC gives whole seconds only, wait for its next second change
+      (at most one second) so that the time base starts on a second
+                             boundary.
+\* ------------------------------------------------------------------ */
+void time_base_sync_rtc(void)
+{
+  UINT64 Start;
+  UINT64 TimeOut;
+  UINT64 UnixTime;
+
+
+  Start   = time_base_read_rtc();
+  TimeOut = time_us_64() + 1100000ULL;
+  do
+  {
+    UnixTime = time_base_read_rtc();
+  } while ((UnixTime == Start) && (time_us_64() < TimeOut));
+
+  time_base_set(UnixTime * 1000000ULL, time_us_64());
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_timer_us() */
+/* ------------------------------------------------------------------ *\
+       Return the Pico timer duration (in usec) matching a duration
+       "Duration" of the time base beginning now, to program a Pico
+        alarm on an exact second of the time base in spite of the
+           frequency correction and of a phase slew in progress.
+\* ------------------------------------------------------------------ */
+UINT64 time_base_timer_us(UINT64 Duration)
+{
+  return time_base_duration(&TimeBase, time_us_64(), Duration);
+}
+
+
 
 
 
-  /* -------------------------- Snowflakes animation. -------------------------- */
-  /* Initialize Up and Down limits. */
-  for (Loop1UInt16 = 0; Loop1UInt16 < 23; ++Loop1UInt16)
-  {
-    ColumnUp[Loop1UInt16]   = 0;
-    ColumnDown[Loop1UInt16] = 0;
-  }
+/* $PAGE */
+/* $TITLE=time_base_us() */
+/* ------------------------------------------------------------------ *\
+       Return current UTC time, in usec since 01-JAN-1970 00h00.
+       This is the only time base of the clock, all other time
+       values are derived from it (see time_base_at() in time_base.c
+       for the corrections applied to the Pico timer). Since
+       timer_callback_s() re-phases itself on the time base every
+         second, its period follows the frequency correction.
+\* ------------------------------------------------------------------ */
+UINT64 time_base_us(void)
+{
+  return time_base_at(&TimeBase, time_us_64());
+}
 
 
-  /* Perform animation for the specified number of seconds. */
-  DurationSeconds = 15;
-  StartTimer = (UINT64)time_us_64();
-  while ((CurrentTimer = (UINT64)time_us_64()) < (StartTimer + (DurationSeconds * 1000000)))
-  {
-    do
-    {
-      Column = ((rand() % 22) + 1);
-    } while (Column % 2);
-  
-    if (DebugBitMask & DEBUG_TEMP)
-      uart_send(__LINE__, "Random Column: %2u   ColumnUp[%2u]: %u   ColumnDown[%2u]: %u ", Column, Column, ColumnUp[Column], Column, ColumnDown[Column]);
 
 
-    if (CurrentTimer < (StartTimer + ((DurationSeconds - 3) * 1000000)))
-      uart_send(__LINE__, "- Not the time to purge yet...\r");
-    else
-      uart_send(__LINE__, "- Time to purge NOW...\r");
 
+/* $PAGE */
+/* $TITLE=time_civil_update() */
+/* ------------------------------------------------------------------ *\
+        Derive GlobalUnixTime and local civil time fields (CurrentHour,
+      CurrentDayOfMonth, etc...) from the time base. Date fields are
+       computed again only when the local day changes (at midnight,
+          or when time, timezone or Daylight Saving Time changes).
+\* ------------------------------------------------------------------ */
+void time_civil_update(void)
+{
+  int32_t Day;
 
-    if ((ColumnUp[Column] == 0) && (CurrentTimer < (StartTimer + ((DurationSeconds - 3) * 1000000))))
-    {
-      /* Empty column, set the up and down limits for it. */
-      Row = ((rand() % 3) + 1);
-      ColumnUp[Column]   = Row;
-      ColumnDown[Column] = Row;
-    
-      set_pixel(ColumnDown[Column], Column, FLAG_ON);
+  UINT32 SecondOfDay;
 
-      if (DebugBitMask & DEBUG_TEMP)
-        uart_send(__LINE__, "- Empty column - Random Row: %u   Turn  On pixel %u, %2u\r", Row, Row, Column);
-    }
-    else
-    {
-      /* Column already occupied or five seconds before end of animation... check current down position. */
-      if (DebugBitMask & DEBUG_TEMP)
-        uart_send(__LINE__, "- Occupied - Up[%2u]: %u   Down[%2u]: %u ", Column, ColumnUp[Column], Column, ColumnDown[Column]);
+  int64_t LocalTime;
 
-      if ((ColumnDown[Column] < 7) && (ColumnDown[Column] != 0))
-      {
-        ++ColumnDown[Column];
-        set_pixel(ColumnDown[Column], Column, FLAG_ON);
-        
-        if (DebugBitMask & DEBUG_TEMP)
-          uart_send(__LINE__, "- Turn  On pixel %u, %2u\r", ColumnDown[Column], Column);
-      }
-      else
-      {
-        /* We already reached the lowest down mark, erase falling flake. */
-        if (DebugBitMask & DEBUG_TEMP)
-          uart_send(__LINE__, "- Turn Off pixel %u, %2u\r", ColumnUp[Column], Column);
 
-        set_pixel(ColumnUp[Column], Column, FLAG_OFF);
-        ++ColumnUp[Column];
+  GlobalUnixTime = time_base_us() / 1000000ULL;
+  LocalTime      = (int64_t)GlobalUnixTime + get_utc_offset();
+  Day            = (int32_t)(LocalTime / (int64_t)CIVIL_SECONDS_PER_DAY);
+  SecondOfDay    = (UINT32)(LocalTime % (int64_t)CIVIL_SECONDS_PER_DAY);
 
-        /* If this column is totally erased, re-initialize it. */
-        if (ColumnUp[Column] == 8)
-        {
-          ColumnUp[Column]   = 0;
-          ColumnDown[Column] = 0;
-        }
-      }
-    }
-    sleep_ms(10);
+  if (Day != TimeCivilDay)
+  {
+    civil_from_days(Day, &CurrentYear, &CurrentMonth, &CurrentDayOfMonth);
+    CurrentYearLowPart = CurrentYear % 100;
+    CurrentDayOfWeek   = civil_weekday(Day) + 1;  // 1 = SUN to 7 = SAT.
+    CurrentDayOfYear   = civil_day_of_year(CurrentYear, CurrentMonth, CurrentDayOfMonth);
+    TimeCivilDay       = Day;
   }
-  
-  /* Return to normal time display mode. */
-  show_time();
+
+  CurrentHour   = SecondOfDay / 3600;
+  CurrentMinute = (SecondOfDay / 60) % 60;
+  CurrentSecond = SecondOfDay % 60;
 
   return;
-  /* ------------------------------------------------------------------ *\
-          END - Test 18 - PWM tests for clock display brightness.
-  \* ------------------------------------------------------------------ */
 }
-#endif
 
 
 
@@ -16890,6 +17578,10 @@ bool timer_callback_ms(struct repeating_timer *TimerMSec)
   UINT8 Loop1UInt8;
 
 
+  /* Keep track of the deepest stack pointer seen in interrupt context. */
+  if ((UINT32)&String[0] < StackIsrLowest) StackIsrLowest = (UINT32)&String[0];
+
+
   Dum1UInt8 = 0;
 
   adjust_clock_brightness();  // read ambient light every millisecond and calculate average for last 60 seconds.
@@ -17267,26 +17959,25 @@ bool timer_callback_s(struct repeating_timer *TimerSec)
   UCHAR String1[64];
 
   UINT8 CurrentDutyCycle;
-  UINT8 Dum1UInt8;
-  static UINT8 FlagChimeDone     = FLAG_OFF;  // indicates that hourly chime has already been triggered for current hour.
-  static UINT8 FlagChimeHalfDone = FLAG_OFF;  // if "On", indicates that half-hour chime has already been triggered for current hour.
-  static UINT8 FlagEventDone     = FLAG_OFF;  // to prevent duplication of Calendar Events.
   UINT8 Loop1UInt8;
   UINT8 Loop2UInt8;
-  UINT8 TotalBeeps;
 
   static UINT16 AlarmRingTime[MAX_ALARMS];    // cumulative number of seconds alarm has been ringing.
   UINT16 BeepLength;
   static UINT16 CountDownAlarmDuration;       // keep track of curent cumulative time (in seconds) count-down alarm has been sounding so far.
   static UINT16 CountDownDelay;               // delay (in seconds) betweek each count-down alarm sound burst.
   UINT16 LightLevel;
-  static UINT16 PreviousYear;
+  UINT16 TotalBeeps;
 
   UINT64 Timer1;
   UINT64 Timer2;
   static UINT64 PreviousTimer;
 
 
+  /* Keep track of the deepest stack pointer seen in interrupt context. */
+  if ((UINT32)&String[0] < StackIsrLowest) StackIsrLowest = (UINT32)&String[0];
+
+
   /* Indicate that we just entered callback_s. */
   /***
   if ((DebugBitMask & DEBUG_SOUND_QUEUE) || (DebugBitMask & DEBUG_TIMING))
@@ -17312,71 +18003,33 @@ bool timer_callback_s(struct repeating_timer *TimerSec)
                           Manage time of day
                       and Daylight Saving Time.
   \* ................................................................ */
-  ++CurrentSecond;
-  ++GlobalUnixTime;
-
-    
-  if ((CurrentMinute == 0) && (CurrentSecond == 1))
-  {
-    /* Since we just changed hour, check for an eventual change in Daylight Saving Time status.
-       Wait two seconds in case there is a small discrepancy between Green Clock real-time and RTC IC. */
-    update_dst_status();
-  }
+  /* Time of day is derived from the time base (next callback is scheduled when leaving, see below). */
+  time_civil_update();
 
 
-  if (CurrentSecond == 60)
+  /* Local time is copied to the real-time clock IC right at the beginning of the second (in main() context, since it requires I2C transactions). */
+  if (FlagRtcWrite == FLAG_ON)
   {
-    ++CurrentMinute;
-    CurrentSecond = 0; // reset second counter.
-
-    /* Reset FlagChimeHalfDone to get prepared for next half-hour chime. */
-    if (CurrentMinute == 32)
-    {
-      FlagChimeHalfDone = FLAG_OFF;
-
-      if (DebugBitMask & DEBUG_CHIME)
-        uart_send(__LINE__, "Resetting FlagChimeHalfDone: 0x%2.2X   Hour: %2u   Minute: %2u   CurrentSecond: %2u\r", FlagChimeHalfDone, CurrentHour, CurrentMinute, CurrentSecond);
-    }
-
-    /* Reset FlagChimeDone to get prepared for next hour chime. */
-    if (CurrentMinute == 2)
-    {
-      FlagChimeDone = FLAG_OFF;
-
-      if (DebugBitMask & DEBUG_CHIME)
-        uart_send(__LINE__, "Resetting FlagChimeDone: 0x%2.2X   Hour: %2u   Minute: %2u   CurrentSecond: %2u\r", FlagChimeDone, CurrentHour, CurrentMinute, CurrentSecond);
-
-      
-      /* Perform this check at 0h02, out of peak period. */
-      if (CurrentYear != PreviousYear)
-      {
-        /* We just changed year, find specific days for Daylight Saving Time change for this year. */
-        get_dst_days();
-
-        PreviousYear = CurrentYear;
-      }
-    }
-
-
-    /* Reset FlagEventDone to get prepared for next iteration. */
-    if (((EVENT_MINUTE1 < 57) && (CurrentMinute == (EVENT_MINUTE1 + 2))) || ((EVENT_MINUTE1 >= 57) && (CurrentMinute == 2)))
-      FlagEventDone = FLAG_OFF;
-
-    if (((EVENT_MINUTE2 < 57) && (CurrentMinute == (EVENT_MINUTE2 + 2))) || ((EVENT_MINUTE2 >= 57) && (CurrentMinute == 2)))
-      FlagEventDone = FLAG_OFF;
-
+    FlagRtcWrite = FLAG_OFF;
+    command_queue(COMMAND_RTC_WRITE, 0);
+  }
 
 
-    if (CurrentMinute == 60)
-    {
-      CurrentMinute = 0;  // reset minute counter.
-      ++CurrentHour;
+  /* Daylight Saving Time changes at the exact second of the transition (UTC epochs precomputed in TzCache). */
+  if ((int64_t)GlobalUnixTime >= TzCache.Next)
+    update_dst_status();
 
-      if (CurrentHour == 24) CurrentHour = 0;  // if out-of-bound, revert to 0.
-    }
 
+  if ((CurrentMinute == 0) && (CurrentSecond == 1))
+  {
+    /* Once an hour, check the time base against the RTC IC (in main() context, since it requires I2C transactions). */
+    command_queue(COMMAND_TIME_CHECK, 0);
+  }
 
 
+  /* Hourly and half-hour chimes, calendar events and the year change check are performed by chime_callback() (see ChimeSchedule[]). */
+  if (CurrentSecond == 0)
+  {
     /* Log tag. */
     if (DebugBitMask & DEBUG_TIMING)
       uart_send(__LINE__, "-1");
@@ -17435,9 +18088,9 @@ bool timer_callback_s(struct repeating_timer *TimerSec)
       TotalBeeps = 0;
       for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
       {
-        if (AlarmReachedBitMask & (1 << Loop1UInt8))
+        if (AlarmReachedBitMask & (1ULL << Loop1UInt8))
         {
-          TotalBeeps += (Loop1UInt8 + 1);
+          TotalBeeps += ((Loop1UInt8 % 9) + 1);
         }
       }
 
@@ -17462,210 +18115,44 @@ bool timer_callback_s(struct repeating_timer *TimerSec)
       /* Trigger ringer for each alarm condition reached. */
       for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
       {
-        if (AlarmReachedBitMask & (1 << Loop1UInt8))
+        if (AlarmReachedBitMask & (1ULL << Loop1UInt8))
         {
           if (DebugBitMask & DEBUG_ALARMS)
             uart_send(__LINE__, "-AL %u ON   RingTime: %u\r", Loop1UInt8 + 1, AlarmRingTime[Loop1UInt8]);
 
           /* Check if this alarm has been ringing for specified ring time. */
           AlarmRingTime[Loop1UInt8] += ALARM_PERIOD;
-          if (AlarmRingTime[Loop1UInt8] >= MAX_ALARM_RING_TIME)
-          {
-            /* This alarm has been sounding for the specified ring time now... Turn it Off. */
-            AlarmReachedBitMask &= ~(1 << Loop1UInt8);
-
-            /* Reset total ringing time. */
-            AlarmRingTime[Loop1UInt8] = 0;
-
-            if (DebugBitMask & DEBUG_ALARMS)
-              uart_send(__LINE__, "-Bitmask: %8.8X\r", AlarmReachedBitMask);
-
-            break;  // skip to check next alarm.
-          }
-
-
-          #ifdef PASSIVE_PIEZO_SUPPORT
-          for (Loop2UInt8 = 0; Loop2UInt8 < (Loop1UInt8 + 1); ++Loop2UInt8)
-          {
-            sound_queue_passive(600 + (Loop1UInt8 * 150), BeepLength);
-            sound_queue_passive(SILENT, 50); // separate each beep in the train of beeps.
-          }
-          sound_queue_passive(SILENT, 150);  // separate the train of beeps of an alarm from each other.
-          #else
-          sound_queue_active(BeepLength, Loop1UInt8 + 1);
-          sound_queue_active(500, SILENT);   // separate the train of beeps of an alarm from each other.
-          #endif
-        }
-      }
-    }
-  }
-
-
-
-  /* Log tag. */
-  if (DebugBitMask & DEBUG_TIMING)
-    uart_send(__LINE__, "-3");
-
-
-
-  /* ................................................................ *\
-        Check alarms and turn On corresponding bit in the bitmask
-                     when reaching all alarm conditions.
-  \* ................................................................ */
-  /* Scan all alarms. The check is done during an off-peak second (not 00, 14, 44). */
-  if (CurrentSecond == 29)
-  {
-    for (Loop1UInt8 = 0; Loop1UInt8 < 9; ++Loop1UInt8)
-    {
-      /* If this alarm is Off, skip it. */
-      if (FlashConfig.Alarm[Loop1UInt8].FlagStatus == FLAG_OFF)
-      {
-        if (DebugBitMask & DEBUG_ALARMS)
-          uart_send(__LINE__, "-[%2.2u]: Off\r", Loop1UInt8);
-
-        continue;
-      }
-
-      /* This alarm is On, check if current day-of-week is defined in the "day-mask". */
-      if ((FlashConfig.Alarm[Loop1UInt8].Day & (1 << CurrentDayOfWeek)) == 0)
-      {
-        if (DebugBitMask & DEBUG_ALARMS)
-          uart_send(__LINE__, "-[%2.2u]: Wrong day    (%2.2X VS %2.2X)\r", Loop1UInt8, FlashConfig.Alarm[Loop1UInt8].Day, (1 << CurrentDayOfWeek));
-
-        continue;
-      }
-
-      /* Current day-of-week is defined in DayMask, check if current hour is the "alarm-hour". */
-      if (FlashConfig.Alarm[Loop1UInt8].Hour != CurrentHour)
-      {
-        if (DebugBitMask & DEBUG_ALARMS)
-          uart_send(__LINE__, "-[%2.2u]: Wrong hour   (%2.2u VS %2.2u)\r", Loop1UInt8, FlashConfig.Alarm[Loop1UInt8].Hour, CurrentHour);
-
-        continue;
-      }
-
-      /* Current hour is the "alarm hour", check if current minute is the "alarm-minute". */
-      if (FlashConfig.Alarm[Loop1UInt8].Minute != CurrentMinute)
-      {
-        if (DebugBitMask & DEBUG_ALARMS)
-          uart_send(__LINE__, "-[%2.2u]: Wrong minute (%2.2u VS %2.2u)\r", Loop1UInt8, FlashConfig.Alarm[Loop1UInt8].Minute, CurrentMinute);
-
-        continue;
-      }
-
-      /* We reach this point if we comply with all alarm conditions. */
-      if (DebugBitMask & DEBUG_ALARMS)
-        uart_send(__LINE__, "-[%2.2u]: **Reached**\r", Loop1UInt8);
-
-      /* Set the bit corresponding to this alarm in the alarm bit mask. */
-      AlarmReachedBitMask |= (1 << Loop1UInt8);
-
-      if (DebugBitMask & DEBUG_ALARMS)
-        uart_send(__LINE__, "-BitMask: 0x%4.4X\r\r", AlarmReachedBitMask);
-
-      /* If there is a string associated with this alarm, scroll it on clock display. */
-      if (FlashConfig.Alarm[Loop1UInt8].Text[0] != 0x00)
-        scroll_string(24, FlashConfig.Alarm[Loop1UInt8].Text);
-    }
-  }
-
-
-
-  /* Log tag. */
-  if (DebugBitMask & DEBUG_TIMING)
-    uart_send(__LINE__, "-4");
-
-
-
-  /* ................................................................ *\
-                       Hourly and half-hour chimes.
-  \* ................................................................ */
-  /* Hourly chime will never sound if set to Off and will always sound if set to On (except if user requested a silence period - see remote control).
-     However, if Hourly chime is set to Day "OI" ("On, Intermittent" in clock setup), here is what happens:
-
-     "Daytime workers":
-     Hourly chime "normal behavior": When "Chime time On" is smaller than "Chime time Off".
-     For example: "Chime time On" = 9h00 and "Chime time Off" is 21h00. Chime will sound between (and including) 9h00 and 21h00 as we would expect (and will be silent otherwise).
-
-     "Nighttime workers":
-     Hourly chime "special behavior": When "Chime time On" is greater than "Chime time Off".
-     For example: "Chime time On" = 21h00 and "Chime time Off" is 9h00. Chime will sound AFTER 21h00 and BEFORE 9h00 (and will be silent otherwise).
-     (That is, will not sound between 9h00 and 21h00). */
-  if (DebugBitMask & DEBUG_CHIME)
-  {
-    CurrentDutyCycle = Pwm[PWM_BRIGHTNESS].DutyCycle;
-    pwm_set_duty_cycle(0);  // blank display so that we don't see frozen display while LED scanning is delayed by UART.
-
-    uart_send(__LINE__, "H: %2u   (HS: %2u)   M: %2u   (MS: %2u)   S: %2u   FCD: 0x%2.2X\r", CurrentHour, CurrentHourSetting, CurrentMinute, CurrentMinuteSetting, CurrentSecond, FlagChimeDone);
-    
-    uart_send(__LINE__, "ChimeMode:  %u   On: %2u   Off: %2u   FlagSetupClock[MIN]: 0x%2.2X\r\r", FlashConfig.ChimeMode, FlashConfig.ChimeTimeOn, FlashConfig.ChimeTimeOff, FlagSetupClock[SETUP_MINUTE]);
-
-    pwm_set_duty_cycle(CurrentDutyCycle);  // restore display when done.
-  }
-
-  if ((SilencePeriod == 0) &&
-     ((FlashConfig.ChimeMode == CHIME_ON) ||                                                                                                                                                       // always On
-     ((FlashConfig.ChimeMode == CHIME_DAY) && (FlashConfig.ChimeTimeOn  < FlashConfig.ChimeTimeOff) && (CurrentHour >= FlashConfig.ChimeTimeOn)  && (CurrentHour <= FlashConfig.ChimeTimeOff)) ||  // "normal behavior"  for daytime workers.
-     ((FlashConfig.ChimeMode == CHIME_DAY) && (FlashConfig.ChimeTimeOff < FlashConfig.ChimeTimeOn) && ((CurrentHour >= FlashConfig.ChimeTimeOff) || (CurrentHour <= FlashConfig.ChimeTimeOn)))))   // "special behavior" for nighttime workers.
-  {
-    /* Half-hour chime. */
-    if ((CurrentMinute == 30) && (FlagChimeHalfDone == FLAG_OFF) && (FlagSetupClock[SETUP_MINUTE] == FLAG_OFF))
-    {
-      /* Indicate that half-hour chime has been done for current half-hour chime. */
-      FlagChimeHalfDone = FLAG_ON;
-
-      sound_queue_active(50, 2);
-    }
-
-
-
-    /* Hourly chime. */
-    if ((CurrentMinute == 0) && (FlagChimeDone == FLAG_OFF) && (FlagSetupClock[SETUP_MINUTE] == FLAG_OFF))
-    {
-      /* Indicate that hourly chime has been done for current hour chime. */
-      FlagChimeDone = FLAG_ON;
-
-      if (DebugBitMask & DEBUG_CHIME)
-        uart_send(__LINE__, "Queueing hourly chime...\r");
-
-      /* If user select option where hourly chime to be equivalent to hour value. */
-      if (CHIME_HOUR_COUNT)
-      {
-        /* Number of "beeps" correspond to hour value in 12-hour format. */
-        Dum1UInt8 = CurrentHour;
-        if (CurrentHour > 12) Dum1UInt8 -= 12;
-        for (Loop1UInt8 = 0; Loop1UInt8 < Dum1UInt8; ++Loop1UInt8)
-        {
-          sound_queue_active(CHIME_HOUR_COUNT_BEEP_DURATION, 1);
-          sound_queue_active(CHIME_HOUR_COUNT_BEEP_DURATION, SILENT);
-        }
-      }
-      else
-      {
-        /* If CHIME_HOUR_COUNT is Off, use normal hourly chime. */
-        for (Loop1UInt8 = 0; Loop1UInt8 < TONE_CHIME_REPEAT2; ++Loop1UInt8)  // second repeat level.
-        {
-          sound_queue_active(TONE_CHIME_DURATION, TONE_CHIME_REPEAT1);       // first repeat level.
-          sound_queue_active(50, SILENT);
-        }
-        sound_queue_active(100, SILENT);
-      }
- 
-      #ifdef PASSIVE_PIEZO_SUPPORT
-      /* Let the time to complete the active buzzer hourly chime. */
-      sound_queue_passive(SILENT, WAIT_4_ACTIVE);
+          if (AlarmRingTime[Loop1UInt8] >= MAX_ALARM_RING_TIME)
+          {
+            /* This alarm has been sounding for the specified ring time now... Turn it Off. */
+            AlarmReachedBitMask &= ~(1ULL << Loop1UInt8);
 
-      /* Close encounter of the third kind. */
-      play_jingle(JINGLE_ENCOUNTER);
-      #endif  // PASSIVE_PIEZO_SUPPORT
-    }
-  }
+            /* Reset total ringing time. */
+            AlarmRingTime[Loop1UInt8] = 0;
+
+            if (DebugBitMask & DEBUG_ALARMS)
+              uart_send(__LINE__, "-Bitmask: %16.16llX\r", AlarmReachedBitMask);
 
+            break;  // skip to check next alarm.
+          }
 
 
-  /* Log tag. */
-  if (DebugBitMask & DEBUG_TIMING)
-    uart_send(__LINE__, "-5");
+          #ifdef PASSIVE_PIEZO_SUPPORT
+          /* Alarms 1 to 9 give 1 to 9 beeps, and so on for alarms 10 to 18, etc. */
+          for (Loop2UInt8 = 0; Loop2UInt8 < ((Loop1UInt8 % 9) + 1); ++Loop2UInt8)
+          {
+            sound_queue_passive(600 + ((Loop1UInt8 % 9) * 150), BeepLength);
+            sound_queue_passive(SILENT, 50); // separate each beep in the train of beeps.
+          }
+          sound_queue_passive(SILENT, 150);  // separate the train of beeps of an alarm from each other.
+          #else
+          sound_queue_active(BeepLength, (Loop1UInt8 % 9) + 1);
+          sound_queue_active(500, SILENT);   // separate the train of beeps of an alarm from each other.
+          #endif
+        }
+      }
+    }
+  }
 
 
 
@@ -17891,72 +18378,6 @@ bool timer_callback_s(struct repeating_timer *TimerSec)
 
 
 
-  /* Log tag. */
-  if (DebugBitMask & DEBUG_TIMING)
-    uart_send(__LINE__, "-9");
-
-
-
-  /* ................................................................ *\
-                             Calendar events.
-              Check if we should scroll a calendar event.
-         This check is done twice an hour, at XXh14m and XXh44m.
-  \* ................................................................ */
-  /***
-  if (DebugBitMask & DEBUG_EVENT)
-    uart_send(__LINE__, "CurrentMinute: %2u   CurrentSecond: %2u   Check min1: %2u  Check min2: %2u   FlagEventDone: 0x%2.2X\r", CurrentMinute, CurrentSecond, EVENT_MINUTE1, EVENT_MINUTE2, FlagEventDone);
-  ***/
-
-
-  if ((CurrentSecond == 0) && (FlagEventDone == FLAG_OFF) && ((CurrentMinute == EVENT_MINUTE1) || (CurrentMinute == EVENT_MINUTE2)))
-  {
-    /* Prevent repeats. */
-    FlagEventDone = FLAG_ON;
-
-    for (Loop1UInt8 = 0; Loop1UInt8 < MAX_EVENTS; ++Loop1UInt8)
-    {
-      if ((CalendarEvent[Loop1UInt8].Day == CurrentDayOfMonth) && (CalendarEvent[Loop1UInt8].Month == CurrentMonth))
-      {
-        /* Scroll text corresponding to this event on clock display. */
-        scroll_queue(Loop1UInt8);  // when Tag number is lower than MAX_EVENTS, it means to scroll the Calendar Event Text.
-
-        /* Sound "event tones" in compliance with clock Chime settings. */
-        if ((SilencePeriod == 0) &&
-           ((FlashConfig.ChimeMode == CHIME_ON) ||                                                                                                                                                                      // always On
-           ((FlashConfig.ChimeMode == CHIME_DAY) && (FlashConfig.ChimeTimeOn  < FlashConfig.ChimeTimeOff) && (CurrentHourSetting  >= FlashConfig.ChimeTimeOn)  && (CurrentHourSetting <= FlashConfig.ChimeTimeOff)) ||  // "normal behavior"  for daytime workers.
-           ((FlashConfig.ChimeMode == CHIME_DAY) && (FlashConfig.ChimeTimeOff < FlashConfig.ChimeTimeOn)  && ((CurrentHourSetting >= FlashConfig.ChimeTimeOff) || (CurrentHourSetting <= FlashConfig.ChimeTimeOn)))))   // "special behavior" for nighttime workers.
-        {
-          /* Calendar Event sounds with active buzzer. */
-          for (Loop2UInt8 = 0; Loop2UInt8 < TONE_EVENT_REPEAT2; ++Loop2UInt8)
-          {
-            sound_queue_active(TONE_EVENT_DURATION, TONE_EVENT_REPEAT1);
-            sound_queue_active(100, SILENT);
-          }
-
-          #ifdef PASSIVE_PIEZO_SUPPORT
-          /* Calendar Event sounds with passive buzzer if one has been installed by user, and if a jingle is defined with this Calendar Event. */
-          if (CalendarEvent[Loop1UInt8].Jingle != 0)
-          {
-            sound_queue_passive(SILENT, WAIT_4_ACTIVE);  // jingle should begin only after active buzzer has completed.
-
-            /* If there is a jingle defined, play it. */
-            /// command_queue(COMMAND_PLAY_JINGLE, CalendarEvent[Loop1UInt8].Jingle);
-            play_jingle(CalendarEvent[Loop1UInt8].Jingle);
-          }
-          #endif  // PASSIVE_PIEZO_SUPPORT
-        }
-      }
-    }
-  }
-
-
-
-  /* Log tag. */
-  if (DebugBitMask & DEBUG_TIMING)
-    uart_send(__LINE__, "-10");
-
-
-
   /* ................................................................ *\
                                Night light.
   \* ................................................................ */
@@ -18019,6 +18440,13 @@ bool timer_callback_s(struct repeating_timer *TimerSec)
   }
   ***/
 
+
+  /* Next callback is kept TIME_BASE_PHASE usec after the beginning of next second of the time base (so that no second is ever skipped
+     or seen twice), since this phase moves each time the time base is set. The delay is positive, so that the SDK counts it from the
+     return of this callback: a negative delay would be counted from the time this callback was due, and its latency would move the
+     next callback earlier, up to before the second boundary. */
+  TimerSec->delay_us = (int64_t)time_base_timer_us(1000000ULL + TIME_BASE_PHASE - (time_base_us() % 1000000ULL));
+
   return TRUE;
 }
 
@@ -18180,38 +18608,35 @@ void uint64_to_binary_string(UINT64 Value, UINT8 StringLength, UCHAR *BinaryStri
 
 
 /* $PAGE */
-/* $TITLE=update_dst_status()) */
+/* $TITLE=update_dst_status() */
 /* ---------------------------------------------------------------- *\
           Set DST parameters (FlagSummerTime and Timezone)
-      according to current DST setting and current date and time.
+         according to current DST rule and current date and time.
+     Called on power-up, after clock setup, after a NTP resync and
+           when GlobalUnixTime reaches next transition.
 \* ---------------------------------------------------------------- */
-void update_dst_status()
+void update_dst_status(void)
 {
   UCHAR Dum1UChar;
-  UCHAR String[256];
-
-  int8_t UtcDisplayTime;
-  int8_t UtcTime;
 
+  int32_t NewOffset;
+  int32_t OldOffset;
 
-  /* Initializations. */
-  FlagDaylightSavingTime = 0x55;  // undefined value.
 
-  /* Get DayOfYear for current date. */  
-  CurrentDayOfYear = get_day_of_year(CurrentYear, CurrentMonth, CurrentDayOfMonth);
+  OldOffset = get_utc_offset();
 
 
   if (DebugBitMask & DEBUG_DST)
   {
     Dum1UChar = ' ';
-    if (FlashConfig.Timezone >= 0) Dum1UChar = '+';
+    if (OldOffset >= 0) Dum1UChar = '+';
 
     uart_send(__LINE__, "Entering update_dst_status()\r");
     uart_send(__LINE__, "DST country setting in flash memory:       %2u\r",     FlashConfig.DSTCountry);
-    uart_send(__LINE__, "Timezone setting in flash memory:         %3d\r",      FlashConfig.Timezone);
+    uart_send(__LINE__, "Timezone setting in flash memory:         %3d:%2.2d\r", FlashConfig.Timezone, abs(FlashConfig.TimezoneMinutes));
     uart_send(__LINE__, "FlagSummerTime status in flash memory:    %3d\r",      FlashConfig.FlagSummerTime);
-    uart_send(__LINE__, "DST check:    %8s %2u-%s-%4.4u   DoY: %3u\r",          DayName[FlashConfig.Language][CurrentDayOfWeek], CurrentDayOfMonth, ShortMonth[ENGLISH][CurrentMonth], CurrentYear, CurrentDayOfYear);
-    uart_send(__LINE__, "Local hour: %2u:%2.2u    Delta with UTC time: %c%d\r", CurrentHour, CurrentMinute, Dum1UChar, FlashConfig.Timezone);
+    uart_send(__LINE__, "DST check:    %8s %2u-%s-%4.4u   DoY: %3u\r",          DAY_NAME(FlashConfig.Language, CurrentDayOfWeek), CurrentDayOfMonth, SHORT_MONTH(ENGLISH, CurrentMonth), CurrentYear, CurrentDayOfYear);
+    uart_send(__LINE__, "Local hour: %2u:%2.2u    Delta with UTC time: %c%ld sec   UTC: %llu   Next transition: %lld\r", CurrentHour, CurrentMinute, Dum1UChar, OldOffset, GlobalUnixTime, TzCache.Next);
   }
 
 
@@ -18231,444 +18656,58 @@ void update_dst_status()
 
 
   /* ------------------------------------------------------------------ *\
-       Check Northern countries for main periods between time change.
-  \* ------------------------------------------------------------------ */
-  if (DstParameters[FlashConfig.DSTCountry].StartMonth < DstParameters[FlashConfig.DSTCountry].EndMonth)  // Northern countries
-  {
-    /* Check if we are during Summer time. */
-    if ((CurrentDayOfYear > DstParameters[FlashConfig.DSTCountry].StartDayOfYear) && (CurrentDayOfYear < DstParameters[FlashConfig.DSTCountry].EndDayOfYear))
-    {
-      if (DebugBitMask & DEBUG_DST)
-        uart_send(__LINE__, " -> Currently Summer Time.\r");
-
-      FlagDaylightSavingTime = FLAG_ON;
-    }
-
-    /* Check if we are during Winter time. */
-    if ((CurrentDayOfYear > DstParameters[FlashConfig.DSTCountry].EndDayOfYear) || (CurrentDayOfYear < DstParameters[FlashConfig.DSTCountry].StartDayOfYear))
-    {
-      if (DebugBitMask & DEBUG_DST)
-        uart_send(__LINE__, " -> Currently Winter Time.\r");
-
-      FlagDaylightSavingTime = FLAG_OFF;
-    }
-  }
-
-
-
-  /* ------------------------------------------------------------------ *\
-       Check Southern countries for main periods between time change.
+       Offset in effect is given by the transitions precomputed for
+          current year and next one (recomputed when out of range).
   \* ------------------------------------------------------------------ */
-  if (DstParameters[FlashConfig.DSTCountry].StartMonth > DstParameters[FlashConfig.DSTCountry].EndMonth)  // Southern countries.
-  {
-    /* Check if we are during Summer time. */
-    if ((CurrentDayOfYear > DstParameters[FlashConfig.DSTCountry].StartDayOfYear) || (CurrentDayOfYear < DstParameters[FlashConfig.DSTCountry].EndDayOfYear))
-    {
-      if (DebugBitMask & DEBUG_DST)
-        uart_send(__LINE__, " -> Currently Summer Time.\r");
+  NewOffset = tz_offset(&TzCache, GlobalUnixTime);
 
-      FlagDaylightSavingTime = FLAG_ON;
-    }
-
-    /* Check if we are during Winter time. */
-    if ((CurrentDayOfYear > DstParameters[FlashConfig.DSTCountry].EndDayOfYear) && (CurrentDayOfYear < DstParameters[FlashConfig.DSTCountry].StartDayOfYear))
-    {
-      if (DebugBitMask & DEBUG_DST)
-        uart_send(__LINE__, " -> Currently Winter Time.\r");
+  if ((TzCache.Rule.FlagDst) && (NewOffset == TzCache.Rule.DstOffset))
+    FlagDaylightSavingTime = FLAG_ON;
+  else
+    FlagDaylightSavingTime = FLAG_OFF;
 
-      FlagDaylightSavingTime = FLAG_OFF;
-    }
-  }
+  if (DebugBitMask & DEBUG_DST)
+    uart_send(__LINE__, " -> Currently %s Time.\r", (FlagDaylightSavingTime == FLAG_ON) ? "Summer" : "Winter");
 
 
 
   /* ------------------------------------------------------------------ *\
-                   Check if today is the date to change 
-                     from Winter Time to Summer Time.
-          Current time can't be in the period from "Start Hour" to
-                      "Start Hour + Switch Minutes".
+        If offset changed, adjust Timezone and clock time. Local time
+       is derived again from the time base (UTC), so that a change
+       across midnight also moves the date (for example Chile at 24h00
+                      or Lebanon and Paraguay at 0h00).
   \* ------------------------------------------------------------------ */
-  if (CurrentDayOfYear == DstParameters[FlashConfig.DSTCountry].StartDayOfYear)
-  {
-    /* Today is the day we change from Summer Time to Winter Time... */
-    if (DebugBitMask & DEBUG_DST)
-      uart_send(__LINE__, " -> Today is time to change from Winter Time to Summer Time.\r");
-
-
-    switch (FlashConfig.DSTCountry)
-    {
-      case (DST_EUROPE):
-        /* Special case for countries where Spring-Forward is based on UTC. */
-        UtcTime = CurrentHour - FlashConfig.Timezone;
-        UtcDisplayTime = UtcTime;
-        if (UtcDisplayTime < 0) UtcDisplayTime += 24;  // UTC time is still "Yesterday".
-        if (DebugBitMask & DEBUG_DST)
-          uart_send(__LINE__, " -> Handling European countries. Time change occurs at UTC time = 1h00 (current UTC time: %d:%2.2u).\r", UtcDisplayTime, CurrentMinute);
-
-        if ((UtcTime < 0) || (UtcTime < DstParameters[FlashConfig.DSTCountry].StartHour))
-        {
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Still Winter Time.\r");
-
-          FlagDaylightSavingTime = FLAG_OFF;
-        }
-        else
-        {
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Now Summer Time.\r");
-
-          FlagDaylightSavingTime = FLAG_ON;
-        }
-      break;
-
-      case (DST_CHILE):
-        /* Chile is a special case since time change happens at "24h00. */
-        if (CurrentHour < DstParameters[FlashConfig.DSTCountry].StartHour)
-        {
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Still Winter Time.\r");
-
-          FlagDaylightSavingTime = FLAG_OFF;
-        }
-      break;
-
-      default:
-        /* Other countries change from Winter Time to Summer Time based on local time (not UTC). */
-        if (CurrentHour < DstParameters[FlashConfig.DSTCountry].StartHour)
-        {
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Still Winter Time.\r");
-
-          FlagDaylightSavingTime = FLAG_OFF;
-        }
-        else
-        {
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Now Summer Time.\r");
-
-          FlagDaylightSavingTime = FLAG_ON;
-        }
-      break;
-    }        
-  }
-
-
-
-  /* ------------------------------------------------------------------------------------------------------------------ *\
-                            Check if today is the date to change from Summer Time to Winter Time.
-                 If current time is during the period from "Start Hour" to "Start Hour + Switch Minutes":
-           1) If the clock is running normally (CurrentClockMode = MODE_DISPLAY_TIME), update DST accordingly.
-           2) If the clock is being powered-up, there is no way to know if hour change has already been done or not. 
-              In this case, let's assume that FlashConfig.FlagSummerTime is right.
-  \* ------------------------------------------------------------------------------------------------------------------ */
-  if (CurrentDayOfYear == DstParameters[FlashConfig.DSTCountry].EndDayOfYear)
+  if (NewOffset != OldOffset)
   {
-    /* Today is the day we change from Summer Time to Winter Time... */
     if (DebugBitMask & DEBUG_DST)
-      uart_send(__LINE__, " -> Today is time to change from Summer Time to Winter Time.\r");
-
-
-    switch (FlashConfig.DSTCountry)
     {
-      case (DST_EUROPE):
-        /* Special case for countries where Fall-Back is based on UTC time. */
-        UtcTime = CurrentHour - FlashConfig.Timezone;
-        UtcDisplayTime = UtcTime;
-        if (UtcDisplayTime < 0) UtcDisplayTime += 24;
-        if (DebugBitMask & DEBUG_DST)
-          uart_send(__LINE__, " -> Handling European countries. Time change occurs at UTC time = 1h00 (current UTC time: %d:%2.2u).\r", UtcDisplayTime, CurrentMinute);
-
-        if (UtcTime > DstParameters[FlashConfig.DSTCountry].EndHour)
-        {
-          /* We are sure that we are in Winter Time. */
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Now Winter Time.\r");
-
-          FlagDaylightSavingTime = FLAG_OFF;
-        }
-
-        if (UtcTime < (int8_t)(DstParameters[FlashConfig.DSTCountry].EndHour - 1))
-        {
-          /* Soon enough to be sure we are still in Summer Time. */
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Still Summer Time.\r");
-
-          FlagDaylightSavingTime = FLAG_ON;
-        }
-
-        /* We reach one hour before time change to Winter Time, we need to check if it has already occured one hour ago. */
-        if (UtcTime == (DstParameters[FlashConfig.DSTCountry].EndHour - 1))
-        {
-          if (FlashConfig.FlagSummerTime == FLAG_OFF)
-          {
-            /* Hour change already occured one hour ago.*/
-            FlagDaylightSavingTime = FLAG_OFF;
-            uart_send(__LINE__, " -> Time change occured one hour ago. Now Winter Time.\r");
-          }
-          else
-          {
-            /* Hour change did not occur yet. Will be in one hour. */
-            FlagDaylightSavingTime = FLAG_ON;
-            uart_send(__LINE__, " -> Time change will occur in one hour. Now still Summer Time.\r");
-          }
-        }
-      
-        /* We reach hour to change to Winter Time, we need to check if it has already occured one hour ago. */
-        if (UtcTime == DstParameters[FlashConfig.DSTCountry].EndHour)
-        {
-          if (FlashConfig.FlagSummerTime == FLAG_OFF)
-          {
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, " -> Time change already occured one hour ago.\r");
-          }
-          else
-          {
-            /* Either we are during normal clock mode, either we are during power-up and hour change has not occured yet. */
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, " -> Now time to change to Winter Time.\r");
-          }
-          FlagDaylightSavingTime = FLAG_OFF;
-        }
-      break;
-
-      case (DST_CHILE):
-        /* Chile is a special case since time change occurs at 24h00. It means that when we fall back from 0h00 (24h00) to 23h00, we would trigger
-           two (2) day changes for the same day. Let's return to Yesterday's date and let the second time we cross midnight the date will change. */
-        if (CurrentHour < 23)
-        {
-          FlagDaylightSavingTime = FLAG_ON;
-
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Still Summer Time.\r");
-        }
-        else
-        {
-          if (FlashConfig.FlagSummerTime == FLAG_ON)
-          {
-            /* This is the first time we cross 23h00, we are still in Summer Time. */
-            FlagDaylightSavingTime = FLAG_ON;
-    
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, " -> Still Summer Time.\r");
-          }
-          else
-          {
-            /* This is the second time we cross 23h00, we are now in Winter Time. */
-            FlagDaylightSavingTime = FLAG_OFF;
-  
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, " -> Now Winter Time.\r");
-          }
-        }
-      break;
-
-      default:
-        /* Other countries change time based on local time (not UTC) */
-        if (CurrentHour > DstParameters[FlashConfig.DSTCountry].EndHour)
-        {
-          /* We are sure that we are in Winter Time. */
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Now Winter Time.\r");
-
-          FlagDaylightSavingTime = FLAG_OFF;
-        }
-
-        if (CurrentHour < (DstParameters[FlashConfig.DSTCountry].EndHour - 1))
-        {
-          /* Soon enough to be sure we are still in Summer Time. */
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, " -> Still Summer Time.\r");
-
-          FlagDaylightSavingTime = FLAG_ON;
-        }
-
-        /* We reach one hour before time change to Winter Time, we need to check if it has already occured one hour ago. */
-        if (CurrentHour == (DstParameters[FlashConfig.DSTCountry].EndHour - 1))
-        {
-          if (FlashConfig.FlagSummerTime == FLAG_OFF)
-          {
-            /* Hour change already occured one hour ago.*/
-            FlagDaylightSavingTime = FLAG_OFF;
-            uart_send(__LINE__, " -> Time change occured one hour ago. Now Winter Time.\r");
-          }
-          else
-          {
-            /* Hour change did not occur yet. Will be in one hour. */
-            FlagDaylightSavingTime = FLAG_ON;
-            uart_send(__LINE__, " -> Time change will occur in one hour. Now still Summer Time.\r");
-          }
-        }
-
-        /* We reach hour to change to Winter Time, we need to check if it has already occured one hour ago. */
-        if (CurrentHour == DstParameters[FlashConfig.DSTCountry].EndHour)
-        {
-          if (FlashConfig.FlagSummerTime == FLAG_OFF)
-          {
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, " -> Time change already occured one hour ago.\r");
-          }
-          else
-          {
-            /* Either we are during normal clock mode, either we are during power-up and hour change has not occured yet. */
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, " -> Now time to change to Winter Time.\r");
-          }
-          FlagDaylightSavingTime = FLAG_OFF;
-        }
-      break;
+      uart_send(__LINE__, "  --------------------------------------------------------===> Changing from %s Time to %s Time.\r",
+                (FlagDaylightSavingTime == FLAG_ON) ? "Winter" : "Summer", (FlagDaylightSavingTime == FLAG_ON) ? "Summer" : "Winter");
+      uart_send(__LINE__, "DST country code: %u   Number of seconds to shift: %ld\r", FlashConfig.DSTCountry, NewOffset - OldOffset);
+      uart_send(__LINE__, "Current Time before change: %2u:%2.2u:%2.2u\r", CurrentHour, CurrentMinute, CurrentSecond);
     }
-  }
 
+    set_utc_offset(NewOffset);
+    time_civil_update();
 
+    CurrentHourSetting   = CurrentHour;
+    CurrentMinuteSetting = CurrentMinute;
+    set_time(CurrentSecond, CurrentMinute, CurrentHour, CurrentDayOfWeek, CurrentDayOfMonth, CurrentMonth, CurrentYearLowPart);
 
-  if (FlagDaylightSavingTime == 0x55)
     if (DebugBitMask & DEBUG_DST)
-      uart_send(__LINE__, " -> CASE NOT COVERED... Please report this problem and how to reproduce it.\r");
-
-
-
-  /* ------------------------------------------------------------------ *\
-         Now that we know if we are in Summer Time or Winter Time,
-           set the Daylight Saving Time parameters accordingly.
-  \* ------------------------------------------------------------------ */
-  if (FlagDaylightSavingTime == FLAG_ON)
-  {
-    if (FlashConfig.FlagSummerTime == FLAG_OFF)
-    {
-      /* We are in Summer Time, but flash indicates that we are still in Winter Time... We need to adjust Timezone and clock time. */
-      ++FlashConfig.Timezone;
-
-      if (DebugBitMask & DEBUG_DST)
-      {
-        uart_send(__LINE__, "  --------------------------------------------------------===> Changing from Winter Time to Summer Time.\r");
-        uart_send(__LINE__, "DST country code: %u   Number of minutes to shift: %u\r", 
-                             FlashConfig.DSTCountry, DstParameters[FlashConfig.DSTCountry].ShiftMinutes);
-      }
-
-      /* Check shift minutes, just in case we have to cover other than 60 minutes shifts later on. */
-      if (DstParameters[FlashConfig.DSTCountry].ShiftMinutes == 60)
-      {
-        if (DebugBitMask & DEBUG_DST)
-          uart_send(__LINE__, "Current Hour that will be incremented: %u:%2.2u\r", CurrentHour, CurrentMinute);
-
-        ++CurrentHour;
-        CurrentHourSetting = CurrentHour;
-        set_hour(CurrentHourSetting);
-      }
-      else
-      {
-        if (DebugBitMask & DEBUG_DST)
-          uart_send(__LINE__, "Current minutes that will be incremented: %u\r", CurrentHour);
-
-        CurrentMinute += DstParameters[FlashConfig.DSTCountry].ShiftMinutes;
-        CurrentMinuteSetting = CurrentMinute;
-        set_minute(CurrentMinuteSetting);
-        if (DebugBitMask & DEBUG_DST)
-          uart_send(__LINE__, "Current Time after hour change: %u:%2.2u\r", CurrentHour, CurrentMinute);
-      }
-      show_time();  // update clock display to show time change.
-    }
-    FlashConfig.FlagSummerTime = FLAG_ON;
-  }
-
-
-
-  if (FlagDaylightSavingTime == FLAG_OFF)
-  {
-    if (FlashConfig.FlagSummerTime == FLAG_ON)
-    {
-      /* We are in Winter Time, but flash indicates that we are still in Summer Time... We need to adjust Timezone and clock time. */
-      if (DebugBitMask & DEBUG_DST)
-      {
-        uart_send(__LINE__, " ---------------------------------------------------------===> Changing from Summer Time to Winter Time.\r");
-        uart_send(__LINE__, "DST country code: %u   Number of minutes to shift: %u\r", 
-                             FlashConfig.DSTCountry, DstParameters[FlashConfig.DSTCountry].ShiftMinutes);
-      }
-          
-      switch (FlashConfig.DSTCountry)
-      {
-        case (DST_CHILE):
-          /* Special case for Chile since they are changing time at "24h00", whereas we are already "tomorrow". */
-          CurrentHour = 23;
-
-          --CurrentDayOfMonth;
-          if (CurrentDayOfMonth == 0)
-          {
-            --CurrentMonth;
-            CurrentDayOfMonth = get_month_days(CurrentYear, CurrentMonth);
-          }
-
-          CurrentHourSetting = CurrentHour;
-          set_hour(CurrentHourSetting);
-          set_day_of_month(CurrentDayOfMonth);
-          set_month(CurrentMonth);
-
-          /* We are in Winter Time, but flash indicates that we are in Summer Time... We need to adjust DST parameters. */
-          --FlashConfig.Timezone;
-        break;
-
-        case (DST_LEBANON):
-        case (DST_PARAGUAY):
-          /* Special case for Lebanon and Paraguay since we are changing time at "0h00", and moving it back to 23h00 Yesterday.
-             We need to make some housekeeping so that we don't change the day (date, DayOfMonth) twice while crossing 0h00 twice. */
-          CurrentHour = 23;
-
-          --CurrentDayOfMonth;
-          if (CurrentDayOfMonth == 0)
-          {
-            --CurrentMonth;
-            CurrentDayOfMonth = get_month_days(CurrentYear, CurrentMonth);
-          }
-
-          CurrentHourSetting = CurrentHour;
-          set_hour(CurrentHourSetting);
-          set_day_of_month(CurrentDayOfMonth);
-          set_month(CurrentMonth);
-
-          /* We are in Winter Time, but flash indicates that we are in Summer Time... We need to adjust DST parameters. */
-          --FlashConfig.Timezone;
-        break;
+      uart_send(__LINE__, "Current Time after change:  %2u:%2.2u:%2.2u\r", CurrentHour, CurrentMinute, CurrentSecond);
 
-        default:
-          if (DebugBitMask & DEBUG_DST)
-            uart_send(__LINE__, "Current Hour that will be decremented: %u:%2.2u\r", CurrentHour, CurrentMinute);
-
-          /* We are in Winter Time, but flash indicates that we are in Summer Time... We need to adjust DST parameters. */
-          --FlashConfig.Timezone;
-
-          /* Check shift minutes, just in case we have to cover other than 60 minutes shifts later on. */
-          if (DstParameters[FlashConfig.DSTCountry].ShiftMinutes == 60)
-          {
-            --CurrentHour;
-            CurrentHourSetting = CurrentHour;
-            set_hour(CurrentHourSetting);
-          }
-          else
-          {
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, "Current Minute that will be decremented: %u:%2.2u\r", CurrentHour, CurrentMinute);
+    show_time();  // update clock display to show time change.
 
-            CurrentMinute -= DstParameters[FlashConfig.DSTCountry].ShiftMinutes;
-            if (CurrentMinute > 59)  // went below 0.
-            {
-              CurrentMinute += 60;
-              --CurrentHour;
-            }
-            CurrentHourSetting   = CurrentHour;
-            CurrentMinuteSetting = CurrentMinute;
-            set_hour(CurrentHourSetting);
-            set_minute(CurrentMinuteSetting);
-            if (DebugBitMask & DEBUG_DST)
-              uart_send(__LINE__, "Current Time after hour change: %u:%2.2u\r", CurrentHour, CurrentMinute);
-          }
-        break;
-      }
-      show_time();  // update clock display to show time change.
-    }
-    FlashConfig.FlagSummerTime = FLAG_OFF;
+    /* Local time moved, reminders may be due now (or later than the Pico alarm has been set for). Next alarm moves with local time. */
+    command_queue(COMMAND_REMINDER_DUE, 0);
+    command_queue(COMMAND_ALARM_SCHEDULE, 0);
+    command_queue(COMMAND_CHIME_SCHEDULE, 0);
   }
+  FlashConfig.FlagSummerTime = FlagDaylightSavingTime;
 
-  uart_send(__LINE__, "\r");
+  if (DebugBitMask & DEBUG_DST)
+    uart_send(__LINE__, "\r");
 
   return;
 }
@@ -18702,12 +18741,12 @@ void update_left_indicators(void)
   /* ---------------------------------------------------------------- *\
          Turn on "Alarm On" indicator if at least one alarm is On.
   \* ---------------------------------------------------------------- */
-  for (Loop1UInt8 = 0; Loop1UInt8 < 9; ++Loop1UInt8)
+  for (Loop1UInt8 = 0; Loop1UInt8 < MAX_ALARMS; ++Loop1UInt8)
   {
-    if (FlashConfig.Alarm[Loop1UInt8].FlagStatus == FLAG_ON)
+    if (Alarm[Loop1UInt8].FlagStatus == FLAG_ON)
     {
       if (DebugBitMask & DEBUG_INDICATORS)
-        uart_send(__LINE__, "Alarm[%1u]:   0x%2.2X\r", Loop1UInt8, FlashConfig.Alarm[Loop1UInt8]);
+        uart_send(__LINE__, "Alarm[%2u]:   0x%2.2X\r", Loop1UInt8, Alarm[Loop1UInt8].FlagStatus);
 
       IndicatorAlarmOn;
       break; // get out of for loop as soon as alarm indicator is On.
@@ -1,8 +1,10 @@
 struct reminder1 Reminder1[MAX_REMINDERS1]=
 {
   // Reminder1[0]:
+  // Example: ring every 15 minutes for 4 hours, every two weeks. Not active (a StartPeriod Year of 0 means the reminder is not defined),
+  // replace the StartPeriod Year by 2010 (for example) to activate it.
   {
-     0,  0,  0,  1,  1, 2010, 1,   1, 0,   // StartPeriod   [Hours, Minutes, Seconds, DayOfMonth, Month, Year, DayOfWeek, DayOfYear, SummerTimeFlag]
+     0,  0,  0,  1,  1,    0, 1,   1, 0,   // StartPeriod   [Hours, Minutes, Seconds, DayOfMonth, Month, Year, DayOfWeek, DayOfYear, SummerTimeFlag]
     0ll,                                   // StartPeriodEpoch
     23, 59, 59, 31, 12, 2040, 1, 365, 0,   // EndPeriod
     0ll,                                   // EndPeriodEpoch
@@ -11,6 +13,7 @@ struct reminder1 Reminder1[MAX_REMINDERS1]=
     4 * 60 * 60,                           // RingDuration - intermittently ring for 4 hours
     15 * 60,                               // RingRepeatTime - ring every 15 minutes.
     2 * 7 * 24 * 60 * 60,                  // NextReminderDelay - next reminder in 2 weeks.
+    // .Rule = "FREQ=MONTHLY;BYDAY=-1FR",  // optional recurrence rule, replaces NextReminderDelay (here: last Friday of every month, see recurrence.h).
   },
 
   // Reminder1[1]:
@@ -0,0 +1,178 @@
+/* ======================================================================== *\
+   civil_time.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Integer calendar kernels for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   Conversions between a date of the proleptic Gregorian calendar and a
+   number of days since 01-JAN-1970, after Howard Hinnant's
+   "days_from_civil" / "civil_from_days" algorithms. Years are shifted so
+   that they begin on March 1st, which moves the leap day at the end of
+   the year and makes the month lengths a linear function of the month.
+
+   All functions are "static inline" in this header, so that calls with
+   constant arguments are folded by the compiler. No loop, no table, no
+   library call, and no memory allocation.
+
+   Valid for years 1970 to 2199 (the arithmetic itself is correct for
+   any year from 0001 on, as long as results fit in the types used).
+   Days of week are numbered 0 = Sunday to 6 = Saturday, months 1 to 12.
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _CIVIL_TIME_H_
+#define _CIVIL_TIME_H_
+
+
+
+#include <stdint.h>
+
+
+
+#define CIVIL_DAYS_PER_ERA     146097UL  // number of days in 400 years.
+#define CIVIL_EPOCH_SHIFT      719468UL  // number of days from 01-MAR-0000 to 01-JAN-1970.
+#define CIVIL_SECONDS_PER_DAY  86400UL
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=civil_days() */
+/* ------------------------------------------------------------------ *\
+          Number of days since 01-JAN-1970 for a given date.
+\* ------------------------------------------------------------------ */
+static inline int32_t civil_days(uint32_t Year, uint32_t Month, uint32_t DayOfMonth)
+{
+  uint32_t DayOfEra;
+  uint32_t DayOfYear;
+  uint32_t Era;
+  uint32_t YearOfEra;
+
+
+  Year     -= (Month <= 2);                                                    // January and February belong to previous March-based year.
+  Era       = Year / 400;
+  YearOfEra = Year - (Era * 400);                                              // 0 to 399.
+  DayOfYear = (((153 * (Month + ((Month > 2) ? -3 : 9))) + 2) / 5) + DayOfMonth - 1;  // 0 to 365, from March 1st.
+  DayOfEra  = (YearOfEra * 365) + (YearOfEra / 4) - (YearOfEra / 100) + DayOfYear;  // 0 to 146096.
+
+  return (int32_t)((Era * CIVIL_DAYS_PER_ERA) + DayOfEra - CIVIL_EPOCH_SHIFT);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=civil_from_days() */
+/* ------------------------------------------------------------------ *\
+      Date for a given number of days since 01-JAN-1970 (Days >= 0).
+\* ------------------------------------------------------------------ */
+static inline void civil_from_days(int32_t Days, uint16_t *Year, uint8_t *Month, uint8_t *DayOfMonth)
+{
+  uint32_t DayOfEra;
+  uint32_t DayOfYear;
+  uint32_t Era;
+  uint32_t MonthShifted;
+  uint32_t Shifted;
+  uint32_t YearOfEra;
+
+
+  Shifted      = (uint32_t)Days + CIVIL_EPOCH_SHIFT;                                                      // days since 01-MAR-0000.
+  Era          = Shifted / CIVIL_DAYS_PER_ERA;
+  DayOfEra     = Shifted - (Era * CIVIL_DAYS_PER_ERA);                                                    // 0 to 146096.
+  YearOfEra    = (DayOfEra - (DayOfEra / 1460) + (DayOfEra / 36524) - (DayOfEra / 146096)) / 365;         // 0 to 399.
+  DayOfYear    = DayOfEra - ((365 * YearOfEra) + (YearOfEra / 4) - (YearOfEra / 100));                    // 0 to 365, from March 1st.
+  MonthShifted = ((5 * DayOfYear) + 2) / 153;                                                             // 0 = March to 11 = February.
+
+  *DayOfMonth  = (uint8_t)(DayOfYear - (((153 * MonthShifted) + 2) / 5) + 1);
+  *Month       = (uint8_t)((MonthShifted < 10) ? (MonthShifted + 3) : (MonthShifted - 9));
+  *Year        = (uint16_t)(YearOfEra + (Era * 400) + (*Month <= 2));
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=civil_is_leap_year() */
+/* ------------------------------------------------------------------ *\
+              Return 1 if Year is a leap year, 0 otherwise.
+\* ------------------------------------------------------------------ */
+static inline uint8_t civil_is_leap_year(uint32_t Year)
+{
+  return (uint8_t)(((Year % 4) == 0) && (((Year % 100) != 0) || ((Year % 400) == 0)));
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=civil_day_of_year() */
+/* ------------------------------------------------------------------ *\
+                 Day-of-year (1 to 366) of a given date.
+\* ------------------------------------------------------------------ */
+static inline uint16_t civil_day_of_year(uint32_t Year, uint32_t Month, uint32_t DayOfMonth)
+{
+  uint32_t DayOfYear;
+
+
+  /* Day number in a March-based year (January 1st is day 307), then brought back to a January-based year. */
+  DayOfYear = (((153 * (Month + ((Month > 2) ? -3 : 9))) + 2) / 5) + DayOfMonth;
+
+  return (uint16_t)((Month > 2) ? (DayOfYear + 59 + civil_is_leap_year(Year)) : (DayOfYear - 306));
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=civil_month_days() */
+/* ------------------------------------------------------------------ *\
+      Number of days in a month. Bits 2 * Month of 0x3BBEECC give the
+         number of days above 28 for each month (February is 0).
+\* ------------------------------------------------------------------ */
+static inline uint8_t civil_month_days(uint32_t Year, uint32_t Month)
+{
+  return (uint8_t)(28 + ((0x3BBEECCUL >> (Month * 2)) & 0x03) + ((Month == 2) & civil_is_leap_year(Year)));
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=civil_weekday() */
+/* ------------------------------------------------------------------ *\
+      Day-of-week (0 = Sunday to 6 = Saturday) for a given number of
+       days since 01-JAN-1970 (Days >= -4). 01-JAN-1970 was a Thursday.
+\* ------------------------------------------------------------------ */
+static inline uint8_t civil_weekday(int32_t Days)
+{
+  return (uint8_t)(((uint32_t)(Days + 4)) % 7);
+}
+
+#endif  // _CIVIL_TIME_H_
@@ -0,0 +1,95 @@
+/* ======================================================================== *\
+   event_blob.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Layout of the calendar events blob for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   The blob is built on the host by tools/ics2blob from an iCalendar
+   (.ics) file, and written in its own flash area (EVENT_BLOB_OFFSET),
+   apart from the firmware. The firmware reads it in place through XIP
+   flash, so events use no RAM and may be changed by reflashing this
+   area only. The same header is used by the firmware and by the tool.
+
+   The blob is made of:
+     - a header, with the day index: records of day-of-year "n" (0 to
+       365, numbered as in a leap year) are records DayStart[n] to
+       DayStart[n + 1] - 1,
+     - the records, first those of the day index (sorted by day, then
+       in the order of the .ics file), then those with a recurrence rule
+       (records IndexedCount to EventCount - 1),
+     - the string pool (descriptions and rules, each string stored only
+       once and terminated by a null character).
+
+   All fields are little-endian (as the RP2040), and aligned on their
+   own size. The CRC16 covers everything after the Crc16 field, up to
+   the end of the blob (Size bytes from the beginning of the header).
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _EVENT_BLOB_H_
+#define _EVENT_BLOB_H_
+
+
+
+#include <stdint.h>
+
+
+
+#ifndef EVENT_BLOB_OFFSET
+#define EVENT_BLOB_OFFSET      0x1F7000      // offset of the blob area in flash (below the flash configuration sector at 0x1FF000).
+#endif
+#define EVENT_BLOB_AREA        0x8000        // size of the blob area in flash (8 sectors of 4096 bytes).
+#define EVENT_BLOB_DAYS        366           // number of days in the day index (one entry per day of a leap year).
+#define EVENT_BLOB_MAGIC       0x56454347UL  // "GCEV" (Green Clock EVents).
+#define EVENT_BLOB_MAX_EVENTS  0xAA          // event numbers are used as scroll queue tags, they must stay below 0xAA.
+#define EVENT_BLOB_NO_STRING   0xFFFF        // string offset of a record without recurrence rule.
+#define EVENT_BLOB_VERSION     1
+
+
+
+/* Blob header, at the beginning of the blob area. */
+struct event_blob_header
+{
+  uint32_t Magic;                             // EVENT_BLOB_MAGIC.
+  uint16_t Version;                           // EVENT_BLOB_VERSION.
+  uint16_t Crc16;                             // CRC16 (polynom 0x1021, initial value 0) of the blob after this field.
+  uint32_t Size;                              // total size of the blob (in bytes, header included).
+  uint16_t EventCount;                        // total number of records.
+  uint16_t IndexedCount;                      // number of records in the day index (the others have a recurrence rule).
+  uint16_t StringSize;                        // size of the string pool (in bytes).
+  uint16_t Reserved;
+  uint16_t DayStart[EVENT_BLOB_DAYS + 1];     // first record of each day-of-year, DayStart[EVENT_BLOB_DAYS] = IndexedCount.
+};
+
+
+/* One calendar event. */
+struct event_blob_record
+{
+  uint8_t  Month;                             // 1 to 12.
+  uint8_t  Day;                               // 1 to 31.
+  uint16_t Year;                              // year of a one-time event (0 = every year).
+  uint16_t Jingle;                            // jingle to play with this event (0 = none).
+  uint16_t Description;                       // offset of the description in the string pool.
+  uint16_t Rule;                              // offset of the recurrence rule in the string pool (EVENT_BLOB_NO_STRING = none).
+};
+
+#endif  // _EVENT_BLOB_H_
@@ -0,0 +1,69 @@
+/* ======================================================================== *\
+   event_index.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Day-of-year index of calendar events for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   See event_index.h for the layout of the index.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include "event_index.h"
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=event_index_sort() */
+/* ------------------------------------------------------------------ *\
+        Sort events by day number with a counting sort, which keeps
+       the events of a same day in the order they are given. Events
+           with day number EVENT_INDEX_NONE are left out.
+\* ------------------------------------------------------------------ */
+void event_index_sort(const uint16_t *DayNumber, uint16_t Count, uint16_t *DayStart, uint16_t *Index)
+{
+  uint16_t Loop1UInt16;
+
+
+  for (Loop1UInt16 = 0; Loop1UInt16 <= EVENT_INDEX_DAYS; ++Loop1UInt16)
+    DayStart[Loop1UInt16] = 0;
+
+  /* Count events of each day (count of day "n" is kept in entry "n + 1"). */
+  for (Loop1UInt16 = 0; Loop1UInt16 < Count; ++Loop1UInt16)
+    if (DayNumber[Loop1UInt16] < EVENT_INDEX_DAYS) ++DayStart[DayNumber[Loop1UInt16] + 1];
+
+  /* Running total gives the position of the first event of each day. */
+  for (Loop1UInt16 = 1; Loop1UInt16 <= EVENT_INDEX_DAYS; ++Loop1UInt16)
+    DayStart[Loop1UInt16] += DayStart[Loop1UInt16 - 1];
+
+  /* Put each event in place. Entry "n" is used as the insertion point of day "n", so that it ends up at the beginning of day "n + 1". */
+  for (Loop1UInt16 = 0; Loop1UInt16 < Count; ++Loop1UInt16)
+    if (DayNumber[Loop1UInt16] < EVENT_INDEX_DAYS) Index[DayStart[DayNumber[Loop1UInt16]]++] = Loop1UInt16;
+
+  /* Move insertion points back to the beginning of their own day. */
+  for (Loop1UInt16 = EVENT_INDEX_DAYS - 1; Loop1UInt16 > 0; --Loop1UInt16)
+    DayStart[Loop1UInt16] = DayStart[Loop1UInt16 - 1];
+  DayStart[0] = 0;
+
+  return;
+}
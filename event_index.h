@@ -0,0 +1,51 @@
+/* ======================================================================== *\
+   event_index.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Day-of-year index of calendar events for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   Events are sorted by day-of-year (0 to 365, numbered as in a leap year
+   so that 29-FEB has its own day) with a counting sort, in O(n + 366).
+   Events of day "n" are then Index[DayStart[n]] to
+   Index[DayStart[n + 1] - 1], in the order they were given, and finding
+   the events of a date is O(1) plus the number of events found.
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _EVENT_INDEX_H_
+#define _EVENT_INDEX_H_
+
+
+
+#include <stdint.h>
+
+
+
+#define EVENT_INDEX_DAYS    366       // number of days in the index (one entry per day of a leap year).
+#define EVENT_INDEX_NONE    0xFFFF    // day number of an event left out of the index.
+
+
+
+/* Sort Count events by day number (EVENT_INDEX_NONE = left out), filling DayStart (EVENT_INDEX_DAYS + 1 entries) and Index. */
+void event_index_sort(const uint16_t *DayNumber, uint16_t Count, uint16_t *DayStart, uint16_t *Index);
+
+#endif  // _EVENT_INDEX_H_
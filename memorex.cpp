@@ -63,7 +63,7 @@ UINT8 decode_ir_command(UCHAR FlagDebug, UINT8 *IrCommand)
     {
       /* Display two <Get ready> levels from IR burst. */
       if (DebugBitMask & DEBUG_IR_COMMAND)
-        uart_send(__LINE__, " [%2u]    --     %c     %5lu      %c     %5lu\r", Loop1UInt16, IrLevel[Loop1UInt16], IrResultValue[Loop1UInt16], IrLevel[Loop1UInt16 + 1], IrResultValue[Loop1UInt16 + 1]);
+        uart_send(__LINE__, " [%2u]    --     %c     %5u      %c     %5u\r", Loop1UInt16, IR_LEVEL(Loop1UInt16), IrPulse[Loop1UInt16], IR_LEVEL(Loop1UInt16 + 1), IrPulse[Loop1UInt16 + 1]);
       continue;
     }
           
@@ -71,11 +71,11 @@ UINT8 decode_ir_command(UCHAR FlagDebug, UINT8 *IrCommand)
     if ((BitNumber > 0) && (BitNumber <= 32))
     {
       DataBuffer <<= 1;
-      if (IrResultValue[Loop1UInt16 + 1] > 1400) ++DataBuffer;
+      if (IrPulse[Loop1UInt16 + 1] > 1400) ++DataBuffer;
   
       /* Display 32 data bits. */
       if (DebugBitMask & DEBUG_IR_COMMAND)
-         uart_send(__LINE__, " [%2u]   %3u     %c     %5lu      %c     %5lu      Data: 0x%8.8X\r", Loop1UInt16, BitNumber, IrLevel[Loop1UInt16], IrResultValue[Loop1UInt16], IrLevel[Loop1UInt16 + 1], IrResultValue[Loop1UInt16 + 1], DataBuffer);
+         uart_send(__LINE__, " [%2u]   %3u     %c     %5u      %c     %5u      Data: 0x%8.8X\r", Loop1UInt16, BitNumber, IR_LEVEL(Loop1UInt16), IrPulse[Loop1UInt16], IR_LEVEL(Loop1UInt16 + 1), IrPulse[Loop1UInt16 + 1], DataBuffer);
     }
 
 
@@ -83,12 +83,12 @@ UINT8 decode_ir_command(UCHAR FlagDebug, UINT8 *IrCommand)
     {
       /* Display extra bits. */
       if (DebugBitMask & DEBUG_IR_COMMAND)
-        uart_send(__LINE__, " [%2u]    --     %c     %5lu      %c     %5lu\r", Loop1UInt16, IrLevel[Loop1UInt16], IrResultValue[Loop1UInt16], IrLevel[Loop1UInt16 + 1], IrResultValue[Loop1UInt16 + 1]);
+        uart_send(__LINE__, " [%2u]    --     %c     %5u      %c     %5u\r", Loop1UInt16, IR_LEVEL(Loop1UInt16), IrPulse[Loop1UInt16], IR_LEVEL(Loop1UInt16 + 1), IrPulse[Loop1UInt16 + 1]);
     }
   
   
     /* When reading a value that makes no sense, assume that we passed the last valid value of the IR stream. */
-    if ((IrResultValue[Loop1UInt16] > 10000l) || (IrResultValue[Loop1UInt16 + 1] > 10000))
+    if ((IrPulse[Loop1UInt16] > 10000l) || (IrPulse[Loop1UInt16 + 1] > 10000))
     {
       /* We reached end of IR burst, get out of "for" loop. */
       /// break;
@@ -100,15 +100,15 @@ UINT8 decode_ir_command(UCHAR FlagDebug, UINT8 *IrCommand)
     {
       for (Loop2UInt16 - 0; Loop2UInt16 < 2; ++Loop2UInt16)
       {
-        if (IrLevel[Loop1UInt16 + Loop2UInt16] == 'L')
+        if (IR_LEVEL(Loop1UInt16 + Loop2UInt16) == 'L')
         {
           /* Low level, it is a first half bit. Make a rough validation only. */
-          if ((IrResultValue[Loop1UInt16 + Loop2UInt16] < 400l) || (IrResultValue[Loop1UInt16 + Loop2UInt16] > 725l))
+          if ((IrPulse[Loop1UInt16 + Loop2UInt16] < 400l) || (IrPulse[Loop1UInt16 + Loop2UInt16] > 725l))
           {
             FlagError = FLAG_ON;
 
             if (DebugBitMask & DEBUG_IR_COMMAND)
-              uart_send(__LINE__, "decode_ir_command() - Error IrLevel <L>   Event number: %u   IrResultValue: %lu\r", Loop1UInt16 + Loop2UInt16, IrResultValue[Loop1UInt16 + Loop2UInt16]);
+              uart_send(__LINE__, "decode_ir_command() - Error IrLevel <L>   Event number: %u   IrPulse: %u\r", Loop1UInt16 + Loop2UInt16, IrPulse[Loop1UInt16 + Loop2UInt16]);
           }
         }
         else
@@ -117,7 +117,7 @@ UINT8 decode_ir_command(UCHAR FlagDebug, UINT8 *IrCommand)
           DataBuffer <<= 1;
 
           /* Now check if our assumption was correct. */
-          if ((IrResultValue[Loop1UInt16 + Loop2UInt16] > 1500l) && (IrResultValue[Loop1UInt16 + Loop2UInt16] < 1800l))
+          if ((IrPulse[Loop1UInt16 + Loop2UInt16] > 1500l) && (IrPulse[Loop1UInt16 + Loop2UInt16] < 1800l))
           {
             /* It was a "one" bit. DataBuffer has already been shifted left above, simply add 1 for current "one" bit. */
             ++DataBuffer;
@@ -138,12 +138,7 @@ UINT8 decode_ir_command(UCHAR FlagDebug, UINT8 *IrCommand)
 
   /* Now that the command has been decoded, initalize variables to get ready for next burst decoding. */
   for (Loop1UInt16 = 0; Loop1UInt16 < MAX_IR_READINGS; ++Loop1UInt16)
-  {
-    IrInitialValue[Loop1UInt16] = 0ll;
-    IrFinalValue[Loop1UInt16]   = 0ll;
-    IrResultValue[Loop1UInt16]  = 0l;
-    IrLevel[Loop1UInt16]        = 'X';
-  }
+    IrPulse[Loop1UInt16] = 0;
   IrStepCount = 0;  // reset IrStepCount.
 
 
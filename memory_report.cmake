@@ -0,0 +1,205 @@
+# memory_report.cmake
+# For Pico-Green-Clock
+# Memory budget report, run as a script once the firmware has been linked:
+#
+#   cmake -DELF=<file.elf> -DNM=<nm> -DOBJDUMP=<objdump> [-DREPORT=<file.txt>]
+#         [-DBUDGET_RAM=<bytes>] [-DBUDGET_FLASH=<bytes>] [-DBUDGETS=<ID_RAM=bytes;ID_FLASH=bytes;...>]
+#         [-DTOP=<number of symbols>] -P memory_report.cmake
+#
+# Totals come from the section headers of the elf file (so they include heap and stacks reserved by the linker script).
+# Per-symbol and per-subsystem figures come from the symbol table:
+#   - text / read-only symbols (t, T, r, R) use flash only.
+#   - initialized data (d, D) uses RAM and also flash for its initial values.
+#   - zero-initialized data (b, B) uses RAM only.
+# The script fails if one of the budgets given is exceeded.
+#
+#
+cmake_minimum_required(VERSION 3.13)
+#
+#
+if (NOT DEFINED ELF OR NOT EXISTS "${ELF}")
+  message(FATAL_ERROR "memory_report: elf file not found: ${ELF}")
+endif ()
+if (NOT DEFINED TOP)
+  set(TOP 40)
+endif ()
+#
+#
+# Subsystems, in the order they are tried. First regular expression matching the symbol name wins. Optional features are identified
+# by their own subsystem, so that their size impact shows up in the report.
+set(SUBSYSTEMS      LOCALIZATION CALENDAR REMINDERS SOUND IR FONTS IDLE DHT BME280 NTP_WIFI)
+set(LOCALIZATION_RE "^(MessagePool|MessageOffset|msg|msg_lang)$")
+set(CALENDAR_RE     "^(CalendarEvent|Event[A-Z]|event_|recur_)")
+set(REMINDERS_RE    "^Reminder")
+set(SOUND_RE        "^(SoundQueue|Sound|sound_|tone$|Pwm$|pwm_)")
+set(IR_RE           "^(Ir[A-Z]|IR|decode_ir_command$|process_ir_command$|isr_signal_trap$)")
+set(FONTS_RE        "^(CharacterMap|CharMap|CharWidth|Pixel$)")
+set(IDLE_RE         "^(Idle|idle_)")
+set(DHT_RE          "^(Dht|dht_|core1_|Core[01]Queue)")
+set(BME280_RE       "^(Bme280|bme280_)")
+set(NTP_WIFI_RE     "^(NTPData|NTP_|ntp_|cyw43|CYW43|lwip|netif|udp_|dns_|pbuf|mem_|memp_|ram_heap|ip4?_|etharp|dhcp|sys_|tcpip|wifi|Wifi)")
+#
+#
+# Section totals.
+execute_process(COMMAND ${OBJDUMP} -h "${ELF}" OUTPUT_VARIABLE HEADERS RESULT_VARIABLE RC)
+if (NOT RC EQUAL 0)
+  message(FATAL_ERROR "memory_report: ${OBJDUMP} -h failed")
+endif ()
+string(REPLACE ";" "," HEADERS "${HEADERS}")
+string(REPLACE "\n" ";" HEADERS "${HEADERS}")
+#
+set(TOTAL_RAM 0)
+set(TOTAL_FLASH 0)
+set(SECTIONS "")
+set(SIZE "")
+foreach (LINE IN LISTS HEADERS)
+  if (LINE MATCHES "^ *[0-9]+ +([^ ]+) +([0-9a-fA-F]+) +([0-9a-fA-F]+) +([0-9a-fA-F]+)")
+    set(NAME ${CMAKE_MATCH_1})
+    math(EXPR SIZE "0x${CMAKE_MATCH_2}")
+  elseif (NOT SIZE STREQUAL "" AND LINE MATCHES "ALLOC")
+    set(WHERE "")
+    if (NOT LINE MATCHES "READONLY")
+      math(EXPR TOTAL_RAM "${TOTAL_RAM} + ${SIZE}")
+      set(WHERE "RAM")
+    endif ()
+    if (LINE MATCHES "LOAD")
+      math(EXPR TOTAL_FLASH "${TOTAL_FLASH} + ${SIZE}")
+      set(WHERE "${WHERE} FLASH")
+    endif ()
+    if (SIZE GREATER 0)
+      string(STRIP "${WHERE}" WHERE)
+      list(APPEND SECTIONS "${NAME}|${SIZE}|${WHERE}")
+    endif ()
+    set(SIZE "")
+  else ()
+    set(SIZE "")
+  endif ()
+endforeach ()
+#
+#
+# Symbol table, largest symbols first.
+execute_process(COMMAND ${NM} -S --size-sort -r "${ELF}" OUTPUT_VARIABLE SYMBOLS RESULT_VARIABLE RC)
+if (NOT RC EQUAL 0)
+  message(FATAL_ERROR "memory_report: ${NM} -S failed")
+endif ()
+string(REPLACE ";" "," SYMBOLS "${SYMBOLS}")
+string(REPLACE "\n" ";" SYMBOLS "${SYMBOLS}")
+#
+foreach (ID IN LISTS SUBSYSTEMS ITEMS OTHER)
+  set(${ID}_RAM 0)
+  set(${ID}_FLASH 0)
+endforeach ()
+set(TOP_LINES "")
+set(COUNT 0)
+foreach (LINE IN LISTS SYMBOLS)
+  if (NOT LINE MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) ([bBdDrRtT]) (.+)$")
+    continue()
+  endif ()
+  math(EXPR SIZE "0x${CMAKE_MATCH_1}")
+  set(TYPE ${CMAKE_MATCH_2})
+  set(NAME ${CMAKE_MATCH_3})
+  #
+  set(RAM 0)
+  set(FLASH 0)
+  if (TYPE MATCHES "[bBdD]")
+    set(RAM ${SIZE})
+  endif ()
+  if (TYPE MATCHES "[dDrRtT]")
+    set(FLASH ${SIZE})
+  endif ()
+  #
+  set(OWNER OTHER)
+  foreach (ID IN LISTS SUBSYSTEMS)
+    if (NAME MATCHES "${${ID}_RE}")
+      set(OWNER ${ID})
+      break()
+    endif ()
+  endforeach ()
+  math(EXPR ${OWNER}_RAM   "${${OWNER}_RAM} + ${RAM}")
+  math(EXPR ${OWNER}_FLASH "${${OWNER}_FLASH} + ${FLASH}")
+  #
+  if (COUNT LESS TOP)
+    string(LENGTH "${NAME}" LENGTH)
+    if (LENGTH LESS 32)
+      string(SUBSTRING "                                " ${LENGTH} -1 PAD)
+    else ()
+      set(PAD " ")
+    endif ()
+    list(APPEND TOP_LINES "  ${NAME}${PAD}${TYPE} ${RAM}|${FLASH}|${OWNER}")
+    math(EXPR COUNT "${COUNT} + 1")
+  endif ()
+endforeach ()
+#
+#
+# Build the report.
+get_filename_component(ELF_NAME "${ELF}" NAME)
+set(OUT "Memory report for ${ELF_NAME}\n\n")
+#
+string(APPEND OUT "Sections (bytes):\n")
+foreach (ENTRY IN LISTS SECTIONS)
+  string(REPLACE "|" ";" ENTRY "${ENTRY}")
+  list(GET ENTRY 0 NAME)
+  list(GET ENTRY 1 SIZE)
+  list(GET ENTRY 2 WHERE)
+  string(APPEND OUT "  ${NAME}\t${SIZE}\t${WHERE}\n")
+endforeach ()
+string(APPEND OUT "  Total RAM:   ${TOTAL_RAM}\n")
+string(APPEND OUT "  Total flash: ${TOTAL_FLASH}\n\n")
+#
+# Optional features are detected from the code they bring in.
+string(APPEND OUT "Optional features found in this build:\n")
+foreach (FEATURE DHT BME280 IR NTP_WIFI)
+  if (${FEATURE}_FLASH GREATER 0)
+    string(APPEND OUT "  ${FEATURE}: yes (RAM ${${FEATURE}_RAM}, flash ${${FEATURE}_FLASH})\n")
+  else ()
+    string(APPEND OUT "  ${FEATURE}: no\n")
+  endif ()
+endforeach ()
+string(APPEND OUT "\n")
+#
+string(APPEND OUT "Per subsystem (bytes):\n  Subsystem         RAM      Flash\n")
+foreach (ID IN LISTS SUBSYSTEMS ITEMS OTHER)
+  string(LENGTH "${ID}" LENGTH)
+  string(SUBSTRING "                " ${LENGTH} -1 PAD)
+  string(APPEND OUT "  ${ID}${PAD}  ${${ID}_RAM}\t${${ID}_FLASH}\n")
+endforeach ()
+string(APPEND OUT "\n")
+#
+string(APPEND OUT "Largest ${TOP} symbols (RAM / flash in bytes):\n")
+foreach (ENTRY IN LISTS TOP_LINES)
+  string(REPLACE "|" "\t" ENTRY "${ENTRY}")
+  string(APPEND OUT "${ENTRY}\n")
+endforeach ()
+#
+#
+# Check budgets.
+set(ERRORS "")
+if (DEFINED BUDGET_RAM AND BUDGET_RAM GREATER 0 AND TOTAL_RAM GREATER BUDGET_RAM)
+  list(APPEND ERRORS "total RAM ${TOTAL_RAM} exceeds budget ${BUDGET_RAM}")
+endif ()
+if (DEFINED BUDGET_FLASH AND BUDGET_FLASH GREATER 0 AND TOTAL_FLASH GREATER BUDGET_FLASH)
+  list(APPEND ERRORS "total flash ${TOTAL_FLASH} exceeds budget ${BUDGET_FLASH}")
+endif ()
+foreach (BUDGET IN LISTS BUDGETS)
+  if (NOT BUDGET MATCHES "^([A-Z0-9_]+)_(RAM|FLASH)=([0-9]+)$")
+    message(FATAL_ERROR "memory_report: invalid budget \"${BUDGET}\" (expected <SUBSYSTEM>_RAM=<bytes> or <SUBSYSTEM>_FLASH=<bytes>)")
+  endif ()
+  set(ID ${CMAKE_MATCH_1})
+  set(KIND ${CMAKE_MATCH_2})
+  set(LIMIT ${CMAKE_MATCH_3})
+  if (NOT DEFINED ${ID}_${KIND})
+    message(FATAL_ERROR "memory_report: unknown subsystem \"${ID}\" in budget \"${BUDGET}\"")
+  endif ()
+  if (${ID}_${KIND} GREATER LIMIT)
+    list(APPEND ERRORS "${ID} ${KIND} ${${ID}_${KIND}} exceeds budget ${LIMIT}")
+  endif ()
+endforeach ()
+#
+if (DEFINED REPORT)
+  file(WRITE "${REPORT}" "${OUT}")
+endif ()
+message("${OUT}")
+if (ERRORS)
+  string(REPLACE ";" "\n  " ERRORS "${ERRORS}")
+  message(FATAL_ERROR "Memory budget exceeded:\n  ${ERRORS}")
+endif ()
@@ -0,0 +1,160 @@
+/* ======================================================================== *\
+   messages.h
+   Localized strings (month names, day names and user messages) for the
+   Pico Green Clock.
+
+   Each MESSAGE() entry gives the same message in every language, in the
+   order of the language numbers (ENGLISH, FRENCH, GERMAN, CZECH, SPANISH).
+   The table is expanded by the preprocessor in Pico-Green-Clock.c into
+   a single string pool and a table of 16-bit offsets. An empty string
+   falls back to the English message (resolved at compile time).
+
+   Accented characters are encoded directly with their character map
+   code (octal escapes, see bitmap.h):
+     \036 = u-circumflex   \037 = e-acute    \201 = a-acute
+     \202 = e-caron        \203 = i-acute    \204 = y-acute
+     \205 = u-acute        \207 = r-caron    \210 = c-caron
+     \211 = z-caron        \212 = e-acute    \213 = o-acute
+     \214 = n-tilde
+
+   To add a language, add one column to MESSAGE() (and to the pool
+   expansion in Pico-Green-Clock.c).
+\* ======================================================================== */
+#ifndef _MESSAGES_H_
+#define _MESSAGES_H_
+
+
+
+#define MESSAGE_TABLE \
+  /* Month names (index 0 is a placeholder, so that MSG_MONTH_NONE + month number gives the month name). */ \
+  MESSAGE(MSG_MONTH_NONE,       "",                 "",                 "",                 "",                 "") \
+  MESSAGE(MSG_JANUARY,          "January",          "Janvier",          "Januar",           "leden",            "enero") \
+  MESSAGE(MSG_FEBRUARY,         "February",         "F\037vrier",       "Februar",          "\205nor",          "febrero") \
+  MESSAGE(MSG_MARCH,            "March",            "Mars",             "Maerz",            "b\207ezen",        "marzo") \
+  MESSAGE(MSG_APRIL,            "April",            "Avril",            "April",            "duben",            "abril") \
+  MESSAGE(MSG_MAY,              "May",              "Mai",              "Mai",              "kv\202ten",        "mayo") \
+  MESSAGE(MSG_JUNE,             "June",             "Juin",             "Juni",             "\210erven",        "junio") \
+  MESSAGE(MSG_JULY,             "July",             "Juillet",          "Juli",             "\210ervenec",      "julio") \
+  MESSAGE(MSG_AUGUST,           "August",           "Ao\036t",          "August",           "srpen",            "agosto") \
+  MESSAGE(MSG_SEPTEMBER,        "September",        "Septembre",        "September",        "z\201\207i",       "septiembre") \
+  MESSAGE(MSG_OCTOBER,          "October",          "Octobre",          "Oktober",          "\207\203jen",      "octubre") \
+  MESSAGE(MSG_NOVEMBER,         "November",         "Novembre",         "November",         "listopad",         "noviembre") \
+  MESSAGE(MSG_DECEMBER,         "December",         "D\037cembre",      "Dezember",         "prosinec",         "diciembre") \
+  \
+  /* Short month names. */ \
+  MESSAGE(MSG_SHORT_MONTH_NONE, "",                 "",                 "",                 "",                 "") \
+  MESSAGE(MSG_SHORT_JAN,        "JAN",              "",                 "",                 "led.",             "ene.") \
+  MESSAGE(MSG_SHORT_FEB,        "FEB",              "F\037V",           "",                 "\205no.",          "feb.") \
+  MESSAGE(MSG_SHORT_MAR,        "MAR",              "",                 "",                 "b\207e.",          "mar.") \
+  MESSAGE(MSG_SHORT_APR,        "APR",              "AVR",              "",                 "dub.",             "abr.") \
+  MESSAGE(MSG_SHORT_MAY,        "MAY",              "MAI",              "MAI",              "kv\202.",          "may.") \
+  MESSAGE(MSG_SHORT_JUN,        "JUN",              "",                 "",                 "\210vn.",          "jun.") \
+  MESSAGE(MSG_SHORT_JUL,        "JUL",              "",                 "",                 "\210vc.",          "jul.") \
+  MESSAGE(MSG_SHORT_AUG,        "AUG",              "AO\036",           "",                 "srp.",             "ago.") \
+  MESSAGE(MSG_SHORT_SEP,        "SEP",              "",                 "",                 "z\201\207.",       "sep.") \
+  MESSAGE(MSG_SHORT_OCT,        "OCT",              "",                 "OKT",              "\207\203j.",       "oct.") \
+  MESSAGE(MSG_SHORT_NOV,        "NOV",              "",                 "",                 "lis.",             "nov.") \
+  MESSAGE(MSG_SHORT_DEC,        "DEC",              "D\037C",           "DEZ",              "pro.",             "dic.") \
+  \
+  /* Day names (index 0 is a placeholder, so that MSG_DAY_NONE + day-of-week gives the day name). */ \
+  MESSAGE(MSG_DAY_NONE,         "",                 "",                 "",                 "",                 "") \
+  MESSAGE(MSG_SUNDAY,           "Sunday",           "Dimanche",         "Sonntag",          "ned\202le",        "domingo") \
+  MESSAGE(MSG_MONDAY,           "Monday",           "Lundi",            "Montag",           "pond\202l\203",    "lunes") \
+  MESSAGE(MSG_TUESDAY,          "Tuesday",          "Mardi",            "Dienstag",         "\205ter\204",      "martes") \
+  MESSAGE(MSG_WEDNESDAY,        "Wednesday",        "Mercredi",         "Mittwoch",         "st\207eda",        "mi\212rcoles") \
+  MESSAGE(MSG_THURSDAY,         "Thursday",         "Jeudi",            "Donnerstag",       "\210tvrtek",       "jueves") \
+  MESSAGE(MSG_FRIDAY,           "Friday",           "Vendredi",         "Freitag",          "p\201tek",         "viernes") \
+  MESSAGE(MSG_SATURDAY,         "Saturday",         "Samedi",           "Samstag",          "sobota",           "s\201bado") \
+  \
+  /* Short day names. */ \
+  MESSAGE(MSG_SHORT_DAY_NONE,   "",                 "",                 "",                 "",                 "") \
+  MESSAGE(MSG_SHORT_SUN,        "SUN",              "DIM",              "SON",              "ne",               "do.") \
+  MESSAGE(MSG_SHORT_MON,        "MON",              "LUN",              "",                 "po",               "lu.") \
+  MESSAGE(MSG_SHORT_TUE,        "TUE",              "MAR",              "DIE",              "\205t",            "ma.") \
+  MESSAGE(MSG_SHORT_WED,        "WED",              "MER",              "MIT",              "st",               "mi.") \
+  MESSAGE(MSG_SHORT_THU,        "THU",              "JEU",              "DON",              "\210t",            "ju.") \
+  MESSAGE(MSG_SHORT_FRI,        "FRI",              "VEN",              "FRE",              "p\201",            "vi.") \
+  MESSAGE(MSG_SHORT_SAT,        "SAT",              "SAM",              "SAM",              "so",               "s\201.") \
+  \
+  /* Messages scrolled on clock display. */ \
+  MESSAGE(MSG_AMBIENT_LIGHT,       "Ambient light: %u   Hysteresis: %u   Display: %u%%    ", "Luminosit\037: %u   Hysteresis: %u   Affichage: %u%%    ", "", "Jas: %u   hystereze: %u   displej: %u%%.    ", "Luminosidad: %u   Hysteresis: %u   Monitor: %u%%    ") \
+  MESSAGE(MSG_AUTO_BRIGHTNESS_OFF, "Auto brightness is Off",          "Intensit\037 automatique est a Off",   "", "Automatick\212 nastaven\203 jasu je vypnuto.", "Intensidad autom\201tica est\201 desactivada") \
+  MESSAGE(MSG_AUTO_BRIGHTNESS_ON,  "Auto brightness is On   Light level: %u   Hysteresis: %u   Display: %u%%", "Intensit\037 automatique est a On   Luminosit\037: %u   Hysteresis: %u   Affichage: %u%%", "", "Automatick\212 nastaven\203 jasu je zapnuto. Jas: %u   hystereze: %u   zobrazen\203: %u%%.", "Intensidad autom\201tica est\201 activada   Luminosidad: %u   Hysteresis: %u   Monitor: %u%%") \
+  MESSAGE(MSG_BME280_INIT_ERROR,   "BME280 initialization error    ", "BME280 erreur d'initialisation    ", "", "Chyba nastaven\203 BME280.    ", "BME280 error de inicializacion    ") \
+  MESSAGE(MSG_BME280_TEMP,         "Out: %2.2f%c%c  Hum: %2.2f%%  Pressure: %4.2f hPa ", "Ext: %2.2f%c%c  Hum: %2.2f%%  Pression: %4.2f hPa ", "", "Venku: %2.2f %c%c, %2.2f %%, %4.2f hPa.", "Ext: %2.2f%c%c  Hum: %2.2f%%  Presi\213n: %4.2f hPa ") \
+  MESSAGE(MSG_CHIME_DAY,           "Hourly chime is intermittent, from %u:00 to %u:00", "Le signal horaire est intermittent, de %u:00 a %u:00", "", "Hodinov\204 zvuk zapnut jen od %u:00 do %u:00.", "El timbre cada hora est\201 en intermitente, de %u:00 a %u:00") \
+  MESSAGE(MSG_CHIME_OFF,           "Hourly chime is Off",             "Le signal horaire est a Off",        "", "Hodinov\204 zvuk je vypnut.",   "El timbre cada hora est\201 desactivado") \
+  MESSAGE(MSG_CHIME_ON,            "Hourly chime is On",              "Le signal horaire est a On",         "", "Hodinov\204 zvuk je zapnut.",   "El timbre cada hora est\201 activado") \
+  MESSAGE(MSG_DEBUG_ON,            "SOME DEBUG ON    ",               "DES DEBUG SONT ACTIFS    ",          "", "DEBUG ZAPNUT!    ",             "DEPURACION ACTIVADA    ") \
+  MESSAGE(MSG_DHT22_ERROR,         "DHT22 communication error    ",   "DHT22 erreur de communication    ",  "", "Chyba v komunikaci s DHT22.    ", "DHT22 error de comunicacion    ") \
+  MESSAGE(MSG_DST_ACTIVE,          " - DST active    ",               " - active    ",                      "", " - je letn\203 \210as    ",        " - activado    ") \
+  MESSAGE(MSG_DST_INACTIVE,        " - DST inactive    ",             " - inactive    ",                    "", " - nen\203 letn\203 \210as    ",  " - desactivado    ") \
+  MESSAGE(MSG_DST_NONE,            "No support for daylight saving time    ", "Heure avanc\037e non support\037e    ", "", "Funkce letn\203ho \210asu je vypnuta.", "Horario de verano no compatible    ") \
+  MESSAGE(MSG_DST_SETTING,         "DST setting: %s",                 "Heure avanc\037e: %s",               "", "Letn\203 \210as: %s",           "Horario de verano: %s") \
+  MESSAGE(MSG_EVENTS_TODAY,        "%u events today",                 "%u \037v\037nements aujourd'hui",    "", "Dnes %u ud\201losti.",          "%u eventos hoy") \
+  MESSAGE(MSG_EVENTS_TODAY_NONE,   "No event today",                  "Aucun \037v\037nement aujourd'hui",  "", "Dnes \211\201dn\201 ud\201lost.", "No hay eventos hoy") \
+  MESSAGE(MSG_EVENTS_TODAY_ONE,    "1 event today",                   "1 \037v\037nement aujourd'hui",      "", "Dnes 1 ud\201lost.",            "Un evento hoy") \
+  MESSAGE(MSG_EVENTS_WEEK,         "   %u events this week",          "   %u \037v\037nements cette semaine", "", "   Tento t\204den %u ud\201lost\203.", "   %u eventos esta semana") \
+  MESSAGE(MSG_EVENTS_WEEK_NONE,    "   No event this week",           "   Aucun \037v\037nement cette semaine", "", "   Tento t\204den \211\201dn\201 ud\201lost.", "   No hay eventos esta semana") \
+  MESSAGE(MSG_EVENTS_WEEK_ONE,     "   1 event this week",            "   1 \037v\037nement cette semaine",   "", "   Tento t\204den 1 ud\201lost.", "   1 evento esta semana") \
+  MESSAGE(MSG_FIRMWARE_VERSION,    "Pico Green Clock - Firmware Version %s    ", "Pico Green Clock - Microcode Version %s    ", "", "Pico Green Clock - verze firmwaru %s    ", "Pico Green Clock - Versi\213n del firmware %s    ") \
+  MESSAGE(MSG_HUMIDITY,            "  Hum: %2.2f%%",                  "",                                   "", "  vlh: %2.2f%%",                "") \
+  MESSAGE(MSG_IDLE_MONITOR,        "System idle monitor: %lu (%u min: %lu / %lu / %lu)    ", "", "", "Vyt\203\211en\203: %lu (%u min: %lu / %lu / %lu)    ", "Monitor del tiempo de inactividad del sistema: %lu (%u min: %lu / %lu / %lu)    ") \
+  MESSAGE(MSG_KEYCLICK_OFF,        "Keyclick Off",                    "",                                   "", "Zvuk kl\201ves vypnut.",        "Clic en clave desactivado") \
+  MESSAGE(MSG_KEYCLICK_ON,         "Keyclick On - Duration: %u ms Repeat1: %u Repeat2: %u", "Keyclick On - Dur\037e %u ms Repeat1: %u Repeat2: %u", "", "Zvuk kl\201ves zapnut - doba %u ms, opakov\201n\203 1: %u opakov\201n\203 2: %u.", "Clic en clave activado - Duraci\213n %u ms Repeat1: %u Repeat2: %u") \
+  MESSAGE(MSG_LANGUAGE,            "Language is English   ",          "La langue est le francais   ",       "Language is German   ", "Jazyk je \210estina   ", "La lengua es el espa\214ol   ") \
+  MESSAGE(MSG_LANGUAGE_CODE,       "EN",                              "FR",                                 "GE", "CZ",                           "SP") \
+  MESSAGE(MSG_MICROCONTROLLER,     "Microcontroller: %s    ",         "Microcontroleur: %s    ",            "", "mikrokontrol\212r: %s.    ",   "Microcontrolador: %s    ") \
+  MESSAGE(MSG_NIGHT_LIGHT_AUTO,    "Night light is automatic",        "La veilleuse de nuit est automatique", "", "No\210n\203 sv\202tlo je zapnuto automaticky.", "La luz nocturna est\201 en autom\201tica") \
+  MESSAGE(MSG_NIGHT_LIGHT_NIGHT,   "Night light is intermittent, from %u:00 to %u:00", "La veilleuse de nuit est intermittente, de %u:00 a %u:00", "", "No\210n\203 sv\202tlo zapnuto jen od %u:00 do %u:00.", "La luz nocturna est\201 en intermitente, de %u:00 a %u:00") \
+  MESSAGE(MSG_NIGHT_LIGHT_OFF,     "Night light is Off",              "La veilleuse de nuit est a Off",     "", "No\210n\203 sv\202tlo je vypnuto.", "La luz nocturna est\201 desactivado") \
+  MESSAGE(MSG_NIGHT_LIGHT_ON,      "Night light is On",               "La veilleuse de nuit est a On",      "", "No\210n\203 sv\202tlo je zapnuto.", "La luz nocturna est\201 activado") \
+  MESSAGE(MSG_NTP_ERRORS,          "NTP errors: %lu   ",              "Erreurs NTP: %lu   ",                "", "Chyba NTP: %lu.   ",           "Errores NTP: %lu   ") \
+  MESSAGE(MSG_NTP_STATUS,          "NTP status: %lu/%lu   ",          "Statut NTP: %lu/%lu   ",             "", "Stav NTP: %lu/%lu.   ",        "Status NTP: %lu/%lu   ") \
+  MESSAGE(MSG_PICO_TEMP,           "Pico temp: %2.2f%c%c    ",        "",                                   "", "Pico tep.: %2.2f %c%c    ",    "Temp. de la Pico: %2.2f%c%c    ") \
+  MESSAGE(MSG_PRESSURE,            "  Pressure: %2.2f hPa",           "  Pression: %2.2f hPa",              "", "  tlak: %2.2f hPa.",           "  Presion: %2.2f hPa") \
+  MESSAGE(MSG_SCROLLING_OFF,       "Scrolling Off.",                  "Scrolling OFF.",                     "", "Posuv vypnut.",                "Desplazamiento desactivado.") \
+  MESSAGE(MSG_SCROLLING_ON,        "Scrolling On - Frequency: %u minutes   Dot speed: %u msec.", "Scrolling On - P\037riode: %u minutes   Vitesse des dots: %u msec.", "", "Posuv zapnut - opakov\201n\203: %u minut   rychlost te\210ek: %u ms.", "Desplazamiento activado - Duraci\213n: %u minutos   Velodicad de los dots: %u msec.") \
+  MESSAGE(MSG_SILENCE_PERIOD,      "Silence period: %u minutes",      "P\037riode de silence: %u minutes",  "", "Obdob\203 klidu: %u minut.",     "Per\203odo de silencio: %u minutos") \
+  MESSAGE(MSG_SILENCE_PERIOD_ONE,  "Silence period: %u minutes",      "P\037riode de silence: %u minutes",  "", "Obdob\203 klidu: %u minuta.",    "Per\203odo de silencio: %u minutos") \
+  MESSAGE(MSG_SOUND_CUT_OFF,       "WARNING - SOUND CUT-OFF    ",     "ATTENTION - PAS DE SON    ",         "", "POZOR - BEZ ZVUKU!    ",        "AVISO - SONIDO APAGADO    ") \
+  MESSAGE(MSG_TEMPERATURE_UNIT,    "Temperature unit is %s   ",       "Unit\037 de temp\037rature: %s   ",  "", "Jedn. teploty: %s.   ",        "Unidad de temperatura: %s   ") \
+  MESSAGE(MSG_TIME_FORMAT,         "Time display format: %u-hours",   "Format d'affichage de l'heure: %u heures", "", "%uhodinov\212 zobrazen\203 \210asu.", "Formato de visualizaci\213n de la hora: %u horas") \
+  MESSAGE(MSG_TIMEZONE,            "Timezone: %s    ",                "",                                   "", "\210asov\201 z\213na: %s    ",  "Zona horaria: %s    ") \
+  MESSAGE(MSG_VOLTAGE,             "%2.2f Volts    ",                 "",                                   "", "%2.2f V    ",                  "%2.2f voltios  ") \
+  \
+  /* Daylight saving time regions (index 0 is a placeholder, so that MSG_DST_COUNTRY_NONE + DST country gives the region name). */ \
+  MESSAGE(MSG_DST_COUNTRY_NONE,    "",                 "",                 "",                 "",                 "") \
+  MESSAGE(MSG_DST_AUSTRALIA,       "Australia",        "Australie",        "",                 "Austr\201lie",     "Australia") \
+  MESSAGE(MSG_DST_AUSTRALIA_HOWE,  "Australia Howe",   "Australie Howe",   "",                 "Austr\201lie Howe", "Australia Howe") \
+  MESSAGE(MSG_DST_CHILE,           "Chile",            "Chili",            "",                 "Chile",            "Chile") \
+  MESSAGE(MSG_DST_CUBA,            "Cuba",             "Cuba",             "",                 "Kuba",             "Cuba") \
+  MESSAGE(MSG_DST_EUROPE,          "Europe",           "Europe",           "",                 "Evropa",           "Europa") \
+  MESSAGE(MSG_DST_ISRAEL,          "Israel",           "Israel",           "",                 "Izrael",           "Israel") \
+  MESSAGE(MSG_DST_LEBANON,         "Lebanon",          "Liban",            "",                 "Libanon",          "L\203bano") \
+  MESSAGE(MSG_DST_MOLDOVA,         "Moldova",          "Moldavie",         "",                 "Moldavie",         "Moldova") \
+  MESSAGE(MSG_DST_NEW_ZEALAND,     "New Zealand",      "Nouvelle-Z\037lande", "",              "Novy Zeland",      "Nueva Zelandia") \
+  MESSAGE(MSG_DST_NORTH_AMERICA,   "North America",    "Am\037rique du Nord", "",              "Severni Amerika",  "Am\037rica del Norte") \
+  MESSAGE(MSG_DST_PALESTINE,       "Palestine",        "Palestine",        "",                 "Palestina",        "Palestina") \
+  MESSAGE(MSG_DST_PARAGUAY,        "Paraguay",         "Paraguay",         "",                 "Paraguay",         "Paraguay")
+
+
+
+/* Message identifiers. */
+enum message_id
+{
+#define MESSAGE(Id, English, French, German, Czech, Spanish) Id,
+  MESSAGE_TABLE
+#undef MESSAGE
+  MSG_HI_LIMIT
+};
+
+
+
+/* Month and day names, given the month number (1 to 12) or day-of-week (1 = Sunday to 7 = Saturday). */
+#define DAY_NAME(Language, DayOfWeek)     msg_lang((Language), MSG_DAY_NONE + (DayOfWeek))
+#define MONTH_NAME(Language, Month)       msg_lang((Language), MSG_MONTH_NONE + (Month))
+#define SHORT_DAY(Language, DayOfWeek)    msg_lang((Language), MSG_SHORT_DAY_NONE + (DayOfWeek))
+#define SHORT_MONTH(Language, Month)      msg_lang((Language), MSG_SHORT_MONTH_NONE + (Month))
+
+#endif  // _MESSAGES_H_
@@ -0,0 +1,248 @@
+/* ======================================================================== *\
+   ntp_packet.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   NTP message fields and SNTP exchange arithmetic for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   See ntp_packet.h for the times used.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include <string.h>
+#include "ntp_packet.h"
+
+
+static uint32_t get_uint32(const uint8_t *Packet, uint8_t Offset);
+static void     put_uint32(uint8_t *Packet, uint8_t Offset, uint32_t Value);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=get_uint32() */
+/* ------------------------------------------------------------------ *\
+       Return the 32 bits (network byte order) at the given offset
+                         of an NTP message.
+\* ------------------------------------------------------------------ */
+static uint32_t get_uint32(const uint8_t *Packet, uint8_t Offset)
+{
+  return ((uint32_t)Packet[Offset] << 24) | ((uint32_t)Packet[Offset + 1] << 16) | ((uint32_t)Packet[Offset + 2] << 8) | Packet[Offset + 3];
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=put_uint32() */
+/* ------------------------------------------------------------------ *       Write 32 bits (network byte order) at the given offset of an
+                            NTP message.
+\* ------------------------------------------------------------------ */
+static void put_uint32(uint8_t *Packet, uint8_t Offset, uint32_t Value)
+{
+  Packet[Offset]     = (Value >> 24) & 0xFF;
+  Packet[Offset + 1] = (Value >> 16) & 0xFF;
+  Packet[Offset + 2] = (Value >>  8) & 0xFF;
+  Packet[Offset + 3] =  Value        & 0xFF;
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_packet_get_timestamp() */
+/* ------------------------------------------------------------------ *\
+        Return the NTP timestamp (32 bits of seconds since 1900 and
+       32 bits of fraction of second) found at the given offset of an
+         NTP message, as UTC time in usec since 01-JAN-1970.
+\* ------------------------------------------------------------------ */
+int64_t ntp_packet_get_timestamp(const uint8_t *Packet, uint8_t Offset)
+{
+  uint32_t Fraction;
+  uint32_t Seconds;
+  uint64_t SecondsSince1900;
+
+
+  Seconds  = get_uint32(Packet, Offset);
+  Fraction = get_uint32(Packet, Offset + 4);
+
+  /* NTP era 0 ends in February 2036. Seconds lower than NTP_DELTA can only be found in era 1 (RFC 4330, section 3). */
+  SecondsSince1900 = Seconds;
+  if (Seconds < NTP_DELTA) SecondsSince1900 += 0x100000000ULL;
+
+  return ((int64_t)(SecondsSince1900 - NTP_DELTA) * 1000000LL) + (int64_t)(((uint64_t)Fraction * 1000000ULL) >> 32);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_packet_put_timestamp() */
+/* ------------------------------------------------------------------ *\
+       Write UTC time "UnixTimeUs" (in usec since 01-JAN-1970) as an
+        NTP timestamp (32 bits of seconds since 1900, wrapping at the
+          end of era 0, and 32 bits of fraction of second) at the
+                    given offset of an NTP message.
+\* ------------------------------------------------------------------ */
+void ntp_packet_put_timestamp(uint8_t *Packet, uint8_t Offset, uint64_t UnixTimeUs)
+{
+  uint8_t  Loop1UInt8;
+  uint32_t Fraction;
+  uint32_t Seconds;
+
+
+  Seconds  = (uint32_t)((UnixTimeUs / 1000000ULL) + NTP_DELTA);
+  Fraction = (uint32_t)(((UnixTimeUs % 1000000ULL) << 32) / 1000000ULL);
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < 4; ++Loop1UInt8)
+  {
+    Packet[Offset + Loop1UInt8]     = (Seconds  >> (24 - (Loop1UInt8 * 8))) & 0xFF;
+    Packet[Offset + 4 + Loop1UInt8] = (Fraction >> (24 - (Loop1UInt8 * 8))) & 0xFF;
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_packet_sample() */
+/* ------------------------------------------------------------------ *\
+       Classify the answer to a request sent at Pico time T1 and
+       received at T4. The originate timestamp must be T1 (otherwise
+       it is a late answer to a previous request, or a forged one).
+       With the four timestamps of the SNTP exchange (T2 and T3 from
+       the server, in UTC), the offset between UTC and the Pico timer
+           and the round-trip delay are (RFC 4330, section 5):
+                Offset = ((T2 - T1) + (T3 - T4)) / 2
+                Delay  = (T4 - T1) - (T3 - T2)
+       The offset error is at most half of the difference between
+               network delays from and to the server.
+\* ------------------------------------------------------------------ */
+uint8_t ntp_packet_sample(const uint8_t *Packet, uint64_t T1, uint64_t T4, struct ntp_packet_sample *Sample)
+{
+  uint8_t Leap;
+  uint8_t Mode;
+  uint8_t Stratum;
+  int64_t ReceiveTime;
+  int64_t TransmitTime;
+
+
+  Leap    = Packet[0] >> 6;
+  Mode    = Packet[0] & 0x07;
+  Stratum = Packet[1];
+
+  if ((Mode != 4) || (get_uint32(Packet, NTP_OFFSET_ORIGINATE) != (uint32_t)(T1 >> 32)) || (get_uint32(Packet, NTP_OFFSET_ORIGINATE + 4) != (uint32_t)T1))
+    return NTP_PACKET_INVALID;
+
+  /* Kiss-o'-death (RFC 5905 section 7.4). */
+  if (Stratum == 0) return NTP_PACKET_KOD;
+
+  /* Leap indicator 3: server clock not synchronized. */
+  if (Leap == 3) return NTP_PACKET_INVALID;
+
+  ReceiveTime  = ntp_packet_get_timestamp(Packet, NTP_OFFSET_RECEIVE);   // T2.
+  TransmitTime = ntp_packet_get_timestamp(Packet, NTP_OFFSET_TRANSMIT);  // T3.
+
+  Sample->Offset         = ((ReceiveTime - (int64_t)T1) + (TransmitTime - (int64_t)T4)) / 2;
+  Sample->Delay          = ((int64_t)(T4 - T1)) - (TransmitTime - ReceiveTime);
+  if (Sample->Delay < 0) Sample->Delay = 0;  // server processing time may be reported longer than it was (clock granularity).
+  Sample->RootDelay      = ((uint64_t)get_uint32(Packet, NTP_OFFSET_ROOT_DELAY) * 1000000ULL) >> 16;
+  Sample->RootDispersion = ((uint64_t)get_uint32(Packet, NTP_OFFSET_ROOT_DISP)  * 1000000ULL) >> 16;
+  Sample->Stratum        = Stratum;
+
+  return NTP_PACKET_SAMPLE;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_packet_serve() */
+/* ------------------------------------------------------------------ *       Turn the request of "Length" bytes in Packet, received at UTC
+       time "ReceiveTime" (T2), into the answer of the LAN NTP server
+       (RFC 5905), but its transmit timestamp (T3), written by the
+       caller just before the answer leaves. Only client requests
+       (mode 3) with a full NTP header are answered (returns 0 for
+                       the others).
+       - Synchronized: stratum one above the system peer of the last
+         sync, whose address is the reference ID. The root dispersion
+         grows by NTP_SERVE_PHI from the last sync.
+       - Unsynchronized (no sync since power-up, or root dispersion
+         beyond NTP_SERVE_MAX_DISP): leap indicator 3, stratum 16, so
+         that clients do not use this server.
+\* ------------------------------------------------------------------ */
+uint8_t ntp_packet_serve(uint8_t *Packet, uint16_t Length, uint64_t ReceiveTime, const struct ntp_packet_peer *Peer)
+{
+  uint8_t Leap;
+  uint8_t Stratum;
+  uint8_t Version;
+  int64_t Dispersion;
+
+
+  if ((Length < NTP_MSG_LEN) || ((Packet[0] & 0x07) != 3)) return 0;
+
+  Version    = (Packet[0] >> 3) & 0x07;  // answer with the version of the request.
+  Dispersion = Peer->RootDispersion + ((Peer->Elapsed / 1000000LL) * NTP_SERVE_PHI);
+
+  if ((Peer->FlagSynced == 0) || (Dispersion >= NTP_SERVE_MAX_DISP))
+  {
+    Leap       = 3;
+    Stratum    = 16;
+    Dispersion = NTP_SERVE_MAX_DISP;
+    memcpy(&Packet[NTP_OFFSET_REFERENCE], "INIT", 4);
+  }
+  else
+  {
+    Leap    = 0;
+    Stratum = (Peer->Stratum < 15) ? Peer->Stratum + 1 : 15;
+    memcpy(&Packet[NTP_OFFSET_REFERENCE], Peer->Address, 4);
+  }
+
+  /* Reference timestamp: time of the last sync, if any. */
+  if (Peer->FlagSynced == 0)
+    memset(&Packet[NTP_OFFSET_REF_TIME], 0, 8);
+  else
+    ntp_packet_put_timestamp(Packet, NTP_OFFSET_REF_TIME, ReceiveTime - (uint64_t)Peer->Elapsed);
+
+  /* The transmit timestamp of the request (T1 of the client) is returned as originate timestamp. */
+  memcpy(&Packet[NTP_OFFSET_ORIGINATE], &Packet[NTP_OFFSET_TRANSMIT], 8);
+
+  Packet[0] = (Leap << 6) | (Version << 3) | 4;  // mode 4: server.
+  Packet[1] = Stratum;
+  Packet[3] = (uint8_t)NTP_SERVE_PRECISION;      // Packet[2] (poll) is the one of the request.
+
+  /* Root delay and root dispersion in NTP short format (16 bits of seconds and 16 bits of fraction). */
+  put_uint32(Packet, NTP_OFFSET_ROOT_DELAY, (uint32_t)(((uint64_t)Peer->RootDelay << 16) / 1000000ULL));
+  put_uint32(Packet, NTP_OFFSET_ROOT_DISP,  (uint32_t)(((uint64_t)Dispersion << 16) / 1000000ULL));
+  ntp_packet_put_timestamp(Packet, NTP_OFFSET_RECEIVE, ReceiveTime);
+
+  return 1;
+}
@@ -0,0 +1,109 @@
+/* ======================================================================== *\
+   ntp_packet.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   NTP message fields and SNTP exchange arithmetic for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   These functions only work on the 48 bytes of an NTP message and on
+   times given to them, they do not depend on lwIP or on the Pico SDK
+   (see picow_ntp_client.c for the network side).
+
+   Times are UTC times in usec since 01-JAN-1970. NTP timestamps hold
+   32 bits of seconds since 01-JAN-1900, that wrap in February 2036
+   (end of NTP era 0). Seconds lower than NTP_DELTA are taken as era 1,
+   so that timestamps are decoded correctly from 1970 to 2106.
+
+   T1 and T4 (request sent and answer received) are Pico timer values.
+   T1 is sent as transmit timestamp of the request, so the server
+   returns it as originate timestamp and an answer can be matched with
+   its request.
+
+   The LAN NTP server answers requests with the time base (UTC), from
+   the system peer of the last sync (see ntp_packet_serve()).
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _NTP_PACKET_H_
+#define _NTP_PACKET_H_
+
+
+
+#include <stdint.h>
+
+
+
+#define NTP_DELTA             2208988800ULL  // number of seconds between 01-JAN-1900 and 01-JAN-1970.
+#define NTP_MSG_LEN           48
+#define NTP_OFFSET_ORIGINATE  24        // offset of the originate timestamp (T1, echoed by the server) in an NTP message.
+#define NTP_OFFSET_REFERENCE  12        // offset of the reference ID (kiss code when stratum is 0) in an NTP message.
+#define NTP_OFFSET_REF_TIME   16        // offset of the reference timestamp (time of the last sync of the server) in an NTP message.
+#define NTP_OFFSET_ROOT_DELAY  4        // offset of the server root delay (NTP short format) in an NTP message.
+#define NTP_OFFSET_ROOT_DISP   8        // offset of the server root dispersion (NTP short format) in an NTP message.
+#define NTP_OFFSET_RECEIVE    32        // offset of the receive timestamp (T2, request received by the server) in an NTP message.
+#define NTP_OFFSET_TRANSMIT   40        // offset of the transmit timestamp (T3, answer sent by the server) in an NTP message.
+#define NTP_SERVE_MAX_DISP    16000000  // root dispersion (in usec) at which the LAN NTP server declares itself unsynchronized (RFC 5905 MAXDISP).
+#define NTP_SERVE_PHI         15        // frequency tolerance (in ppm) making the root dispersion grow since last sync (RFC 5905 PHI).
+#define NTP_SERVE_PRECISION   (-20)     // precision of the time base given to LAN clients (log2 of seconds: 1 usec).
+
+/* Answers, as classified by ntp_packet_sample(). */
+#define NTP_PACKET_INVALID    0         // not a server answer to the request sent at T1, or server not synchronized.
+#define NTP_PACKET_KOD        1         // kiss-o'-death, kiss code is at NTP_OFFSET_REFERENCE.
+#define NTP_PACKET_SAMPLE     2         // valid answer, sample filled.
+
+
+
+/* Sample given by a valid answer (times in usec). */
+struct ntp_packet_sample
+{
+  int64_t Offset;              // UTC time minus Pico timer value.
+  int64_t Delay;               // round-trip delay, server processing time excluded.
+  int64_t RootDelay;           // server root delay.
+  int64_t RootDispersion;      // server root dispersion.
+  uint8_t Stratum;             // server stratum.
+};
+
+/* System peer of the last sync, from which the LAN NTP server answers (times in usec). */
+struct ntp_packet_peer
+{
+  int64_t Elapsed;             // time since the last sync.
+  int64_t RootDelay;           // root delay through the system peer.
+  int64_t RootDispersion;      // root dispersion at the last sync.
+  uint8_t Address[4];          // IPv4 address of the system peer (network byte order), given as reference ID.
+  uint8_t FlagSynced;          // 0 if there has been no sync since power-up.
+  uint8_t Stratum;             // stratum of the system peer.
+};
+
+
+
+/* Return the NTP timestamp at the given offset of an NTP message, as UTC time in usec since 01-JAN-1970. */
+int64_t ntp_packet_get_timestamp(const uint8_t *Packet, uint8_t Offset);
+
+/* Write UTC time in usec since 01-JAN-1970 as an NTP timestamp at the given offset of an NTP message. */
+void ntp_packet_put_timestamp(uint8_t *Packet, uint8_t Offset, uint64_t UnixTimeUs);
+
+/* Classify an answer to the request sent at Pico time T1 and received at T4, and fill Sample if it is valid. Returns NTP_PACKET_xxx. */
+uint8_t ntp_packet_sample(const uint8_t *Packet, uint64_t T1, uint64_t T4, struct ntp_packet_sample *Sample);
+
+/* Turn the request of Length bytes in Packet, received at UTC time ReceiveTime, into the answer of the LAN NTP server (but its transmit timestamp). Returns 0 if the request is not answered. */
+uint8_t ntp_packet_serve(uint8_t *Packet, uint16_t Length, uint64_t ReceiveTime, const struct ntp_packet_peer *Peer);
+
+#endif  // _NTP_PACKET_H_
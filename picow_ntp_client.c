@@ -8,21 +8,52 @@
    Adapted for Pico-Green-Clock
    St-Louys, Andre - January 2023
    astlouys@gmail.com
-   Revision 10-FEB-2023
+   Revision 18-OCT-2026
    Compiler: arm-none-eabi-gcc 7.3.1
-   Version 1.00
+   Version 1.10
 
    REVISION HISTORY:
    =================
    10-FEB-2023 1.00 - Initial release.
+   18-OCT-2026 1.01 - Full SNTP exchange: offset and round-trip delay are computed from the four timestamps (with their
+                      fractions) instead of using whole seconds of the transmit timestamp only.
+   18-OCT-2026 1.02 - Sample several pool servers in a burst on each sync. Keep the minimum-delay sample of each server
+                      (clock filter), reject falsetickers with an intersection (Marzullo) algorithm and combine the
+                      offsets of the truechimers.
+   18-OCT-2026 1.03 - Adaptive poll interval (64 seconds to 36 hours) and exponential backoff with jitter on failures.
+                      Kiss-o'-death answers are honoured (RATE lengthens the poll interval, DENY and RSTR drop the server).
+   18-OCT-2026 1.04 - Event-driven sync: a state machine (resolve, request, await, apply) runs from lwIP callbacks and an
+                      at-time worker of the cyw43 async context, and posts COMMAND_NTP_UPDATE to the main loop when done.
+                      The main loop no longer waits for the network.
+   18-OCT-2026 1.05 - DNS cache: the address of each pool name is kept for NTP_DNS_LIFETIME (the address of a truechimer is
+                      saved to flash for the first sync after a reboot). A server that stops answering, is a falseticker or denies access is
+                      replaced by resolving its pool name again, so that the clock rotates through pool servers.
+   18-OCT-2026 1.06 - Fast Wi-Fi reconnect: the BSSID and channel of the access point, and the DHCP lease, are saved to
+                      flash. On power-up, the access point is joined without a scan and the saved lease (or a static IP
+                      configuration) is used as soon as the link is up, with a full connection as a fallback.
+   18-OCT-2026 1.07 - Duty-cycled Wi-Fi radio: when the next sync is at least NTP_RADIO_SLEEP away, the access point is
+                      left and station mode is disabled. The next sync brings the link up again (NTP_STATE_LINK) through
+                      the fast reconnect path before sending its DNS and NTP requests.
+   18-OCT-2026 1.08 - Optional LAN NTP server (see ntp_serve_start()): requests from the local network are answered from
+                      the disciplined time base, timestamped in the receive callback, one stratum below the system peer
+                      of the last sync, with a root dispersion that grows during holdover.
+   18-OCT-2026 1.09 - NTP timestamps and the offset and delay of an SNTP exchange moved to ntp_packet.c, so that they can be
+                      tested on the host.
+   18-OCT-2026 1.10 - The answer of the LAN NTP server is built by ntp_packet_serve() (ntp_packet.c), so that its fields can
+                      be tested on the host.
 \* ================================================================================================================ */
 
 #include "debug.h"
+#include "lwip/dhcp.h"
 #include "lwip/dns.h"
+#include "lwip/netif.h"
 #include "lwip/pbuf.h"
 #include "lwip/udp.h"
+#include "messages.h"
+#include "ntp_packet.h"
 #include "pico/stdlib.h"
 #include "picow_ntp_client.h"
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -35,13 +66,55 @@ typedef uint32_t      UINT32;
 typedef uint64_t      UINT64;
 typedef unsigned char UCHAR;
 
+typedef struct NTP_SAMPLE_T_
+{
+  int64_t          offset;          // UTC time in usec minus Pico timer value.
+  int64_t          delay;           // round-trip delay (in usec), server processing time excluded.
+  int64_t          root_distance;   // half of server root delay plus server root dispersion (in usec).
+  int64_t          root_delay;      // server root delay (in usec).
+  UINT8            stratum;         // server stratum.
+} NTP_SAMPLE_T;
+
+typedef struct NTP_CACHE_T_
+{
+  ip_addr_t        address;         // last address given by DNS for this pool name.
+  UINT64           expiry;          // Pico timer value when the pool name must be resolved again (0 = no address cached).
+  UINT8            misses;          // number of consecutive syncs without an answer from this address.
+  bool             chimer;          // address was a truechimer of the last sync, to be saved to flash (see ntp_server_save()).
+} NTP_CACHE_T;
+
+typedef struct NTP_SERVER_T_
+{
+  ip_addr_t        address;
+  bool             resolved;        // DNS gave an address for this server (and no other server has the same).
+  UINT64           send_time;       // Pico timer value when the pending request has been sent (T1), 0 if no request is pending.
+  UINT8            sample_count;    // number of valid samples received during current sync.
+  NTP_SAMPLE_T     sample[NTP_BURST];
+  bool             kod;             // server sent a kiss-o'-death, no more requests to it during current sync.
+} NTP_SERVER_T;
+
 typedef struct NTP_T_
 {
-  ip_addr_t        ntp_server_address;
+  NTP_SERVER_T     server[NTP_MAX_SERVERS];
+  NTP_CACHE_T      cache[NTP_MAX_SERVERS];  // addresses of the pool names, so that DNS is not queried on each sync.
   bool             dns_request_sent;
+  UINT8            dns_pending;     // number of DNS answers still expected during current sync.
   struct udp_pcb  *ntp_pcb;
-  absolute_time_t  ntp_test_time;
-  alarm_id_t       ntp_resend_alarm;
+  absolute_time_t  ntp_test_time;   // a new sync may not begin before this time.
+  async_at_time_worker_t worker;    // runs ntp_worker() at the time of the next step of the sync.
+  UINT8            burst_count;     // number of request rounds sent during current sync.
+  ip_addr_t        denied[NTP_MAX_DENIED];  // servers that sent a DENY or RSTR kiss-o'-death, never used again.
+  UINT8            denied_next;     // next entry of denied[] to overwrite.
+  bool             kod_rate;        // a server sent a RATE kiss-o'-death during current sync.
+  bool             link_full;       // a full connection (scan of all channels) is in progress in NTP_STATE_LINK.
+  absolute_time_t  link_time;       // time-out of the connection in progress in NTP_STATE_LINK.
+  struct udp_pcb  *serve_pcb;       // LAN NTP server on port NTP_PORT (NULL = not started, see ntp_serve_start()).
+  ip_addr_t        peer_address;    // system peer of the last sync (truechimer with the smallest root distance), given as reference ID.
+  UINT8            peer_stratum;    // stratum of the system peer.
+  int64_t          peer_root_delay; // root delay (in usec) through the system peer: its root delay plus the round-trip delay to it.
+  int64_t          peer_root_disp;  // root dispersion (in usec) at the last sync, so that root delay / 2 plus root dispersion is the root distance.
+  UINT64           peer_time;       // Pico timer value of the last sync (0 = no sync yet, the LAN NTP server is unsynchronized).
+  UINT32           serve_count;     // number of requests answered by the LAN NTP server.
 } NTP_T;
 
 
@@ -55,51 +128,39 @@ enum
 
 
 
+#define COMMAND_NTP_UPDATE 0x07         // must be the same as in Pico-Green-Clock.c.
+#ifndef CYW43_IOCTL_GET_CHANNEL
+#define CYW43_IOCTL_GET_CHANNEL 0x3A    // cyw43 ioctl giving the channel info of the interface (hw_channel first).
+#endif
 #define FLAG_OFF           0x00
 #define FLAG_ON            0x01
-#define FLAG_POLL          0x02
-#define NTP_SERVER        "pool.ntp.org"
-#define NTP_MSG_LEN        48
+#define NTP_CONNECT_TIME   10000        // maximum time (in msec) for a full connection (scan of all channels) when the radio is powered up for a sync.
+#define NTP_JOIN_TIME      5000         // maximum time (in msec) for the link to come up when joining the access point last used.
+#define NTP_LEASE_MARGIN   600          // a saved DHCP lease is used on power-up only if it is still valid for this time (in seconds).
+#define NTP_LEASE_MIN      14400        // shorter DHCP leases are not saved to flash (in seconds).
+#define NTP_LINK_POLL      50           // interval between two checks of the link status in NTP_STATE_LINK (in msec).
+#define NTP_MIN_DISTANCE   1000         // minimum root distance (in usec) of a server, accounting for clock granularity.
 #define NTP_PORT           123
-#define NTP_DELTA          2208988800   // number of seconds between 01-JAN-1900 and 01-JAN-1970.
-#define NTP_TEST_TIME      (60 * 1000)
-#define NTP_RESEND_TIME    (10 * 1000)
+#define NTP_DNS_LIFETIME   (24 * 3600 * 1000000ULL)  // time (in usec) a server address is used before its pool name is resolved again.
+#define NTP_DNS_MISSES     2            // number of consecutive syncs without an answer before a server address is replaced.
+#define NTP_POLL_STABLE    5000         // phase error (in usec) below which the poll interval is doubled.
+#define NTP_POLL_STEP      128000       // phase error (in usec) above which the poll interval restarts from NTP_POLL_MIN.
+#define NTP_POLL_UNSTABLE  20000        // phase error (in usec) above which the poll interval is halved.
+#define NTP_TEST_TIME      (60 * 1000)  // minimum time between the beginning of two syncs (in msec).
 
 NTP_T *NTPStruct;
 
+/* NTP pool servers sampled on each sync. Each name gives a different server of the pool, so that a bad one may be outvoted. */
+static const char *NTPServerName[NTP_MAX_SERVERS] = {"0.pool.ntp.org", "1.pool.ntp.org", "2.pool.ntp.org", "3.pool.ntp.org"};
+
 
 extern uint64_t             DebugBitMask;
 extern datetime_t           CurrentTime;
-extern unsigned char        DayName[3][8][10];
+extern const char          *msg_lang(UINT8 Language, UINT16 MessageId);
 extern UINT8                FlagNTPSuccess;
 
-extern struct alarm
-{
-  UINT8 FlagStatus;
-  UINT8 Second;
-  UINT8 Minute;
-  UINT8 Hour;
-  UINT8 Day;
-  UCHAR Text[40];
-}Alarm;
-
-extern struct dst_parameters
-{
-  UINT8  StartMonth;
-  UINT8  StartDayOfWeek;
-  int8_t StartDayOfMonthLow;
-  int8_t StartDayOfMonthHigh;
-  UINT8  StartHour;
-  UINT16 StartDayOfYear;
-  UINT8  EndMonth;
-  UINT8  EndDayOfWeek;
-  int8_t EndDayOfMonthLow;
-  int8_t EndDayOfMonthHigh;
-  UINT8  EndHour;
-  UINT16 EndDayOfYear;
-  UINT8  ShiftMinutes;
-}DstParameters[25];
-
+/* Queue a command to be processed while in main context. */
+extern UINT8 command_queue(UINT8 Command, UINT16 Parameter);
 
 extern struct flash_config
 {
@@ -119,9 +180,17 @@ extern struct flash_config
   UINT8  FlagKeyclick;        // flag for keyclick ("button-press" tone)
   UINT8  FlagScrollEnable;    // flag indicating the clock will scroll the date and temperature at regular intervals on the display.
   UINT8  FlagSummerTime;      // flag indicating the current status of Daylight Saving Time / Summer Time.
-  int8_t Timezone;            // (in minutes) value to add to local time to reach UTC (Universal Time Coordinate).
-  UINT8  Reserved1[48];       // reserved for future use.
-  struct alarm Alarm[9];      // alarms 1 to 9 parameters. Day is a bit mask.
+  int8_t Timezone;            // (in hours) value to add to UTC time (Universal Time Coordinate) to get the local time.
+  int8_t TimezoneMinutes;     // (in minutes) value to add to Timezone for half-hour and quarter-hour timezones (same sign as Timezone).
+  UINT32 AlarmPacked[64];     // alarms 1 to 64 parameters, packed in 32 bits (see ALARM_PACK() in Pico-Green-Clock.c).
+  int32_t TimeBaseFreq;       // frequency correction of the Pico crystal (in ppb), learned from NTP syncs.
+  UINT32 NTPServerAddress[NTP_MAX_SERVERS];  // IPv4 addresses of the NTP pool servers last used (0 or 0xFFFFFFFF = none).
+  UINT8  WiFiBssid[6];        // BSSID of the Wi-Fi access point last joined.
+  UINT8  WiFiChannel;         // channel of the Wi-Fi access point last joined (1 to 14, other values = none).
+  UINT8  WiFiStatic;          // FLAG_ON if WiFiAddress is a static IP configuration, otherwise it is the last DHCP lease.
+  UINT32 WiFiAddress[4];      // IPv4 address, netmask, gateway and DNS server of the Pico W (network byte order).
+  UINT32 WiFiLeaseEnd;        // UTC time (seconds since 01-JAN-1970) when the last DHCP lease ends (0 or 0xFFFFFFFF = none).
+  UINT8  Reserved1[147];      // reserved for future use (SSID stays at offset 475, as in Version 9.02).
   UCHAR  SSID[40];            // SSID for Wi-Fi network. Note: SSID begins at position 5, so that a "footprint" can be confirmed prior to writing to flash.
   UCHAR  Password[70];        // password for Wi-Fi network. Note: password begins at position 5, for the same reason as SSID above.
   UCHAR  Reserved2[48];       // reserved for future use.
@@ -145,11 +214,20 @@ extern struct ntp_data
   time_t Epoch;
   UINT8  FlagNTPResync;   // flag set to On if there is a specific reason to request an NTP update without delay.
   UINT8  FlagNTPSuccess;  // flag indicating that NTP date and time request has succeeded.
-  UINT64 NTPDelta;
+  UINT64 NTPDelta;        // time (in usec) from NTPLastUpdate to next NTP sync (poll interval, or retry interval after a failure).
   UINT32 NTPErrors;       // cumulative number of errors while trying to re-sync with NTP.
-  UINT64 NTPGetTime;
+  UINT8  NTPFailures;     // number of consecutive NTP sync failures.
+  UINT64 NTPFirstSync;    // Pico timer value (time since power-up) when the first NTP sync has been applied (0 = not yet).
+  UINT64 NTPGetTime;      // Pico timer value when last NTP answer has been received (T4).
   UINT64 NTPLastUpdate;
+  int64_t NTPOffset;      // offset given by last NTP answer: UTC time in usec is the Pico timer value + NTPOffset.
+  UINT8  NTPPoll;         // poll interval (log2 of seconds, NTP_POLL_MIN to NTP_POLL_MAX).
   UINT32 NTPReadCycles;   // total number of re-sync cycles through NTP.
+  int64_t NTPRoundTrip;   // round-trip delay of last NTP exchange (in usec), server processing time excluded.
+  UINT8  NTPState;        // state of the NTP sync (NTP_STATE_IDLE to NTP_STATE_APPLY, see picow_ntp_client.h).
+  UINT64 WiFiLinkTime;    // Pico timer value (time since power-up) when the Wi-Fi link came up (0 = no link).
+  UINT64 WiFiOnSince;     // Pico timer value when the Wi-Fi radio has been powered up (0 = powered down, see ntp_radio_sleep()).
+  UINT64 WiFiOnTime;      // cumulative time (in usec) the Wi-Fi radio has been powered up before it was last powered down.
 }NTPData;
 
 
@@ -163,25 +241,64 @@ void init_cyw43(UINT CountryCode);
 /* Call back with a DNS result. */
 static void ntp_dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg);
 
-/* NTP request failed. */
-static int64_t ntp_failed_handler(alarm_id_t id, void *user_data);
+/* Save the DHCP lease of the Pico W to flash, so that it may be used as soon as the link is up again. */
+static void ntp_lease_save(void);
+
+/* Save the BSSID and channel of the access point joined to flash, so that the next connection does not need a scan. */
+static void ntp_link_save(void);
+
+/* Set the retry interval after a failed NTP sync. */
+void ntp_poll_failed(void);
+
+/* Adapt the poll interval after a successful NTP sync. */
+void ntp_poll_update(int64_t Phase);
+
+/* Power down the Wi-Fi radio until next sync, if it is far enough. */
+void ntp_radio_sleep(void);
 
 /* NTP data received. */
 static void ntp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port);
 
-/* Make an NTP request. */
-static void ntp_request(NTP_T *NTPStruct);
+/* Make an NTP request to one server. */
+static void ntp_request(NTP_T *NTPStruct, NTP_SERVER_T *Server);
 
 /* Called with results of operation. */
 static void ntp_result(NTP_T* NTPStruct, int status, time_t *result);
 
+/* Select the best samples of all servers and compute the offset to apply. */
+static void ntp_select(NTP_T *NTPStruct);
+
+/* Answer an NTP request from a LAN client. */
+static void ntp_serve(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port);
+
+/* Start the LAN NTP server. */
+int ntp_serve_start(void);
+
+/* Add a server address to the servers sampled during current sync. */
+static void ntp_server_add(const char *Name, const ip_addr_t *Address, NTP_SERVER_T *Server);
+
+/* Save the addresses of the truechimers of the last sync to flash, for the first sync after a reboot. */
+void ntp_server_save(void);
+
+/* Save a static IP configuration, used instead of DHCP when connecting to Wi-Fi. */
+void ntp_static_ip(const char *Address, const char *Netmask, const char *Gateway, const char *Dns);
+
+/* Begin to join the access point last used on its BSSID and channel, without a scan. */
+static int ntp_wifi_join(void);
+
+/* Perform the next step of a sync in progress (lwIP context). */
+static void ntp_worker(async_context_t *Context, async_at_time_worker_t *Worker);
+
 /* Convert epoch time received from NTP to local real-time. */
 void epoch_time_to_utc_time(time_t *EpochTime);
 
 
 
-/* Return day-of-week of parameters passed as arguments. */
-extern UINT8 get_day_of_week(UINT16 Year, UINT8 Month, UINT8 DayOfMonth);
+/* Convert a Unix time to a tm structure (allocation-free, see civil_time.h). */
+extern void convert_unix_to_tm(time_t UnixTime, struct tm *TmTime, UINT8 FlagLocalTime);
+
+/* Return current UTC time in usec since 01-JAN-1970 (see Pico-Green-Clock.c). */
+extern UINT64 time_base_us(void);
 
 /* Send a string to external monitor through Pico UART (or USB CDC). */
 extern void uart_send(UINT LineNumber, UCHAR *Format, ...);
@@ -236,31 +353,49 @@ void init_cyw43(UINT CountryCode)
 /* $PAGE */
 /* $TITLE=ntp_dns_found() */
 /* ------------------------------------------------------------------ *\
-                       Call back with a DNS result.
+         Call back with a DNS result for one of the NTP servers.
+       The address is cached for NTP_DNS_LIFETIME, so that next syncs
+       do not need DNS (it is saved to flash once it answered, see
+                         ntp_server_save()).
+        Requests are sent to the server from the next round of the
+                      burst (see ntp_worker()).
 \* ------------------------------------------------------------------ */
 static void ntp_dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg)
 {
-  UCHAR String[256];
+  UINT8 Index;
 
-  NTP_T *NTPStruct = (NTP_T*)arg;
+  NTP_SERVER_T *Server = (NTP_SERVER_T*)arg;
 
 
   if (DebugBitMask & DEBUG_NTP)
     uart_send(__LINE__, "Entering ntp_dns_found()\r");
 
 
+  /* When the last DNS answer comes in, requests do not need to wait for NTP_DNS_TIME. */
+  if (NTPStruct->dns_pending > 0)
+  {
+    --NTPStruct->dns_pending;
+    if ((NTPStruct->dns_pending == 0) && (NTPStruct->dns_request_sent) && (NTPData.NTPState == NTP_STATE_RESOLVE))
+    {
+      async_context_remove_at_time_worker(cyw43_arch_async_context(), &NTPStruct->worker);
+      async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &NTPStruct->worker, 0);
+    }
+  }
+
   if (ipaddr)
   {
-    NTPStruct->ntp_server_address = *ipaddr;
-    if (DebugBitMask & DEBUG_NTP)
-      uart_send(__LINE__, "NTP server address: %s\r", ip4addr_ntoa(ipaddr));
-    ntp_request(NTPStruct);
+    Index = Server - NTPStruct->server;
+    NTPStruct->cache[Index].address = *ipaddr;
+    NTPStruct->cache[Index].expiry  = time_us_64() + NTP_DNS_LIFETIME;
+    NTPStruct->cache[Index].misses  = 0;
+    NTPStruct->cache[Index].chimer  = false;
+
+    ntp_server_add(hostname, ipaddr, Server);
   }
   else
   {
     if (DebugBitMask & DEBUG_NTP)
-      uart_send(__LINE__, "NTP DNS request failed.\r");
-    ntp_result(NTPStruct, -1, NULL);
+      uart_send(__LINE__, "NTP DNS request failed for %s.\r", hostname);
   }
 
   return;
@@ -270,44 +405,22 @@ static void ntp_dns_found(const char *hostname, const ip_addr_t *ipaddr, void *a
 
 
 
-/* $PAGE */
-/* $TITLE=ntp_failed_handler() */
-/* ------------------------------------------------------------------ *\
-                           NTP request failed.
-\* ------------------------------------------------------------------ */
-static int64_t ntp_failed_handler(alarm_id_t id, void *user_data)
-{
-  UCHAR String[256];
-
-
-  if (DebugBitMask & DEBUG_NTP)
-    uart_send(__LINE__, "Entering ntp_failed_handler()\r");
-
-  NTP_T* NTPStruct = (NTP_T*)user_data;
-  if (DebugBitMask & DEBUG_NTP)
-    uart_send(__LINE__, "NTP request failed.\n");
-  ntp_result(NTPStruct, -1, NULL);
-
-  return 0;
-}
-
-
-
-
-
 /* $PAGE */
 /* $TITLE=ntp_get_time() */
 /* ------------------------------------------------------------------ *\
-               Retrieve current UTC time from NTP server.
+        Begin a sync with NTP servers (called from main context).
+        The sync then runs by itself (see ntp_worker()) and posts
+        COMMAND_NTP_UPDATE to the command queue when it is done.
+       A sync requested less than NTP_TEST_TIME after the beginning
+          of the previous one is delayed until NTP_TEST_TIME.
 \* ------------------------------------------------------------------ */
 void ntp_get_time(void)
 {
   UCHAR String[256];
 
-  int ReturnCode;
+  bool FlagLink;
 
-  absolute_time_t AbsoluteTime;
-  int64_t         AbsoluteTimeDiff;
+  int64_t Wait;
 
 
   if (DebugBitMask & DEBUG_NTP)
@@ -315,106 +428,74 @@ void ntp_get_time(void)
     uart_send(__LINE__, "Entering ntp_get_time()\r");
     uart_send(__LINE__, "FlagNTPResync:                        %2.2u\r", NTPData.FlagNTPResync);
     uart_send(__LINE__, "time_us_64():               0x%10.10llX\r", time_us_64());
-    uart_send(__LINE__, "NTPGetTime + NTPDelta:      0x%10.10llX\r", NTPData.NTPGetTime + NTPData.NTPDelta);
+    uart_send(__LINE__, "NTPLastUpdate + NTPDelta:   0x%10.10llX\r", NTPData.NTPLastUpdate + NTPData.NTPDelta);
   }
 
-  if (NTPStruct)
-  {
-    if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "NTPStruct validation Ok.\r");
-    if ((!NTPData.FlagNTPResync) && (NTPData.NTPGetTime + NTPData.NTPDelta > time_us_64()))
-    {
-      if (DebugBitMask & DEBUG_NTP)
-        uart_send(__LINE__, "NTP poll...\r");
-        NTPData.FlagNTPSuccess = FLAG_POLL;
-        return;
-    }
-
+  /* A sync is already in progress, or its result has not been applied yet. */
+  if (NTPData.NTPState != NTP_STATE_IDLE) return;
 
-    AbsoluteTime = get_absolute_time();
+  if (NTPStruct == NULL)
+  {
+    /* Wi-Fi connection or NTP initialization failed, post the failure so that it is retried later (see ntp_poll_failed()). */
     if (DebugBitMask & DEBUG_NTP)
-    {
-      uart_send(__LINE__, "NTPStruct->dns_request_sent:  %10d\r",   NTPStruct->dns_request_sent);
-      uart_send(__LINE__, "AbsoluteTime:               %12lld\r",   AbsoluteTime);
-      uart_send(__LINE__, "NTPStruct->ntp_test_time:     %10lld\r", to_ms_since_boot(NTPStruct->ntp_test_time));
-      uart_send(__LINE__, "Time check: %lld usec.\r", absolute_time_diff_us(AbsoluteTime, NTPStruct->ntp_test_time));
-    }
-    if ((absolute_time_diff_us(AbsoluteTime, NTPStruct->ntp_test_time) < 0) && (NTPStruct->dns_request_sent == 0))
-    {
-      NTPData.NTPReadCycles++;
-
-      /* Set alarm in case udp requests are lost (10 seconds). */
-      NTPStruct->ntp_resend_alarm = add_alarm_in_ms(NTP_RESEND_TIME, ntp_failed_handler, NTPStruct, true);
+      uart_send(__LINE__, "NTPStruct validation failed.\r");
 
-      /* NOTE: cyw43_arch_lwip_begin/end should be used around calls into lwIP to ensure correct locking. You can omit them if you are
-               in a callback from lwIP. Note that when using pico_cyw_arch_poll these calls are a no-op and can be omitted, but it is
-               a good practice to use them in case you switch the cyw43_arch type later. */
-      cyw43_arch_lwip_begin();
-      {
-        ReturnCode = dns_gethostbyname(NTP_SERVER, &NTPStruct->ntp_server_address, ntp_dns_found, NTPStruct);
-      }
-      cyw43_arch_lwip_end();
+    NTPData.NTPState = NTP_STATE_APPLY;
+    command_queue(COMMAND_NTP_UPDATE, FLAG_OFF);
 
+    return;
+  }
 
-      NTPStruct->dns_request_sent = true;
-      if (DebugBitMask & DEBUG_NTP)
-        uart_send(__LINE__, "Sent a request to DNS server to get a NTP server IP address (return code: %d)\r", ReturnCode);
+  if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "NTPStruct validation Ok.\r");
 
+  NTPData.NTPReadCycles++;
 
-      if (ReturnCode == 0)
-      {
-        if (DebugBitMask & DEBUG_NTP)
-          uart_send(__LINE__, "Cache DNS response.\r");
+  /* DHCP may have bound or renewed the lease since last sync. */
+  ntp_lease_save();
 
-        ntp_request(NTPStruct);  // cached result.
-      }
-      else if (ReturnCode != ERR_INPROGRESS)
-      {
-        /* ERR_INPROGRESS means expect a callback. */
-        if (DebugBitMask & DEBUG_NTP)
-          uart_send(__LINE__, "DNS request failed.\r");
-        ntp_result(NTPStruct, -1, NULL);
-      }
-      else
-      {
-        /* Other error code. */
-        if (DebugBitMask & DEBUG_NTP)
-          uart_send(__LINE__, "DNS request return code: %d (-5 is Ok).\r", ReturnCode);
-      }
-    }
-    else
+  /* Wi-Fi radio powered down since last sync (see ntp_radio_sleep()), or link lost: the sync begins by bringing the link up. */
+  FlagLink = (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP);
+  if (!FlagLink)
+  {
+    if (NTPData.WiFiOnSince == 0)
     {
-      if (DebugBitMask & DEBUG_NTP)
-      {
-        uart_send(__LINE__, "Evaluate latency:   get_absolute_time: %llu   NTPStruct->ntp_test_time: %llu   NTPStruct->dns_request_sent: %u)\r", get_absolute_time(), NTPStruct->ntp_test_time, NTPStruct->dns_request_sent);
-        uart_send(__LINE__, "absolute_time_diff_us(get_absolute_time(), NTPStruct->ntp_test_time): %d\r", absolute_time_diff_us(get_absolute_time(), NTPStruct->ntp_test_time));
-      }
+      cyw43_arch_enable_sta_mode();
+      NTPData.WiFiOnSince = time_us_64();
     }
 
-
-#if PICO_CYW43_ARCH_POLL
-    if (DebugBitMask & DEBUG_NTP)
+    NTPStruct->link_full = (ntp_wifi_join() != 0);
+    if (NTPStruct->link_full)
     {
-      sprintf(String, "Proceeding with CYW43 arch poll.\r");
-      uart_send(__LINE__, String);
+      cyw43_arch_lwip_begin();
+      cyw43_arch_wifi_connect_async(&FlashConfig.SSID[4], &FlashConfig.Password[4], CYW43_AUTH_WPA2_AES_PSK);
+      cyw43_arch_lwip_end();
     }
+    NTPStruct->link_time = make_timeout_time_ms(NTPStruct->link_full ? NTP_CONNECT_TIME : NTP_JOIN_TIME);
 
-    /* If using cyw43_arch_poll(), a periodic poll must be done to check for Wi-Fi driver or lwIP work that needs to be done. */
-    cyw43_arch_poll();
-    sleep_ms(1);
-#else
     if (DebugBitMask & DEBUG_NTP)
-      uart_send(__LINE__, "Not using CYW43 arch poll.\r");
-
-    /* if cyw43_arch_poll is not used, then Wi-Fi driver and lwIP work is done via interrupt in the background. 
-       The sleep below is just an example of some (blocking) work you might be doing. */
-    /// sleep_ms(1000);
-#endif
+      uart_send(__LINE__, "Wi-Fi radio powered up, %s.\r", NTPStruct->link_full ? "scanning all channels" : "joining access point last used");
   }
-  else
+
+  /* Forget samples of the previous sync. DNS requests are sent by the first step of the state machine after the link. */
+  cyw43_arch_lwip_begin();
   {
-    if (DebugBitMask & DEBUG_NTP)
-      uart_send(__LINE__, "NTPStruct validation failed.\r");
+    memset(NTPStruct->server, 0, sizeof(NTPStruct->server));
+    NTPStruct->kod_rate         = false;
+    NTPStruct->burst_count      = 0;
+    NTPStruct->dns_pending      = 0;
+    NTPStruct->dns_request_sent = false;
+    NTPData.NTPState            = FlagLink ? NTP_STATE_RESOLVE : NTP_STATE_LINK;
+
+    Wait = absolute_time_diff_us(get_absolute_time(), NTPStruct->ntp_test_time);
+    if (Wait < 0) Wait = 0;
+
+    NTPStruct->worker.do_work = ntp_worker;
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &NTPStruct->worker, (UINT32)(Wait / 1000));
   }
+  cyw43_arch_lwip_end();
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "NTP sync begins in %lld msec.\r", Wait / 1000);
 
   return;
 }
@@ -435,7 +516,10 @@ int ntp_init(void)
   UINT8 Loop1UInt8;
   UINT8 Loop2UInt8;
 
+  UINT64 StartTime;
+
   int ReturnCode;
+  int Status;
   
   
   ReturnCode = 0;  // assume no error on entry.
@@ -446,7 +530,7 @@ int ntp_init(void)
 
   /* Enable Wi-Fi Station mode. */
   cyw43_arch_enable_sta_mode();
-  sleep_ms(250);
+  NTPData.WiFiOnSince = time_us_64();
 
   if (DebugBitMask & DEBUG_NTP)
   {
@@ -462,7 +546,36 @@ int ntp_init(void)
     uart_send(__LINE__, "Password: [%s]\r\r\r", &FlashConfig.Password[4]);
   }
 
-  for (Loop1UInt8 = 0; Loop1UInt8 < 20; ++Loop1UInt8)
+  /* Join the access point last used without scanning all channels and wait for the link (and for DHCP, if no address was saved).
+     If it fails, do a full connection (with retries). */
+  ReturnCode = ntp_wifi_join();
+  if (ReturnCode == 0)
+  {
+    StartTime = time_us_64();
+    while ((Status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA)) != CYW43_LINK_UP)
+    {
+      /* CYW43_LINK_FAIL, CYW43_LINK_NONET or CYW43_LINK_BADAUTH, or time-out: access point moved to another channel or gone. */
+      if ((Status < 0) || ((time_us_64() - StartTime) >= (NTP_JOIN_TIME * 1000ULL)))
+      {
+        if (DebugBitMask & DEBUG_NTP)
+          uart_send(__LINE__, "Access point last used not joined (link status: %d), doing a full connection.\r", Status);
+
+        /* Leave the pending join before the full connection. */
+        cyw43_arch_lwip_begin();
+        cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+        cyw43_arch_lwip_end();
+
+        ReturnCode = 1;
+        break;
+      }
+      sleep_ms(10);
+    }
+
+    if ((ReturnCode == 0) && (DebugBitMask & DEBUG_NTP))
+      uart_send(__LINE__, "Wi-Fi connection succeeded on access point last used (channel %u).\r", FlashConfig.WiFiChannel);
+  }
+
+  for (Loop1UInt8 = 0; (ReturnCode != 0) && (Loop1UInt8 < 20); ++Loop1UInt8)
   {
     if (DebugBitMask & DEBUG_NTP)
     {
@@ -520,6 +633,14 @@ int ntp_init(void)
   }
 
 
+  NTPData.WiFiLinkTime = time_us_64();
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "Wi-Fi link up %llu msec after power-up.\r", NTPData.WiFiLinkTime / 1000);
+
+  ntp_link_save();
+  ntp_lease_save();
+
+
   /* To overcome the inherent bug with output Pico W print in this situation, blink Pico's LED 3 times to indicate success. */
   for (Loop1UInt8 = 0; Loop1UInt8 < 3; ++Loop1UInt8)
   {
@@ -540,6 +661,15 @@ int ntp_init(void)
     if (NTPStruct->ntp_pcb)
     {
       udp_recv(NTPStruct->ntp_pcb, ntp_recv, NTPStruct);
+
+      /* Server addresses used before the reboot, so that the first sync does not need DNS (they are replaced if they do not answer). */
+      for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+      {
+        if ((FlashConfig.NTPServerAddress[Loop1UInt8] == 0) || (FlashConfig.NTPServerAddress[Loop1UInt8] == 0xFFFFFFFF)) continue;
+
+        ip4_addr_set_u32(&NTPStruct->cache[Loop1UInt8].address, FlashConfig.NTPServerAddress[Loop1UInt8]);
+        NTPStruct->cache[Loop1UInt8].expiry = time_us_64() + NTP_DNS_LIFETIME;
+      }
     }
     else
     {
@@ -579,51 +709,65 @@ int ntp_init(void)
 
 
 /* $PAGE */
-/* $TITLE=ntp_recv() */
+/* $TITLE=ntp_lease_save() */
 /* ------------------------------------------------------------------ *\
-                             NTP data received.
+        Save the DHCP lease of the Pico W (address, netmask, gateway,
+         DNS server and end of lease in UTC) to flash, so that it may
+        be used as soon as the link is up on next power-up, or when the
+          radio is powered up again (see ntp_wifi_join()). Flash is
+          written when the address changes, and otherwise when less
+         than half of the lease saved remains, so that renewals do not
+                        write to flash each time.
 \* ------------------------------------------------------------------ */
-static void ntp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+static void ntp_lease_save(void)
 {
-  UCHAR String[256];
-
-  time_t EpochTime;
+  struct dhcp  *Dhcp;
+  struct netif *Netif;
 
+  UINT32 Address[4];
+  UINT32 Lease;
+  UINT32 LeaseEnd;
+  UINT32 Used;
+  UINT32 UtcTime;
 
-  if (DebugBitMask & DEBUG_NTP)
-    uart_send(__LINE__, "Entering ntp_recv()\r");
 
-  NTP_T *NTPStruct = (NTP_T*)arg;
-  uint8_t mode     = pbuf_get_at(p, 0) & 0x7;
-  uint8_t stratum  = pbuf_get_at(p, 1);
+  /* A static IP configuration is not a lease. */
+  if (FlashConfig.WiFiStatic == FLAG_ON) return;
 
+  Netif = &cyw43_state.netif[CYW43_ITF_STA];
+  Lease = 0;
+  Used  = 0;
 
-  /* Check the result. */
-  if (ip_addr_cmp(addr, &NTPStruct->ntp_server_address) && port == NTP_PORT && p->tot_len == NTP_MSG_LEN && mode == 0x4 && stratum != 0)
-  {
-    uint8_t seconds_buf[4] = {0};
-    pbuf_copy_partial(p, seconds_buf, sizeof(seconds_buf), 40);
-    uint32_t seconds_since_1900 = seconds_buf[0] << 24 | seconds_buf[1] << 16 | seconds_buf[2] << 8 | seconds_buf[3];
-    uint32_t seconds_since_1970 = seconds_since_1900 - NTP_DELTA;
-    EpochTime = seconds_since_1970;
-    NTPData.Epoch = EpochTime;
-    if (DebugBitMask & DEBUG_NTP)
+  cyw43_arch_lwip_begin();
+  {
+    Dhcp = netif_dhcp_data(Netif);
+    if (dhcp_supplied_address(Netif))
     {
-      // uart_send(__LINE__, "Seconds since 1900: %lu\r", seconds_since_1900);
-      // uart_send(__LINE__, "Seconds since 1970: %lu\r", seconds_since_1970);
-      // uart_send(__LINE__, "NTP_DELTA:          %lu\r", NTP_DELTA);
+      Address[0] = ip4_addr_get_u32(netif_ip4_addr(Netif));
+      Address[1] = ip4_addr_get_u32(netif_ip4_netmask(Netif));
+      Address[2] = ip4_addr_get_u32(netif_ip4_gw(Netif));
+      Address[3] = ip4_addr_get_u32(ip_2_ip4(dns_getserver(0)));
+      Lease      = Dhcp->offered_t0_lease;
+      Used       = Dhcp->lease_used * DHCP_COARSE_TIMER_SECS;  // time elapsed since the lease has been granted or renewed.
     }
-    
-    ntp_result(NTPStruct, 0, &EpochTime);
   }
-  else
+  cyw43_arch_lwip_end();
+
+  /* No lease yet (DHCP still running), or lease too short to be saved. */
+  if ((Lease < NTP_LEASE_MIN) || (Used >= Lease)) return;
+
+  UtcTime  = (UINT32)(time_base_us() / 1000000ULL);
+  LeaseEnd = UtcTime + (Lease - Used);
+
+  /* A saved end of lease later than the one just computed is wrong (erased bytes, or time base corrected since it was saved). */
+  if (memcmp(Address, FlashConfig.WiFiAddress, sizeof(Address)) || (FlashConfig.WiFiLeaseEnd > LeaseEnd) || (FlashConfig.WiFiLeaseEnd < (UtcTime + (Lease / 2))))
   {
+    memcpy(FlashConfig.WiFiAddress, Address, sizeof(Address));
+    FlashConfig.WiFiLeaseEnd = LeaseEnd;
+
     if (DebugBitMask & DEBUG_NTP)
-      uart_send(__LINE__, "Invalid ntp response\r");
-    ntp_result(NTPStruct, -1, NULL);
+      uart_send(__LINE__, "DHCP lease saved: %s until UTC %lu (%lu sec left).\r", ip4addr_ntoa(netif_ip4_addr(Netif)), LeaseEnd, Lease - Used);
   }
-  
-  pbuf_free(p);
 
   return;
 }
@@ -633,33 +777,72 @@ static void ntp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_ad
 
 
 /* $PAGE */
-/* $TITLE=ntp_request() */
+/* $TITLE=ntp_link_save() */
 /* ------------------------------------------------------------------ *\
-                           Make an NTP request.
+        Save the BSSID and channel of the access point joined, so that
+         the next connection does not need a scan (see ntp_wifi_join()).
+         Flash is written only if they changed (see flash_check_config()
+                         in Pico-Green-Clock.c).
 \* ------------------------------------------------------------------ */
-static void ntp_request(NTP_T *NTPStruct)
+static void ntp_link_save(void)
 {
-  UCHAR String[256];
+  UINT8 Bssid[6];
+  UINT8 Channel[12];
+
 
+  /* The cyw43 channel info begins with the channel in use (hw_channel). */
+  if ((cyw43_wifi_get_bssid(&cyw43_state, Bssid) != 0) || (cyw43_ioctl(&cyw43_state, CYW43_IOCTL_GET_CHANNEL, sizeof(Channel), Channel, CYW43_ITF_STA) != 0)) return;
+  if ((Channel[0] < 1) || (Channel[0] > 14)) return;
+
+  memcpy(FlashConfig.WiFiBssid, Bssid, sizeof(Bssid));
+  FlashConfig.WiFiChannel = Channel[0];
 
   if (DebugBitMask & DEBUG_NTP)
-    uart_send(__LINE__, "Entering ntp_request()\r");
+    uart_send(__LINE__, "Access point: %2.2X:%2.2X:%2.2X:%2.2X:%2.2X:%2.2X   Channel: %u\r", Bssid[0], Bssid[1], Bssid[2], Bssid[3], Bssid[4], Bssid[5], Channel[0]);
 
+  return;
+}
 
-  // cyw43_arch_lwip_begin/end should be used around calls into lwIP to ensure correct locking.
-  // You can omit them if you are in a callback from lwIP. Note that when using pico_cyw_arch_poll
-  // these calls are a no-op and can be omitted, but it is a good practice to use them in
-  // case you switch the cyw43_arch type later.
-  cyw43_arch_lwip_begin();
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_poll_failed() */
+/* ------------------------------------------------------------------ *\
+       Set the retry interval after a failed NTP sync: it doubles on
+       each consecutive failure, from NTP_POLL_MIN up to NTP_RETRY_MAX,
+        with a random jitter of +/- 1/8 so that clocks that failed
+        together (network or pool outage) do not retry together.
+       A RATE kiss-o'-death received during the failed sync lengthens
+         the poll interval as after a success, and the retry does not
+                      come sooner than this interval.
+\* ------------------------------------------------------------------ */
+void ntp_poll_failed(void)
+{
+  UINT8 Exponent;
+
+  UINT64 Delta;
+
+
+  if (NTPData.NTPFailures < 0xFF) ++NTPData.NTPFailures;
+
+  Exponent = NTP_POLL_MIN + NTPData.NTPFailures - 1;
+  if ((NTPData.NTPFailures > (NTP_RETRY_MAX - NTP_POLL_MIN)) || (Exponent > NTP_RETRY_MAX)) Exponent = NTP_RETRY_MAX;
+
+  /* Servers asked to slow down: ntp_get_time() forgets it on next sync, so honour it now. */
+  if ((NTPStruct != NULL) && (NTPStruct->kod_rate))
   {
-    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, NTP_MSG_LEN, PBUF_RAM);
-    uint8_t *req = (uint8_t *) p->payload;
-    memset(req, 0, NTP_MSG_LEN);
-    req[0] = 0x1b;
-    udp_sendto(NTPStruct->ntp_pcb, p, &NTPStruct->ntp_server_address, NTP_PORT);
-    pbuf_free(p);
+    NTPData.NTPPoll = ((NTPData.NTPPoll + 2) > NTP_POLL_MAX) ? NTP_POLL_MAX : (NTPData.NTPPoll + 2);
+    NTPStruct->kod_rate = false;
+    if (Exponent < NTPData.NTPPoll) Exponent = NTPData.NTPPoll;
   }
-  cyw43_arch_lwip_end();
+
+  Delta = (1ULL << Exponent) * 1000000ULL;
+  NTPData.NTPDelta = Delta - (Delta / 8) + ((UINT64)rand() % (Delta / 4));
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "NTP sync failure %u, retry in %llu sec.\r", NTPData.NTPFailures, NTPData.NTPDelta / 1000000ULL);
 
   return;
 }
@@ -669,33 +852,41 @@ static void ntp_request(NTP_T *NTPStruct)
 
 
 /* $PAGE */
-/* $TITLE=ntp_result() */
+/* $TITLE=ntp_poll_update() */
 /* ------------------------------------------------------------------ *\
-                    Called with results of operation.
+       Adapt the poll interval after a successful NTP sync, from the
+       phase error (in usec) it has corrected. While the phase error
+       stays small, the clock keeps time by itself and the interval
+       is doubled (up to NTP_POLL_MAX). A larger one halves it, and a
+        step restarts it from NTP_POLL_MIN, so that the next sync
+        comes soon. A RATE kiss-o'-death lengthens it further.
 \* ------------------------------------------------------------------ */
-static void ntp_result(NTP_T* NTPStruct, int status, time_t *EpochTime)
+void ntp_poll_update(int64_t Phase)
 {
-  UCHAR String[256];
+  int64_t Magnitude;
 
 
-  if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "Entering ntp_result()\r");
+  NTPData.NTPFailures = 0;
 
-  if (status == 0 && EpochTime)
-  {
-    if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "Going to convert Epoch\r");
-    epoch_time_to_utc_time(EpochTime);
-  }
+  Magnitude = (Phase < 0) ? -Phase : Phase;
 
-  if (NTPStruct->ntp_resend_alarm > 0)
+  if (Magnitude > NTP_POLL_STEP)
+    NTPData.NTPPoll = NTP_POLL_MIN;
+  else if ((Magnitude > NTP_POLL_UNSTABLE) && (NTPData.NTPPoll > NTP_POLL_MIN))
+    --NTPData.NTPPoll;
+  else if ((Magnitude < NTP_POLL_STABLE) && (NTPData.NTPPoll < NTP_POLL_MAX))
+    ++NTPData.NTPPoll;
+
+  if ((NTPStruct != NULL) && (NTPStruct->kod_rate))
   {
-    if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "Cancelling alarm\r");
-    cancel_alarm(NTPStruct->ntp_resend_alarm);
-    NTPStruct->ntp_resend_alarm = 0;
+    NTPData.NTPPoll = ((NTPData.NTPPoll + 2) > NTP_POLL_MAX) ? NTP_POLL_MAX : (NTPData.NTPPoll + 2);
+    NTPStruct->kod_rate = false;
   }
 
-  if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "Resetting dns_request_sent\r");
-  NTPStruct->ntp_test_time    = make_timeout_time_ms(NTP_TEST_TIME);
-  NTPStruct->dns_request_sent = false;
+  NTPData.NTPDelta = (1ULL << NTPData.NTPPoll) * 1000000ULL;
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "NTP phase error: %lld usec   Next sync in %llu sec.\r", Phase, NTPData.NTPDelta / 1000000ULL);
 
   return;
 }
@@ -705,62 +896,947 @@ static void ntp_result(NTP_T* NTPStruct, int status, time_t *EpochTime)
 
 
 /* $PAGE */
-/* $TITLE=epoch_time_to_utc_time() */
+/* $TITLE=ntp_radio_sleep() */
 /* ------------------------------------------------------------------ *\
-          Convert epoch time received from NTP to local time.
+       Power down the Wi-Fi radio once the result of a sync has been
+       applied, if the next sync is at least NTP_RADIO_SLEEP away. The
+       access point is left and station mode is disabled, so that the
+       CYW43 no longer listens to the access point and lwIP no longer
+       handles network traffic in the background. The next sync brings
+           the link up again first (see ntp_get_time()).
 \* ------------------------------------------------------------------ */
-void epoch_time_to_utc_time(time_t *EpochTime)
+void ntp_radio_sleep(void)
 {
-  UCHAR String[256];
+  UINT64 OnTime;
+
+
+  /* Radio already powered down, next sync too close to be worth a new connection, or LAN clients served (see ntp_serve_start()). */
+  if ((NTPStruct == NULL) || (NTPData.WiFiOnSince == 0) || (NTPData.NTPDelta < (NTP_RADIO_SLEEP * 1000000ULL)) || (NTPStruct->serve_pcb != NULL)) return;
 
-  struct tm *UtcTime;
+  /* Save the lease while it is known. The access point is left before the interface goes down, so that the DHCP release sent
+     by lwIP does not reach the server and the lease may be used again as soon as the link is up (see ntp_wifi_join()). */
+  ntp_lease_save();
 
+  cyw43_arch_lwip_begin();
+  cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+  cyw43_arch_lwip_end();
+  cyw43_arch_disable_sta_mode();
+
+  OnTime               = time_us_64() - NTPData.WiFiOnSince;
+  NTPData.WiFiOnTime  += OnTime;
+  NTPData.WiFiOnSince  = 0;
 
   if (DebugBitMask & DEBUG_NTP)
-    uart_send(__LINE__, "Entering epoch_time_to_utc_time(): %lu\r", *EpochTime);
+    uart_send(__LINE__, "Wi-Fi radio powered down for %llu sec (it was on for %llu msec, %llu sec in all since power-up).\r", NTPData.NTPDelta / 1000000ULL, OnTime / 1000, NTPData.WiFiOnTime / 1000000ULL);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_recv() */
+/* ------------------------------------------------------------------ *\
+       NTP data received. The answer is checked and its offset and
+       round-trip delay are computed by ntp_packet_sample(), from the
+        four timestamps of the SNTP exchange (T1 and T4 from the Pico
+       timer, T2 and T3 from the server). The sample is kept for
+         ntp_select(), answers that are not valid are ignored.
+\* ------------------------------------------------------------------ */
+static void ntp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+  UINT8 Loop1UInt8;
+  UINT8 Packet[NTP_MSG_LEN];
+  UINT8 Result;
+
+  UINT64 T4;
+
+  NTP_SAMPLE_T *Sample;
+  NTP_SERVER_T *Server;
+
+  struct ntp_packet_sample Answer;
+
+
+  /* Read the Pico timer first, so that processing time is not part of the round-trip delay. */
+  T4 = time_us_64();
 
-  /* Adjust Epoch for local timezone, so that we will convert "Epoch local time" to "Current local time". */
-  *EpochTime += (FlashConfig.Timezone * 60 * 60);  // Flash.TimeZone is given in hour.
-  UtcTime = gmtime(EpochTime);
   if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "Entering ntp_recv()\r");
+
+  NTP_T *NTPStruct = (NTP_T*)arg;
+
+
+  /* Find the server that sent this answer and that is waiting for one. */
+  Server = NULL;
+  for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
   {
-    uart_send(__LINE__, "EpochTime adjusted for local time: %lu\r", *EpochTime);
-    uart_send(__LINE__, "Date: %2d/%2.2d/%4.4d   %2d:%2.2d:%2.2d\r", UtcTime->tm_mday, UtcTime->tm_mon + 1, UtcTime->tm_year + 1900, UtcTime->tm_hour, UtcTime->tm_min, UtcTime->tm_sec);
+    if ((NTPStruct->server[Loop1UInt8].resolved) && (NTPStruct->server[Loop1UInt8].send_time != 0) && ip_addr_cmp(addr, &NTPStruct->server[Loop1UInt8].address))
+    {
+      Server = &NTPStruct->server[Loop1UInt8];
+      break;
+    }
   }
-  
-
-  NTPData.CurrentDayOfMonth = UtcTime->tm_mday;
-  NTPData.CurrentMonth      = UtcTime->tm_mon + 1;	     // 0 -> 11 converted to 1 -> 12
-  NTPData.CurrentYear       = UtcTime->tm_year + 1900;
-  NTPData.CurrentHour       = UtcTime->tm_hour;
-  NTPData.CurrentMinute     = UtcTime->tm_min;
-  NTPData.CurrentSecond     = UtcTime->tm_sec++;        // compensate for time elapsed between NTP request and real-time IC complete setup.
 
-  NTPData.NTPGetTime        = time_us_64();
+  /* Check the result. */
+  Result = NTP_PACKET_INVALID;
+  if ((Server != NULL) && (port == NTP_PORT) && (p->tot_len == NTP_MSG_LEN) && (pbuf_copy_partial(p, Packet, NTP_MSG_LEN, 0) == NTP_MSG_LEN))
+    Result = ntp_packet_sample(Packet, Server->send_time, T4, &Answer);
 
-  /* If seconds is near a minute change, postpone the update to prevent the need for an atomic operation requiring a critical section
-     that doesn't goes along well with our millisecond callback. */
-  if (NTPData.CurrentSecond > 57)
+  if (Result == NTP_PACKET_KOD)
   {
-    if (DebugBitMask & DEBUG_NTP)
+    /* Kiss-o'-death, accepted only as an answer to our request. No more requests to this server during this sync. */
+    Server->send_time = 0;
+    Server->kod       = true;
+
+    if (memcmp(&Packet[NTP_OFFSET_REFERENCE], "RATE", 4) == 0)
+    {
+      NTPStruct->kod_rate = true;  // poll interval will be lengthened (see ntp_poll_update() and ntp_poll_failed()).
+    }
+    else if ((memcmp(&Packet[NTP_OFFSET_REFERENCE], "DENY", 4) == 0) || (memcmp(&Packet[NTP_OFFSET_REFERENCE], "RSTR", 4) == 0))
     {
-      uart_send(__LINE__, "NTP time seconds are closed to minute change (%2u).\r", NTPData.CurrentSecond);
-      uart_send(__LINE__, "Postpone the update to prevent the need for a critical section.\r");
+      NTPStruct->denied[NTPStruct->denied_next] = *addr;
+      NTPStruct->denied_next = (NTPStruct->denied_next + 1) % NTP_MAX_DENIED;
+      NTPStruct->cache[Server - NTPStruct->server].expiry = 0;  // another server will be taken from the pool on next sync.
     }
 
-    return;  // main program will make a retry in a few minutes.
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "Kiss-o'-death from %s: %c%c%c%c\r", ip4addr_ntoa(addr), Packet[NTP_OFFSET_REFERENCE], Packet[NTP_OFFSET_REFERENCE + 1], Packet[NTP_OFFSET_REFERENCE + 2], Packet[NTP_OFFSET_REFERENCE + 3]);
+  }
+  else if (Result == NTP_PACKET_SAMPLE)
+  {
+    Server->send_time = 0;  // a duplicated answer will not be accepted.
+
+    if (Server->sample_count < NTP_BURST)
+    {
+      Sample = &Server->sample[Server->sample_count++];
+
+      Sample->offset        = Answer.Offset;
+      Sample->delay         = Answer.Delay;
+      Sample->root_distance = (Answer.RootDelay / 2) + Answer.RootDispersion;
+      Sample->root_delay    = Answer.RootDelay;
+      Sample->stratum       = Answer.Stratum;
+
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "NTP sample from %s: offset: %lld usec   Round-trip delay: %lld usec   Root distance: %lld usec\r", ip4addr_ntoa(addr), Sample->offset, Sample->delay, Sample->root_distance);
+    }
+  }
+  else
+  {
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "Invalid ntp response\r");
   }
+  
+  pbuf_free(p);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_request() */
+/* ------------------------------------------------------------------ *\
+                   Make an NTP request to one server.
+\* ------------------------------------------------------------------ */
+static void ntp_request(NTP_T *NTPStruct, NTP_SERVER_T *Server)
+{
+  UINT8 Loop1UInt8;
+
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "Entering ntp_request()\r");
+
+
+  // cyw43_arch_lwip_begin/end should be used around calls into lwIP to ensure correct locking.
+  // You can omit them if you are in a callback from lwIP. Note that when using pico_cyw_arch_poll
+  // these calls are a no-op and can be omitted, but it is a good practice to use them in
+  // case you switch the cyw43_arch type later.
+  cyw43_arch_lwip_begin();
+  {
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, NTP_MSG_LEN, PBUF_RAM);
+    uint8_t *req = (uint8_t *) p->payload;
+    memset(req, 0, NTP_MSG_LEN);
+    req[0] = 0x1b;
+
+    /* Pico timer value when the request is sent (T1). It is also sent as transmit timestamp: the server returns it
+       as originate timestamp, so that ntp_recv() can make sure the answer is for this request. */
+    Server->send_time = time_us_64();
+    for (Loop1UInt8 = 0; Loop1UInt8 < 8; ++Loop1UInt8)
+      req[NTP_OFFSET_TRANSMIT + Loop1UInt8] = (Server->send_time >> (56 - (Loop1UInt8 * 8))) & 0xFF;
+
+    udp_sendto(NTPStruct->ntp_pcb, p, &Server->address, NTP_PORT);
+    pbuf_free(p);
+  }
+  cyw43_arch_lwip_end();
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_result() */
+/* ------------------------------------------------------------------ *\
+       Called with the result of a sync. Post it to the main loop,
+       where it is applied (see ntp_update() in Pico-Green-Clock.c).
+\* ------------------------------------------------------------------ */
+static void ntp_result(NTP_T* NTPStruct, int status, time_t *EpochTime)
+{
+  if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "Entering ntp_result()\r");
+
+  if (status == 0 && EpochTime)
+  {
+    if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "Going to convert Epoch\r");
+    epoch_time_to_utc_time(EpochTime);
+  }
+
+  if (DebugBitMask & DEBUG_NTP) uart_send(__LINE__, "Resetting dns_request_sent\r");
+  NTPStruct->ntp_test_time    = make_timeout_time_ms(NTP_TEST_TIME);
+  NTPStruct->dns_request_sent = false;
+
+  /* Main loop sets the state back to NTP_STATE_IDLE once the result has been applied. */
+  NTPData.NTPState = NTP_STATE_APPLY;
+  command_queue(COMMAND_NTP_UPDATE, ((status == 0) && EpochTime) ? FLAG_ON : FLAG_OFF);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_select() */
+/* ------------------------------------------------------------------ *\
+        Select the best samples of all servers at the end of a sync
+                   and compute the offset to apply:
+       - Clock filter: for each server, the sample with the minimum
+         round-trip delay is kept, since it is the one least disturbed
+         by network queuing. Its root distance (maximum error) is half
+         of its delay, plus server root delay / 2 and root dispersion,
+         plus the jitter of the other samples of the burst.
+       - Intersection (Marzullo): find the interval of time shared by
+         the largest number of [offset - distance, offset + distance]
+         intervals. Servers whose interval does not contain it are
+         falsetickers and are rejected. There must be a majority of
+                     truechimers to apply an offset.
+       - Combine: average the offsets of the truechimers, each one
+                 weighted by the inverse of its root distance.
+\* ------------------------------------------------------------------ */
+static void ntp_select(NTP_T *NTPStruct)
+{
+  UINT8 Best;
+  UINT8 Count;
+  UINT8 Depth;
+  UINT8 EndpointType[NTP_MAX_SERVERS * 2];
+  UINT8 Loop1UInt8;
+  UINT8 Loop2UInt8;
+  UINT8 MaxDepth;
+  UINT8 Peer[NTP_MAX_SERVERS];
+  UINT8 TempType;
+  UINT8 TrueCount;
+
+  int64_t Delay;
+  int64_t Distance[NTP_MAX_SERVERS];
+  int64_t Endpoint[NTP_MAX_SERVERS * 2];
+  int64_t Jitter;
+  int64_t Low;
+  int64_t High;
+  int64_t Middle;
+  int64_t Offset[NTP_MAX_SERVERS];
+  int64_t Sum;
+  int64_t Temp;
+  int64_t Weight;
+  int64_t WeightSum;
+
+  time_t EpochTime;
+
+  NTP_SERVER_T *Server;
+
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "Entering ntp_select()\r");
+
+  /* Clock filter: keep the minimum-delay sample of each server that answered. */
+  Count = 0;
+  for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+  {
+    Server = &NTPStruct->server[Loop1UInt8];
+    if (Server->sample_count == 0) continue;
+
+    Best = 0;
+    for (Loop2UInt8 = 1; Loop2UInt8 < Server->sample_count; ++Loop2UInt8)
+      if (Server->sample[Loop2UInt8].delay < Server->sample[Best].delay) Best = Loop2UInt8;
+
+    /* Jitter: largest difference between the offset of the best sample and the others. */
+    Jitter = 0;
+    for (Loop2UInt8 = 0; Loop2UInt8 < Server->sample_count; ++Loop2UInt8)
+    {
+      Temp = Server->sample[Loop2UInt8].offset - Server->sample[Best].offset;
+      if (Temp < 0) Temp = -Temp;
+      if (Temp > Jitter) Jitter = Temp;
+    }
+
+    Peer[Count]     = Loop1UInt8;
+    Offset[Count]   = Server->sample[Best].offset;
+    Distance[Count] = (Server->sample[Best].delay / 2) + Server->sample[Best].root_distance + Jitter + NTP_MIN_DISTANCE;
+
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "Server %s: %u samples   Offset: %lld usec   Delay: %lld usec   Distance: %lld usec\r", ip4addr_ntoa(&Server->address), Server->sample_count, Offset[Count], Server->sample[Best].delay, Distance[Count]);
+
+    ++Count;
+  }
+
+  if (Count == 0)
+  {
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "No NTP server answered.\r");
+    ntp_result(NTPStruct, -1, NULL);
+    return;
+  }
+
+
+  /* Intersection: sort the interval endpoints (lower endpoints first when equal), then find the deepest overlap. */
+  for (Loop1UInt8 = 0; Loop1UInt8 < Count; ++Loop1UInt8)
+  {
+    Endpoint[Loop1UInt8 * 2]         = Offset[Loop1UInt8] - Distance[Loop1UInt8];
+    EndpointType[Loop1UInt8 * 2]     = 0;  // lower endpoint.
+    Endpoint[Loop1UInt8 * 2 + 1]     = Offset[Loop1UInt8] + Distance[Loop1UInt8];
+    EndpointType[Loop1UInt8 * 2 + 1] = 1;  // upper endpoint.
+  }
+
+  for (Loop1UInt8 = 1; Loop1UInt8 < (Count * 2); ++Loop1UInt8)
+  {
+    for (Loop2UInt8 = Loop1UInt8; (Loop2UInt8 > 0) && ((Endpoint[Loop2UInt8 - 1] > Endpoint[Loop2UInt8]) || ((Endpoint[Loop2UInt8 - 1] == Endpoint[Loop2UInt8]) && (EndpointType[Loop2UInt8 - 1] > EndpointType[Loop2UInt8]))); --Loop2UInt8)
+    {
+      Temp                          = Endpoint[Loop2UInt8];
+      Endpoint[Loop2UInt8]          = Endpoint[Loop2UInt8 - 1];
+      Endpoint[Loop2UInt8 - 1]      = Temp;
+      TempType                      = EndpointType[Loop2UInt8];
+      EndpointType[Loop2UInt8]      = EndpointType[Loop2UInt8 - 1];
+      EndpointType[Loop2UInt8 - 1]  = TempType;
+    }
+  }
+
+  Depth    = 0;
+  MaxDepth = 0;
+  Low      = 0;
+  High     = 0;
+  for (Loop1UInt8 = 0; Loop1UInt8 < (Count * 2); ++Loop1UInt8)
+  {
+    if (EndpointType[Loop1UInt8] == 0)
+    {
+      ++Depth;
+      if (Depth > MaxDepth)
+      {
+        MaxDepth = Depth;
+        Low      = Endpoint[Loop1UInt8];
+        High     = Endpoint[Loop1UInt8 + 1];  // an upper endpoint always follows the last lower endpoint.
+      }
+    }
+    else
+    {
+      --Depth;
+    }
+  }
+
+  if ((MaxDepth * 2) <= Count)
+  {
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "No majority of NTP servers agree (%u out of %u), offset is not applied.\r", MaxDepth, Count);
+    ntp_result(NTPStruct, -1, NULL);
+    return;
+  }
+
+
+  /* Combine the truechimers (intervals containing the intersection). Weights are relative to the first truechimer to keep precision. */
+  Middle    = Low + ((High - Low) / 2);
+  TrueCount = 0;
+  Delay     = 0;
+  Sum       = 0;
+  WeightSum = 0;
+  Temp      = 0;
+  for (Loop1UInt8 = 0; Loop1UInt8 < Count; ++Loop1UInt8)
+  {
+    if (((Offset[Loop1UInt8] - Distance[Loop1UInt8]) > Middle) || ((Offset[Loop1UInt8] + Distance[Loop1UInt8]) < Middle))
+    {
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "Server %s is a falseticker (offset: %lld usec).\r", ip4addr_ntoa(&NTPStruct->server[Peer[Loop1UInt8]].address), Offset[Loop1UInt8]);
+      NTPStruct->cache[Peer[Loop1UInt8]].expiry = 0;  // another server will be taken from the pool on next sync.
+      continue;
+    }
+
+    if (TrueCount == 0)
+    {
+      Temp  = Offset[Loop1UInt8];  // reference offset.
+      Best  = Loop1UInt8;
+    }
+    else if (Distance[Loop1UInt8] < Distance[Best])
+    {
+      Best = Loop1UInt8;
+    }
+
+    NTPStruct->cache[Peer[Loop1UInt8]].chimer = true;  // address answered and agreed with the majority, worth saving.
+
+    Weight     = 1000000000LL / Distance[Loop1UInt8];
+    Sum       += Weight * (Offset[Loop1UInt8] - Temp);
+    WeightSum += Weight;
+    ++TrueCount;
+  }
+
+  NTPData.NTPOffset    = Temp + (Sum / WeightSum);
+  NTPData.NTPGetTime   = time_us_64();
+  Server               = &NTPStruct->server[Peer[Best]];
+  for (Loop1UInt8 = 1, Loop2UInt8 = 0; Loop1UInt8 < Server->sample_count; ++Loop1UInt8)
+    if (Server->sample[Loop1UInt8].delay < Server->sample[Loop2UInt8].delay) Loop2UInt8 = Loop1UInt8;
+  Delay                = Server->sample[Loop2UInt8].delay;
+  NTPData.NTPRoundTrip = Delay;
+
+  /* The truechimer with the smallest root distance is the system peer given to LAN clients (see ntp_serve()). */
+  NTPStruct->peer_address    = Server->address;
+  NTPStruct->peer_stratum    = Server->sample[Loop2UInt8].stratum;
+  NTPStruct->peer_root_delay = Server->sample[Loop2UInt8].root_delay + Delay;
+  NTPStruct->peer_root_disp  = Distance[Best] - (NTPStruct->peer_root_delay / 2);
+  NTPStruct->peer_time       = NTPData.NTPGetTime;
+
+  /* UTC time (in seconds) when the offset has been computed. */
+  EpochTime     = ((int64_t)NTPData.NTPGetTime + NTPData.NTPOffset) / 1000000LL;
+  NTPData.Epoch = EpochTime;
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "NTP offset: %lld usec from %u truechimers out of %u servers   Round-trip delay: %lld usec\r", NTPData.NTPOffset, TrueCount, Count, NTPData.NTPRoundTrip);
+
+  ntp_result(NTPStruct, 0, &EpochTime);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_serve() */
+/* ------------------------------------------------------------------ *\
+       Answer an NTP request (mode 3) from a LAN client (RFC 5905).
+       The receive timestamp (T2) is read from the time base first
+       thing in this lwIP callback, and the transmit timestamp (T3)
+       just before the answer is sent, so that the time spent by the
+        server is known to the client and left out of its delay.
+       The answer is built by ntp_packet_serve() from the system peer
+       of the last sync (see ntp_select()). During holdover (upstream
+       servers not reachable), the time base keeps its frequency
+       correction and is held within one second of the DS3231 (see
+       time_base_check_rtc()), while the root dispersion given to
+                     clients grows by NTP_SERVE_PHI.
+\* ------------------------------------------------------------------ */
+static void ntp_serve(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+  UINT8 Packet[NTP_MSG_LEN];
+
+  UINT16 Length;
+
+  UINT64 ReceiveTime;
+
+  struct ntp_packet_peer Peer;
+
+  struct pbuf *Answer;
+
+  NTP_T *NTPStruct = (NTP_T*)arg;
+
+
+  /* Read the time base first, so that processing time is left out of the receive timestamp (T2). */
+  ReceiveTime = time_base_us();
+
+  Length = (p->tot_len < NTP_MSG_LEN) ? 0 : pbuf_copy_partial(p, Packet, NTP_MSG_LEN, 0);
+  pbuf_free(p);
+
+  Peer.FlagSynced     = (NTPStruct->peer_time != 0);
+  Peer.Elapsed        = (NTPStruct->peer_time == 0) ? 0 : (int64_t)(time_us_64() - NTPStruct->peer_time);
+  Peer.RootDelay      = NTPStruct->peer_root_delay;
+  Peer.RootDispersion = NTPStruct->peer_root_disp;
+  Peer.Stratum        = NTPStruct->peer_stratum;
+  memcpy(Peer.Address, &ip_2_ip4(&NTPStruct->peer_address)->addr, 4);  // IPv4 address, in network byte order.
+
+  /* Only client requests with a full NTP header are answered (a short or other-mode packet is dropped silently). */
+  if (ntp_packet_serve(Packet, Length, ReceiveTime, &Peer) == 0) return;
+
+  Answer = pbuf_alloc(PBUF_TRANSPORT, NTP_MSG_LEN, PBUF_RAM);
+  if (Answer == NULL) return;
+
+  /* Transmit timestamp (T3) last, as close as possible to the time the answer leaves. */
+  ntp_packet_put_timestamp(Packet, NTP_OFFSET_TRANSMIT, time_base_us());
+  pbuf_take(Answer, Packet, NTP_MSG_LEN);
+  udp_sendto(pcb, Answer, addr, port);
+  pbuf_free(Answer);
+
+  ++NTPStruct->serve_count;
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_serve_start() */
+/* ------------------------------------------------------------------ *\
+        Start the LAN NTP server (see option LAN_NTP_SERVER in
+       Pico-Green-Clock.c): requests to port NTP_PORT are answered by
+         ntp_serve(). The Wi-Fi radio then stays on between syncs
+                        (see ntp_radio_sleep()).
+\* ------------------------------------------------------------------ */
+int ntp_serve_start(void)
+{
+  int ReturnCode;
+
+
+  /* Wi-Fi connection or NTP initialization failed. */
+  if (NTPStruct == NULL) return ERR_NTP_ALLOC;
+
+  ReturnCode = 0;
+
+  cyw43_arch_lwip_begin();
+  {
+    NTPStruct->serve_pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+    if (NTPStruct->serve_pcb == NULL)
+    {
+      ReturnCode = ERR_NTP_PCB;
+    }
+    else if (udp_bind(NTPStruct->serve_pcb, IP_ANY_TYPE, NTP_PORT) != ERR_OK)
+    {
+      udp_remove(NTPStruct->serve_pcb);
+      NTPStruct->serve_pcb = NULL;
+      ReturnCode = ERR_NTP_PCB;
+    }
+    else
+    {
+      udp_recv(NTPStruct->serve_pcb, ntp_serve, NTPStruct);
+    }
+  }
+  cyw43_arch_lwip_end();
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "LAN NTP server %s on port %u.\r", (ReturnCode == 0) ? "started" : "could not be started", NTP_PORT);
+
+  return ReturnCode;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_server_add() */
+/* ------------------------------------------------------------------ *\
+       Add the address of pool name "Name" (from DNS or from the DNS
+       cache) to the servers sampled during current sync, unless it
+       denied access before or is already sampled under another name.
+\* ------------------------------------------------------------------ */
+static void ntp_server_add(const char *Name, const ip_addr_t *Address, NTP_SERVER_T *Server)
+{
+  UINT8 Loop1UInt8;
+
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_DENIED; ++Loop1UInt8)
+  {
+    if (ip_addr_cmp(Address, &NTPStruct->denied[Loop1UInt8]))
+    {
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "NTP server %s denied access before, not used (%s).\r", Name, ip4addr_ntoa(Address));
+      return;
+    }
+  }
+
+  /* Pool names may give the same server twice, it must be counted only once. */
+  for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+  {
+    if ((NTPStruct->server[Loop1UInt8].resolved) && ip_addr_cmp(Address, &NTPStruct->server[Loop1UInt8].address))
+    {
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "NTP server %s already sampled (%s).\r", Name, ip4addr_ntoa(Address));
+      return;
+    }
+  }
+
+  Server->address  = *Address;
+  Server->resolved = true;
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "NTP server address: %s (%s)\r", ip4addr_ntoa(Address), Name);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_server_save() */
+/* ------------------------------------------------------------------ *\
+        Save the addresses of the truechimers of the last sync (see
+       ntp_select()) to flash, so that the first sync after a reboot
+       does not need DNS. Called from the main loop once the result
+       has been applied, so that FlashConfig is not changed from lwIP
+        context while flash_check_config() compares it. Flash is only
+        written when an address changed, not on each DNS lookup.
+\* ------------------------------------------------------------------ */
+void ntp_server_save(void)
+{
+  UINT8 Loop1UInt8;
+
+  UINT32 Address[NTP_MAX_SERVERS];
+
+
+  if (NTPStruct == NULL) return;
+
+  cyw43_arch_lwip_begin();
+  {
+    for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+    {
+      Address[Loop1UInt8] = FlashConfig.NTPServerAddress[Loop1UInt8];
+      if (NTPStruct->cache[Loop1UInt8].chimer) Address[Loop1UInt8] = ip4_addr_get_u32(&NTPStruct->cache[Loop1UInt8].address);
+      NTPStruct->cache[Loop1UInt8].chimer = false;
+    }
+  }
+  cyw43_arch_lwip_end();
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+  {
+    if (Address[Loop1UInt8] == FlashConfig.NTPServerAddress[Loop1UInt8]) continue;
+
+    FlashConfig.NTPServerAddress[Loop1UInt8] = Address[Loop1UInt8];
+    if (DebugBitMask & DEBUG_NTP)
+      uart_send(__LINE__, "NTP server address %u saved: %lu.%lu.%lu.%lu\r", Loop1UInt8, Address[Loop1UInt8] & 0xFF, (Address[Loop1UInt8] >> 8) & 0xFF, (Address[Loop1UInt8] >> 16) & 0xFF, Address[Loop1UInt8] >> 24);
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_static_ip() */
+/* ------------------------------------------------------------------ *\
+        Save a static IP configuration (dotted strings, see option
+        STATIC_IP_ADDRESS in Pico-Green-Clock.c) to flash. It is used
+         instead of DHCP when connecting to Wi-Fi (see ntp_wifi_join()).
+        An invalid configuration is ignored and DHCP is used instead.
+\* ------------------------------------------------------------------ */
+void ntp_static_ip(const char *Address, const char *Netmask, const char *Gateway, const char *Dns)
+{
+  UINT8 Loop1UInt8;
+
+  ip4_addr_t IpAddress[4];
+
+  const char *Text[4];
+
+
+  Text[0] = Address;
+  Text[1] = Netmask;
+  Text[2] = Gateway;
+  Text[3] = Dns;
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < 4; ++Loop1UInt8)
+  {
+    if (ip4addr_aton(Text[Loop1UInt8], &IpAddress[Loop1UInt8]) == 0)
+    {
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "Invalid static IP configuration [%s], using DHCP.\r", Text[Loop1UInt8]);
+
+      FlashConfig.WiFiStatic   = FLAG_OFF;
+      FlashConfig.WiFiLeaseEnd = 0;
+
+      return;
+    }
+  }
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < 4; ++Loop1UInt8)
+    FlashConfig.WiFiAddress[Loop1UInt8] = ip4_addr_get_u32(&IpAddress[Loop1UInt8]);
+  FlashConfig.WiFiStatic   = FLAG_ON;
+  FlashConfig.WiFiLeaseEnd = 0;
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_wifi_join() */
+/* ------------------------------------------------------------------ *\
+        Apply the IP configuration saved in flash (static, or DHCP
+        lease still valid) so that the address may be used as soon as
+        the link is up, then begin to join the access point last used
+           on its BSSID and channel, without scanning all channels.
+        Return 0 when the join has begun (the caller waits for the
+        link), non-zero if a full connection must be done instead.
+\* ------------------------------------------------------------------ */
+static int ntp_wifi_join(void)
+{
+  ip4_addr_t Address;
+  ip4_addr_t Gateway;
+  ip4_addr_t Netmask;
+  ip_addr_t  Dns;
+
+  struct netif *Netif;
+
+  UINT64 UtcTime;
+
+  int Status;
+
+
+  Netif   = &cyw43_state.netif[CYW43_ITF_STA];
+  UtcTime = time_base_us() / 1000000ULL;
+
+  cyw43_arch_lwip_begin();
+  {
+    /* With a saved lease, DHCP keeps running: it confirms or replaces the address in the background. A static configuration stops it. */
+    if ((FlashConfig.WiFiAddress[0] != 0) && (FlashConfig.WiFiAddress[0] != 0xFFFFFFFF) &&
+        ((FlashConfig.WiFiStatic == FLAG_ON) || ((FlashConfig.WiFiLeaseEnd != 0xFFFFFFFF) && ((UtcTime + NTP_LEASE_MARGIN) < FlashConfig.WiFiLeaseEnd))))
+    {
+      if (FlashConfig.WiFiStatic == FLAG_ON) dhcp_stop(Netif);
+
+      ip4_addr_set_u32(&Address, FlashConfig.WiFiAddress[0]);
+      ip4_addr_set_u32(&Netmask, FlashConfig.WiFiAddress[1]);
+      ip4_addr_set_u32(&Gateway, FlashConfig.WiFiAddress[2]);
+      ip_addr_set_ip4_u32(&Dns,  FlashConfig.WiFiAddress[3]);
+      netif_set_addr(Netif, &Address, &Netmask, &Gateway);
+      dns_setserver(0, &Dns);
+
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "Using %s IP address %s.\r", (FlashConfig.WiFiStatic == FLAG_ON) ? "static" : "saved", ip4addr_ntoa(&Address));
+    }
+  }
+  cyw43_arch_lwip_end();
+
+  /* No access point saved yet (or erased bytes): a full connection is needed. */
+  if ((FlashConfig.WiFiChannel < 1) || (FlashConfig.WiFiChannel > 14)) return 1;
+
+  cyw43_arch_lwip_begin();
+  Status = cyw43_wifi_join(&cyw43_state, strlen(&FlashConfig.SSID[4]), &FlashConfig.SSID[4], strlen(&FlashConfig.Password[4]), &FlashConfig.Password[4],
+                           CYW43_AUTH_WPA2_AES_PSK, FlashConfig.WiFiBssid, FlashConfig.WiFiChannel);
+  cyw43_arch_lwip_end();
+
+  return Status;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=ntp_worker() */
+/* ------------------------------------------------------------------ *\
+       Perform the next step of a sync in progress. Called by the
+       cyw43 async context at the time requested (in lwIP context, so
+                no lwIP lock is needed):
+       - NTP_STATE_LINK: wait for the link after the radio has been
+         powered up, then do a full connection if the access point
+         last used could not be joined.
+       - NTP_STATE_RESOLVE: take server addresses from the DNS cache,
+         send DNS requests for the others, then wait for their answers
+         (at most NTP_DNS_TIME msec).
+       - NTP_STATE_REQUEST: send a round of requests (one to each
+         server resolved so far) every NTP_BURST_INTERVAL msec.
+       - NTP_STATE_AWAIT: one interval after the last round, select
+         the samples (see ntp_select()) and post the result.
+\* ------------------------------------------------------------------ */
+static void ntp_worker(async_context_t *Context, async_at_time_worker_t *Worker)
+{
+  UINT8 Loop1UInt8;
+
+  int ReturnCode;
+
+  ip_addr_t Address;
+
+
+  switch (NTPData.NTPState)
+  {
+    case (NTP_STATE_LINK):
+      ReturnCode = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+      if (ReturnCode != CYW43_LINK_UP)
+      {
+        /* Still joining (or waiting for DHCP). */
+        if ((ReturnCode >= 0) && (!time_reached(NTPStruct->link_time)))
+        {
+          async_context_add_at_time_worker_in_ms(Context, Worker, NTP_LINK_POLL);
+          break;
+        }
+
+        if (NTPStruct->link_full)
+        {
+          if (DebugBitMask & DEBUG_NTP)
+            uart_send(__LINE__, "Wi-Fi connection failed (link status: %d).\r", ReturnCode);
+
+          ntp_result(NTPStruct, -1, NULL);
+          break;
+        }
+
+        /* Access point last used moved to another channel or gone: leave the pending join and scan all channels. */
+        if (DebugBitMask & DEBUG_NTP)
+          uart_send(__LINE__, "Access point last used not joined (link status: %d), doing a full connection.\r", ReturnCode);
+
+        cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+        cyw43_arch_wifi_connect_async(&FlashConfig.SSID[4], &FlashConfig.Password[4], CYW43_AUTH_WPA2_AES_PSK);
+        NTPStruct->link_full = true;
+        NTPStruct->link_time = make_timeout_time_ms(NTP_CONNECT_TIME);
+        async_context_add_at_time_worker_in_ms(Context, Worker, NTP_LINK_POLL);
+        break;
+      }
+
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "Wi-Fi link up %llu msec after radio power-up.\r", (time_us_64() - NTPData.WiFiOnSince) / 1000);
+
+      /* Access point found by a scan, it may have moved to another channel. */
+      if (NTPStruct->link_full) ntp_link_save();
+
+      NTPData.NTPState = NTP_STATE_RESOLVE;
+      /* Fall through. */
+
+    case (NTP_STATE_RESOLVE):
+      if (NTPStruct->dns_request_sent == false)
+      {
+        for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+        {
+          /* Cached address still valid, no DNS request. */
+          if ((NTPStruct->cache[Loop1UInt8].expiry > time_us_64()) && (NTPStruct->cache[Loop1UInt8].misses < NTP_DNS_MISSES))
+          {
+            ntp_server_add(NTPServerName[Loop1UInt8], &NTPStruct->cache[Loop1UInt8].address, &NTPStruct->server[Loop1UInt8]);
+            continue;
+          }
+
+          ++NTPStruct->dns_pending;
+          ReturnCode = dns_gethostbyname(NTPServerName[Loop1UInt8], &Address, ntp_dns_found, &NTPStruct->server[Loop1UInt8]);
+
+          if (DebugBitMask & DEBUG_NTP)
+            uart_send(__LINE__, "Sent a request to DNS server to get the IP address of %s (return code: %d)\r", NTPServerName[Loop1UInt8], ReturnCode);
+
+          if (ReturnCode == ERR_OK)
+          {
+            /* Cached DNS response, no callback will come. */
+            ntp_dns_found(NTPServerName[Loop1UInt8], &Address, &NTPStruct->server[Loop1UInt8]);
+          }
+          else if (ReturnCode != ERR_INPROGRESS)
+          {
+            /* ERR_INPROGRESS means expect a callback. This server will not be sampled, the others may be enough. */
+            --NTPStruct->dns_pending;
+            if (DebugBitMask & DEBUG_NTP)
+              uart_send(__LINE__, "DNS request failed.\r");
+          }
+        }
+        NTPStruct->dns_request_sent = true;
+
+        /* Wait for the DNS answers still expected (ntp_dns_found() calls back sooner when the last one comes in). */
+        if (NTPStruct->dns_pending > 0)
+        {
+          async_context_add_at_time_worker_in_ms(Context, Worker, NTP_DNS_TIME);
+          break;
+        }
+      }
+
+      /* All DNS answers received or DNS time-out, begin sending requests. */
+      NTPData.NTPState = NTP_STATE_REQUEST;
+      /* Fall through. */
+
+    case (NTP_STATE_REQUEST):
+      for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+        if ((NTPStruct->server[Loop1UInt8].resolved) && (!NTPStruct->server[Loop1UInt8].kod)) ntp_request(NTPStruct, &NTPStruct->server[Loop1UInt8]);
+
+      ++NTPStruct->burst_count;
+      if (NTPStruct->burst_count >= NTP_BURST) NTPData.NTPState = NTP_STATE_AWAIT;
+      async_context_add_at_time_worker_in_ms(Context, Worker, NTP_BURST_INTERVAL);
+
+      if (DebugBitMask & DEBUG_NTP)
+        uart_send(__LINE__, "NTP request round %u sent.\r", NTPStruct->burst_count);
+    break;
+
+    case (NTP_STATE_AWAIT):
+      /* A cached address that no longer answers is replaced after NTP_DNS_MISSES syncs. */
+      for (Loop1UInt8 = 0; Loop1UInt8 < NTP_MAX_SERVERS; ++Loop1UInt8)
+      {
+        /* Address not used (denied, or same server as another name): resolve this name again on next sync. */
+        if (!NTPStruct->server[Loop1UInt8].resolved)
+        {
+          NTPStruct->cache[Loop1UInt8].expiry = 0;
+          continue;
+        }
+
+        if ((NTPStruct->server[Loop1UInt8].sample_count == 0) && (!NTPStruct->server[Loop1UInt8].kod))
+        {
+          if (NTPStruct->cache[Loop1UInt8].misses < 0xFF) ++NTPStruct->cache[Loop1UInt8].misses;
+        }
+        else
+        {
+          NTPStruct->cache[Loop1UInt8].misses = 0;
+        }
+      }
+
+      /* Selects the samples and posts the result (see ntp_result()). */
+      ntp_select(NTPStruct);
+    break;
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=epoch_time_to_utc_time() */
+/* ------------------------------------------------------------------ *\
+          Convert epoch time received from NTP to local time.
+\* ------------------------------------------------------------------ */
+void epoch_time_to_utc_time(time_t *EpochTime)
+{
+  UCHAR String[256];
+
+  struct tm UtcTime;
+
+
+  if (DebugBitMask & DEBUG_NTP)
+    uart_send(__LINE__, "Entering epoch_time_to_utc_time(): %lu\r", *EpochTime);
+
+  /* Adjust Epoch for local timezone, so that we will convert "Epoch local time" to "Current local time". */
+  *EpochTime += (FlashConfig.Timezone * 60 * 60) + (FlashConfig.TimezoneMinutes * 60);  // Flash.TimeZone is given in hour, FlashConfig.TimezoneMinutes in minutes.
+  convert_unix_to_tm(*EpochTime, &UtcTime, FLAG_OFF);
+  if (DebugBitMask & DEBUG_NTP)
+  {
+    uart_send(__LINE__, "EpochTime adjusted for local time: %lu\r", *EpochTime);
+    uart_send(__LINE__, "Date: %2d/%2.2d/%4.4d   %2d:%2.2d:%2.2d\r", UtcTime.tm_mday, UtcTime.tm_mon + 1, UtcTime.tm_year + 1900, UtcTime.tm_hour, UtcTime.tm_min, UtcTime.tm_sec);
+  }
+  
+
+  NTPData.CurrentDayOfMonth = UtcTime.tm_mday;
+  NTPData.CurrentMonth      = UtcTime.tm_mon + 1;	     // 0 -> 11 converted to 1 -> 12
+  NTPData.CurrentYear       = UtcTime.tm_year + 1900;
+  NTPData.CurrentHour       = UtcTime.tm_hour;
+  NTPData.CurrentMinute     = UtcTime.tm_min;
+  NTPData.CurrentSecond     = UtcTime.tm_sec;
 
+  /* The clock time base is set from NTPOffset in a single operation (see main()), there is no need to avoid minute changes. */
   NTPData.FlagNTPSuccess = FLAG_ON;
 
   /* Get current day-of-week, given the day-of-month, month and year. */
-  NTPData.CurrentDayOfWeek  = get_day_of_week(NTPData.CurrentYear, NTPData.CurrentMonth, NTPData.CurrentDayOfMonth);
+  NTPData.CurrentDayOfWeek  = UtcTime.tm_wday + 1;
 
   if (DebugBitMask & DEBUG_NTP)
   {
-    uart_send(__LINE__, "Convert Epoch [%llu] to current time. FlashConfig.Timezone: %d hour (%d in seconds).\r", *EpochTime, FlashConfig.Timezone, (int32_t)FlashConfig.Timezone * 60 * 60);
+    uart_send(__LINE__, "Convert Epoch [%llu] to current time. FlashConfig.Timezone: %d hour %d minutes (%d in seconds).\r", *EpochTime, FlashConfig.Timezone, FlashConfig.TimezoneMinutes, ((int32_t)FlashConfig.Timezone * 60 * 60) + (FlashConfig.TimezoneMinutes * 60));
     uart_send(__LINE__, "NTP time:\r");
-    uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r", DayName[FlashConfig.Language][NTPData.CurrentDayOfWeek], NTPData.CurrentDayOfMonth, NTPData.CurrentMonth, NTPData.CurrentYear, NTPData.CurrentHour, NTPData.CurrentMinute, NTPData.CurrentSecond);
+    uart_send(__LINE__, "DoW: %s   Date: %2.2u/%2.2u/%4.4u   Time: %2.2u:%2.2u:%2.2u\r", DAY_NAME(FlashConfig.Language, NTPData.CurrentDayOfWeek), NTPData.CurrentDayOfMonth, NTPData.CurrentMonth, NTPData.CurrentYear, NTPData.CurrentHour, NTPData.CurrentMinute, NTPData.CurrentSecond);
   }
 
   return;
@@ -12,15 +12,52 @@
 #include "time.h"
 
 
+#define NTP_BURST              3     // number of requests sent to each server on each sync.
+#define NTP_BURST_INTERVAL     2000  // interval between two requests to the same server (in msec).
+#define NTP_DNS_TIME           2000  // maximum wait for DNS answers before requests are sent to the servers resolved (in msec).
+#define NTP_MAX_DENIED         4     // number of servers remembered after a DENY or RSTR kiss-o'-death.
+#define NTP_MAX_SERVERS        4     // number of NTP pool servers sampled on each sync.
+#define NTP_POLL_MAX           17    // maximum poll interval (log2 of seconds: about 36 hours).
+#define NTP_POLL_MIN           6     // minimum poll interval (log2 of seconds: 64 seconds).
+#define NTP_RADIO_SLEEP        600   // Wi-Fi radio is powered down between syncs at least this far apart (in seconds).
+#define NTP_RETRY_MAX          12    // maximum retry interval after failed syncs (log2 of seconds: about 68 minutes).
+
+/* States of an NTP sync (NTPData.NTPState). */
+#define NTP_STATE_IDLE         0     // no sync in progress.
+#define NTP_STATE_LINK         1     // Wi-Fi radio powered up, waiting for the link to the access point.
+#define NTP_STATE_RESOLVE      2     // DNS requests sent, waiting for the server addresses.
+#define NTP_STATE_REQUEST      3     // sending rounds of requests to the servers.
+#define NTP_STATE_AWAIT        4     // last round sent, waiting for the last answers.
+#define NTP_STATE_APPLY        5     // result posted to the main loop (COMMAND_NTP_UPDATE), waiting to be applied.
+
+
 /* Initialize the cyw43 on Pico W. */
 void init_cyw43(unsigned int CountryCode);
 
-/* Retrieve current utc time from NTP server. */
+/* Begin a sync with NTP servers, its result is posted to the main loop when done. */
 void ntp_get_time(void);
 
 /* Initialize NTP connection. */
 int ntp_init(void);
 
+/* Set the retry interval after a failed NTP sync. */
+void ntp_poll_failed(void);
+
+/* Adapt the poll interval after a successful NTP sync. */
+void ntp_poll_update(int64_t Phase);
+
+/* Power down the Wi-Fi radio until next sync, if it is far enough. */
+void ntp_radio_sleep(void);
+
+/* Start the LAN NTP server, answering requests from the local network with the time of the clock. */
+int ntp_serve_start(void);
+
+/* Save the addresses of the truechimers of the last sync to flash, for the first sync after a reboot. */
+void ntp_server_save(void);
+
+/* Save a static IP configuration, used instead of DHCP when connecting to Wi-Fi. */
+void ntp_static_ip(const char *Address, const char *Netmask, const char *Gateway, const char *Dns);
+
 void rtc_from_ntp_epoch(time_t *epoch_seconds);	 // work outside interrupt
 
 #endif
\ No newline at end of file
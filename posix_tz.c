@@ -0,0 +1,417 @@
+/* ======================================================================== *\
+   posix_tz.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   POSIX TZ rule engine for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   See posix_tz.h for the format of the rules and for the conventions
+   used for offsets.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include <string.h>
+#include "civil_time.h"
+#include "posix_tz.h"
+
+
+#define SECONDS_PER_DAY   86400L
+
+
+static const char *parse_date(const char *String, struct tz_date *Date);
+static const char *parse_name(const char *String, char *Name);
+static const char *parse_number(const char *String, int32_t *Value, int32_t Min, int32_t Max);
+static const char *parse_time(const char *String, int32_t *Seconds, int32_t MaxHour);
+static int64_t     transition_time(const struct tz_date *Date, int32_t Year, int32_t Offset);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=parse_date() */
+/* ------------------------------------------------------------------ *\
+          Parse a transition date "Jn", "n" or "Mm.w.d" with an
+                      optional "/time" suffix.
+\* ------------------------------------------------------------------ */
+static const char *parse_date(const char *String, struct tz_date *Date)
+{
+  int32_t Value;
+
+
+  memset(Date, 0, sizeof(*Date));
+
+  if (*String == 'M')
+  {
+    Date->Type = TZ_DATE_MONTH;
+    if ((String = parse_number(String + 1, &Value, 1, 12)) == NULL) return NULL;
+    Date->Month = (uint8_t)Value;
+    if (*String++ != '.') return NULL;
+    if ((String = parse_number(String, &Value, 1, 5)) == NULL) return NULL;
+    Date->Week = (uint8_t)Value;
+    if (*String++ != '.') return NULL;
+    if ((String = parse_number(String, &Value, 0, 6)) == NULL) return NULL;
+    Date->DayOfWeek = (uint8_t)Value;
+  }
+  else if (*String == 'J')
+  {
+    Date->Type = TZ_DATE_JULIAN1;
+    if ((String = parse_number(String + 1, &Value, 1, 365)) == NULL) return NULL;
+    Date->Day = (uint16_t)Value;
+  }
+  else
+  {
+    Date->Type = TZ_DATE_JULIAN0;
+    if ((String = parse_number(String, &Value, 0, 365)) == NULL) return NULL;
+    Date->Day = (uint16_t)Value;
+  }
+
+  /* Default transition time is 02:00:00 local time. */
+  Date->Time = 2 * 3600L;
+  if (*String == '/')
+    String = parse_time(String + 1, &Date->Time, 167);
+
+  return String;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=parse_name() */
+/* ------------------------------------------------------------------ *\
+         Parse a zone abbreviation, either alphabetic ("EST") or
+                       quoted ("<+1030>").
+\* ------------------------------------------------------------------ */
+static const char *parse_name(const char *String, char *Name)
+{
+  uint8_t Length;
+
+
+  Length = 0;
+
+  if (*String == '<')
+  {
+    for (++String; (*String != '>') && (*String != '\0'); ++String)
+      if (Length < (TZ_NAME_SIZE - 1)) Name[Length++] = *String;
+    if (*String++ != '>') return NULL;
+  }
+  else
+  {
+    for (; ((*String >= 'A') && (*String <= 'Z')) || ((*String >= 'a') && (*String <= 'z')); ++String)
+      if (Length < (TZ_NAME_SIZE - 1)) Name[Length++] = *String;
+  }
+  Name[Length] = '\0';
+
+  /* POSIX requires at least three characters. */
+  if (Length < 3) return NULL;
+
+  return String;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=parse_number() */
+/* ------------------------------------------------------------------ *\
+           Parse a decimal number and check it is within range.
+\* ------------------------------------------------------------------ */
+static const char *parse_number(const char *String, int32_t *Value, int32_t Min, int32_t Max)
+{
+  if ((*String < '0') || (*String > '9')) return NULL;
+
+  for (*Value = 0; (*String >= '0') && (*String <= '9'); ++String)
+  {
+    *Value = (*Value * 10) + (*String - '0');
+    if (*Value > Max) return NULL;
+  }
+  if (*Value < Min) return NULL;
+
+  return String;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=parse_time() */
+/* ------------------------------------------------------------------ *\
+       Parse "[+|-]hh[:mm[:ss]]" and return the number of seconds.
+\* ------------------------------------------------------------------ */
+static const char *parse_time(const char *String, int32_t *Seconds, int32_t MaxHour)
+{
+  int8_t  Sign;
+  int32_t Value;
+
+
+  Sign = 1;
+  if      (*String == '+') ++String;
+  else if (*String == '-') {Sign = -1; ++String;}
+
+  if ((String = parse_number(String, &Value, 0, MaxHour)) == NULL) return NULL;
+  *Seconds = Value * 3600L;
+
+  if (*String == ':')
+  {
+    if ((String = parse_number(String + 1, &Value, 0, 59)) == NULL) return NULL;
+    *Seconds += Value * 60L;
+
+    if (*String == ':')
+    {
+      if ((String = parse_number(String + 1, &Value, 0, 59)) == NULL) return NULL;
+      *Seconds += Value;
+    }
+  }
+  *Seconds *= Sign;
+
+  return String;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=transition_time() */
+/* ------------------------------------------------------------------ *\
+        UTC epoch of a transition for a given year, "Offset" being
+             the UTC offset in effect just before the transition.
+\* ------------------------------------------------------------------ */
+static int64_t transition_time(const struct tz_date *Date, int32_t Year, int32_t Offset)
+{
+  int32_t Days;
+  int32_t DayOfMonth;
+  int32_t FirstDayOfWeek;
+
+
+  switch (Date->Type)
+  {
+    case (TZ_DATE_JULIAN1):
+      /* February 29th is never counted, so day 60 is always March 1st. */
+      Days = civil_days(Year, 1, 1) + Date->Day - 1;
+      if (civil_is_leap_year(Year) && (Date->Day >= 60)) ++Days;
+    break;
+
+    case (TZ_DATE_JULIAN0):
+      Days = civil_days(Year, 1, 1) + Date->Day;
+    break;
+
+    default:
+      Days           = civil_days(Year, Date->Month, 1);
+      FirstDayOfWeek = civil_weekday(Days);
+
+      DayOfMonth = 1 + ((Date->DayOfWeek - FirstDayOfWeek + 7) % 7) + ((Date->Week - 1) * 7);
+      if (DayOfMonth > civil_month_days(Year, Date->Month)) DayOfMonth -= 7;  // week 5 means "last".
+
+      Days += DayOfMonth - 1;
+    break;
+  }
+
+  return ((int64_t)Days * SECONDS_PER_DAY) + Date->Time - Offset;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=tz_offset() */
+/* ------------------------------------------------------------------ *\
+        Return the UTC offset (in seconds) in effect at UtcTime.
+     The cache is rebuilt only when UtcTime is outside the two years
+     it covers, otherwise this is at most a few comparisons (and only
+             one when UtcTime is before the next transition).
+\* ------------------------------------------------------------------ */
+int32_t tz_offset(struct tz_cache *Cache, int64_t UtcTime)
+{
+  uint8_t  DayOfMonth;
+  uint8_t  Month;
+  uint16_t Year;
+
+
+  if ((UtcTime < Cache->Low) || (UtcTime >= Cache->High))
+  {
+    civil_from_days((int32_t)(UtcTime / SECONDS_PER_DAY), &Year, &Month, &DayOfMonth);
+    tz_prepare(Cache, Year);
+  }
+
+  /* Time may go back (clock setup, NTP), restart from the beginning of the cache. */
+  if ((Cache->Index > 0) && (UtcTime < Cache->Transition[Cache->Index - 1]))
+    Cache->Index = 0;
+
+  while ((Cache->Index < Cache->Count) && (UtcTime >= Cache->Transition[Cache->Index]))
+    ++Cache->Index;
+
+  Cache->Next = (Cache->Index < Cache->Count) ? Cache->Transition[Cache->Index] : Cache->High;
+
+  return Cache->Offset[Cache->Index];
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=tz_parse() */
+/* ------------------------------------------------------------------ *\
+                Parse a POSIX TZ string into a tz_rule.
+      Returns 0 on success, -1 if the string is not a valid rule.
+\* ------------------------------------------------------------------ */
+int tz_parse(const char *String, struct tz_rule *Rule)
+{
+  int32_t Offset;
+
+
+  memset(Rule, 0, sizeof(*Rule));
+
+  /* Standard time name and offset (mandatory). */
+  if ((String = parse_name(String, Rule->StdName)) == NULL) return -1;
+  if ((String = parse_time(String, &Offset, 24)) == NULL) return -1;
+  Rule->StdOffset = -Offset;
+  Rule->DstOffset = Rule->StdOffset;
+
+  if (*String == '\0') return 0;
+
+  /* Daylight saving time name and optional offset (one hour ahead of standard time by default). */
+  if ((String = parse_name(String, Rule->DstName)) == NULL) return -1;
+  Rule->FlagDst   = 1;
+  Rule->DstOffset = Rule->StdOffset + 3600L;
+  if ((*String != ',') && (*String != '\0'))
+  {
+    if ((String = parse_time(String, &Offset, 24)) == NULL) return -1;
+    Rule->DstOffset = -Offset;
+  }
+
+  /* Transition rules. POSIX leaves the default to the implementation, use North American rules. */
+  if (*String == '\0') String = ",M3.2.0,M11.1.0";
+
+  if (*String++ != ',') return -1;
+  if ((String = parse_date(String, &Rule->Start)) == NULL) return -1;
+  if (*String++ != ',') return -1;
+  if ((String = parse_date(String, &Rule->End)) == NULL) return -1;
+
+  return ((*String == '\0') ? 0 : -1);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=tz_prepare() */
+/* ------------------------------------------------------------------ *\
+      Compute UTC epochs of all transitions for Year and Year + 1,
+                     sorted in chronological order.
+\* ------------------------------------------------------------------ */
+void tz_prepare(struct tz_cache *Cache, int32_t Year)
+{
+  uint8_t Loop1UInt8;
+  uint8_t Loop2UInt8;
+
+  int32_t Dum1Int32;
+  int64_t Dum1Int64;
+
+
+  Cache->Year  = (uint16_t)Year;
+  Cache->Index = 0;
+
+  if (Cache->Rule.FlagDst == 0)
+  {
+    /* No daylight saving time, standard offset is valid forever. */
+    Cache->Count     = 0;
+    Cache->Offset[0] = Cache->Rule.StdOffset;
+    Cache->Low       = INT64_MIN;
+    Cache->High      = INT64_MAX;
+    Cache->Next      = INT64_MAX;
+
+    return;
+  }
+
+  /* Start of DST happens on local standard time, end of DST on local daylight saving time. */
+  for (Loop1UInt8 = 0; Loop1UInt8 < 2; ++Loop1UInt8)
+  {
+    Cache->Transition[Loop1UInt8 * 2]           = transition_time(&Cache->Rule.Start, Year + Loop1UInt8, Cache->Rule.StdOffset);
+    Cache->Offset[(Loop1UInt8 * 2) + 1]         = Cache->Rule.DstOffset;
+    Cache->Transition[(Loop1UInt8 * 2) + 1]     = transition_time(&Cache->Rule.End,   Year + Loop1UInt8, Cache->Rule.DstOffset);
+    Cache->Offset[(Loop1UInt8 * 2) + 2]         = Cache->Rule.StdOffset;
+  }
+
+  /* Southern hemisphere: DST ends before it starts in the same year. Insertion sort keeps each offset with its transition. */
+  for (Loop1UInt8 = 1; Loop1UInt8 < TZ_TRANSITIONS; ++Loop1UInt8)
+  {
+    for (Loop2UInt8 = Loop1UInt8; (Loop2UInt8 > 0) && (Cache->Transition[Loop2UInt8] < Cache->Transition[Loop2UInt8 - 1]); --Loop2UInt8)
+    {
+      Dum1Int64 = Cache->Transition[Loop2UInt8];
+      Cache->Transition[Loop2UInt8]     = Cache->Transition[Loop2UInt8 - 1];
+      Cache->Transition[Loop2UInt8 - 1] = Dum1Int64;
+
+      Dum1Int32 = Cache->Offset[Loop2UInt8 + 1];
+      Cache->Offset[Loop2UInt8 + 1] = Cache->Offset[Loop2UInt8];
+      Cache->Offset[Loop2UInt8]     = Dum1Int32;
+    }
+  }
+
+  /* Before the first transition, we are in the opposite state of what it switches to. */
+  Cache->Offset[0] = (Cache->Offset[1] == Cache->Rule.DstOffset) ? Cache->Rule.StdOffset : Cache->Rule.DstOffset;
+
+  /* One day of margin on each side still leaves no other transition in the range covered. */
+  Cache->Count = TZ_TRANSITIONS;
+  Cache->Low   = ((int64_t)civil_days(Year,     1, 1) - 1) * SECONDS_PER_DAY;
+  Cache->High  = ((int64_t)civil_days(Year + 2, 1, 1) - 1) * SECONDS_PER_DAY;
+  Cache->Next  = Cache->Transition[0];
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=tz_rebase() */
+/* ------------------------------------------------------------------ *\
+     Apply the daylight saving time rules of a region to another
+     standard offset of the same region. With FlagUtc set, transitions
+     stay at the same UTC time (European Union), otherwise they stay at
+                        the same local time.
+\* ------------------------------------------------------------------ */
+void tz_rebase(struct tz_rule *Rule, int32_t StdOffset, uint8_t FlagUtc)
+{
+  int32_t Delta;
+
+
+  Delta = StdOffset - Rule->StdOffset;
+
+  Rule->StdOffset += Delta;
+  Rule->DstOffset += Delta;
+
+  if (FlagUtc)
+  {
+    Rule->Start.Time += Delta;
+    Rule->End.Time   += Delta;
+  }
+
+  return;
+}
@@ -0,0 +1,112 @@
+/* ======================================================================== *\
+   posix_tz.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   POSIX TZ rule engine for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   A rule is given as a POSIX TZ string, for example:
+     EST5EDT,M3.2.0,M11.1.0
+     <+1030>-10:30<+11>-11,M10.1.0,M4.1.0
+   Offsets in the string are "west of Greenwich" (POSIX convention), but
+   are kept as seconds EAST of UTC (local time = UTC + offset) in the
+   structures below. Half-hour and quarter-hour offsets are supported, as
+   well as transition times outside of 0h00 - 24h00 (-167h to +167h).
+
+   UTC epochs of the transitions are computed once for two consecutive
+   years and kept in a tz_cache. Finding the offset in effect is then a
+   comparison with the next transition epoch.
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _POSIX_TZ_H_
+#define _POSIX_TZ_H_
+
+
+
+#include <stdint.h>
+
+
+
+#define TZ_NAME_SIZE        8    // maximum size of a zone abbreviation (including end-of-string).
+#define TZ_TRANSITIONS      4    // number of transitions kept in cache (two years).
+
+/* Types of transition date. */
+#define TZ_DATE_JULIAN1     1    // "Jn":    Julian day 1 to 365, February 29th never counted.
+#define TZ_DATE_JULIAN0     2    // "n":     zero-based day of year 0 to 365, February 29th counted in leap years.
+#define TZ_DATE_MONTH       3    // "Mm.w.d": day "d" (0 = Sunday) of week "w" (5 = last) of month "m".
+
+
+
+/* Date and time of a daylight saving time transition, as given in the rule. */
+struct tz_date
+{
+  uint8_t  Type;                // one of TZ_DATE_xxx above.
+  uint8_t  Month;               // 1 to 12 (TZ_DATE_MONTH).
+  uint8_t  Week;                // 1 to 5, 5 meaning "last" (TZ_DATE_MONTH).
+  uint8_t  DayOfWeek;           // 0 = Sunday to 6 = Saturday (TZ_DATE_MONTH).
+  uint16_t Day;                 // day number (TZ_DATE_JULIAN1 and TZ_DATE_JULIAN0).
+  int32_t  Time;                // local time of the transition, in seconds after midnight.
+};
+
+
+/* Parsed POSIX TZ rule. */
+struct tz_rule
+{
+  char     StdName[TZ_NAME_SIZE];  // standard time abbreviation.
+  char     DstName[TZ_NAME_SIZE];  // daylight saving time abbreviation (empty if no DST).
+  int32_t  StdOffset;              // standard time offset, in seconds east of UTC.
+  int32_t  DstOffset;              // daylight saving time offset, in seconds east of UTC.
+  uint8_t  FlagDst;                // non-zero if the rule has daylight saving time.
+  struct tz_date Start;            // change from standard time to daylight saving time (local standard time).
+  struct tz_date End;              // change from daylight saving time to standard time (local daylight saving time).
+};
+
+
+/* Precomputed transitions for two consecutive years. */
+struct tz_cache
+{
+  struct tz_rule Rule;
+  uint16_t Year;                          // first year covered by the cache (cache covers Year and Year + 1).
+  uint8_t  Count;                         // number of transitions (0 or TZ_TRANSITIONS).
+  uint8_t  Index;                         // number of transitions already crossed at last lookup.
+  int64_t  Low;                           // first UTC epoch covered by the cache.
+  int64_t  High;                          // first UTC epoch no longer covered by the cache.
+  int64_t  Transition[TZ_TRANSITIONS];    // UTC epochs of the transitions, in chronological order.
+  int32_t  Offset[TZ_TRANSITIONS + 1];    // offset in effect before the first transition, then after each one.
+  int64_t  Next;                          // UTC epoch of the next transition (or High if none left in cache).
+};
+
+
+
+/* Return the UTC offset (in seconds) in effect at the given UTC epoch, refreshing the cache if needed. */
+int32_t tz_offset(struct tz_cache *Cache, int64_t UtcTime);
+
+/* Parse a POSIX TZ string. Returns 0 on success, -1 if the string is invalid. */
+int tz_parse(const char *String, struct tz_rule *Rule);
+
+/* Compute transitions of the rule for Year and Year + 1. */
+void tz_prepare(struct tz_cache *Cache, int32_t Year);
+
+/* Move a rule to another standard offset, keeping the same DST shift (and the same UTC transition times if FlagUtc is set). */
+void tz_rebase(struct tz_rule *Rule, int32_t StdOffset, uint8_t FlagUtc);
+
+#endif  // _POSIX_TZ_H_
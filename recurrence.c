@@ -0,0 +1,544 @@
+/* ======================================================================== *\
+   recurrence.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Recurrence rules (subset of RFC 5545 RRULE) for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   See recurrence.h for the format of the rules and for the parts
+   supported.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include <string.h>
+#include "civil_time.h"
+#include "recurrence.h"
+
+
+#define SECONDS_PER_DAY   86400L
+#define LAST_YEAR         2199    // occurrences are not searched beyond the end of this year.
+
+
+static const char DayName[7][3] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+static const char *FreqName[4]  = {"DAILY", "WEEKLY", "MONTHLY", "YEARLY"};  // in the order of RECUR_xxx frequencies.
+
+
+static uint8_t     day_matches(const struct recur_rule *Rule, int32_t Day, uint16_t Year, uint8_t Month, uint8_t DayOfMonth, uint8_t StartDayOfMonth, uint8_t StartDayOfWeek);
+static int32_t     first_day(uint8_t Freq, int32_t Period);
+static const char *parse_by_day(const char *String, struct recur_rule *Rule);
+static const char *parse_date_time(const char *String, int64_t *Time, uint8_t FlagEndOfDay);
+static const char *parse_number(const char *String, int32_t *Value, int32_t Min, int32_t Max);
+static int32_t     period_of(uint8_t Freq, int32_t Day);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=day_matches() */
+/* ------------------------------------------------------------------ *\
+       Return 1 if the given day matches the BYDAY and BYMONTHDAY
+       parts of the rule (or the default day taken from the start
+     when there is none), 0 otherwise. Months are checked by caller.
+\* ------------------------------------------------------------------ */
+static uint8_t day_matches(const struct recur_rule *Rule, int32_t Day, uint16_t Year, uint8_t Month, uint8_t DayOfMonth, uint8_t StartDayOfMonth, uint8_t StartDayOfWeek)
+{
+  uint8_t  DayOfWeek;
+  uint8_t  FlagByDay;
+  uint8_t  Loop1UInt8;
+  uint8_t  MonthDays;
+  uint8_t  Nth;
+  uint8_t  NthLast;
+  uint16_t Bits;
+  uint16_t Length;
+  uint16_t Position;
+
+
+  DayOfWeek = civil_weekday(Day);
+  MonthDays = civil_month_days(Year, Month);
+
+  FlagByDay = 0;
+  for (Loop1UInt8 = 0; Loop1UInt8 < 7; ++Loop1UInt8)
+    if (Rule->ByDay[Loop1UInt8]) FlagByDay = 1;
+
+  if (Rule->ByMonthDay || Rule->ByMonthDayLast)
+  {
+    if (((Rule->ByMonthDay >> DayOfMonth) & 0x01) == 0)
+      if (((Rule->ByMonthDayLast >> (MonthDays - DayOfMonth + 1)) & 0x01) == 0) return 0;
+  }
+  else if (FlagByDay == 0)
+  {
+    /* No BYxxx part to select days, use the day of the start. */
+    switch (Rule->Freq)
+    {
+      case (RECUR_WEEKLY):
+        return (DayOfWeek == StartDayOfWeek);
+
+      case (RECUR_MONTHLY):
+      case (RECUR_YEARLY):
+        return (DayOfMonth == StartDayOfMonth);
+    }
+
+    return 1;
+  }
+
+  if (FlagByDay)
+  {
+    Bits = Rule->ByDay[DayOfWeek];
+    if (Bits == 0) return 0;
+
+    if ((Bits & RECUR_EVERY) == 0)
+    {
+      /* Ordinals are counted within the year for YEARLY without BYMONTH, within the month otherwise. */
+      if ((Rule->Freq == RECUR_YEARLY) && (Rule->ByMonth == 0))
+      {
+        Position = civil_day_of_year(Year, Month, DayOfMonth);
+        Length   = 365 + civil_is_leap_year(Year);
+      }
+      else
+      {
+        Position = DayOfMonth;
+        Length   = MonthDays;
+      }
+      Nth     = ((Position - 1) / 7) + 1;
+      NthLast = ((Length - Position) / 7) + 1;
+
+      if (((Nth > 5) || (((Bits >> Nth) & 0x01) == 0)) && ((NthLast > 5) || (((Bits >> (NthLast + 5)) & 0x01) == 0))) return 0;
+    }
+  }
+
+  return 1;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=first_day() */
+/* ------------------------------------------------------------------ *\
+         Number of days since 01-JAN-1970 of the first day of a
+           period (see period_of() for the numbering of periods).
+\* ------------------------------------------------------------------ */
+static int32_t first_day(uint8_t Freq, int32_t Period)
+{
+  switch (Freq)
+  {
+    case (RECUR_WEEKLY):
+      return (Period * 7) - 3;
+
+    case (RECUR_MONTHLY):
+      return civil_days(Period / 12, (Period % 12) + 1, 1);
+
+    case (RECUR_YEARLY):
+      return civil_days(Period, 1, 1);
+  }
+
+  return Period;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=parse_by_day() */
+/* ------------------------------------------------------------------ *\
+       Parse one BYDAY item ("MO", "2SU", "-1FR") and add it to the
+                               rule.
+\* ------------------------------------------------------------------ */
+static const char *parse_by_day(const char *String, struct recur_rule *Rule)
+{
+  int8_t  Sign;
+  uint8_t DayOfWeek;
+  int32_t Value;
+
+
+  Sign = 1;
+  if      (*String == '+') ++String;
+  else if (*String == '-') {Sign = -1; ++String;}
+
+  Value = 0;
+  if ((*String >= '0') && (*String <= '9'))
+  {
+    if ((String = parse_number(String, &Value, 1, 5)) == NULL) return NULL;
+  }
+  else if (Sign < 0)
+  {
+    return NULL;
+  }
+
+  for (DayOfWeek = 0; DayOfWeek < 7; ++DayOfWeek)
+    if (strncmp(String, DayName[DayOfWeek], 2) == 0) break;
+  if (DayOfWeek == 7) return NULL;
+
+  if (Value == 0)
+    Rule->ByDay[DayOfWeek] |= RECUR_EVERY;
+  else
+    Rule->ByDay[DayOfWeek] |= (uint16_t)(1 << ((Sign > 0) ? Value : (Value + 5)));
+
+  return String + 2;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=parse_date_time() */
+/* ------------------------------------------------------------------ *\
+        Parse "YYYYMMDD[THHMMSS[Z]]" and return the local time epoch.
+      When only a date is given, time is 00:00:00, or 23:59:59 when
+                          FlagEndOfDay is set.
+\* ------------------------------------------------------------------ */
+static const char *parse_date_time(const char *String, int64_t *Time, uint8_t FlagEndOfDay)
+{
+  uint8_t     DayOfMonth;
+  uint8_t     Month;
+  uint16_t    Year;
+  int32_t     Value;
+  const char *Begin;
+
+
+  Begin = String;
+  if ((String = parse_number(String, &Value, 19700101, (LAST_YEAR * 10000L) + 1231)) == NULL) return NULL;
+  if ((String - Begin) != 8) return NULL;
+
+  Year       = (uint16_t)(Value / 10000);
+  Month      = (uint8_t)((Value / 100) % 100);
+  DayOfMonth = (uint8_t)(Value % 100);
+  if ((Month < 1) || (Month > 12) || (DayOfMonth < 1) || (DayOfMonth > civil_month_days(Year, Month))) return NULL;
+
+  *Time = (int64_t)civil_days(Year, Month, DayOfMonth) * SECONDS_PER_DAY;
+
+  if (*String == 'T')
+  {
+    Begin = ++String;
+    if ((String = parse_number(String, &Value, 0, 235959)) == NULL) return NULL;
+    if ((String - Begin) != 6) return NULL;
+    if (((Value / 100) % 100 > 59) || (Value % 100 > 59)) return NULL;
+
+    *Time += ((Value / 10000) * 3600L) + (((Value / 100) % 100) * 60L) + (Value % 100);
+
+    /* UTC times are taken as local times, the clock has no time zone information at this level. */
+    if (*String == 'Z') ++String;
+  }
+  else if (FlagEndOfDay)
+  {
+    *Time += SECONDS_PER_DAY - 1;
+  }
+
+  return String;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=parse_number() */
+/* ------------------------------------------------------------------ *\
+           Parse a decimal number and check it is within range.
+\* ------------------------------------------------------------------ */
+static const char *parse_number(const char *String, int32_t *Value, int32_t Min, int32_t Max)
+{
+  if ((*String < '0') || (*String > '9')) return NULL;
+
+  for (*Value = 0; (*String >= '0') && (*String <= '9'); ++String)
+  {
+    *Value = (*Value * 10) + (*String - '0');
+    if (*Value > Max) return NULL;
+  }
+  if (*Value < Min) return NULL;
+
+  return String;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=period_of() */
+/* ------------------------------------------------------------------ *\
+       Number of the period containing a given day: the day itself
+      for DAILY, weeks beginning on Monday for WEEKLY (week 0 begins
+       on 29-DEC-1969), Year * 12 + Month - 1 for MONTHLY and Year
+                              for YEARLY.
+\* ------------------------------------------------------------------ */
+static int32_t period_of(uint8_t Freq, int32_t Day)
+{
+  uint8_t  DayOfMonth;
+  uint8_t  Month;
+  uint16_t Year;
+
+
+  switch (Freq)
+  {
+    case (RECUR_WEEKLY):
+      return (Day + 3) / 7;
+
+    case (RECUR_MONTHLY):
+      civil_from_days(Day, &Year, &Month, &DayOfMonth);
+      return (Year * 12) + Month - 1;
+
+    case (RECUR_YEARLY):
+      civil_from_days(Day, &Year, &Month, &DayOfMonth);
+      return Year;
+  }
+
+  return Day;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=recur_next() */
+/* ------------------------------------------------------------------ *\
+      Return the first occurrence of the rule strictly after After
+                  (local time epoch), or RECUR_NONE.
+     Without COUNT, the search begins directly in the period holding
+     After. With COUNT, occurrences must be counted from the start;
+     the last occurrence found is kept in the rule so that the next
+         call (with a later After) resumes from there instead.
+\* ------------------------------------------------------------------ */
+int64_t recur_next(struct recur_rule *Rule, int64_t After)
+{
+  uint8_t  DayOfMonth;
+  uint8_t  Month;
+  uint8_t  StartDayOfMonth;
+  uint8_t  StartDayOfWeek;
+  uint8_t  StartMonth;
+  uint16_t Count;
+  uint16_t MonthMask;
+  uint16_t Year;
+  int32_t  Day;
+  int32_t  FirstPeriod;
+  int32_t  LastDay;
+  int32_t  Period;
+  int32_t  PeriodEnd;
+  int32_t  Skip;
+  int32_t  StartDay;
+  int32_t  TimeOfDay;
+  int64_t  Time;
+
+
+  StartDay  = (int32_t)(Rule->Start / SECONDS_PER_DAY);
+  TimeOfDay = (int32_t)(Rule->Start % SECONDS_PER_DAY);
+  civil_from_days(StartDay, &Year, &StartMonth, &StartDayOfMonth);
+  StartDayOfWeek = civil_weekday(StartDay);
+
+  /* Months that may hold occurrences. YEARLY with no BYxxx part to select days falls on the month of the start. */
+  if (Rule->ByMonth)
+    MonthMask = Rule->ByMonth;
+  else if ((Rule->Freq == RECUR_YEARLY) && (Rule->ByMonthDay == 0) && (Rule->ByMonthDayLast == 0) &&
+           (Rule->ByDay[0] | Rule->ByDay[1] | Rule->ByDay[2] | Rule->ByDay[3] | Rule->ByDay[4] | Rule->ByDay[5] | Rule->ByDay[6]) == 0)
+    MonthMask = (uint16_t)(1 << StartMonth);
+  else
+    MonthMask = 0x1FFE;
+
+  /* Find the first day to check. */
+  Count = 0;
+  if (Rule->Count)
+  {
+    if ((Rule->CursorCount) && (Rule->CursorTime <= After))
+    {
+      Day   = (int32_t)(Rule->CursorTime / SECONDS_PER_DAY) + 1;
+      Count = Rule->CursorCount;
+    }
+    else
+    {
+      Day = StartDay;
+    }
+  }
+  else
+  {
+    Day = (After < Rule->Start) ? StartDay : (int32_t)(After / SECONDS_PER_DAY);
+  }
+
+  FirstPeriod = period_of(Rule->Freq, StartDay);
+  LastDay     = civil_days(LAST_YEAR, 12, 31);
+  PeriodEnd   = -1;
+
+  while (Day <= LastDay)
+  {
+    /* Entering another period, skip the periods excluded by INTERVAL. */
+    if (Day > PeriodEnd)
+    {
+      Period = period_of(Rule->Freq, Day);
+      Skip   = (Period - FirstPeriod) % Rule->Interval;
+      if (Skip)
+      {
+        Period += Rule->Interval - Skip;
+        Day     = first_day(Rule->Freq, Period);
+        if (Day > LastDay) break;
+      }
+      PeriodEnd = first_day(Rule->Freq, Period + 1) - 1;
+    }
+
+    civil_from_days(Day, &Year, &Month, &DayOfMonth);
+
+    /* Skip the rest of a month that cannot match. */
+    if (((MonthMask >> Month) & 0x01) == 0)
+    {
+      Day += civil_month_days(Year, Month) - DayOfMonth + 1;
+      continue;
+    }
+
+    if (day_matches(Rule, Day, Year, Month, DayOfMonth, StartDayOfMonth, StartDayOfWeek))
+    {
+      Time = ((int64_t)Day * SECONDS_PER_DAY) + TimeOfDay;
+
+      if ((Rule->Until) && (Time > Rule->Until)) return RECUR_NONE;
+
+      if (Rule->Count)
+      {
+        if (Count >= Rule->Count) return RECUR_NONE;
+        ++Count;
+        Rule->CursorTime  = Time;
+        Rule->CursorCount = Count;
+      }
+
+      if (Time > After) return Time;
+    }
+    ++Day;
+  }
+
+  return RECUR_NONE;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=recur_parse() */
+/* ------------------------------------------------------------------ *\
+                Parse a recurrence rule into a recur_rule.
+      Returns 0 on success, -1 if the string is not a valid rule.
+\* ------------------------------------------------------------------ */
+int recur_parse(const char *String, int64_t Start, struct recur_rule *Rule)
+{
+  uint8_t Loop1UInt8;
+  int8_t  Sign;
+  int32_t Value;
+
+
+  memset(Rule, 0, sizeof(*Rule));
+  Rule->Interval = 1;
+  Rule->Start    = Start;
+
+  if (strncmp(String, "RRULE:", 6) == 0) String += 6;
+
+  while (*String != '\0')
+  {
+    if (strncmp(String, "FREQ=", 5) == 0)
+    {
+      String += 5;
+      for (Loop1UInt8 = 0; Loop1UInt8 < 4; ++Loop1UInt8)
+        if (strncmp(String, FreqName[Loop1UInt8], strlen(FreqName[Loop1UInt8])) == 0) break;
+      if (Loop1UInt8 == 4) return -1;
+      Rule->Freq = Loop1UInt8 + 1;
+      String += strlen(FreqName[Loop1UInt8]);
+    }
+    else if (strncmp(String, "INTERVAL=", 9) == 0)
+    {
+      if ((String = parse_number(String + 9, &Value, 1, 255)) == NULL) return -1;
+      Rule->Interval = (uint8_t)Value;
+    }
+    else if (strncmp(String, "COUNT=", 6) == 0)
+    {
+      if ((String = parse_number(String + 6, &Value, 1, 65535)) == NULL) return -1;
+      Rule->Count = (uint16_t)Value;
+    }
+    else if (strncmp(String, "UNTIL=", 6) == 0)
+    {
+      if ((String = parse_date_time(String + 6, &Rule->Until, 1)) == NULL) return -1;
+    }
+    else if (strncmp(String, "DTSTART=", 8) == 0)
+    {
+      if ((String = parse_date_time(String + 8, &Rule->Start, 0)) == NULL) return -1;
+    }
+    else if (strncmp(String, "BYMONTH=", 8) == 0)
+    {
+      String += 8;
+      for (;;)
+      {
+        if ((String = parse_number(String, &Value, 1, 12)) == NULL) return -1;
+        Rule->ByMonth |= (uint16_t)(1 << Value);
+        if (*String != ',') break;
+        ++String;
+      }
+    }
+    else if (strncmp(String, "BYMONTHDAY=", 11) == 0)
+    {
+      String += 11;
+      for (;;)
+      {
+        Sign = 1;
+        if      (*String == '+') ++String;
+        else if (*String == '-') {Sign = -1; ++String;}
+        if ((String = parse_number(String, &Value, 1, 31)) == NULL) return -1;
+        if (Sign > 0)
+          Rule->ByMonthDay |= (1UL << Value);
+        else
+          Rule->ByMonthDayLast |= (1UL << Value);
+        if (*String != ',') break;
+        ++String;
+      }
+    }
+    else if (strncmp(String, "BYDAY=", 6) == 0)
+    {
+      String += 6;
+      for (;;)
+      {
+        if ((String = parse_by_day(String, Rule)) == NULL) return -1;
+        if (*String != ',') break;
+        ++String;
+      }
+    }
+    else if (strncmp(String, "WKST=MO", 7) == 0)
+    {
+      String += 7;
+    }
+    else
+    {
+      return -1;
+    }
+
+    if (*String == ';')
+      ++String;
+    else if (*String != '\0')
+      return -1;
+  }
+
+  if ((Rule->Freq == 0) || (Rule->Start < 0) || (Rule->Until < 0)) return -1;
+
+  /* RFC 5545 forbids BYMONTHDAY with WEEKLY. Ordinals have no meaning within a day or a week. */
+  if ((Rule->Freq == RECUR_WEEKLY) && (Rule->ByMonthDay || Rule->ByMonthDayLast)) return -1;
+  if (Rule->Freq <= RECUR_WEEKLY)
+    for (Loop1UInt8 = 0; Loop1UInt8 < 7; ++Loop1UInt8)
+      if (Rule->ByDay[Loop1UInt8] & ~RECUR_EVERY) return -1;
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+/* ======================================================================== *\
+   recurrence.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Recurrence rules (subset of RFC 5545 RRULE) for the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   A rule is given as a string of "NAME=VALUE" parts separated by ";",
+   optionally preceded by "RRULE:", for example:
+     FREQ=YEARLY;BYMONTH=5;BYDAY=2SU           (second Sunday of May)
+     FREQ=YEARLY;BYMONTH=2;BYMONTHDAY=-1       (last day of February)
+     FREQ=MONTHLY;BYDAY=-1FR;COUNT=12          (last Friday of the month, 12 times)
+     FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,TH;UNTIL=20301231
+
+   Supported parts:
+     FREQ        DAILY, WEEKLY, MONTHLY or YEARLY (mandatory).
+     INTERVAL    1 to 255 (default 1).
+     COUNT       1 to 65535. Occurrences are counted from the start.
+     UNTIL       YYYYMMDD or YYYYMMDDTHHMMSS[Z] (local time, inclusive;
+                 end of day when only a date is given).
+     BYMONTH     list of months 1 to 12.
+     BYMONTHDAY  list of days 1 to 31 or -1 (last day) to -31.
+     BYDAY       list of SU, MO, TU, WE, TH, FR, SA, each with an optional
+                 ordinal 1 to 5 or -1 (last) to -5. Ordinals are within
+                 the month (MONTHLY, or YEARLY with BYMONTH) or within the
+                 year (YEARLY without BYMONTH). Not allowed with DAILY and
+                 WEEKLY.
+     WKST        MO only (weeks begin on Monday).
+     DTSTART     YYYYMMDD[THHMMSS] (not part of RRULE in RFC 5545, given
+                 here for convenience, overrides the start passed to
+                 recur_parse()).
+
+   As in RFC 5545, the start gives the time of day of all occurrences,
+   the first period counted for INTERVAL and the default day (month,
+   day-of-month or day-of-week) when no BYxxx part selects one. The
+   start itself is an occurrence only if it matches the rule. Dates that
+   do not exist (31st of a short month, 29th of February) are skipped.
+
+   Times are local time epochs (seconds since 01-JAN-1970 00:00:00 local
+   time, as for Reminder1[]). Occurrences are searched up to the end of
+   year 2199. Nothing is allocated and occurrence lists are never built:
+   recur_next() walks the calendar from the time given, one day at a
+   time, skipping the months and periods that cannot match.
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _RECURRENCE_H_
+#define _RECURRENCE_H_
+
+
+
+#include <stdint.h>
+
+
+
+#define RECUR_NONE          (-1)     // returned by recur_next() when there is no other occurrence.
+
+/* Frequencies. */
+#define RECUR_DAILY         1
+#define RECUR_WEEKLY        2
+#define RECUR_MONTHLY       3
+#define RECUR_YEARLY        4
+
+/* Bits of ByDay[] entries (one entry per day-of-week, 0 = Sunday). Bits 1 to 5 are the 1st to 5th such day,
+   bits 6 to 10 are the last to 5th last such day of the month or of the year. */
+#define RECUR_EVERY         0x0001   // every such day-of-week.
+
+
+
+/* Parsed recurrence rule. */
+struct recur_rule
+{
+  uint8_t  Freq;               // one of RECUR_xxx frequencies above.
+  uint8_t  Interval;           // number of periods between two periods with occurrences.
+  uint16_t Count;              // maximum number of occurrences (0 = no limit).
+  uint16_t ByMonth;            // bit 1 = January to bit 12 = December (0 = not given).
+  uint16_t ByDay[7];           // see RECUR_EVERY above (all 0 = not given).
+  uint32_t ByMonthDay;         // bit "n" = day "n" of the month (1 to 31).
+  uint32_t ByMonthDayLast;     // bit "n" = "n"th last day of the month (1 = last day).
+  int64_t  Start;              // first possible occurrence (local time epoch), gives the time of day of all occurrences.
+  int64_t  Until;              // last possible occurrence (local time epoch, 0 = no limit).
+  int64_t  CursorTime;         // last occurrence found by recur_next() when counting occurrences.
+  uint16_t CursorCount;        // number of occurrences up to and including CursorTime (0 = no cursor).
+};
+
+
+
+/* Parse a recurrence rule, Start being the local time of the first possible occurrence. Returns 0 on success, -1 if the rule is invalid. */
+int recur_parse(const char *String, int64_t Start, struct recur_rule *Rule);
+
+/* Return the first occurrence strictly after local time After, or RECUR_NONE. */
+int64_t recur_next(struct recur_rule *Rule, int64_t After);
+
+#endif  // _RECURRENCE_H_
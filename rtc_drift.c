@@ -0,0 +1,126 @@
+/* ======================================================================== *\
+   rtc_drift.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Drift measurement of the real-time clock IC (DS3231) against NTP and
+   trim of its aging offset.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   See rtc_drift.h for the drift measurement.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include "rtc_drift.h"
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=rtc_drift_due() */
+/* ------------------------------------------------------------------ *\
+       Return 1 if the real-time clock IC may be written at Pico timer
+       value "Now": no drift measurement is going on, or it has not
+       been written for RTC_DRIFT_INTERVAL_MIN. In between, it keeps
+       its own time, so that each write can be measured (waiting for
+       its second change) without holding the firmware at every sync.
+\* ------------------------------------------------------------------ */
+uint8_t rtc_drift_due(const struct rtc_drift *Drift, uint64_t Now)
+{
+  if (Drift->Timer == 0) return 1;
+
+  return ((Now - Drift->Written) >= (uint64_t)RTC_DRIFT_INTERVAL_MIN) ? 1 : 0;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=rtc_drift_update() */
+/* ------------------------------------------------------------------ *\
+       Add to the drift measurement the error "Error" (in usec) of the
+       real-time clock IC about to be written, at Pico timer value
+       "Now". Once the measurement lasts RTC_DRIFT_INTERVAL (or
+       RTC_DRIFT_INTERVAL_MIN with an error change of RTC_DRIFT_ERROR),
+       fill Trim with the drift and the aging offset correcting it
+       from current aging offset "Aging", and end the measurement.
+       A drift larger than RTC_DRIFT_MAX is not a drift (time has been
+       changed by other means). Drifts below 3/4 of a step are left
+           alone, so that measurement noise does not toggle it.
+\* ------------------------------------------------------------------ */
+uint8_t rtc_drift_update(struct rtc_drift *Drift, int64_t Error, uint64_t Now, int8_t Aging, struct rtc_drift_trim *Trim)
+{
+  int32_t Steps;
+
+
+  Trim->Drift    = 0;
+  Trim->Interval = 0;
+  Trim->Aging    = Aging;
+  if (Drift->Timer == 0) return RTC_DRIFT_NONE;
+
+  Drift->Change += Error - Drift->Error;
+  Trim->Interval = (int64_t)(Now - Drift->Timer);
+
+  if ((Trim->Interval < RTC_DRIFT_INTERVAL) && ((Trim->Interval < RTC_DRIFT_INTERVAL_MIN) || ((Drift->Change < RTC_DRIFT_ERROR) && (Drift->Change > -RTC_DRIFT_ERROR))))
+    return RTC_DRIFT_NONE;
+
+  /* Begin a new measurement on next write. */
+  Drift->Timer = 0;
+
+  Trim->Drift = (Drift->Change * 1000000LL) / (Trim->Interval / 1000LL);
+  if ((Trim->Drift > RTC_DRIFT_MAX) || (Trim->Drift < -RTC_DRIFT_MAX)) return RTC_DRIFT_REJECTED;
+
+  /* A positive aging offset slows the oscillator. */
+  Steps = (int32_t)((Trim->Drift + ((Trim->Drift < 0) ? -(RTC_AGING_STEP / 4) : (RTC_AGING_STEP / 4))) / RTC_AGING_STEP);
+  if (Steps == 0) return RTC_DRIFT_KEPT;
+
+  Steps += Aging;
+  if (Steps >  127) Steps =  127;
+  if (Steps < -128) Steps = -128;
+  Trim->Aging = (int8_t)Steps;
+
+  return (Trim->Aging == Aging) ? RTC_DRIFT_KEPT : RTC_DRIFT_TRIMMED;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=rtc_drift_written() */
+/* ------------------------------------------------------------------ *\
+       Record the error "Error" (in usec) of the real-time clock IC
+       just written, at Pico timer value "Now". A new drift
+         measurement begins if none is going on.
+\* ------------------------------------------------------------------ */
+void rtc_drift_written(struct rtc_drift *Drift, int64_t Error, uint64_t Now)
+{
+  if (Drift->Timer == 0)
+  {
+    Drift->Change = 0;
+    Drift->Timer  = Now;
+  }
+  Drift->Error   = Error;
+  Drift->Written = Now;
+
+  return;
+}
@@ -0,0 +1,97 @@
+/* ======================================================================== *\
+   rtc_drift.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Drift measurement of the real-time clock IC (DS3231) against NTP and
+   trim of its aging offset.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   The aging offset register of the DS3231 (signed, -128 to 127) trims
+   the frequency of its TCXO by about RTC_AGING_STEP ppb per step at
+   25 degrees C, a positive value slowing the oscillator.
+
+   Errors of the RTC IC are measured against NTP (in usec, positive when
+   it is fast), each time it is about to be written and right after it
+   has been written. The same NTP offset is used for both, so the drift
+   summed over several writes only has the NTP error of the first and
+   of the last sync. It is measured over RTC_DRIFT_INTERVAL, or sooner
+   if it is already large, and the RTC IC is only written once in a
+   while (see rtc_drift_due()) so that each write is measured.
+
+   These functions only work on the errors and times given to them,
+   they do not access the RTC IC (see rtc_drift_measure() and others in
+   Pico-Green-Clock.c for the firmware side), so that they can be run
+   on the host.
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _RTC_DRIFT_H_
+#define _RTC_DRIFT_H_
+
+
+
+#include <stdint.h>
+
+
+
+#define RTC_AGING_STEP            100       // frequency change (in ppb) of the real-time clock IC for one step of its aging offset (at 25 degrees C).
+#define RTC_DRIFT_ERROR           50000     // error change (in usec) that allows an early drift estimation (after RTC_DRIFT_INTERVAL_MIN).
+#define RTC_DRIFT_INTERVAL        (7 * 24 * 3600 * 1000000LL)  // time (in usec) over which the drift of the real-time clock IC is measured.
+#define RTC_DRIFT_INTERVAL_MIN    (12 * 3600 * 1000000LL)      // minimum time (in usec) between two writes of the real-time clock IC, and to estimate a large drift.
+#define RTC_DRIFT_MAX             20000     // drift (in ppb) above which a measurement is rejected (time changed by other means).
+
+/* Drift measurements, as classified by rtc_drift_update(). */
+#define RTC_DRIFT_NONE            0         // drift measurement still going on.
+#define RTC_DRIFT_REJECTED        1         // drift out of range, aging offset left alone.
+#define RTC_DRIFT_KEPT            2         // drift below 3/4 of a step, aging offset left alone.
+#define RTC_DRIFT_TRIMMED         3         // aging offset changed.
+
+
+
+/* Drift measurement of the real-time clock IC. */
+struct rtc_drift
+{
+  int64_t  Change;             // error change (in usec) of the RTC IC between the writes of the measurement so far.
+  int64_t  Error;              // error (in usec) of the RTC IC when last written.
+  uint64_t Timer;              // Pico timer value when the measurement began (0 = none).
+  uint64_t Written;            // Pico timer value when the RTC IC was last written.
+};
+
+/* Aging offset trim given by a drift measurement. */
+struct rtc_drift_trim
+{
+  int64_t Drift;               // drift of the real-time clock IC (in ppb, positive when it is fast).
+  int64_t Interval;            // time (in usec) over which the drift has been measured.
+  int8_t  Aging;               // aging offset to write to the real-time clock IC.
+};
+
+
+
+/* Return 1 if the real-time clock IC may be written at Pico timer value Now (measured, and not written for RTC_DRIFT_INTERVAL_MIN). */
+uint8_t rtc_drift_due(const struct rtc_drift *Drift, uint64_t Now);
+
+/* Add the error of the RTC IC about to be written (Error, at Pico timer value Now) to the measurement and trim aging offset Aging when done. Returns RTC_DRIFT_xxx. */
+uint8_t rtc_drift_update(struct rtc_drift *Drift, int64_t Error, uint64_t Now, int8_t Aging, struct rtc_drift_trim *Trim);
+
+/* Error of the RTC IC just written (Error, at Pico timer value Now), a new measurement begins if none is going on. */
+void rtc_drift_written(struct rtc_drift *Drift, int64_t Error, uint64_t Now);
+
+#endif  // _RTC_DRIFT_H_
@@ -0,0 +1,214 @@
+/* ======================================================================== *\
+   time_base.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Disciplined time base of the Pico Green Clock (frequency and phase
+   corrections of the Pico timer from NTP results).
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   See time_base.h for the time base itself.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include "time_base.h"
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_adjust() */
+/* ------------------------------------------------------------------ *\
+       Discipline the time base with an NTP result: UTC time
+       "UnixTimeUs" (in usec since 01-JAN-1970) at Pico timer value
+       "TimerValue", applied at Pico timer value "Now".
+       - Frequency: the drift since the beginning of the measurement
+         (phase error, plus the corrections made meanwhile), divided
+         by the time elapsed, is the remaining frequency error of the
+         Pico crystal. It is added to Freq, so that the clock keeps
+         time between syncs. The drift is measured over
+         TIME_FLL_INTERVAL, whatever the NTP poll interval, or sooner
+         if it is already large.
+       - Phase: a phase error below TIME_STEP_THRESHOLD is slewed out
+         over TIME_SLEW_PERIOD (the time base runs slightly faster or
+         slower, with no jump), a larger one is stepped.
+\* ------------------------------------------------------------------ */
+void time_base_adjust(struct time_base *Base, uint64_t UnixTimeUs, uint64_t TimerValue, uint64_t Now, struct time_base_sync *Sync)
+{
+  int64_t Current;
+  int64_t Drift;
+  int64_t SlewElapsed;
+
+
+  Current          = (int64_t)time_base_at(Base, Now);
+  Sync->Phase      = ((int64_t)UnixTimeUs + (int64_t)(Now - TimerValue)) - Current;
+  Sync->FreqError  = 0;
+  Sync->Interval   = 0;
+  Sync->FreqStatus = TIME_BASE_FREQ_NONE;
+
+  /* The part of previous phase error already slewed out is a correction made during the drift measurement. */
+  SlewElapsed      = (Now < Base->SlewEnd) ? (int64_t)(Now - Base->Timer) : (int64_t)(Base->SlewEnd - Base->Timer);
+  Base->SyncSteps += ((SlewElapsed / 1000LL) * Base->Slew) / 1000000LL;
+
+
+  /* Frequency error, from the drift since the beginning of the measurement (including slews and steps made meanwhile). */
+  if (Base->SyncTimer != 0)
+  {
+    Sync->Interval = (int64_t)(Now - Base->SyncTimer);
+    Drift          = Sync->Phase + Base->SyncSteps;
+
+    if ((Sync->Interval >= TIME_FLL_INTERVAL) || ((Sync->Interval >= TIME_FLL_INTERVAL_MIN) && ((Drift >= TIME_FLL_DRIFT) || (Drift <= -TIME_FLL_DRIFT))))
+    {
+      Sync->FreqError = (Drift * 1000000LL) / (Sync->Interval / 1000LL);
+
+      if ((Sync->FreqError > TIME_FREQ_MAX) || (Sync->FreqError < -TIME_FREQ_MAX))
+      {
+        /* Time has been changed by some other mean, this is not a drift. */
+        Sync->FreqStatus = TIME_BASE_FREQ_REJECTED;
+      }
+      else
+      {
+        /* A large error (first estimation, temperature change) is corrected at once, a small one (mostly NTP noise) is averaged. */
+        if ((Sync->FreqError > TIME_FREQ_NOISE) || (Sync->FreqError < -TIME_FREQ_NOISE))
+          Base->Freq += (int32_t)Sync->FreqError;
+        else
+          Base->Freq += (int32_t)(Sync->FreqError / TIME_FREQ_AVERAGE);
+
+        if (Base->Freq >  TIME_FREQ_MAX) Base->Freq =  TIME_FREQ_MAX;
+        if (Base->Freq < -TIME_FREQ_MAX) Base->Freq = -TIME_FREQ_MAX;
+
+        Sync->FreqStatus = TIME_BASE_FREQ_UPDATED;
+      }
+
+      /* Begin a new measurement with the new frequency correction. */
+      Base->SyncTimer = 0;
+    }
+  }
+
+
+  /* New origin of the time base at current time, so that the new frequency correction applies from now on with no jump. */
+  Base->Utc     = (uint64_t)Current;
+  Base->Timer   = Now;
+  Base->SlewEnd = Now + TIME_SLEW_PERIOD;
+
+  /* The drift measurement begins with current phase error, which is about to be corrected. */
+  if (Base->SyncTimer == 0)
+  {
+    Base->SyncSteps = -Sync->Phase;
+    Base->SyncTimer = Now;
+  }
+
+  if ((Sync->Phase > TIME_STEP_THRESHOLD) || (Sync->Phase < -TIME_STEP_THRESHOLD))
+  {
+    Base->Utc       += Sync->Phase;
+    Base->Slew       = 0;
+    Base->SyncSteps += Sync->Phase;
+    Sync->FlagStep   = 1;
+  }
+  else
+  {
+    Base->Slew     = (int32_t)((Sync->Phase * 1000000000LL) / TIME_SLEW_PERIOD);
+    Sync->FlagStep = 0;
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_at() */
+/* ------------------------------------------------------------------ *\
+       Return UTC time at Pico timer value "Now", in usec since
+       01-JAN-1970 00h00. Time elapsed on the Pico timer since the
+       origin of the time base is corrected for the Pico crystal
+        frequency error (Freq) and for a phase slew in progress.
+\* ------------------------------------------------------------------ */
+uint64_t time_base_at(const struct time_base *Base, uint64_t Now)
+{
+  int64_t Elapsed;
+  int64_t SlewElapsed;
+
+
+  Elapsed     = (int64_t)(Now - Base->Timer);
+  SlewElapsed = (Now < Base->SlewEnd) ? Elapsed : (int64_t)(Base->SlewEnd - Base->Timer);
+
+  /* Corrections are computed on msec to stay far from overflow (less than 1 usec error). */
+  return Base->Utc + Elapsed + (((Elapsed / 1000LL) * Base->Freq) / 1000000LL) + (((SlewElapsed / 1000LL) * Base->Slew) / 1000000LL);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_duration() */
+/* ------------------------------------------------------------------ *\
+       Return the Pico timer duration (in usec) matching a duration
+       "Duration" of the time base beginning at Pico timer value
+       "Now", in spite of the frequency correction and of a phase
+                        slew in progress.
+\* ------------------------------------------------------------------ */
+uint64_t time_base_duration(const struct time_base *Base, uint64_t Now, uint64_t Duration)
+{
+  int64_t Correction;
+  int64_t SlewDuration;
+
+
+  SlewDuration = 0;
+  if (Now < Base->SlewEnd)
+    SlewDuration = ((Base->SlewEnd - Now) < Duration) ? (int64_t)(Base->SlewEnd - Now) : (int64_t)Duration;
+
+  Correction = ((((int64_t)Duration / 1000LL) * Base->Freq) / 1000000LL) + (((SlewDuration / 1000LL) * Base->Slew) / 1000000LL);
+
+  return (uint64_t)((int64_t)Duration - Correction);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=time_base_origin() */
+/* ------------------------------------------------------------------ *\
+       Move the origin of the time base so that UTC time "UnixTimeUs"
+       (in usec since 01-JAN-1970) corresponds to Pico timer value
+       "TimerValue". The frequency correction is kept, a slew in
+                       progress is dropped.
+\* ------------------------------------------------------------------ */
+void time_base_origin(struct time_base *Base, uint64_t UnixTimeUs, uint64_t TimerValue)
+{
+  int64_t SlewElapsed;
+
+
+  /* The part of the slew already made is a correction made during the drift measurement (see time_base_adjust()). */
+  SlewElapsed      = (TimerValue < Base->SlewEnd) ? (int64_t)(TimerValue - Base->Timer) : (int64_t)(Base->SlewEnd - Base->Timer);
+  Base->SyncSteps += ((SlewElapsed / 1000LL) * Base->Slew) / 1000000LL;
+
+  Base->Utc     = UnixTimeUs;
+  Base->Timer   = TimerValue;
+  Base->Slew    = 0;
+  Base->SlewEnd = TimerValue;
+
+  return;
+}
@@ -0,0 +1,100 @@
+/* ======================================================================== *\
+   time_base.h
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC 7.3.1 arm-none-eabi
+   Version 1.00
+
+   Disciplined time base of the Pico Green Clock (frequency and phase
+   corrections of the Pico timer from NTP results).
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   UTC time (in usec since 01-JAN-1970) is the UTC time of the origin
+   of the time base plus the Pico timer time elapsed since then, the
+   latter being corrected for the Pico crystal frequency error (Freq)
+   and for the phase slew in progress (Slew, until SlewEnd).
+
+   These functions are given the Pico timer value "Now" instead of
+   reading it, and do not protect the time base against interrupts,
+   so that they can be run on the host (see time_base_us() and others
+   in Pico-Green-Clock.c for the firmware side).
+\* ======================================================================== */
+
+
+
+/* $TITLE=Definitions and include files. */
+/* $PAGE */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files.
+\* ----------------------------------------------------------------- */
+#ifndef _TIME_BASE_H_
+#define _TIME_BASE_H_
+
+
+
+#include <stdint.h>
+
+
+
+#define TIME_FLL_DRIFT            20000     // drift (in usec) that allows an early estimation of the Pico crystal frequency error (after TIME_FLL_INTERVAL_MIN).
+#define TIME_FLL_INTERVAL         (4 * 3600 * 1000000LL)  // time (in usec) over which the drift is measured to estimate the Pico crystal frequency error.
+#define TIME_FLL_INTERVAL_MIN     (15 * 60 * 1000000LL)   // minimum time (in usec) to estimate a large frequency error of the Pico crystal.
+#define TIME_FREQ_AVERAGE         4         // frequency errors below TIME_FREQ_NOISE are averaged over this number of NTP syncs.
+#define TIME_FREQ_MAX             500000    // maximum frequency correction of the Pico crystal (in ppb, 500 ppm).
+#define TIME_FREQ_NOISE           1000      // frequency error (in ppb) above which the correction is applied at once.
+#define TIME_SLEW_PERIOD          1000000000LL  // time (in usec) to slew out the phase error of an NTP sync.
+#define TIME_STEP_THRESHOLD       128000    // NTP phase error (in usec) above which the time base is stepped instead of slewed.
+
+/* Frequency estimation made by time_base_adjust(). */
+#define TIME_BASE_FREQ_NONE       0         // drift measurement still going on.
+#define TIME_BASE_FREQ_UPDATED    1         // frequency error measured and applied to Freq.
+#define TIME_BASE_FREQ_REJECTED   2         // frequency error out of range (time changed by some other mean), ignored.
+
+
+
+/* Time base. */
+struct time_base
+{
+  int32_t  Freq;               // frequency correction of the Pico crystal (in ppb).
+  int32_t  Slew;               // temporary frequency correction (in ppb) slewing out the phase error of last NTP sync until SlewEnd.
+  uint64_t SlewEnd;            // Pico timer value when the phase slew ends.
+  int64_t  SyncSteps;          // phase corrections (in usec) applied to the time base since SyncTimer, minus the phase error then.
+  uint64_t SyncTimer;          // Pico timer value when the drift measurement began (0 = no reference to estimate the frequency error).
+  uint64_t Timer;              // Pico timer value at the origin of the time base.
+  uint64_t Utc;                // UTC time in usec since 01-JAN-1970 at Pico timer value Timer.
+};
+
+/* What an NTP result did to the time base. */
+struct time_base_sync
+{
+  int64_t  Phase;              // phase error (in usec).
+  int64_t  FreqError;          // frequency error measured (in ppb), unless FreqStatus is TIME_BASE_FREQ_NONE.
+  int64_t  Interval;           // time (in usec) over which the frequency error has been measured.
+  uint8_t  FreqStatus;         // one of TIME_BASE_FREQ_xxx above.
+  uint8_t  FlagStep;           // 1 if the phase error has been stepped, 0 if it is slewed.
+};
+
+
+
+/* Discipline the time base with an NTP result: UTC time UnixTimeUs at Pico timer value TimerValue, applied at Pico timer value Now. */
+void time_base_adjust(struct time_base *Base, uint64_t UnixTimeUs, uint64_t TimerValue, uint64_t Now, struct time_base_sync *Sync);
+
+/* Return UTC time (in usec since 01-JAN-1970) at Pico timer value Now. */
+uint64_t time_base_at(const struct time_base *Base, uint64_t Now);
+
+/* Return the Pico timer duration matching a duration of the time base beginning at Pico timer value Now. */
+uint64_t time_base_duration(const struct time_base *Base, uint64_t Now, uint64_t Duration);
+
+/* Move the origin of the time base to UTC time UnixTimeUs at Pico timer value TimerValue, keeping the frequency correction. */
+void time_base_origin(struct time_base *Base, uint64_t UnixTimeUs, uint64_t TimerValue);
+
+#endif  // _TIME_BASE_H_
@@ -0,0 +1,622 @@
+/* ======================================================================== *\
+   ics2blob.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host tool compiling an iCalendar (.ics) file into the calendar events
+   blob of the Pico Green Clock.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   Usage: ics2blob [-a offset] [-u file.uf2] input.ics output.bin
+
+     -a offset     offset of the blob area in flash (default EVENT_BLOB_OFFSET),
+                   used for the addresses of the UF2 file.
+     -u file.uf2   also write the blob as a UF2 file, that may be copied to
+                   the Pico in BOOTSEL mode to update the events without
+                   touching the firmware.
+
+   Each VEVENT gives one calendar event:
+     - SUMMARY is the text scrolled on the clock (up to 50 characters).
+     - DTSTART gives the date (time and time zone are ignored).
+     - X-GREENCLOCK-JINGLE gives the jingle number to play (optional).
+     - Without RRULE, the event is scrolled on this date only (one-time).
+     - With RRULE "FREQ=YEARLY" on the same date, the event is scrolled
+       every year and goes into the day index, as the events of
+       CalendarEventsGeneric.cpp.
+     - Any other RRULE is kept as a recurrence rule (see recurrence.h),
+       DTSTART being added to the rule.
+   Events that cannot be converted are reported and left out.
+
+   See event_blob.h for the layout of the blob.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "civil_time.h"
+#include "event_blob.h"
+#include "recurrence.h"
+
+
+#define CRC16_POLYNOM       0x1021       // same polynom as the firmware.
+#define DESCRIPTION_SIZE    51           // same as struct event in the firmware (50 characters + end-of-string).
+#define LINE_SIZE           4096         // maximum size of an unfolded .ics line.
+#define RULE_SIZE           256          // maximum size of a recurrence rule.
+#define UF2_BLOCK_PAYLOAD   256          // bytes of data in each UF2 block.
+#define UF2_FAMILY_RP2040   0xE48BFF56UL
+#define UF2_FLAG_FAMILY     0x00002000UL
+#define UF2_MAGIC_END       0x0AB16F30UL
+#define UF2_MAGIC_START0    0x0A324655UL
+#define UF2_MAGIC_START1    0x9E5D5157UL
+#define XIP_BASE            0x10000000UL
+
+
+/* One event, as read from the .ics file. */
+struct ics_event
+{
+  uint8_t  Month;
+  uint8_t  Day;
+  uint16_t Year;
+  uint16_t Jingle;
+  uint16_t Order;                        // position in the .ics file (keeps events of a same day in file order).
+  uint16_t DayNumber;                    // day-of-year (0 to 365, leap year numbering).
+  char     Description[DESCRIPTION_SIZE];
+  char     Rule[RULE_SIZE];              // empty when there is no recurrence rule.
+};
+
+
+static struct ics_event Event[EVENT_BLOB_MAX_EVENTS];
+static uint16_t EventCount;
+
+static uint8_t  Blob[EVENT_BLOB_AREA];
+static uint16_t StringSize;
+
+
+static int      add_event(const char *Summary, const char *DtStart, const char *RRule, const char *Jingle, uint32_t LineNumber);
+static uint16_t add_string(const char *String, uint8_t *Pool, uint32_t PoolSize);
+static int      compare_events(const void *Event1, const void *Event2);
+static uint16_t crc16(const uint8_t *Data, uint32_t DataSize);
+static char    *next_line(char **Text, uint32_t *LineNumber);
+static void     unescape(char *Destination, const char *Source, uint32_t DestinationSize);
+static int      write_uf2(const char *FileName, const uint8_t *Data, uint32_t Size, uint32_t Offset);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=add_event() */
+/* ------------------------------------------------------------------ *\
+        Convert the properties of one VEVENT into a calendar event.
+             Returns 0 on success, -1 if the event is left out.
+\* ------------------------------------------------------------------ */
+static int add_event(const char *Summary, const char *DtStart, const char *RRule, const char *Jingle, uint32_t LineNumber)
+{
+  uint8_t  DayOfMonth;
+  uint8_t  Month;
+  uint16_t Year;
+  uint32_t Date;
+  char     Rule[RULE_SIZE];
+
+  struct ics_event *New;
+  struct recur_rule Recurrence;
+
+
+  if (EventCount >= EVENT_BLOB_MAX_EVENTS)
+  {
+    fprintf(stderr, "line %u: more than %u events, event left out\n", LineNumber, EVENT_BLOB_MAX_EVENTS);
+    return -1;
+  }
+
+  /* Date, "YYYYMMDD" possibly followed by a time. */
+  if ((strlen(DtStart) < 8) || (sscanf(DtStart, "%8u", &Date) != 1))
+  {
+    fprintf(stderr, "line %u: invalid or missing DTSTART, event left out\n", LineNumber);
+    return -1;
+  }
+  Year       = (uint16_t)(Date / 10000);
+  Month      = (uint8_t)((Date / 100) % 100);
+  DayOfMonth = (uint8_t)(Date % 100);
+  if ((Year < 1970) || (Year > 2199) || (Month < 1) || (Month > 12) || (DayOfMonth < 1) || (DayOfMonth > civil_month_days(Year, Month)))
+  {
+    fprintf(stderr, "line %u: invalid date %s, event left out\n", LineNumber, DtStart);
+    return -1;
+  }
+
+  New = &Event[EventCount];
+  memset(New, 0, sizeof(*New));
+  New->Month     = Month;
+  New->Day       = DayOfMonth;
+  New->Year      = Year;
+  New->Jingle    = (uint16_t)strtoul(Jingle, NULL, 10);
+  New->Order     = EventCount;
+  New->DayNumber = civil_day_of_year(2000, Month, DayOfMonth) - 1;
+  unescape(New->Description, Summary, sizeof(New->Description));
+
+  if (RRule[0] != '\0')
+  {
+    /* Recurrence rule is evaluated from the date of DTSTART. */
+    if (strstr(RRule, "DTSTART=") != NULL)
+      snprintf(Rule, sizeof(Rule), "%s", RRule);
+    else
+      snprintf(Rule, sizeof(Rule), "%s;DTSTART=%8.8u", RRule, Date);
+
+    if (recur_parse(Rule, (int64_t)civil_days(Year, Month, DayOfMonth) * CIVIL_SECONDS_PER_DAY, &Recurrence) != 0)
+    {
+      fprintf(stderr, "line %u: unsupported recurrence rule \"%s\", event left out\n", LineNumber, RRule);
+      return -1;
+    }
+
+    /* Plain "every year on this date" needs no rule, the day index is enough. */
+    if ((Recurrence.Freq == RECUR_YEARLY) && (Recurrence.Interval == 1) && (Recurrence.Count == 0) && (Recurrence.Until == 0) &&
+        (Recurrence.ByDay[0] | Recurrence.ByDay[1] | Recurrence.ByDay[2] | Recurrence.ByDay[3] | Recurrence.ByDay[4] | Recurrence.ByDay[5] | Recurrence.ByDay[6]) == 0 &&
+        ((Recurrence.ByMonth == 0) || (Recurrence.ByMonth == (1U << Month))) &&
+        (Recurrence.ByMonthDayLast == 0) && ((Recurrence.ByMonthDay == 0) || (Recurrence.ByMonthDay == (1UL << DayOfMonth))))
+    {
+      New->Year = 0;
+    }
+    else
+    {
+      snprintf(New->Rule, sizeof(New->Rule), "%s", Rule);
+    }
+  }
+
+  ++EventCount;
+
+  return 0;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=add_string() */
+/* ------------------------------------------------------------------ *\
+       Add a string to the string pool, unless it is already there.
+        Return its offset in the pool, or EVENT_BLOB_NO_STRING if
+                          the pool is full.
+\* ------------------------------------------------------------------ */
+static uint16_t add_string(const char *String, uint8_t *Pool, uint32_t PoolSize)
+{
+  uint32_t Length;
+  uint32_t Offset;
+
+
+  Length = (uint32_t)strlen(String) + 1;
+
+  for (Offset = 0; Offset < StringSize; Offset += (uint32_t)strlen((char *)&Pool[Offset]) + 1)
+    if (strcmp((char *)&Pool[Offset], String) == 0) return (uint16_t)Offset;
+
+  if ((StringSize + Length > PoolSize) || (StringSize + Length >= EVENT_BLOB_NO_STRING)) return EVENT_BLOB_NO_STRING;
+
+  memcpy(&Pool[StringSize], String, Length);
+  Offset      = StringSize;
+  StringSize += (uint16_t)Length;
+
+  return (uint16_t)Offset;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=compare_events() */
+/* ------------------------------------------------------------------ *\
+      Sort order of the records: indexed events by day-of-year, then
+     events with a recurrence rule, each group in .ics file order.
+\* ------------------------------------------------------------------ */
+static int compare_events(const void *Event1, const void *Event2)
+{
+  const struct ics_event *First;
+  const struct ics_event *Second;
+
+
+  First  = (const struct ics_event *)Event1;
+  Second = (const struct ics_event *)Event2;
+
+  if ((First->Rule[0] != '\0') != (Second->Rule[0] != '\0'))
+    return (First->Rule[0] != '\0') ? 1 : -1;
+
+  if ((First->Rule[0] == '\0') && (First->DayNumber != Second->DayNumber))
+    return (int)First->DayNumber - (int)Second->DayNumber;
+
+  return (int)First->Order - (int)Second->Order;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=crc16() */
+/* ------------------------------------------------------------------ *\
+        Cyclic redundancy check of the specified data, computed as
+                by crc16() in the firmware.
+\* ------------------------------------------------------------------ */
+static uint16_t crc16(const uint8_t *Data, uint32_t DataSize)
+{
+  uint8_t  Loop1UInt8;
+  uint16_t CrcValue;
+
+
+  CrcValue = 0;
+
+  while (DataSize-- > 0)
+  {
+    CrcValue = CrcValue ^ (uint16_t)(*Data++ << 8);
+
+    for (Loop1UInt8 = 0; Loop1UInt8 < 8; ++Loop1UInt8)
+    {
+      if (CrcValue & 0x8000)
+        CrcValue = (uint16_t)((CrcValue << 1) ^ CRC16_POLYNOM);
+      else
+        CrcValue = (uint16_t)(CrcValue << 1);
+    }
+  }
+
+  return CrcValue;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=next_line() */
+/* ------------------------------------------------------------------ *\
+      Return the next logical line of the .ics text, with folded
+       lines (continuation lines beginning with a space or a tab)
+      joined, or NULL at the end of the text. Lines are unfolded in
+                          place.
+\* ------------------------------------------------------------------ */
+static char *next_line(char **Text, uint32_t *LineNumber)
+{
+  char *Line;
+  char *Read;
+  char *Write;
+
+
+  if (**Text == '\0') return NULL;
+
+  Line  = *Text;
+  Read  = *Text;
+  Write = *Text;
+
+  for (;;)
+  {
+    if ((*Read == '\r') || (*Read == '\n') || (*Read == '\0'))
+    {
+      if (*Read == '\0') break;
+
+      ++*LineNumber;
+      if ((Read[0] == '\r') && (Read[1] == '\n')) ++Read;
+      ++Read;
+
+      /* A line beginning with a space or a tab continues the previous one. */
+      if ((*Read == ' ') || (*Read == '\t'))
+      {
+        ++Read;
+        continue;
+      }
+      break;
+    }
+    *Write++ = *Read++;
+  }
+  *Write = '\0';
+  *Text  = Read;
+
+  return Line;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=unescape() */
+/* ------------------------------------------------------------------ *\
+       Copy an iCalendar TEXT value, removing escape characters and
+        truncating it to the size of the destination. Line breaks
+                     are replaced by a space.
+\* ------------------------------------------------------------------ */
+static void unescape(char *Destination, const char *Source, uint32_t DestinationSize)
+{
+  uint32_t Length;
+
+
+  for (Length = 0; (*Source != '\0') && (Length < (DestinationSize - 1)); ++Source)
+  {
+    if ((*Source == '\\') && (Source[1] != '\0'))
+    {
+      ++Source;
+      Destination[Length++] = ((*Source == 'n') || (*Source == 'N')) ? ' ' : *Source;
+    }
+    else
+    {
+      Destination[Length++] = *Source;
+    }
+  }
+  Destination[Length] = '\0';
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=write_uf2() */
+/* ------------------------------------------------------------------ *\
+     Write data as a UF2 file, to be written at the given offset in
+                           Pico's flash.
+\* ------------------------------------------------------------------ */
+static int write_uf2(const char *FileName, const uint8_t *Data, uint32_t Size, uint32_t Offset)
+{
+  uint8_t  Block[512];
+  uint32_t BlockCount;
+  uint32_t Header[8];
+  uint32_t Length;
+  uint32_t Loop1UInt32;
+  uint32_t MagicEnd;
+
+  FILE *File;
+
+
+  if ((File = fopen(FileName, "wb")) == NULL) return -1;
+
+  BlockCount = (Size + UF2_BLOCK_PAYLOAD - 1) / UF2_BLOCK_PAYLOAD;
+  MagicEnd   = UF2_MAGIC_END;
+
+  for (Loop1UInt32 = 0; Loop1UInt32 < BlockCount; ++Loop1UInt32)
+  {
+    Header[0] = UF2_MAGIC_START0;
+    Header[1] = UF2_MAGIC_START1;
+    Header[2] = UF2_FLAG_FAMILY;
+    Header[3] = XIP_BASE + Offset + (Loop1UInt32 * UF2_BLOCK_PAYLOAD);
+    Header[4] = UF2_BLOCK_PAYLOAD;
+    Header[5] = Loop1UInt32;
+    Header[6] = BlockCount;
+    Header[7] = UF2_FAMILY_RP2040;
+
+    Length = Size - (Loop1UInt32 * UF2_BLOCK_PAYLOAD);
+    if (Length > UF2_BLOCK_PAYLOAD) Length = UF2_BLOCK_PAYLOAD;
+
+    /* Payload is padded with 0xFF (erased flash). */
+    memset(Block, 0x00, sizeof(Block));
+    memcpy(Block, Header, sizeof(Header));
+    memset(&Block[sizeof(Header)], 0xFF, UF2_BLOCK_PAYLOAD);
+    memcpy(&Block[sizeof(Header)], &Data[Loop1UInt32 * UF2_BLOCK_PAYLOAD], Length);
+    memcpy(&Block[sizeof(Block) - sizeof(MagicEnd)], &MagicEnd, sizeof(MagicEnd));
+
+    if (fwrite(Block, sizeof(Block), 1, File) != 1)
+    {
+      fclose(File);
+      return -1;
+    }
+  }
+
+  return ((fclose(File) == 0) ? 0 : -1);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                          Main program entry.
+\* ------------------------------------------------------------------ */
+int main(int argc, char *argv[])
+{
+  uint8_t  FlagEvent;
+  uint8_t  FlagOther;
+  uint16_t IndexedCount;
+  uint16_t Loop1UInt16;
+  uint16_t RuleCount;
+  uint32_t LineNumber;
+  uint32_t Offset;
+  uint32_t PoolSize;
+  uint32_t Size;
+  uint32_t StartLine;
+  long     FileSize;
+  char    *Line;
+  char    *Text;
+  char    *Cursor;
+  char    *Value;
+  char     DtStart[LINE_SIZE];
+  char     Jingle[LINE_SIZE];
+  char     RRule[LINE_SIZE];
+  char     Summary[LINE_SIZE];
+  const char *InputName;
+  const char *OutputName;
+  const char *Uf2Name;
+
+  FILE *File;
+
+  struct event_blob_header *Header;
+  struct event_blob_record *Record;
+
+
+  /* Command line. */
+  Offset     = EVENT_BLOB_OFFSET;
+  Uf2Name    = NULL;
+  InputName  = NULL;
+  OutputName = NULL;
+  for (Loop1UInt16 = 1; Loop1UInt16 < argc; ++Loop1UInt16)
+  {
+    if ((strcmp(argv[Loop1UInt16], "-a") == 0) && (Loop1UInt16 + 1 < argc))
+      Offset = (uint32_t)strtoul(argv[++Loop1UInt16], NULL, 0);
+    else if ((strcmp(argv[Loop1UInt16], "-u") == 0) && (Loop1UInt16 + 1 < argc))
+      Uf2Name = argv[++Loop1UInt16];
+    else if (InputName == NULL)
+      InputName = argv[Loop1UInt16];
+    else if (OutputName == NULL)
+      OutputName = argv[Loop1UInt16];
+    else
+      InputName = NULL;
+  }
+  if ((InputName == NULL) || (OutputName == NULL) || (Offset % 4096))
+  {
+    fprintf(stderr, "Usage: %s [-a offset] [-u file.uf2] input.ics output.bin\n", argv[0]);
+    fprintf(stderr, "       (offset must be a multiple of 4096, default 0x%X)\n", EVENT_BLOB_OFFSET);
+    return 1;
+  }
+
+
+  /* Read the whole .ics file. */
+  if ((File = fopen(InputName, "rb")) == NULL)
+  {
+    fprintf(stderr, "%s: cannot open %s\n", argv[0], InputName);
+    return 1;
+  }
+  fseek(File, 0, SEEK_END);
+  FileSize = ftell(File);
+  fseek(File, 0, SEEK_SET);
+  if ((FileSize < 0) || ((Text = malloc((size_t)FileSize + 1)) == NULL) || (fread(Text, 1, (size_t)FileSize, File) != (size_t)FileSize))
+  {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], InputName);
+    fclose(File);
+    return 1;
+  }
+  fclose(File);
+  Text[FileSize] = '\0';
+
+
+  /* Collect the properties of each VEVENT. Components nested in a VEVENT (VALARM) are skipped. */
+  Cursor     = Text;
+  LineNumber = 0;
+  StartLine  = 0;
+  FlagEvent  = 0;
+  FlagOther  = 0;
+  while ((Line = next_line(&Cursor, &LineNumber)) != NULL)
+  {
+    if (strcmp(Line, "BEGIN:VEVENT") == 0)
+    {
+      FlagEvent  = 1;
+      FlagOther  = 0;
+      StartLine  = LineNumber;
+      DtStart[0] = '\0';
+      Jingle[0]  = '\0';
+      RRule[0]   = '\0';
+      Summary[0] = '\0';
+      continue;
+    }
+    if (FlagEvent == 0) continue;
+
+    if (strcmp(Line, "END:VEVENT") == 0)
+    {
+      FlagEvent = 0;
+      add_event(Summary, DtStart, RRule, Jingle, StartLine);
+      continue;
+    }
+    if (strncmp(Line, "BEGIN:", 6) == 0) ++FlagOther;
+    if ((strncmp(Line, "END:", 4) == 0) && FlagOther) {--FlagOther; continue;}
+    if (FlagOther) continue;
+
+    /* Value begins after the first ':' that is not within a quoted parameter value. */
+    for (Value = Line; (*Value != ':') && (*Value != '\0'); ++Value)
+      if (*Value == '"') while ((*++Value != '"') && (*Value != '\0'));
+    if (*Value == '\0') continue;
+    ++Value;
+
+    if      ((strncmp(Line, "SUMMARY", 7) == 0) && ((Line[7] == ':') || (Line[7] == ';')))  snprintf(Summary, sizeof(Summary), "%s", Value);
+    else if ((strncmp(Line, "DTSTART", 7) == 0) && ((Line[7] == ':') || (Line[7] == ';')))  snprintf(DtStart, sizeof(DtStart), "%s", Value);
+    else if ((strncmp(Line, "RRULE", 5) == 0) && (Line[5] == ':') && (RRule[0] == '\0'))    snprintf(RRule, sizeof(RRule), "%s", Value);
+    else if (strncmp(Line, "X-GREENCLOCK-JINGLE:", 20) == 0)                                snprintf(Jingle, sizeof(Jingle), "%s", Value);
+    else if ((strncmp(Line, "EXDATE", 6) == 0) || (strncmp(Line, "RDATE", 5) == 0))
+      fprintf(stderr, "line %u: %.6s is not supported and is ignored\n", StartLine, Line);
+  }
+  free(Text);
+
+
+  /* Sort events and build the blob. */
+  qsort(Event, EventCount, sizeof(Event[0]), compare_events);
+
+  memset(Blob, 0x00, sizeof(Blob));
+  Header = (struct event_blob_header *)Blob;
+  Record = (struct event_blob_record *)&Blob[sizeof(*Header)];
+
+  IndexedCount = 0;
+  for (Loop1UInt16 = 0; Loop1UInt16 < EventCount; ++Loop1UInt16)
+  {
+    if (Event[Loop1UInt16].Rule[0] != '\0') break;
+    ++IndexedCount;
+    ++Header->DayStart[Event[Loop1UInt16].DayNumber + 1];
+  }
+  for (Loop1UInt16 = 1; Loop1UInt16 <= EVENT_BLOB_DAYS; ++Loop1UInt16)
+    Header->DayStart[Loop1UInt16] += Header->DayStart[Loop1UInt16 - 1];
+  RuleCount = EventCount - IndexedCount;
+
+  Size     = sizeof(*Header) + (EventCount * sizeof(*Record));
+  PoolSize = sizeof(Blob) - Size;
+  for (Loop1UInt16 = 0; Loop1UInt16 < EventCount; ++Loop1UInt16)
+  {
+    Record[Loop1UInt16].Month       = Event[Loop1UInt16].Month;
+    Record[Loop1UInt16].Day         = Event[Loop1UInt16].Day;
+    Record[Loop1UInt16].Year        = Event[Loop1UInt16].Year;
+    Record[Loop1UInt16].Jingle      = Event[Loop1UInt16].Jingle;
+    Record[Loop1UInt16].Description = add_string(Event[Loop1UInt16].Description, &Blob[Size], PoolSize);
+    Record[Loop1UInt16].Rule        = EVENT_BLOB_NO_STRING;
+    if (Event[Loop1UInt16].Rule[0] != '\0')
+    {
+      Record[Loop1UInt16].Rule = add_string(Event[Loop1UInt16].Rule, &Blob[Size], PoolSize);
+      if (Record[Loop1UInt16].Rule == EVENT_BLOB_NO_STRING) Record[Loop1UInt16].Description = EVENT_BLOB_NO_STRING;
+    }
+    if (Record[Loop1UInt16].Description == EVENT_BLOB_NO_STRING)
+    {
+      fprintf(stderr, "%s: events do not fit in the %u bytes of the blob area\n", argv[0], EVENT_BLOB_AREA);
+      return 1;
+    }
+  }
+  Size += StringSize;
+
+  Header->Magic        = EVENT_BLOB_MAGIC;
+  Header->Version      = EVENT_BLOB_VERSION;
+  Header->Size         = Size;
+  Header->EventCount   = EventCount;
+  Header->IndexedCount = IndexedCount;
+  Header->StringSize   = StringSize;
+  Header->Crc16        = crc16(&Blob[offsetof(struct event_blob_header, Size)], Size - offsetof(struct event_blob_header, Size));
+
+
+  /* Output files. */
+  if (((File = fopen(OutputName, "wb")) == NULL) || (fwrite(Blob, 1, Size, File) != Size) || (fclose(File) != 0))
+  {
+    fprintf(stderr, "%s: cannot write %s\n", argv[0], OutputName);
+    return 1;
+  }
+  if ((Uf2Name != NULL) && (write_uf2(Uf2Name, Blob, Size, Offset) != 0))
+  {
+    fprintf(stderr, "%s: cannot write %s\n", argv[0], Uf2Name);
+    return 1;
+  }
+
+  printf("%s: %u events (%u in the day index, %u with a recurrence rule), %u bytes of strings, blob size %u bytes at flash offset 0x%X\n",
+         OutputName, EventCount, IndexedCount, RuleCount, StringSize, Size, Offset);
+
+  return 0;
+}
@@ -0,0 +1,289 @@
+/* ======================================================================== *\
+   civil_time_test.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host test and benchmark of the calendar kernels (civil_time.h).
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   Every day from 01-JAN-1970 to 31-DEC-2199 is compared with gmtime_r()
+   and timegm() of the host C library: date, day-of-week, day-of-year and
+   month length. Unix times are then converted to a date and time and back,
+   as convert_unix_to_tm() and convert_tm_to_unix() do in the firmware, on
+   the first and last second of every day and on random seconds.
+
+   The benchmark times the same round trip with the kernels and with
+   gmtime_r() + timegm(). It is informative only, the test does not fail
+   on timing.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "civil_time.h"
+
+
+#define BENCHMARK_COUNT     10000000UL   // round trips timed for each method.
+#define FIRST_YEAR          1970
+#define LAST_YEAR           2199
+#define RANDOM_SECONDS      16           // random seconds of each day converted back and forth.
+
+
+static uint64_t bench_kernels(const int64_t *Time, uint32_t Count);
+static uint64_t bench_libc(const int64_t *Time, uint32_t Count);
+static uint64_t now_ns(void);
+static int64_t  round_trip(int64_t UnixTime);
+static uint32_t random32(void);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=bench_kernels() */
+/* ------------------------------------------------------------------ *\
+          Round trips with the kernels, returns a checksum so that
+                    the compiler keeps the work.
+\* ------------------------------------------------------------------ */
+static uint64_t bench_kernels(const int64_t *Time, uint32_t Count)
+{
+  uint32_t Loop1UInt32;
+  uint64_t Sum;
+
+
+  Sum = 0;
+  for (Loop1UInt32 = 0; Loop1UInt32 < Count; ++Loop1UInt32)
+    Sum += (uint64_t)round_trip(Time[Loop1UInt32]);
+
+  return Sum;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=bench_libc() */
+/* ------------------------------------------------------------------ *\
+       Round trips with gmtime_r() and timegm(), returns a checksum.
+\* ------------------------------------------------------------------ */
+static uint64_t bench_libc(const int64_t *Time, uint32_t Count)
+{
+  uint32_t Loop1UInt32;
+  uint64_t Sum;
+  time_t   UnixTime;
+
+  struct tm Tm;
+
+
+  Sum = 0;
+  for (Loop1UInt32 = 0; Loop1UInt32 < Count; ++Loop1UInt32)
+  {
+    UnixTime = (time_t)Time[Loop1UInt32];
+    gmtime_r(&UnixTime, &Tm);
+    Sum += (uint64_t)timegm(&Tm);
+  }
+
+  return Sum;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=now_ns() */
+/* ------------------------------------------------------------------ *\
+                  Monotonic host time, in nanoseconds.
+\* ------------------------------------------------------------------ */
+static uint64_t now_ns(void)
+{
+  struct timespec Now;
+
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+
+  return ((uint64_t)Now.tv_sec * 1000000000ULL) + (uint64_t)Now.tv_nsec;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random32() */
+/* ------------------------------------------------------------------ *\
+      Pseudo-random numbers (xorshift), same sequence on every run.
+\* ------------------------------------------------------------------ */
+static uint32_t random32(void)
+{
+  static uint32_t State = 2463534242UL;
+
+
+  State ^= State << 13;
+  State ^= State >> 17;
+  State ^= State << 5;
+
+  return State;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=round_trip() */
+/* ------------------------------------------------------------------ *\
+        Convert a Unix time to date and time, then back to a Unix
+        time, the way the firmware does (see convert_unix_to_tm() and
+                 convert_tm_to_unix() in Pico-Green-Clock.c).
+\* ------------------------------------------------------------------ */
+static int64_t round_trip(int64_t UnixTime)
+{
+  uint8_t  DayOfMonth;
+  uint8_t  Month;
+  uint16_t Year;
+  int32_t  Days;
+  uint32_t Seconds;
+  uint32_t Hour;
+  uint32_t Minute;
+  uint32_t Second;
+
+
+  Days    = (int32_t)(UnixTime / CIVIL_SECONDS_PER_DAY);
+  Seconds = (uint32_t)(UnixTime % CIVIL_SECONDS_PER_DAY);
+  civil_from_days(Days, &Year, &Month, &DayOfMonth);
+  Hour    = Seconds / 3600;
+  Minute  = (Seconds / 60) % 60;
+  Second  = Seconds % 60;
+
+  return ((int64_t)civil_days(Year, Month, DayOfMonth) * CIVIL_SECONDS_PER_DAY) + (Hour * 3600) + (Minute * 60) + Second;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                              Main test.
+\* ------------------------------------------------------------------ */
+int main(void)
+{
+  uint8_t  DayOfMonth;
+  uint8_t  Loop1UInt8;
+  uint8_t  Month;
+  uint16_t Year;
+  int32_t  Days;
+  int32_t  FirstDay;
+  int32_t  LastDay;
+  uint32_t Errors;
+  uint32_t Loop1UInt32;
+  uint64_t Elapsed[2];
+  uint64_t Start;
+  uint64_t Sum[2];
+  int64_t  Second;
+  int64_t *Time;
+  time_t   UnixTime;
+
+  struct tm Tm;
+
+
+  FirstDay = civil_days(FIRST_YEAR, 1, 1);
+  LastDay  = civil_days(LAST_YEAR, 12, 31);
+  Errors   = 0;
+
+  /* Every day: kernels against the host C library. */
+  for (Days = FirstDay; Days <= LastDay; ++Days)
+  {
+    civil_from_days(Days, &Year, &Month, &DayOfMonth);
+    UnixTime = (time_t)Days * CIVIL_SECONDS_PER_DAY;
+    gmtime_r(&UnixTime, &Tm);
+
+    if ((Year != (Tm.tm_year + 1900)) || (Month != (Tm.tm_mon + 1)) || (DayOfMonth != Tm.tm_mday) ||
+        (civil_weekday(Days) != Tm.tm_wday) || (civil_day_of_year(Year, Month, DayOfMonth) != (Tm.tm_yday + 1)) ||
+        (civil_days(Year, Month, DayOfMonth) != Days) || ((int64_t)timegm(&Tm) != (int64_t)UnixTime))
+    {
+      if (Errors < 20)
+        printf("Day %d: %4.4u-%2.2u-%2.2u (weekday %u), gmtime_r() gives %4.4d-%2.2d-%2.2d (weekday %d)\n", Days, Year, Month, DayOfMonth, civil_weekday(Days), Tm.tm_year + 1900, Tm.tm_mon + 1, Tm.tm_mday, Tm.tm_wday);
+      ++Errors;
+    }
+
+    /* Month length, on the first day of each month: distance to the first day of next month given by timegm(). */
+    if (DayOfMonth == 1)
+    {
+      Tm.tm_mon += 1;  // timegm() normalizes month 12 to January of next year.
+      if ((((int64_t)timegm(&Tm) - (int64_t)UnixTime) / (int64_t)CIVIL_SECONDS_PER_DAY) != civil_month_days(Year, Month))
+      {
+        if (Errors < 20)
+          printf("%4.4u-%2.2u: month length %u is wrong\n", Year, Month, civil_month_days(Year, Month));
+        ++Errors;
+      }
+    }
+
+    /* Unix time round trip on the first and last second of the day, and on random seconds. */
+    for (Loop1UInt8 = 0; Loop1UInt8 < (RANDOM_SECONDS + 2); ++Loop1UInt8)
+    {
+      if (Loop1UInt8 == 0)
+        Second = 0;
+      else if (Loop1UInt8 == 1)
+        Second = CIVIL_SECONDS_PER_DAY - 1;
+      else
+        Second = random32() % CIVIL_SECONDS_PER_DAY;
+
+      Second += (int64_t)UnixTime;
+      if (round_trip(Second) != Second)
+      {
+        if (Errors < 20)
+          printf("Unix time %lld converted back to %lld\n", (long long)Second, (long long)round_trip(Second));
+        ++Errors;
+      }
+    }
+  }
+  printf("%d days from %u to %u compared with gmtime_r() / timegm(): %u errors.\n", LastDay - FirstDay + 1, FIRST_YEAR, LAST_YEAR, Errors);
+
+
+  /* Benchmark on random times over the same range. */
+  Time = malloc(BENCHMARK_COUNT * sizeof(*Time));
+  if (Time == NULL) return 1;
+  for (Loop1UInt32 = 0; Loop1UInt32 < BENCHMARK_COUNT; ++Loop1UInt32)
+    Time[Loop1UInt32] = ((int64_t)FirstDay * CIVIL_SECONDS_PER_DAY) + (int64_t)((((uint64_t)random32() << 32) | random32()) % ((uint64_t)(LastDay - FirstDay + 1) * CIVIL_SECONDS_PER_DAY));
+
+  Start      = now_ns();
+  Sum[0]     = bench_kernels(Time, BENCHMARK_COUNT);
+  Elapsed[0] = now_ns() - Start;
+  Start      = now_ns();
+  Sum[1]     = bench_libc(Time, BENCHMARK_COUNT);
+  Elapsed[1] = now_ns() - Start;
+  free(Time);
+
+  if (Sum[0] != Sum[1])
+  {
+    printf("Benchmark round trips differ.\n");
+    ++Errors;
+  }
+  printf("Round trip Unix time -> date and time -> Unix time: %.1f nsec with civil_time.h, %.1f nsec with gmtime_r() + timegm().\n", (double)Elapsed[0] / BENCHMARK_COUNT, (double)Elapsed[1] / BENCHMARK_COUNT);
+
+  return (Errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+/* ======================================================================== *\
+   event_index_test.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host test and benchmark of the calendar events index (event_index.c).
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   EVENT_COUNT random events (some of them with an invalid date, as
+   event_index_build() leaves them out of the index) are indexed with
+   event_index_sort(). For every day of a leap year, the events found
+   with the index must be the same, and in the same order, as those
+   found by scanning all events, the way the firmware did before the
+   index.
+
+   The benchmark times the index build, then the events of every day
+   looked up with the index and with the linear scan. It is informative
+   only, the test does not fail on timing. The firmware itself keeps at
+   most MAX_EVENTS events (lower than 0xAA, see scroll queue tags), the
+   benchmark shows how both methods scale.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "civil_time.h"
+#include "event_index.h"
+
+
+#define BENCHMARK_PASSES    200          // number of times every day of the year is looked up for each method.
+#define EVENT_COUNT         5000
+#define EVENT_LEAP_YEAR     2000         // leap year used to number the days of the index (as in Pico-Green-Clock.c).
+#define INVALID_EVERY       20           // one event out of INVALID_EVERY has an invalid date.
+
+
+/* Date of a calendar event, as in CalendarEvent[]. */
+struct event_date
+{
+  uint8_t Day;
+  uint8_t Month;
+};
+
+
+static uint16_t day_number(const struct event_date *Event);
+static uint32_t linear_scan(const struct event_date *Event, uint16_t Count, uint8_t Month, uint8_t DayOfMonth, uint16_t *List);
+static uint64_t now_ns(void);
+static uint32_t random32(void);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=day_number() */
+/* ------------------------------------------------------------------ *\
+        Day-of-year of an event (0 to 365) or EVENT_INDEX_NONE for an
+             invalid date, as event_index_build() computes it.
+\* ------------------------------------------------------------------ */
+static uint16_t day_number(const struct event_date *Event)
+{
+  if ((Event->Month < 1) || (Event->Month > 12)) return EVENT_INDEX_NONE;
+  if ((Event->Day < 1) || (Event->Day > civil_month_days(EVENT_LEAP_YEAR, Event->Month))) return EVENT_INDEX_NONE;
+
+  return civil_day_of_year(EVENT_LEAP_YEAR, Event->Month, Event->Day) - 1;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=linear_scan() */
+/* ------------------------------------------------------------------ *\
+        Find the events of a date by scanning all of them. Fill List
+           (if not NULL) and return the number of events found.
+\* ------------------------------------------------------------------ */
+static uint32_t linear_scan(const struct event_date *Event, uint16_t Count, uint8_t Month, uint8_t DayOfMonth, uint16_t *List)
+{
+  uint16_t Loop1UInt16;
+  uint32_t Found;
+
+
+  Found = 0;
+  for (Loop1UInt16 = 0; Loop1UInt16 < Count; ++Loop1UInt16)
+  {
+    if ((Event[Loop1UInt16].Month == Month) && (Event[Loop1UInt16].Day == DayOfMonth))
+    {
+      if (List != NULL) List[Found] = Loop1UInt16;
+      ++Found;
+    }
+  }
+
+  return Found;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=now_ns() */
+/* ------------------------------------------------------------------ *\
+                  Monotonic host time, in nanoseconds.
+\* ------------------------------------------------------------------ */
+static uint64_t now_ns(void)
+{
+  struct timespec Now;
+
+
+  clock_gettime(CLOCK_MONOTONIC, &Now);
+
+  return ((uint64_t)Now.tv_sec * 1000000000ULL) + (uint64_t)Now.tv_nsec;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random32() */
+/* ------------------------------------------------------------------ *\
+      Pseudo-random numbers (xorshift), same sequence on every run.
+\* ------------------------------------------------------------------ */
+static uint32_t random32(void)
+{
+  static uint32_t State = 2463534242UL;
+
+
+  State ^= State << 13;
+  State ^= State >> 17;
+  State ^= State << 5;
+
+  return State;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                              Main test.
+\* ------------------------------------------------------------------ */
+int main(void)
+{
+  uint8_t  DayOfMonth;
+  uint8_t  Month;
+  uint16_t DayNumber[EVENT_COUNT];
+  uint16_t DayStart[EVENT_INDEX_DAYS + 1];
+  uint16_t Index[EVENT_COUNT];
+  uint16_t List[EVENT_COUNT];
+  uint16_t Loop1UInt16;
+  uint16_t Pass;
+  uint16_t Today;
+  uint32_t Errors;
+  uint32_t Found;
+  uint32_t Indexed;
+  uint64_t Elapsed[3];
+  uint64_t Start;
+  uint64_t Sum[2];
+
+  struct event_date Event[EVENT_COUNT];
+
+
+  /* Random events, one out of INVALID_EVERY with an invalid date (31-APR, 30-FEB, month 13, day 0, ...). */
+  for (Loop1UInt16 = 0; Loop1UInt16 < EVENT_COUNT; ++Loop1UInt16)
+  {
+    Event[Loop1UInt16].Month = (random32() % 12) + 1;
+    if ((random32() % INVALID_EVERY) == 0)
+    {
+      Event[Loop1UInt16].Day = civil_month_days(EVENT_LEAP_YEAR, Event[Loop1UInt16].Month) + 1 + (random32() % 2);
+      if ((Loop1UInt16 % 3) == 0) Event[Loop1UInt16].Day = 0;
+      if ((Loop1UInt16 % 5) == 0) Event[Loop1UInt16].Month = 13;
+    }
+    else
+    {
+      Event[Loop1UInt16].Day = (random32() % civil_month_days(EVENT_LEAP_YEAR, Event[Loop1UInt16].Month)) + 1;
+    }
+  }
+
+  /* Index build, timed (same work as event_index_build()). */
+  Start = now_ns();
+  for (Pass = 0; Pass < BENCHMARK_PASSES; ++Pass)
+  {
+    for (Loop1UInt16 = 0; Loop1UInt16 < EVENT_COUNT; ++Loop1UInt16)
+      DayNumber[Loop1UInt16] = day_number(&Event[Loop1UInt16]);
+    event_index_sort(DayNumber, EVENT_COUNT, DayStart, Index);
+  }
+  Elapsed[0] = (now_ns() - Start) / BENCHMARK_PASSES;
+
+  /* Every day of a leap year: same events, in the same order, with the index and with the linear scan. */
+  Errors  = 0;
+  Indexed = 0;
+  for (Today = 0; Today < EVENT_INDEX_DAYS; ++Today)
+  {
+    civil_from_days(civil_days(EVENT_LEAP_YEAR, 1, 1) + Today, &Loop1UInt16, &Month, &DayOfMonth);
+    Found = linear_scan(Event, EVENT_COUNT, Month, DayOfMonth, List);
+    if (Found != (uint32_t)(DayStart[Today + 1] - DayStart[Today]))
+    {
+      if (Errors < 20)
+        printf("%2.2u-%2.2u: %u events in the index, %u with the linear scan\n", DayOfMonth, Month, DayStart[Today + 1] - DayStart[Today], Found);
+      ++Errors;
+      continue;
+    }
+
+    for (Loop1UInt16 = 0; Loop1UInt16 < Found; ++Loop1UInt16)
+    {
+      if (Index[DayStart[Today] + Loop1UInt16] != List[Loop1UInt16])
+      {
+        if (Errors < 20)
+          printf("%2.2u-%2.2u: event %u is %u in the index, %u with the linear scan\n", DayOfMonth, Month, Loop1UInt16, Index[DayStart[Today] + Loop1UInt16], List[Loop1UInt16]);
+        ++Errors;
+      }
+    }
+    Indexed += Found;
+  }
+
+  if (DayStart[EVENT_INDEX_DAYS] != Indexed)
+  {
+    printf("Index holds %u events, %u found day by day\n", DayStart[EVENT_INDEX_DAYS], Indexed);
+    ++Errors;
+  }
+  printf("%u events (%u with a valid date) compared on %u days: %u errors.\n", EVENT_COUNT, Indexed, EVENT_INDEX_DAYS, Errors);
+
+
+  /* Benchmark: events of every day of the year, with the index and with the linear scan. */
+  Sum[0] = 0;
+  Start  = now_ns();
+  for (Pass = 0; Pass < BENCHMARK_PASSES; ++Pass)
+    for (Month = 1; Month <= 12; ++Month)
+      for (DayOfMonth = 1; DayOfMonth <= civil_month_days(EVENT_LEAP_YEAR, Month); ++DayOfMonth)
+      {
+        Today = civil_day_of_year(EVENT_LEAP_YEAR, Month, DayOfMonth) - 1;
+        for (Loop1UInt16 = DayStart[Today]; Loop1UInt16 < DayStart[Today + 1]; ++Loop1UInt16)
+          Sum[0] += Index[Loop1UInt16];
+      }
+  Elapsed[1] = now_ns() - Start;
+
+  Sum[1] = 0;
+  Start  = now_ns();
+  for (Pass = 0; Pass < BENCHMARK_PASSES; ++Pass)
+    for (Month = 1; Month <= 12; ++Month)
+      for (DayOfMonth = 1; DayOfMonth <= civil_month_days(EVENT_LEAP_YEAR, Month); ++DayOfMonth)
+      {
+        Found = linear_scan(Event, EVENT_COUNT, Month, DayOfMonth, List);
+        for (Loop1UInt16 = 0; Loop1UInt16 < Found; ++Loop1UInt16)
+          Sum[1] += List[Loop1UInt16];
+      }
+  Elapsed[2] = now_ns() - Start;
+
+  if (Sum[0] != Sum[1])
+  {
+    printf("Benchmark lookups differ.\n");
+    ++Errors;
+  }
+  printf("Index build: %.1f usec for %u events.\n", (double)Elapsed[0] / 1000.0, EVENT_COUNT);
+  printf("Events of one day: %.1f nsec with the index, %.1f nsec with the linear scan.\n", (double)Elapsed[1] / (BENCHMARK_PASSES * EVENT_INDEX_DAYS), (double)Elapsed[2] / (BENCHMARK_PASSES * EVENT_INDEX_DAYS));
+
+  return (Errors == 0) ? 0 : 1;
+}
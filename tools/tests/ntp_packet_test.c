@@ -0,0 +1,587 @@
+/* ======================================================================== *\
+   ntp_packet_test.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host test of the SNTP exchange arithmetic (ntp_packet.c) with a fake
+   NTP server, and of the answers of the LAN NTP server.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   The request is built as ntp_request() does (T1, the Pico timer value,
+   as transmit timestamp). A fake server, whose clock is off from UTC by
+   a random error, answers after random network delays to and from it
+   (symmetric or not) and a random processing time. The offset and the
+   delay given by ntp_packet_sample() must be those of the simulated
+   exchange within TOLERANCE (timestamps are truncated to the
+   microsecond): the offset is the true offset plus the server error
+   plus half of the delay asymmetry, so it is never further than half
+   of the round-trip delay from the server clock.
+
+   Exchanges are drawn from 1970 to 2105 (NTP eras 0 and 1), plus many
+   across the end of era 0 (07-FEB-2036 06:28:16 UTC). Answers that do
+   not match the request, that are not from a server or that come from
+   an unsynchronized server are rejected, and kiss-o'-death is told
+   apart from a sample.
+
+   The answers built by ntp_packet_serve() are checked field by field
+   (leap indicator, version, mode, stratum, poll, precision, reference
+   ID, root delay and root dispersion, reference, originate and receive
+   timestamps), on fixed cases (stratum cap, root dispersion growing to
+   NTP_SERVE_MAX_DISP, no sync since power-up) and on SERVE_COUNT random
+   requests and system peers. Each answer, completed with its transmit
+   timestamp, must then be accepted by ntp_packet_sample() as the client
+   would (rejected when unsynchronized), and requests that are short or
+   not from a client must not be answered.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "ntp_packet.h"
+
+
+#define ERA_END_US          (((1ULL << 32) - NTP_DELTA) * 1000000ULL)  // end of NTP era 0, in usec since 01-JAN-1970.
+#define ERA1_END_US         ((1ULL << 32) * 1000000ULL)               // end of the times decoded in era 1.
+#define EXCHANGE_COUNT      1000000UL    // random exchanges from 1970 to 2105.
+#define EXCHANGE_ERA_COUNT  100000UL     // random exchanges across the end of NTP era 0.
+#define MAX_DELAY           300000       // maximum network delay (in usec) in each direction.
+#define MAX_PROCESSING      20000        // maximum server processing time (in usec).
+#define MAX_SERVER_ERROR    2000000      // maximum error (in usec) of the server clock, either way.
+#define SERVE_COUNT         200000UL     // random requests answered by ntp_packet_serve().
+#define SERVE_ELAPSED_MAX   (14ULL * 86400ULL * 1000000ULL)  // longest time (in usec) since the last sync of a random system peer (root dispersion beyond NTP_SERVE_MAX_DISP).
+#define SHORT_TOLERANCE     16           // NTP short format resolution (1/65536 sec), plus truncation to the microsecond (in usec).
+#define TOLERANCE           2            // T2 and T3 are truncated to the microsecond, then the offset to half of their sum (in usec).
+
+
+/* One simulated exchange (times in usec). */
+struct exchange
+{
+  uint64_t Utc;                          // true UTC time when the request is sent.
+  uint64_t T1;                           // Pico timer value when the request is sent.
+  int64_t  Up;                           // network delay to the server.
+  int64_t  Down;                         // network delay from the server.
+  int64_t  Processing;                   // server processing time.
+  int64_t  ServerError;                  // server clock minus true UTC.
+};
+
+
+static void     fake_server(const uint8_t *Request, uint8_t *Answer, const struct exchange *Exchange, uint8_t Leap, uint8_t Stratum);
+static void     make_request(uint8_t *Request, uint64_t T1);
+static uint32_t random32(void);
+static uint64_t random64(uint64_t Range);
+static uint32_t run_exchange(const struct exchange *Exchange, uint8_t FlagPrint, int64_t *MaxError, int64_t *MaxAsymmetry);
+static uint32_t serve_check(const struct ntp_packet_peer *Peer, uint8_t Version, uint64_t T1, uint64_t ReceiveTime, uint8_t *Answer, uint8_t FlagPrint);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=fake_server() */
+/* ------------------------------------------------------------------ *\
+      Answer a request as an NTP server would, its clock being off by
+      Exchange->ServerError: receive timestamp (T2) after the delay to
+       the server, transmit timestamp (T3) after processing time.
+\* ------------------------------------------------------------------ */
+static void fake_server(const uint8_t *Request, uint8_t *Answer, const struct exchange *Exchange, uint8_t Leap, uint8_t Stratum)
+{
+  uint64_t ServerTime;
+
+
+  memset(Answer, 0, NTP_MSG_LEN);
+  Answer[0] = (Leap << 6) | (Request[0] & 0x38) | 4;  // version of the request, mode 4: server.
+  Answer[1] = Stratum;
+  Answer[2] = 6;
+  Answer[3] = (uint8_t)(-23);
+  Answer[NTP_OFFSET_ROOT_DELAY + 2] = 0x01;           // 1/256 sec.
+  Answer[NTP_OFFSET_ROOT_DISP + 2]  = 0x02;           // 1/128 sec.
+  memcpy(&Answer[NTP_OFFSET_REFERENCE], "GPS\0", 4);
+
+  ServerTime = Exchange->Utc + Exchange->Up + Exchange->ServerError;
+  ntp_packet_put_timestamp(Answer, NTP_OFFSET_REF_TIME, ServerTime - 16000000ULL);
+  memcpy(&Answer[NTP_OFFSET_ORIGINATE], &Request[NTP_OFFSET_TRANSMIT], 8);
+  ntp_packet_put_timestamp(Answer, NTP_OFFSET_RECEIVE, ServerTime);
+  ntp_packet_put_timestamp(Answer, NTP_OFFSET_TRANSMIT, ServerTime + Exchange->Processing);
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=make_request() */
+/* ------------------------------------------------------------------ *\
+        Build a request as ntp_request() does in picow_ntp_client.c.
+\* ------------------------------------------------------------------ */
+static void make_request(uint8_t *Request, uint64_t T1)
+{
+  uint8_t Loop1UInt8;
+
+
+  memset(Request, 0, NTP_MSG_LEN);
+  Request[0] = 0x1b;
+  for (Loop1UInt8 = 0; Loop1UInt8 < 8; ++Loop1UInt8)
+    Request[NTP_OFFSET_TRANSMIT + Loop1UInt8] = (T1 >> (56 - (Loop1UInt8 * 8))) & 0xFF;
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random32() */
+/* ------------------------------------------------------------------ *\
+      Pseudo-random numbers (xorshift), same sequence on every run.
+\* ------------------------------------------------------------------ */
+static uint32_t random32(void)
+{
+  static uint32_t State = 2463534242UL;
+
+
+  State ^= State << 13;
+  State ^= State >> 17;
+  State ^= State << 5;
+
+  return State;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random64() */
+/* ------------------------------------------------------------------ *\
+                 Pseudo-random number from 0 to Range - 1.
+\* ------------------------------------------------------------------ */
+static uint64_t random64(uint64_t Range)
+{
+  return ((((uint64_t)random32()) << 32) | random32()) % Range;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=run_exchange() */
+/* ------------------------------------------------------------------ *\
+      Simulate one exchange and check the sample. Return the number
+       of errors (printed if FlagPrint is set) and keep the largest
+         error against the simulated offset, and the largest error
+                   caused by delay asymmetry.
+\* ------------------------------------------------------------------ */
+static uint32_t run_exchange(const struct exchange *Exchange, uint8_t FlagPrint, int64_t *MaxError, int64_t *MaxAsymmetry)
+{
+  uint8_t  Answer[NTP_MSG_LEN];
+  uint8_t  Request[NTP_MSG_LEN];
+  int64_t  Error;
+  int64_t  Expected;
+  int64_t  ServerOffset;
+  uint64_t T4;
+
+  struct ntp_packet_sample Sample;
+
+
+  make_request(Request, Exchange->T1);
+  fake_server(Request, Answer, Exchange, 0, 2);
+  T4 = Exchange->T1 + Exchange->Up + Exchange->Processing + Exchange->Down;
+
+  if (ntp_packet_sample(Answer, Exchange->T1, T4, &Sample) != NTP_PACKET_SAMPLE)
+  {
+    if (FlagPrint) printf("UTC %llu usec: answer rejected\n", (unsigned long long)Exchange->Utc);
+    return 1;
+  }
+
+  /* Server clock as seen from the Pico timer, then what the exchange gives of it. */
+  ServerOffset = (int64_t)(Exchange->Utc - Exchange->T1) + Exchange->ServerError;
+  Expected     = ServerOffset + ((Exchange->Up - Exchange->Down) / 2);
+  Error        = Sample.Offset - Expected;
+  if (Error < 0) Error = -Error;
+  if (Error > *MaxError) *MaxError = Error;
+
+  if ((Error > TOLERANCE) || (Sample.Delay < (Exchange->Up + Exchange->Down - TOLERANCE)) || (Sample.Delay > (Exchange->Up + Exchange->Down + TOLERANCE)) ||
+      (Sample.RootDelay != 3906) || (Sample.RootDispersion != 7812) || (Sample.Stratum != 2))
+  {
+    if (FlagPrint)
+      printf("UTC %llu usec (up %lld, down %lld): offset %lld, expected %lld, delay %lld, expected %lld\n", (unsigned long long)Exchange->Utc, (long long)Exchange->Up, (long long)Exchange->Down,
+             (long long)Sample.Offset, (long long)Expected, (long long)Sample.Delay, (long long)(Exchange->Up + Exchange->Down));
+    return 1;
+  }
+
+  /* Asymmetry: the offset is never further than half of the round-trip delay from the server clock. */
+  Error = Sample.Offset - ServerOffset;
+  if (Error < 0) Error = -Error;
+  if (Error > *MaxAsymmetry) *MaxAsymmetry = Error;
+  if (Error > ((Sample.Delay / 2) + TOLERANCE))
+  {
+    if (FlagPrint) printf("UTC %llu usec: offset error %lld beyond half of delay %lld\n", (unsigned long long)Exchange->Utc, (long long)Error, (long long)Sample.Delay);
+    return 1;
+  }
+
+  return 0;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=serve_check() */
+/* ------------------------------------------------------------------ *      Build a client request (NTP version "Version", transmit time T1)
+      as received by the LAN NTP server at UTC time "ReceiveTime", get
+      its answer from ntp_packet_serve() (left in Answer) and check all
+       its fields against the system peer. Then complete the answer
+      with its transmit timestamp and check that the client takes it
+           as a sample (or rejects it, if unsynchronized). Return the
+               number of errors (printed if FlagPrint is set).
+\* ------------------------------------------------------------------ */
+static uint32_t serve_check(const struct ntp_packet_peer *Peer, uint8_t Version, uint64_t T1, uint64_t ReceiveTime, uint8_t *Answer, uint8_t FlagPrint)
+{
+  uint8_t  Request[NTP_MSG_LEN];
+  uint8_t  FlagUnsynced;
+  uint8_t  Leap;
+  uint8_t  Result;
+  uint8_t  Stratum;
+  uint32_t Errors;
+  int64_t  Decoded;
+  int64_t  Dispersion;
+  int64_t  RootDelay;
+  int64_t  RootDispersion;
+
+  struct ntp_packet_sample Sample;
+
+
+  Errors = 0;
+  make_request(Request, T1);
+  Request[0] = (Version << 3) | 3;
+  Request[2] = 6 + (T1 % 12);  // poll interval of the client, returned as is.
+  memcpy(Answer, Request, NTP_MSG_LEN);
+
+  if (ntp_packet_serve(Answer, NTP_MSG_LEN, ReceiveTime, Peer) == 0)
+  {
+    if (FlagPrint) printf("Request from a version %u client not answered\n", Version);
+    return 1;
+  }
+
+  /* What the answer must hold: unsynchronized before the first sync, or when the root dispersion has grown too much. */
+  Dispersion   = Peer->RootDispersion + ((Peer->Elapsed / 1000000LL) * NTP_SERVE_PHI);
+  FlagUnsynced = ((Peer->FlagSynced == 0) || (Dispersion >= NTP_SERVE_MAX_DISP));
+  if (FlagUnsynced) Dispersion = NTP_SERVE_MAX_DISP;
+  Leap    = FlagUnsynced ? 3 : 0;
+  Stratum = FlagUnsynced ? 16 : ((Peer->Stratum < 15) ? Peer->Stratum + 1 : 15);
+
+  /* Root delay and root dispersion, from NTP short format to usec. */
+  RootDelay      = (int64_t)((((uint64_t)Answer[NTP_OFFSET_ROOT_DELAY] << 24) | ((uint64_t)Answer[NTP_OFFSET_ROOT_DELAY + 1] << 16) | ((uint64_t)Answer[NTP_OFFSET_ROOT_DELAY + 2] << 8) | Answer[NTP_OFFSET_ROOT_DELAY + 3]) * 1000000ULL >> 16);
+  RootDispersion = (int64_t)((((uint64_t)Answer[NTP_OFFSET_ROOT_DISP] << 24) | ((uint64_t)Answer[NTP_OFFSET_ROOT_DISP + 1] << 16) | ((uint64_t)Answer[NTP_OFFSET_ROOT_DISP + 2] << 8) | Answer[NTP_OFFSET_ROOT_DISP + 3]) * 1000000ULL >> 16);
+
+  if (((Answer[0] >> 6) != Leap) || (((Answer[0] >> 3) & 0x07) != Version) || ((Answer[0] & 0x07) != 4))
+  {
+    if (FlagPrint) printf("Header 0x%2.2X answered to version %u (leap indicator %u expected)\n", Answer[0], Version, Leap);
+    ++Errors;
+  }
+  if ((Answer[1] != Stratum) || (Answer[2] != Request[2]) || (Answer[3] != (uint8_t)NTP_SERVE_PRECISION))
+  {
+    if (FlagPrint) printf("Stratum %u (%u expected), poll %u (%u requested), precision %d\n", Answer[1], Stratum, Answer[2], Request[2], (int8_t)Answer[3]);
+    ++Errors;
+  }
+  if (memcmp(&Answer[NTP_OFFSET_REFERENCE], FlagUnsynced ? (const uint8_t *)"INIT" : Peer->Address, 4) != 0)
+  {
+    if (FlagPrint) printf("Reference ID %u.%u.%u.%u (%s expected)\n", Answer[NTP_OFFSET_REFERENCE], Answer[NTP_OFFSET_REFERENCE + 1], Answer[NTP_OFFSET_REFERENCE + 2], Answer[NTP_OFFSET_REFERENCE + 3], FlagUnsynced ? "INIT" : "peer address");
+    ++Errors;
+  }
+  if ((RootDelay > Peer->RootDelay) || (RootDelay < (Peer->RootDelay - SHORT_TOLERANCE)) || (RootDispersion > Dispersion) || (RootDispersion < (Dispersion - SHORT_TOLERANCE)))
+  {
+    if (FlagPrint) printf("Root delay %lld usec (%lld expected), root dispersion %lld usec (%lld expected)\n", (long long)RootDelay, (long long)Peer->RootDelay, (long long)RootDispersion, (long long)Dispersion);
+    ++Errors;
+  }
+
+  /* Reference timestamp: last sync (0 if none), receive timestamp: T2, originate timestamp: T1 of the client, byte for byte. */
+  Decoded = ntp_packet_get_timestamp(Answer, NTP_OFFSET_REF_TIME);
+  if ((Peer->FlagSynced == 0) ? (memcmp(&Answer[NTP_OFFSET_REF_TIME], "\0\0\0\0\0\0\0\0", 8) != 0) :
+                                ((Decoded > (int64_t)(ReceiveTime - Peer->Elapsed)) || (Decoded < (int64_t)(ReceiveTime - Peer->Elapsed - TOLERANCE))))
+  {
+    if (FlagPrint) printf("Reference timestamp %lld usec, last sync at %lld usec\n", (long long)Decoded, (Peer->FlagSynced == 0) ? 0LL : (long long)(ReceiveTime - Peer->Elapsed));
+    ++Errors;
+  }
+  Decoded = ntp_packet_get_timestamp(Answer, NTP_OFFSET_RECEIVE);
+  if ((Decoded > (int64_t)ReceiveTime) || (Decoded < (int64_t)(ReceiveTime - TOLERANCE)))
+  {
+    if (FlagPrint) printf("Receive timestamp %lld usec, request received at %llu usec\n", (long long)Decoded, (unsigned long long)ReceiveTime);
+    ++Errors;
+  }
+  if (memcmp(&Answer[NTP_OFFSET_ORIGINATE], &Request[NTP_OFFSET_TRANSMIT], 8) != 0)
+  {
+    if (FlagPrint) printf("Originate timestamp is not the transmit timestamp of the request (T1 %llu)\n", (unsigned long long)T1);
+    ++Errors;
+  }
+
+  /* The answer, as ntp_serve() sends it, seen by the client 1 msec later. */
+  ntp_packet_put_timestamp(Answer, NTP_OFFSET_TRANSMIT, ReceiveTime + 200);
+  Result = ntp_packet_sample(Answer, T1, T1 + 1000, &Sample);
+  if (Result != (FlagUnsynced ? NTP_PACKET_INVALID : NTP_PACKET_SAMPLE))
+  {
+    if (FlagPrint) printf("Answer (leap indicator %u, stratum %u) classified %u by the client\n", Leap, Stratum, Result);
+    ++Errors;
+  }
+  else if ((Result == NTP_PACKET_SAMPLE) && ((Sample.Stratum != Stratum) || (Sample.Delay < (800 - TOLERANCE)) || (Sample.Delay > (800 + TOLERANCE)) ||
+           (Sample.RootDelay < (Peer->RootDelay - SHORT_TOLERANCE)) || (Sample.RootDispersion < (Dispersion - SHORT_TOLERANCE))))
+  {
+    if (FlagPrint) printf("Client sample: stratum %u, delay %lld usec, root delay %lld usec, root dispersion %lld usec\n", Sample.Stratum, (long long)Sample.Delay, (long long)Sample.RootDelay, (long long)Sample.RootDispersion);
+    ++Errors;
+  }
+
+  return Errors;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                              Main test.
+\* ------------------------------------------------------------------ */
+int main(void)
+{
+  uint8_t  Answer[NTP_MSG_LEN];
+  uint8_t  Loop1UInt8;
+  uint8_t  Request[NTP_MSG_LEN];
+  uint32_t Errors;
+  uint32_t Loop1UInt32;
+  int64_t  Decoded;
+  int64_t  MaxAsymmetry;
+  int64_t  MaxError;
+  uint64_t T4;
+
+  struct exchange Exchange;
+  struct ntp_packet_peer   Peer;
+  struct ntp_packet_sample Sample;
+
+  static const uint64_t Time[] = {0, 999999, 1000000, 2082758399999999ULL, ERA_END_US - 1, ERA_END_US, ERA_END_US + 1, ERA1_END_US - 1000000, ERA1_END_US - 1};
+
+
+  Errors = 0;
+
+  /* Timestamps around the end of era 0 and at the ends of the range, to the microsecond (truncated by the fraction). */
+  for (Loop1UInt8 = 0; Loop1UInt8 < (sizeof(Time) / sizeof(Time[0])); ++Loop1UInt8)
+  {
+    ntp_packet_put_timestamp(Answer, NTP_OFFSET_TRANSMIT, Time[Loop1UInt8]);
+    Decoded = ntp_packet_get_timestamp(Answer, NTP_OFFSET_TRANSMIT);
+    if ((Decoded > (int64_t)Time[Loop1UInt8]) || (Decoded < ((int64_t)Time[Loop1UInt8] - TOLERANCE)))
+    {
+      printf("Timestamp %llu usec decoded as %lld usec\n", (unsigned long long)Time[Loop1UInt8], (long long)Decoded);
+      ++Errors;
+    }
+  }
+  printf("%u timestamps around the end of NTP era 0 and of era 1 checked: %u errors.\n", (unsigned)(sizeof(Time) / sizeof(Time[0])), Errors);
+
+
+  /* Random exchanges from 1970 to 2105, then across the end of era 0. One out of four has a delay much longer on one side. */
+  MaxAsymmetry = 0;
+  MaxError     = 0;
+  for (Loop1UInt32 = 0; Loop1UInt32 < (EXCHANGE_COUNT + EXCHANGE_ERA_COUNT); ++Loop1UInt32)
+  {
+    if (Loop1UInt32 < EXCHANGE_COUNT)
+      Exchange.Utc = MAX_SERVER_ERROR + random64(ERA1_END_US - (120ULL * 86400ULL * 1000000ULL));
+    else
+      Exchange.Utc = ERA_END_US - 2000000ULL + random64(4000000ULL);
+
+    Exchange.T1          = random64(1ULL << 45);  // about one year since power-up.
+    Exchange.Up          = 100 + (int64_t)random64(MAX_DELAY);
+    Exchange.Down        = 100 + (int64_t)random64(MAX_DELAY);
+    Exchange.Processing  = (int64_t)random64(MAX_PROCESSING);
+    Exchange.ServerError = (int64_t)random64(2 * MAX_SERVER_ERROR) - MAX_SERVER_ERROR;
+    if ((random32() % 4) == 0)
+    {
+      if (random32() % 2)
+        Exchange.Up = 100 + (int64_t)random64(1000);
+      else
+        Exchange.Down = 100 + (int64_t)random64(1000);
+    }
+
+    Errors += run_exchange(&Exchange, (Errors < 20), &MaxError, &MaxAsymmetry);
+  }
+  printf("%lu exchanges with a fake server (delays up to %u msec each way): largest error %lld usec, largest asymmetry error %lld usec (within half of the delay).\n",
+         EXCHANGE_COUNT + EXCHANGE_ERA_COUNT, MAX_DELAY / 1000, (long long)MaxError, (long long)MaxAsymmetry);
+
+
+  /* Answers to reject, kiss-o'-death, and a server reporting a processing time longer than the round trip. */
+  Exchange.Utc         = 1792000000000000ULL;  // October 2026.
+  Exchange.T1          = 123456789012ULL;
+  Exchange.Up          = 20000;
+  Exchange.Down        = 5000;
+  Exchange.Processing  = 100;
+  Exchange.ServerError = 0;
+  T4 = Exchange.T1 + Exchange.Up + Exchange.Processing + Exchange.Down;
+  make_request(Request, Exchange.T1);
+
+  fake_server(Request, Answer, &Exchange, 0, 2);
+  for (Loop1UInt8 = 0; Loop1UInt8 < 8; ++Loop1UInt8)
+  {
+    Answer[NTP_OFFSET_ORIGINATE + Loop1UInt8] ^= 0x01;
+    if (ntp_packet_sample(Answer, Exchange.T1, T4, &Sample) != NTP_PACKET_INVALID)
+    {
+      printf("Answer accepted with byte %u of originate timestamp changed\n", Loop1UInt8);
+      ++Errors;
+    }
+    Answer[NTP_OFFSET_ORIGINATE + Loop1UInt8] ^= 0x01;
+  }
+
+  if (ntp_packet_sample(Answer, Exchange.T1 + 1, T4, &Sample) != NTP_PACKET_INVALID)
+  {
+    printf("Answer to an earlier request accepted\n");
+    ++Errors;
+  }
+
+  Answer[0] = (Answer[0] & 0xF8) | 3;
+  if (ntp_packet_sample(Answer, Exchange.T1, T4, &Sample) != NTP_PACKET_INVALID)
+  {
+    printf("Answer in client mode accepted\n");
+    ++Errors;
+  }
+
+  fake_server(Request, Answer, &Exchange, 3, 2);
+  if (ntp_packet_sample(Answer, Exchange.T1, T4, &Sample) != NTP_PACKET_INVALID)
+  {
+    printf("Answer from an unsynchronized server accepted\n");
+    ++Errors;
+  }
+
+  fake_server(Request, Answer, &Exchange, 3, 0);
+  memcpy(&Answer[NTP_OFFSET_REFERENCE], "RATE", 4);
+  if (ntp_packet_sample(Answer, Exchange.T1, T4, &Sample) != NTP_PACKET_KOD)
+  {
+    printf("Kiss-o'-death not recognized\n");
+    ++Errors;
+  }
+  Answer[NTP_OFFSET_ORIGINATE + 7] ^= 0x80;
+  if (ntp_packet_sample(Answer, Exchange.T1, T4, &Sample) != NTP_PACKET_INVALID)
+  {
+    printf("Kiss-o'-death accepted for another request\n");
+    ++Errors;
+  }
+
+  Exchange.Processing = 40000;  // longer than the round trip seen by the client.
+  fake_server(Request, Answer, &Exchange, 0, 2);
+  if ((ntp_packet_sample(Answer, Exchange.T1, T4, &Sample) != NTP_PACKET_SAMPLE) || (Sample.Delay != 0))
+  {
+    printf("Negative delay not clamped to 0 (%lld)\n", (long long)Sample.Delay);
+    ++Errors;
+  }
+  printf("Invalid answers and kiss-o'-death checked: %u errors.\n", Errors);
+
+
+  /* LAN NTP server, fixed cases: stratum 2 peer 1000 sec after the last sync (root dispersion 3 msec + 1000 * 15 usec). */
+  memcpy(Peer.Address, "\xC0\xA8\x01\x0A", 4);  // 192.168.1.10
+  Peer.Elapsed        = 1000000000LL;
+  Peer.FlagSynced     = 1;
+  Peer.RootDelay      = 25000;
+  Peer.RootDispersion = 3000;
+  Peer.Stratum        = 2;
+  Errors += serve_check(&Peer, 4, Exchange.T1, Exchange.Utc, Answer, 1);
+  if ((Answer[0] != 0x24) || (Answer[1] != 3) || (memcmp(&Answer[NTP_OFFSET_REFERENCE], "\xC0\xA8\x01\x0A", 4) != 0) ||
+      (memcmp(&Answer[NTP_OFFSET_ROOT_DELAY], "\x00\x00\x06\x66", 4) != 0) || (memcmp(&Answer[NTP_OFFSET_ROOT_DISP], "\x00\x00\x04\x9B", 4) != 0))
+  {
+    printf("Answer from a stratum 2 peer: header 0x%2.2X, stratum %u, root delay %2.2X%2.2X%2.2X%2.2X, root dispersion %2.2X%2.2X%2.2X%2.2X\n", Answer[0], Answer[1],
+           Answer[NTP_OFFSET_ROOT_DELAY], Answer[NTP_OFFSET_ROOT_DELAY + 1], Answer[NTP_OFFSET_ROOT_DELAY + 2], Answer[NTP_OFFSET_ROOT_DELAY + 3],
+           Answer[NTP_OFFSET_ROOT_DISP], Answer[NTP_OFFSET_ROOT_DISP + 1], Answer[NTP_OFFSET_ROOT_DISP + 2], Answer[NTP_OFFSET_ROOT_DISP + 3]);
+    ++Errors;
+  }
+  Errors += serve_check(&Peer, 3, Exchange.T1, Exchange.Utc, Answer, 1);
+
+  /* Stratum 15 peer: the answer stays at stratum 15. */
+  Peer.Stratum = 15;
+  Errors += serve_check(&Peer, 4, Exchange.T1, Exchange.Utc, Answer, 1);
+  if (Answer[1] != 15)
+  {
+    printf("Answer from a stratum 15 peer at stratum %u\n", Answer[1]);
+    ++Errors;
+  }
+
+  /* Root dispersion of 1 sec growing by 15 usec per second: unsynchronized after 1000000 sec, not one second earlier. */
+  Peer.Stratum        = 2;
+  Peer.RootDispersion = 1000000;
+  Peer.Elapsed        = 999999000000LL;
+  Errors += serve_check(&Peer, 4, Exchange.T1, Exchange.Utc, Answer, 1);
+  if ((Answer[0] >> 6) != 0)
+  {
+    printf("Unsynchronized %lld sec after the last sync\n", (long long)(Peer.Elapsed / 1000000LL));
+    ++Errors;
+  }
+  Peer.Elapsed = 1000000000000LL;
+  Errors += serve_check(&Peer, 4, Exchange.T1, Exchange.Utc, Answer, 1);
+  if (((Answer[0] >> 6) != 3) || (Answer[1] != 16) || (memcmp(&Answer[NTP_OFFSET_REFERENCE], "INIT", 4) != 0) || (memcmp(&Answer[NTP_OFFSET_ROOT_DISP], "\x00\x10\x00\x00", 4) != 0))
+  {
+    printf("Still synchronized %lld sec after the last sync (header 0x%2.2X, stratum %u)\n", (long long)(Peer.Elapsed / 1000000LL), Answer[0], Answer[1]);
+    ++Errors;
+  }
+
+  /* No sync since power-up. */
+  Peer.Elapsed    = 0;
+  Peer.FlagSynced = 0;
+  Errors += serve_check(&Peer, 4, Exchange.T1, Exchange.Utc, Answer, 1);
+  if (((Answer[0] >> 6) != 3) || (Answer[1] != 16) || (memcmp(&Answer[NTP_OFFSET_REFERENCE], "INIT", 4) != 0))
+  {
+    printf("Answer before the first sync: header 0x%2.2X, stratum %u\n", Answer[0], Answer[1]);
+    ++Errors;
+  }
+
+  /* Requests not answered: short packet, and every mode but client (3). */
+  make_request(Request, Exchange.T1);
+  if (ntp_packet_serve(Request, NTP_MSG_LEN - 1, Exchange.Utc, &Peer) != 0)
+  {
+    printf("Short request answered\n");
+    ++Errors;
+  }
+  for (Loop1UInt8 = 0; Loop1UInt8 < 8; ++Loop1UInt8)
+  {
+    if (Loop1UInt8 == 3) continue;
+    make_request(Request, Exchange.T1);
+    Request[0] = (Request[0] & 0xF8) | Loop1UInt8;
+    if (ntp_packet_serve(Request, NTP_MSG_LEN, Exchange.Utc, &Peer) != 0)
+    {
+      printf("Mode %u request answered\n", Loop1UInt8);
+      ++Errors;
+    }
+  }
+
+  /* Random requests and system peers (one out of eight before the first sync). */
+  for (Loop1UInt32 = 0; Loop1UInt32 < SERVE_COUNT; ++Loop1UInt32)
+  {
+    for (Loop1UInt8 = 0; Loop1UInt8 < 4; ++Loop1UInt8)
+      Peer.Address[Loop1UInt8] = random32() & 0xFF;
+    Peer.FlagSynced     = ((random32() % 8) != 0);
+    Peer.Elapsed        = Peer.FlagSynced ? (int64_t)random64(SERVE_ELAPSED_MAX) : 0;
+    Peer.RootDelay      = (int64_t)random64(1000000);
+    Peer.RootDispersion = (int64_t)random64(2000000);
+    Peer.Stratum        = 1 + (random32() % 15);
+    Errors += serve_check(&Peer, 3 + (random32() % 2), random64(1ULL << 45), SERVE_ELAPSED_MAX + random64(ERA1_END_US - (2 * SERVE_ELAPSED_MAX)), Answer, (Errors < 20));
+  }
+  printf("%lu requests to the LAN NTP server checked: %u errors in all.\n", SERVE_COUNT + 14, Errors);
+
+  return (Errors == 0) ? 0 : 1;
+}
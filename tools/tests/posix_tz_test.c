@@ -0,0 +1,268 @@
+/* ======================================================================== *\
+   posix_tz_test.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host test of the POSIX TZ rule engine (posix_tz.c) against the zoneinfo
+   database of the host.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   Each rule of DstRegion[] (Pico-Green-Clock.c) is compared with its
+   reference zoneinfo zone from 2026 to 2126: the UTC offset every hour,
+   and both sides of every transition, to the second. Rules are also
+   moved to other timezones of their region with tz_rebase(), as the
+   firmware does for the Timezone setting.
+
+   Asia/Gaza lists explicit (Ramadan-related) transitions up to 2086,
+   that the POSIX rule of its footer does not follow. It is compared
+   from 2087 on.
+
+   Returns 77 (skipped) when the host has no zoneinfo database.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "civil_time.h"
+#include "posix_tz.h"
+
+
+#define FIRST_YEAR          2026
+#define LAST_YEAR           2126
+#define TEST_SKIPPED        77
+#define TIME_STEP           3600         // offsets are compared every hour, transitions are found to the second.
+
+
+/* A rule and the zoneinfo zone it must match. */
+struct tz_case
+{
+  const char *Rule;                      // POSIX TZ string, as in DstRegion[].
+  int32_t     StdOffset;                 // standard offset given to tz_rebase() (seconds east of UTC), or NO_REBASE.
+  uint8_t     FlagUtc;                   // as in DstRegion[].
+  const char *Zone;                      // zoneinfo reference zone.
+  uint16_t    FirstYear;                 // first year compared.
+};
+#define NO_REBASE           INT32_MIN
+
+
+static const struct tz_case Case[] =
+{
+  /* Rules of DstRegion[], in their reference zone. */
+  {"UTC0",                                  NO_REBASE,  0, "Etc/UTC",             FIRST_YEAR},
+  {"AEST-10AEDT,M10.1.0,M4.1.0/3",          NO_REBASE,  0, "Australia/Sydney",    FIRST_YEAR},
+  {"<+1030>-10:30<+11>-11,M10.1.0,M4.1.0",  NO_REBASE,  0, "Australia/Lord_Howe", FIRST_YEAR},
+  {"<-04>4<-03>,M9.1.6/24,M4.1.6/24",       NO_REBASE,  0, "America/Santiago",    FIRST_YEAR},
+  {"CST5CDT,M3.2.0/0,M11.1.0/1",            NO_REBASE,  0, "America/Havana",      FIRST_YEAR},
+  {"CET-1CEST,M3.5.0,M10.5.0/3",            NO_REBASE,  1, "Europe/Paris",        FIRST_YEAR},
+  {"IST-2IDT,M3.4.4/26,M10.5.0",            NO_REBASE,  0, "Asia/Jerusalem",      FIRST_YEAR},
+  {"EET-2EEST,M3.5.0/0,M10.5.0/0",          NO_REBASE,  0, "Asia/Beirut",         FIRST_YEAR},
+  {"EET-2EEST,M3.5.0,M10.5.0/3",            NO_REBASE,  0, "Europe/Chisinau",     FIRST_YEAR},
+  {"NZST-12NZDT,M9.5.0,M4.1.0/3",           NO_REBASE,  0, "Pacific/Auckland",    FIRST_YEAR},
+  {"EST5EDT,M3.2.0,M11.1.0",                NO_REBASE,  0, "America/New_York",    FIRST_YEAR},
+  {"EET-2EEST,M3.4.4/50,M10.4.4/50",        NO_REBASE,  0, "Asia/Gaza",           2087},
+  {"<-03>3",                                NO_REBASE,  0, "America/Asuncion",    FIRST_YEAR},
+
+  /* Rules moved to other timezones of their region (see set_dst_rule() in Pico-Green-Clock.c). */
+  {"CET-1CEST,M3.5.0,M10.5.0/3",            0,          1, "Europe/London",       FIRST_YEAR},
+  {"CET-1CEST,M3.5.0,M10.5.0/3",            7200,       1, "Europe/Helsinki",     FIRST_YEAR},
+  {"EST5EDT,M3.2.0,M11.1.0",                -21600,     0, "America/Chicago",     FIRST_YEAR},
+  {"EST5EDT,M3.2.0,M11.1.0",                -28800,     0, "America/Los_Angeles", FIRST_YEAR},
+  {"EST5EDT,M3.2.0,M11.1.0",                -12600,     0, "America/St_Johns",    FIRST_YEAR},
+  {"AEST-10AEDT,M10.1.0,M4.1.0/3",          34200,      0, "Australia/Adelaide",  FIRST_YEAR},
+};
+#define CASE_COUNT          (sizeof(Case) / sizeof(Case[0]))
+
+
+static int64_t find_transition(int64_t Low, int64_t High, int64_t (*Offset)(void *, int64_t), void *Context);
+static int64_t engine_offset(void *Context, int64_t UtcTime);
+static int64_t zoneinfo_offset(void *Context, int64_t UtcTime);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=engine_offset() */
+/* ------------------------------------------------------------------ *\
+                 UTC offset given by the rule engine.
+\* ------------------------------------------------------------------ */
+static int64_t engine_offset(void *Context, int64_t UtcTime)
+{
+  return tz_offset((struct tz_cache *)Context, UtcTime);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=find_transition() */
+/* ------------------------------------------------------------------ *\
+        Return the first second of ]Low, High] where the offset is no
+        longer the one at Low (there is one transition at most between
+                         two hourly samples).
+\* ------------------------------------------------------------------ */
+static int64_t find_transition(int64_t Low, int64_t High, int64_t (*Offset)(void *, int64_t), void *Context)
+{
+  int64_t Middle;
+  int64_t LowOffset;
+
+
+  LowOffset = Offset(Context, Low);
+  while ((High - Low) > 1)
+  {
+    Middle = Low + ((High - Low) / 2);
+    if (Offset(Context, Middle) == LowOffset)
+      Low = Middle;
+    else
+      High = Middle;
+  }
+
+  return High;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=zoneinfo_offset() */
+/* ------------------------------------------------------------------ *\
+       UTC offset given by the host C library for the zone of TZ.
+\* ------------------------------------------------------------------ */
+static int64_t zoneinfo_offset(void *Context, int64_t UtcTime)
+{
+  time_t Time;
+  struct tm Tm;
+
+
+  (void)Context;
+  Time = (time_t)UtcTime;
+  localtime_r(&Time, &Tm);
+
+  return Tm.tm_gmtoff;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                              Main test.
+\* ------------------------------------------------------------------ */
+int main(void)
+{
+  uint8_t  Loop1UInt8;
+  uint8_t  Loop2UInt8;
+  uint32_t Errors;
+  uint32_t Transitions;
+  int64_t  Current[2];
+  int64_t  Edge[2];
+  int64_t  End;
+  int64_t  Previous[2];
+  int64_t  Start;
+  int64_t  Time;
+  char     ZoneFile[128];
+  char     ZoneName[64];
+
+  struct tz_cache Cache;
+
+
+  if (access("/usr/share/zoneinfo/Europe/Paris", R_OK) != 0)
+  {
+    printf("No zoneinfo database on this host, test skipped.\n");
+    return TEST_SKIPPED;
+  }
+
+  Errors = 0;
+  for (Loop1UInt8 = 0; Loop1UInt8 < CASE_COUNT; ++Loop1UInt8)
+  {
+    snprintf(ZoneFile, sizeof(ZoneFile), "/usr/share/zoneinfo/%s", Case[Loop1UInt8].Zone);
+    if (access(ZoneFile, R_OK) != 0)
+    {
+      printf("%-20s missing from zoneinfo, not compared.\n", Case[Loop1UInt8].Zone);
+      continue;
+    }
+
+    snprintf(ZoneName, sizeof(ZoneName), ":%s", Case[Loop1UInt8].Zone);
+    setenv("TZ", ZoneName, 1);
+    tzset();
+
+    if (tz_parse(Case[Loop1UInt8].Rule, &Cache.Rule) != 0)
+    {
+      printf("%-20s invalid rule \"%s\".\n", Case[Loop1UInt8].Zone, Case[Loop1UInt8].Rule);
+      ++Errors;
+      continue;
+    }
+    if (Case[Loop1UInt8].StdOffset != NO_REBASE)
+      tz_rebase(&Cache.Rule, Case[Loop1UInt8].StdOffset, Case[Loop1UInt8].FlagUtc);
+    tz_prepare(&Cache, Case[Loop1UInt8].FirstYear);
+
+    Start       = (int64_t)civil_days(Case[Loop1UInt8].FirstYear, 1, 1) * CIVIL_SECONDS_PER_DAY;
+    End         = (int64_t)civil_days(LAST_YEAR + 1, 1, 1) * CIVIL_SECONDS_PER_DAY;
+    Transitions = 0;
+    Previous[0] = engine_offset(&Cache, Start);
+    Previous[1] = zoneinfo_offset(NULL, Start);
+
+    for (Time = Start; Time < End; Time += TIME_STEP)
+    {
+      Current[0] = engine_offset(&Cache, Time);
+      Current[1] = zoneinfo_offset(NULL, Time);
+      if (Current[0] != Current[1])
+      {
+        if (Errors < 20)
+          printf("%-20s %lld: offset %lld, zoneinfo %lld\n", Case[Loop1UInt8].Zone, (long long)Time, (long long)Current[0], (long long)Current[1]);
+        ++Errors;
+      }
+
+      /* A transition on either side since previous sample: both sides must change on the same second. */
+      Edge[0] = (Current[0] != Previous[0]) ? find_transition(Time - TIME_STEP, Time, engine_offset, &Cache) : 0;
+      Edge[1] = (Current[1] != Previous[1]) ? find_transition(Time - TIME_STEP, Time, zoneinfo_offset, NULL) : 0;
+      for (Loop2UInt8 = 0; Loop2UInt8 < 2; ++Loop2UInt8)
+      {
+        if (Edge[Loop2UInt8] == 0) continue;
+
+        if ((engine_offset(&Cache, Edge[Loop2UInt8] - 1) != zoneinfo_offset(NULL, Edge[Loop2UInt8] - 1)) ||
+            (engine_offset(&Cache, Edge[Loop2UInt8]) != zoneinfo_offset(NULL, Edge[Loop2UInt8])))
+        {
+          if (Errors < 20)
+            printf("%-20s transition at %lld: offset %lld, zoneinfo %lld\n", Case[Loop1UInt8].Zone, (long long)Edge[Loop2UInt8], (long long)engine_offset(&Cache, Edge[Loop2UInt8]), (long long)zoneinfo_offset(NULL, Edge[Loop2UInt8]));
+          ++Errors;
+        }
+      }
+      if (Edge[1]) ++Transitions;
+
+      Previous[0] = Current[0];
+      Previous[1] = Current[1];
+    }
+
+    printf("%-20s %-40s %u-%u: %u transitions compared.\n", Case[Loop1UInt8].Zone, Case[Loop1UInt8].Rule, Case[Loop1UInt8].FirstYear, LAST_YEAR, Transitions);
+  }
+
+  printf("%u errors.\n", Errors);
+
+  return (Errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,589 @@
+/* ======================================================================== *\
+   recurrence_test.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host test of the recurrence rules (recurrence.c) against a brute-force
+   expansion.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   A few rules of the examples of recurrence.h are checked against dates
+   found by hand. Then RULE_COUNT random rules (FREQ, INTERVAL, COUNT,
+   UNTIL, BYMONTH, BYMONTHDAY and BYDAY with or without ordinals) are
+   expanded over HORIZON_YEARS years from a random start, one day at a
+   time, with the calendar of the host C library. recur_next() must give
+   the same occurrences, both when called from one occurrence to the next
+   and when called with random times in random order (which moves the
+   cursor of COUNT rules back and forth).
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "recurrence.h"
+
+
+#define HORIZON_YEARS       10           // years of occurrences expanded for each random rule.
+#define MAX_OCCURRENCES     4000         // more than the days of HORIZON_YEARS years.
+#define RANDOM_AFTER        40           // random times given to recur_next() for each rule.
+#define RULE_COUNT          3000
+#define SECONDS_PER_DAY     86400L
+
+
+/* Calendar of one day, from the host C library. Ordinals count the same day-of-week from the beginning (1 = first)
+   or from the end (1 = last) of the month and of the year. */
+struct day_info
+{
+  uint16_t Year;
+  uint8_t  Month;
+  uint8_t  DayOfMonth;
+  uint8_t  DayOfWeek;
+  uint8_t  LastDayOfMonth;               // 1 on the last day of the month, 2 the day before, ...
+  uint8_t  NthInMonth;
+  uint8_t  NthLastInMonth;
+  uint8_t  NthInYear;
+  uint8_t  NthLastInYear;
+};
+
+/* Random rule, before it is written as a string. */
+struct test_rule
+{
+  uint8_t  Freq;
+  uint8_t  Interval;
+  uint16_t Count;
+  int32_t  UntilDay;                     // -1 = no UNTIL.
+  uint16_t ByMonth;
+  uint8_t  MonthDayCount;
+  int8_t   MonthDay[3];
+  uint8_t  ByDayCount;
+  int8_t   Ordinal[3];
+  uint8_t  Weekday[3];
+};
+
+/* Rules of the examples of recurrence.h, with the occurrence expected from a given start. */
+struct fixed_case
+{
+  const char *Rule;
+  const char *Start;                     // YYYYMMDD, at 00:00:00.
+  uint16_t    Nth;                       // occurrence checked (1 = first).
+  const char *Expected;                  // YYYYMMDD, or NULL for no such occurrence.
+};
+
+
+static const struct fixed_case Fixed[] =
+{
+  {"FREQ=YEARLY;BYMONTH=5;BYDAY=2SU",                 "20260101",  1, "20260510"},
+  {"FREQ=YEARLY;BYMONTH=5;BYDAY=2SU",                 "20260101",  2, "20270509"},
+  {"FREQ=YEARLY;BYMONTH=2;BYMONTHDAY=-1",             "20270301",  1, "20280229"},
+  {"FREQ=MONTHLY;BYDAY=-1FR;COUNT=12",                "20260101",  1, "20260130"},
+  {"FREQ=MONTHLY;BYDAY=-1FR;COUNT=12",                "20260101", 12, "20261225"},
+  {"FREQ=MONTHLY;BYDAY=-1FR;COUNT=12",                "20260101", 13, NULL},
+  {"FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,TH;UNTIL=20301231", "20301201", 1, "20301209"},
+  {"FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,TH;UNTIL=20301231", "20301201", 4, "20301226"},
+  {"FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,TH;UNTIL=20301231", "20301201", 5, NULL},
+};
+#define FIXED_COUNT         (sizeof(Fixed) / sizeof(Fixed[0]))
+
+
+static const char DayName[7][3] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+static const char *FreqName[4]  = {"DAILY", "WEEKLY", "MONTHLY", "YEARLY"};
+
+static struct day_info *Calendar;        // one entry per day since 01-JAN-1970.
+static int32_t          CalendarDays;
+
+
+static void     build_calendar(void);
+static int32_t  day_of(const char *Date);
+static uint32_t expand(const struct test_rule *Test, int64_t Start, int32_t LastDay, int64_t *Occurrence, uint8_t *FlagEnded);
+static uint8_t  matches(const struct test_rule *Test, int32_t StartDay, int32_t Day);
+static void     random_rule(struct test_rule *Test, int32_t StartDay, int32_t LastDay);
+static uint32_t random32(void);
+static void     write_rule(const struct test_rule *Test, char *String, size_t Size);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=build_calendar() */
+/* ------------------------------------------------------------------ *\
+        Fill Calendar[] from 01-JAN-1970 to 31-DEC-2199 with gmtime_r().
+        Ordinals are counted forward, then backward, day by day.
+\* ------------------------------------------------------------------ */
+static void build_calendar(void)
+{
+  uint8_t  InMonth[7];
+  uint8_t  InYear[7];
+  uint8_t  Loop1UInt8;
+  uint8_t  MonthDays;
+  int32_t  Day;
+  time_t   Time;
+
+  struct tm Tm;
+
+
+  CalendarDays = day_of("22000101");
+  Calendar     = calloc((size_t)CalendarDays, sizeof(*Calendar));
+
+  for (Day = 0; Day < CalendarDays; ++Day)
+  {
+    Time = (time_t)Day * SECONDS_PER_DAY;
+    gmtime_r(&Time, &Tm);
+    Calendar[Day].Year       = (uint16_t)(Tm.tm_year + 1900);
+    Calendar[Day].Month      = (uint8_t)(Tm.tm_mon + 1);
+    Calendar[Day].DayOfMonth = (uint8_t)Tm.tm_mday;
+    Calendar[Day].DayOfWeek  = (uint8_t)Tm.tm_wday;
+
+    if (Tm.tm_yday == 0) memset(InYear, 0, sizeof(InYear));
+    if (Tm.tm_mday == 1) memset(InMonth, 0, sizeof(InMonth));
+    Calendar[Day].NthInMonth = ++InMonth[Tm.tm_wday];
+    Calendar[Day].NthInYear  = ++InYear[Tm.tm_wday];
+  }
+
+  MonthDays = 0;
+  for (Day = CalendarDays - 1; Day >= 0; --Day)
+  {
+    if ((Day == (CalendarDays - 1)) || (Calendar[Day + 1].Year != Calendar[Day].Year)) memset(InYear, 0, sizeof(InYear));
+    if ((Day == (CalendarDays - 1)) || (Calendar[Day + 1].Month != Calendar[Day].Month))
+    {
+      memset(InMonth, 0, sizeof(InMonth));
+      MonthDays = 0;
+    }
+    Loop1UInt8 = Calendar[Day].DayOfWeek;
+    Calendar[Day].NthLastInMonth = ++InMonth[Loop1UInt8];
+    Calendar[Day].NthLastInYear  = ++InYear[Loop1UInt8];
+    Calendar[Day].LastDayOfMonth = ++MonthDays;
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=day_of() */
+/* ------------------------------------------------------------------ *\
+           Number of days since 01-JAN-1970 of a "YYYYMMDD" date.
+\* ------------------------------------------------------------------ */
+static int32_t day_of(const char *Date)
+{
+  long Value;
+  struct tm Tm;
+
+
+  Value = strtol(Date, NULL, 10);
+  memset(&Tm, 0, sizeof(Tm));
+  Tm.tm_year = (int)(Value / 10000) - 1900;
+  Tm.tm_mon  = (int)((Value / 100) % 100) - 1;
+  Tm.tm_mday = (int)(Value % 100);
+
+  return (int32_t)(timegm(&Tm) / SECONDS_PER_DAY);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=expand() */
+/* ------------------------------------------------------------------ *\
+      Brute-force expansion of a rule, from the start to LastDay.
+       Return the number of occurrences and set FlagEnded when the
+       rule has no other occurrence at all (COUNT or UNTIL reached).
+\* ------------------------------------------------------------------ */
+static uint32_t expand(const struct test_rule *Test, int64_t Start, int32_t LastDay, int64_t *Occurrence, uint8_t *FlagEnded)
+{
+  int32_t  Day;
+  int32_t  StartDay;
+  uint32_t Found;
+
+
+  StartDay   = (int32_t)(Start / SECONDS_PER_DAY);
+  Found      = 0;
+  *FlagEnded = ((Test->UntilDay >= 0) && (Test->UntilDay <= LastDay));
+
+  for (Day = StartDay; Day <= LastDay; ++Day)
+  {
+    if ((Test->UntilDay >= 0) && (Day > Test->UntilDay)) break;
+    if (matches(Test, StartDay, Day) == 0) continue;
+
+    Occurrence[Found++] = ((int64_t)Day * SECONDS_PER_DAY) + (Start % SECONDS_PER_DAY);
+    if (Found == Test->Count)
+    {
+      *FlagEnded = 1;
+      break;
+    }
+  }
+
+  return Found;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=matches() */
+/* ------------------------------------------------------------------ *\
+      Return 1 if Day is an occurrence of the rule (COUNT and UNTIL
+                        aside), 0 otherwise.
+\* ------------------------------------------------------------------ */
+static uint8_t matches(const struct test_rule *Test, int32_t StartDay, int32_t Day)
+{
+  uint8_t  Loop1UInt8;
+  uint8_t  Nth;
+  uint8_t  NthLast;
+  int32_t  Period;
+
+  const struct day_info *Info;
+  const struct day_info *First;
+
+
+  Info  = &Calendar[Day];
+  First = &Calendar[StartDay];
+
+  /* INTERVAL: periods counted from the one of the start, weeks beginning on Monday. */
+  switch (Test->Freq)
+  {
+    case (RECUR_DAILY):
+      Period = Day - StartDay;
+    break;
+
+    case (RECUR_WEEKLY):
+      Period = (Day - (StartDay - ((First->DayOfWeek + 6) % 7))) / 7;
+    break;
+
+    case (RECUR_MONTHLY):
+      Period = ((Info->Year * 12) + Info->Month) - ((First->Year * 12) + First->Month);
+    break;
+
+    default:
+      Period = Info->Year - First->Year;
+    break;
+  }
+  if ((Period % Test->Interval) != 0) return 0;
+
+  /* Months. */
+  if (Test->ByMonth)
+  {
+    if (((Test->ByMonth >> Info->Month) & 0x01) == 0) return 0;
+  }
+  else if ((Test->Freq == RECUR_YEARLY) && (Test->MonthDayCount == 0) && (Test->ByDayCount == 0))
+  {
+    if (Info->Month != First->Month) return 0;
+  }
+
+  /* Days. */
+  if (Test->MonthDayCount)
+  {
+    for (Loop1UInt8 = 0; Loop1UInt8 < Test->MonthDayCount; ++Loop1UInt8)
+    {
+      if ((Test->MonthDay[Loop1UInt8] > 0) && (Info->DayOfMonth == Test->MonthDay[Loop1UInt8])) break;
+      if ((Test->MonthDay[Loop1UInt8] < 0) && (Info->LastDayOfMonth == -Test->MonthDay[Loop1UInt8])) break;
+    }
+    if (Loop1UInt8 == Test->MonthDayCount) return 0;
+  }
+
+  if (Test->ByDayCount)
+  {
+    if ((Test->Freq == RECUR_YEARLY) && (Test->ByMonth == 0))
+    {
+      Nth     = Info->NthInYear;
+      NthLast = Info->NthLastInYear;
+    }
+    else
+    {
+      Nth     = Info->NthInMonth;
+      NthLast = Info->NthLastInMonth;
+    }
+
+    for (Loop1UInt8 = 0; Loop1UInt8 < Test->ByDayCount; ++Loop1UInt8)
+    {
+      if (Info->DayOfWeek != Test->Weekday[Loop1UInt8]) continue;
+      if ((Test->Ordinal[Loop1UInt8] == 0) || (Test->Ordinal[Loop1UInt8] == Nth) || (Test->Ordinal[Loop1UInt8] == -NthLast)) break;
+    }
+    if (Loop1UInt8 == Test->ByDayCount) return 0;
+  }
+
+  /* No BYxxx part to select days: same day as the start. */
+  if ((Test->MonthDayCount == 0) && (Test->ByDayCount == 0))
+  {
+    if ((Test->Freq == RECUR_WEEKLY) && (Info->DayOfWeek != First->DayOfWeek)) return 0;
+    if ((Test->Freq >= RECUR_MONTHLY) && (Info->DayOfMonth != First->DayOfMonth)) return 0;
+  }
+
+  return 1;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random_rule() */
+/* ------------------------------------------------------------------ *\
+       Draw a random rule, among those accepted by recur_parse().
+\* ------------------------------------------------------------------ */
+static void random_rule(struct test_rule *Test, int32_t StartDay, int32_t LastDay)
+{
+  uint8_t Loop1UInt8;
+
+
+  memset(Test, 0, sizeof(*Test));
+  Test->Freq     = (uint8_t)((random32() % 4) + 1);
+  Test->Interval = ((random32() % 2) == 0) ? 1 : (uint8_t)((random32() % 4) + 2);
+  Test->Count    = ((random32() % 5) < 2) ? (uint16_t)((random32() % 60) + 1) : 0;
+  Test->UntilDay = ((random32() % 4) == 0) ? StartDay + (int32_t)(random32() % (uint32_t)(LastDay - StartDay + 1)) : -1;
+
+  if ((random32() % 3) == 0)
+    for (Loop1UInt8 = 0; Loop1UInt8 < 3; ++Loop1UInt8)
+      Test->ByMonth |= (uint16_t)(1 << ((random32() % 12) + 1));
+
+  /* BYMONTHDAY, not allowed with WEEKLY. */
+  if ((Test->Freq != RECUR_WEEKLY) && ((random32() % 3) == 0))
+  {
+    Test->MonthDayCount = (uint8_t)((random32() % 3) + 1);
+    for (Loop1UInt8 = 0; Loop1UInt8 < Test->MonthDayCount; ++Loop1UInt8)
+    {
+      Test->MonthDay[Loop1UInt8] = (int8_t)((random32() % 31) + 1);
+      if (random32() % 2) Test->MonthDay[Loop1UInt8] = -Test->MonthDay[Loop1UInt8];
+    }
+  }
+
+  /* BYDAY, ordinals only with MONTHLY and YEARLY. */
+  if ((random32() % 5) < 2)
+  {
+    Test->ByDayCount = (uint8_t)((random32() % 3) + 1);
+    for (Loop1UInt8 = 0; Loop1UInt8 < Test->ByDayCount; ++Loop1UInt8)
+    {
+      Test->Weekday[Loop1UInt8] = (uint8_t)(random32() % 7);
+      if ((Test->Freq >= RECUR_MONTHLY) && (random32() % 2))
+      {
+        Test->Ordinal[Loop1UInt8] = (int8_t)((random32() % 5) + 1);
+        if (random32() % 2) Test->Ordinal[Loop1UInt8] = -Test->Ordinal[Loop1UInt8];
+      }
+    }
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random32() */
+/* ------------------------------------------------------------------ *\
+      Pseudo-random numbers (xorshift), same sequence on every run.
+\* ------------------------------------------------------------------ */
+static uint32_t random32(void)
+{
+  static uint32_t State = 2463534242UL;
+
+
+  State ^= State << 13;
+  State ^= State >> 17;
+  State ^= State << 5;
+
+  return State;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=write_rule() */
+/* ------------------------------------------------------------------ *\
+                  Write a random rule as an RRULE string.
+\* ------------------------------------------------------------------ */
+static void write_rule(const struct test_rule *Test, char *String, size_t Size)
+{
+  uint8_t Loop1UInt8;
+  size_t  Length;
+
+  const struct day_info *Until;
+
+
+  Length = (size_t)snprintf(String, Size, "FREQ=%s", FreqName[Test->Freq - 1]);
+  if (Test->Interval > 1)
+    Length += (size_t)snprintf(&String[Length], Size - Length, ";INTERVAL=%u", Test->Interval);
+  if (Test->Count)
+    Length += (size_t)snprintf(&String[Length], Size - Length, ";COUNT=%u", Test->Count);
+  if (Test->UntilDay >= 0)
+  {
+    Until   = &Calendar[Test->UntilDay];
+    Length += (size_t)snprintf(&String[Length], Size - Length, ";UNTIL=%4.4u%2.2u%2.2u", Until->Year, Until->Month, Until->DayOfMonth);
+  }
+
+  for (Loop1UInt8 = 1; Loop1UInt8 <= 12; ++Loop1UInt8)
+    if ((Test->ByMonth >> Loop1UInt8) & 0x01)
+      Length += (size_t)snprintf(&String[Length], Size - Length, "%s%u", (Test->ByMonth & ((1 << Loop1UInt8) - 1)) ? "," : ";BYMONTH=", Loop1UInt8);
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < Test->MonthDayCount; ++Loop1UInt8)
+    Length += (size_t)snprintf(&String[Length], Size - Length, "%s%d", Loop1UInt8 ? "," : ";BYMONTHDAY=", Test->MonthDay[Loop1UInt8]);
+
+  for (Loop1UInt8 = 0; Loop1UInt8 < Test->ByDayCount; ++Loop1UInt8)
+  {
+    Length += (size_t)snprintf(&String[Length], Size - Length, "%s", Loop1UInt8 ? "," : ";BYDAY=");
+    if (Test->Ordinal[Loop1UInt8])
+      Length += (size_t)snprintf(&String[Length], Size - Length, "%d", Test->Ordinal[Loop1UInt8]);
+    Length += (size_t)snprintf(&String[Length], Size - Length, "%s", DayName[Test->Weekday[Loop1UInt8]]);
+  }
+
+  return;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                              Main test.
+\* ------------------------------------------------------------------ */
+int main(void)
+{
+  uint8_t  FlagEnded;
+  uint16_t Loop1UInt16;
+  uint16_t Loop2UInt16;
+  uint32_t Compared;
+  uint32_t Errors;
+  uint32_t Found;
+  uint32_t Loop1UInt32;
+  int32_t  LastDay;
+  int32_t  StartDay;
+  int64_t  After;
+  int64_t  Expected;
+  int64_t  LastTime;
+  int64_t  Next;
+  int64_t  Start;
+  char     String[160];
+
+  struct recur_rule Rule;
+  struct test_rule  Test;
+
+  static int64_t Occurrence[MAX_OCCURRENCES];
+
+
+  build_calendar();
+  Errors   = 0;
+  Compared = 0;
+
+  /* Examples of recurrence.h. */
+  for (Loop1UInt16 = 0; Loop1UInt16 < FIXED_COUNT; ++Loop1UInt16)
+  {
+    if (recur_parse(Fixed[Loop1UInt16].Rule, (int64_t)day_of(Fixed[Loop1UInt16].Start) * SECONDS_PER_DAY, &Rule) != 0)
+    {
+      printf("\"%s\" rejected\n", Fixed[Loop1UInt16].Rule);
+      ++Errors;
+      continue;
+    }
+
+    Next = Rule.Start - 1;
+    for (Loop2UInt16 = 0; (Loop2UInt16 < Fixed[Loop1UInt16].Nth) && (Next != RECUR_NONE); ++Loop2UInt16)
+      Next = recur_next(&Rule, Next);
+
+    Expected = (Fixed[Loop1UInt16].Expected == NULL) ? RECUR_NONE : (int64_t)day_of(Fixed[Loop1UInt16].Expected) * SECONDS_PER_DAY;
+    if (Next != Expected)
+    {
+      printf("\"%s\" from %s: occurrence %u is %lld, expected %s\n", Fixed[Loop1UInt16].Rule, Fixed[Loop1UInt16].Start, Fixed[Loop1UInt16].Nth, (long long)Next, (Fixed[Loop1UInt16].Expected == NULL) ? "none" : Fixed[Loop1UInt16].Expected);
+      ++Errors;
+    }
+  }
+  printf("%u examples of recurrence.h checked: %u errors.\n", (unsigned)FIXED_COUNT, Errors);
+
+
+  /* Random rules against the brute-force expansion. */
+  for (Loop1UInt32 = 0; Loop1UInt32 < RULE_COUNT; ++Loop1UInt32)
+  {
+    StartDay = day_of("20200101") + (int32_t)(random32() % (uint32_t)(day_of("21900101") - day_of("20200101")));
+    Start    = ((int64_t)StartDay * SECONDS_PER_DAY) + (random32() % SECONDS_PER_DAY);
+    LastDay  = StartDay + (HORIZON_YEARS * 365) + (HORIZON_YEARS / 4);
+    LastTime = ((int64_t)LastDay * SECONDS_PER_DAY) + SECONDS_PER_DAY - 1;
+
+    random_rule(&Test, StartDay, LastDay);
+    write_rule(&Test, String, sizeof(String));
+    Found = expand(&Test, Start, LastDay, Occurrence, &FlagEnded);
+
+    if (recur_parse(String, Start, &Rule) != 0)
+    {
+      if (Errors < 20) printf("\"%s\" rejected\n", String);
+      ++Errors;
+      continue;
+    }
+
+    /* From one occurrence to the next. */
+    Next = Start - 1;
+    for (Loop1UInt16 = 0; Loop1UInt16 <= Found; ++Loop1UInt16)
+    {
+      Next = recur_next(&Rule, Next);
+      ++Compared;
+
+      if (Loop1UInt16 < Found)
+        Expected = Occurrence[Loop1UInt16];
+      else
+        Expected = ((FlagEnded == 0) && ((Next == RECUR_NONE) || (Next > LastTime))) ? Next : RECUR_NONE;  // beyond the horizon, unless COUNT or UNTIL was reached.
+
+      if (Next != Expected)
+      {
+        if (Errors < 20)
+          printf("\"%s\" from %lld: occurrence %u is %lld, expected %lld\n", String, (long long)Start, Loop1UInt16 + 1, (long long)Next, (long long)Expected);
+        ++Errors;
+        break;
+      }
+      if (Next == RECUR_NONE) break;
+    }
+
+    /* Random times, in random order. */
+    for (Loop1UInt16 = 0; Loop1UInt16 < RANDOM_AFTER; ++Loop1UInt16)
+    {
+      After = Start - (30L * SECONDS_PER_DAY) + (int64_t)(random32() % (uint32_t)(LastTime - Start + (30L * SECONDS_PER_DAY)));
+      Next  = recur_next(&Rule, After);
+      ++Compared;
+
+      for (Loop2UInt16 = 0; (Loop2UInt16 < Found) && (Occurrence[Loop2UInt16] <= After); ++Loop2UInt16);
+      if (Loop2UInt16 < Found)
+        Expected = Occurrence[Loop2UInt16];
+      else
+        Expected = ((FlagEnded == 0) && ((Next == RECUR_NONE) || (Next > LastTime))) ? Next : RECUR_NONE;  // beyond the horizon, unless COUNT or UNTIL was reached.
+
+      if (Next != Expected)
+      {
+        if (Errors < 20)
+          printf("\"%s\" from %lld: first occurrence after %lld is %lld, expected %lld\n", String, (long long)Start, (long long)After, (long long)Next, (long long)Expected);
+        ++Errors;
+      }
+    }
+  }
+  printf("%u random rules expanded over %u years, %u calls to recur_next() compared: %u errors.\n", RULE_COUNT, HORIZON_YEARS, Compared, Errors);
+
+  free(Calendar);
+
+  return (Errors == 0) ? 0 : 1;
+}
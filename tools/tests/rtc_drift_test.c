@@ -0,0 +1,304 @@
+/* ======================================================================== *\
+   rtc_drift_test.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host model of the DS3231 drift response, to test the aging offset
+   trim of the real-time clock IC (rtc_drift.c) in closed loop.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   The DS3231 model runs on TCXO conversions (every 64 seconds). At each
+   one, its frequency error (in ppb) is its initial error, plus crystal
+   aging since power-up, plus a daily temperature residual of the TCXO
+   compensation, plus conversion noise (up to +/- CONVERSION_NOISE),
+   minus the aging offset register times the sensitivity of the model.
+   The sensitivity is not always the RTC_AGING_STEP the trim assumes
+   (it depends on temperature and on the part). A new aging offset is
+   used from the next conversion on.
+
+   The clock is followed as the firmware handles it. NTP syncs come
+   every 17 minutes to 36 hours (poll intervals of ntp_poll_update()),
+   with an error of the NTP offset up to +/- the noise of the case. At
+   a sync where rtc_drift_due() allows it, rtc_drift_measure() finds
+   the second change of the RTC IC (the phase edge, seen up to
+   EDGE_POLL late by its polling loop) and gives its error to
+   rtc_drift_update(). Then rtc_write_time() writes the RTC IC
+   WRITE_DELAY after the next second (which restarts its second
+   countdown), and rtc_drift_start() gives its error START_DELAY later
+   to rtc_drift_written().
+
+   Each clock runs SIMULATION_DAYS. The loop must converge: once
+   SETTLE_DAYS are over, the frequency error of the RTC IC (without
+   the temperature residual and the noise) must stay below
+   RESIDUAL_LIMIT. It must not toggle: once SETTLE_DAYS are over, the
+   aging offset may only turn back to follow crystal aging, and only
+   change as often as crystal aging requires.
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#define _DEFAULT_SOURCE
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "rtc_drift.h"
+
+
+#define CONVERSION             (64 * 1000000LL)  // TCXO conversion period of the DS3231 (in usec).
+#define CONVERSION_NOISE       30           // frequency noise (in ppb) of one TCXO conversion.
+#define DAY                    (86400 * 1000000LL)
+#define EDGE_POLL              400          // time (in usec) between two reads of the RTC IC by the polling loop of rtc_drift_measure().
+#define RESIDUAL_LIMIT         150          // frequency error (in ppb) allowed once SETTLE_DAYS are over (3/4 step, plus crystal aging and noise over a measurement).
+#define SETTLE_DAYS            30
+#define SIMULATION_DAYS        180
+#define START_DELAY            50           // time (in usec) from the write of the RTC IC to rtc_drift_start().
+#define PICO_START             1000000LL    // Pico timer value (in usec) at true time 0.
+#define POLL_MAX               17           // longest NTP poll interval (log2 of seconds).
+#define POLL_MIN               10           // shortest NTP poll interval simulated (log2 of seconds).
+#define TIME_BASE_PHASE        2000         // as in Pico-Green-Clock.c.
+#define WRITE_DELAY            300          // time (in usec) from timer_callback_s() to the write of the RTC IC.
+
+
+/* One simulated DS3231. */
+struct sim_case
+{
+  double Initial;              // initial frequency error of the TCXO (in ppb, positive: RTC IC runs fast).
+  double Sensitivity;          // frequency change (in ppb) for one step of the aging offset.
+  double AgingRate;            // crystal aging (in ppb per day).
+  double Temperature;          // daily temperature residual of the TCXO compensation (in ppb).
+  int32_t Noise;               // maximum error (in usec) of the NTP offset.
+};
+
+static const struct sim_case Case[] =
+{
+  { 1950.0, 100.0,  0.0,   0.0,  1000},
+  { 1950.0, 100.0,  0.0,   0.0, 10000},
+  {-1950.0, 100.0,  0.0,   0.0, 10000},
+  {  -30.0, 100.0,  0.0,   0.0, 10000},
+  {   74.0, 100.0,  0.0,   0.0,  1000},
+  {   74.0, 100.0,  0.0,   0.0, 10000},
+  {  740.0,  70.0,  0.0,   0.0, 10000},
+  { 1950.0,  70.0,  0.0,   0.0, 10000},
+  { 1950.0, 130.0,  0.0,   0.0, 10000},
+  {-1300.0, 130.0,  0.0,   0.0, 10000},
+  {  450.0, 100.0,  3.0,   0.0,  1000},
+  { -450.0, 100.0, -3.0,   0.0, 10000},
+  { 1950.0, 100.0,  0.0, 100.0, 10000},
+  { -700.0,  70.0,  3.0, 100.0, 10000},
+  { 1200.0, 130.0, -3.0, 100.0,  1000},
+  { 1200.0, 130.0, -3.0, 100.0, 10000},
+};
+#define CASE_COUNT             (sizeof(Case) / sizeof(Case[0]))
+
+
+static double   rtc_frequency(const struct sim_case *Sim, int8_t Aging, int64_t TrueTime);
+static uint32_t random32(void);
+static int64_t  random_range(int64_t Range);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random32() */
+/* ------------------------------------------------------------------ *\
+      Pseudo-random numbers (xorshift), same sequence on every run.
+\* ------------------------------------------------------------------ */
+static uint32_t random32(void)
+{
+  static uint32_t State = 2463534242UL;
+
+
+  State ^= State << 13;
+  State ^= State >> 17;
+  State ^= State << 5;
+
+  return State;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random_range() */
+/* ------------------------------------------------------------------ *\
+                Random value from -Range to +Range.
+\* ------------------------------------------------------------------ */
+static int64_t random_range(int64_t Range)
+{
+  return (int64_t)(random32() % (uint32_t)((2 * Range) + 1)) - Range;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=rtc_frequency() */
+/* ------------------------------------------------------------------ *\
+       Frequency error (in ppb) of the DS3231 model at true time
+       "TrueTime" (in usec since power-up) with aging offset "Aging",
+              without the temperature residual and the noise.
+\* ------------------------------------------------------------------ */
+static double rtc_frequency(const struct sim_case *Sim, int8_t Aging, int64_t TrueTime)
+{
+  return Sim->Initial + (Sim->AgingRate * (double)TrueTime / (double)DAY) - (Sim->Sensitivity * Aging);
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                              Main test.
+\* ------------------------------------------------------------------ */
+int main(void)
+{
+  int8_t   Aging;
+  int8_t   Direction;
+  int8_t   LastDirection;
+  uint8_t  Loop1UInt8;
+  uint8_t  Status;
+  uint32_t Changes;
+  uint32_t Errors;
+  uint32_t LateChanges;
+  uint32_t Measures;
+  uint32_t Reversals;
+  int64_t  Edge;
+  int64_t  Error;
+  int64_t  NextSync;
+  int64_t  Now;
+  int64_t  NtpError;
+  int64_t  Offset;
+  int64_t  RtcTime;
+  int64_t  TrueTime;
+  int64_t  Write;
+  double   Frequency;
+  double   Phase;
+  double   Residual;
+  double   ResidualMax;
+
+  struct rtc_drift      Drift;
+  struct rtc_drift_trim Trim;
+
+
+  Errors = 0;
+  printf("  Initial  Sens.   Aging  Temp.  Noise  Measures  Changes  Reversals   Aging offset   Residual   Late residual\n");
+  printf("    (ppb)  (ppb)  (ppb/d)  (ppb)  (usec)                             final  ideal     (ppb)      max (ppb)\n");
+  for (Loop1UInt8 = 0; Loop1UInt8 < CASE_COUNT; ++Loop1UInt8)
+  {
+    Aging         = 0;
+    Phase         = 0.0;
+    NextSync      = 0;
+    Measures      = 0;
+    Changes       = 0;
+    LateChanges   = 0;
+    Reversals     = 0;
+    LastDirection = 0;
+    ResidualMax   = 0.0;
+    Drift.Change  = 0;
+    Drift.Error   = 0;
+    Drift.Timer   = 0;
+    Drift.Written = 0;
+
+    for (TrueTime = 0; TrueTime < (SIMULATION_DAYS * DAY); TrueTime += CONVERSION)
+    {
+      /* TCXO conversion: frequency error until the next one. */
+      Frequency = rtc_frequency(&Case[Loop1UInt8], Aging, TrueTime) + (Case[Loop1UInt8].Temperature * sin(2.0 * M_PI * (double)TrueTime / (double)DAY)) + (double)random_range(CONVERSION_NOISE);
+      Phase    += Frequency * (double)CONVERSION / 1000000000.0;
+
+      Residual = fabs(rtc_frequency(&Case[Loop1UInt8], Aging, TrueTime));
+      if ((TrueTime >= (SETTLE_DAYS * DAY)) && (Residual > ResidualMax)) ResidualMax = Residual;
+
+      /* NTP sync: UTC time is the Pico timer value + Offset, with an error up to the noise of the case. */
+      if (TrueTime < NextSync) continue;
+      NextSync = TrueTime + ((1LL << (POLL_MIN + (random32() % (POLL_MAX - POLL_MIN + 1)))) * 1000000LL);
+      NtpError = random_range(Case[Loop1UInt8].Noise);
+      Offset   = NtpError - PICO_START;
+      if (rtc_drift_due(&Drift, (uint64_t)(TrueTime + PICO_START)) == 0) continue;
+
+      /* rtc_drift_measure(): error of the RTC IC at its next second change, seen up to EDGE_POLL late by the polling loop. */
+      if (Drift.Timer != 0)
+      {
+        RtcTime = TrueTime + (int64_t)llround(Phase);
+        Edge    = TrueTime + (1000000LL - (RtcTime % 1000000LL)) + (int64_t)(random32() % EDGE_POLL) + PICO_START;
+        Error   = (((RtcTime / 1000000LL) + 1) * 1000000LL) - (Edge + Offset);
+
+        Status = rtc_drift_update(&Drift, Error, (uint64_t)Edge, Aging, &Trim);
+        if (Status != RTC_DRIFT_NONE) ++Measures;
+        if (Status == RTC_DRIFT_REJECTED)
+        {
+          if (Errors < 20)
+            printf("%+7.0f ppb: drift %lld ppb rejected on day %lld\n", Case[Loop1UInt8].Initial, (long long)Trim.Drift, (long long)(TrueTime / DAY));
+          ++Errors;
+        }
+        else if (Status == RTC_DRIFT_TRIMMED)
+        {
+          Direction = (Trim.Aging > Aging) ? 1 : -1;
+          if ((LastDirection != 0) && (Direction != LastDirection))
+          {
+            ++Reversals;
+
+            /* Once settled, only crystal aging may move the aging offset (a positive one makes the RTC IC faster, so the aging offset grows). */
+            if ((TrueTime >= (SETTLE_DAYS * DAY)) && (((double)Direction * Case[Loop1UInt8].AgingRate) <= 0.0))
+            {
+              if (Errors < 20)
+                printf("%+7.0f ppb: aging offset toggles %d -> %d on day %lld\n", Case[Loop1UInt8].Initial, Aging, Trim.Aging, (long long)(TrueTime / DAY));
+              ++Errors;
+            }
+          }
+          if (TrueTime >= (SETTLE_DAYS * DAY)) ++LateChanges;
+          LastDirection = Direction;
+          Aging         = Trim.Aging;
+          ++Changes;
+        }
+      }
+
+      /* rtc_write_time() on the next second of the time base: the RTC IC begins that second when written, rtc_drift_start() follows. */
+      Write = ((((TrueTime + NtpError) / 1000000LL) + 1) * 1000000LL) + TIME_BASE_PHASE + WRITE_DELAY;
+      Phase = (double)(((Write / 1000000LL) * 1000000LL) - (Write - NtpError));
+      Now   = Write + START_DELAY - Offset;
+      rtc_drift_written(&Drift, (((Write + START_DELAY) / 1000000LL) * 1000000LL) - (Now + Offset), (uint64_t)Now);
+    }
+
+    Residual = rtc_frequency(&Case[Loop1UInt8], Aging, TrueTime);
+    printf("  %+7.0f  %5.0f  %+6.1f  %5.0f  %5d  %8u  %7u  %9u   %+5d  %+6.1f    %+6.0f       %6.0f\n", Case[Loop1UInt8].Initial, Case[Loop1UInt8].Sensitivity, Case[Loop1UInt8].AgingRate, Case[Loop1UInt8].Temperature, Case[Loop1UInt8].Noise, Measures, Changes, Reversals, Aging, (Case[Loop1UInt8].Initial + (Case[Loop1UInt8].AgingRate * SIMULATION_DAYS)) / Case[Loop1UInt8].Sensitivity, Residual, ResidualMax);
+
+    if (ResidualMax > RESIDUAL_LIMIT)
+    {
+      printf("%+7.0f ppb: frequency error of %.0f ppb after %u days\n", Case[Loop1UInt8].Initial, ResidualMax, SETTLE_DAYS);
+      ++Errors;
+    }
+
+    /* Once settled, the aging offset only follows crystal aging (one step per RTC_AGING_STEP ppb of it). */
+    if (LateChanges > (uint32_t)((fabs(Case[Loop1UInt8].AgingRate) * (SIMULATION_DAYS - SETTLE_DAYS) / Case[Loop1UInt8].Sensitivity) + 1))
+    {
+      printf("%+7.0f ppb: aging offset changed %u times after %u days\n", Case[Loop1UInt8].Initial, LateChanges, SETTLE_DAYS);
+      ++Errors;
+    }
+  }
+
+  printf("%u DS3231 simulated over %u days: %u errors.\n", (unsigned)CASE_COUNT, SIMULATION_DAYS, Errors);
+
+  return (Errors == 0) ? 0 : 1;
+}
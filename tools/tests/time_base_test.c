@@ -0,0 +1,302 @@
+/* ======================================================================== *\
+   time_base_test.c
+   St-Louys Andre - October 2026
+   astlouys@gmail.com
+   Revision 18-OCT-2026
+   Langage: GCC (host)
+   Version 1.00
+
+   Host simulation of the disciplined time base (time_base.c): 24 hours
+   of NTP syncs, then 24 hours of holdover, with a Pico crystal off by
+   up to +/- 50 ppm.
+
+   REVISION HISTORY:
+   =================
+   18-OCT-2026 1.00 - Initial release.
+\* ======================================================================== */
+
+
+
+/* ======================================================================== *\
+   NOTE:
+   The Pico timer is simulated second by second of true time, with a
+   constant frequency error (-50 to +50 ppm) and, in some cases, a daily
+   temperature wander of TEMPERATURE_PPM around it. The clock boots
+   with the time of the DS3231 (whole seconds, BOOT_ERROR behind) and
+   no frequency correction saved in flash, as on a new clock.
+
+   For SYNC_HOURS, NTP results (phase noise up to +/- NOISE, taken up
+   to LATENCY before they are applied) go to time_base_adjust() as
+   time_base_discipline() does. The poll interval follows the rules of
+   ntp_poll_update() (picow_ntp_client.c). Then NTP is gone for
+   HOLDOVER_HOURS and the time base runs on its frequency correction.
+
+   Every second, the test checks that the time base never goes back
+   (once the first sync has stepped it), that time_base_duration() maps
+   one second of the time base to the Pico timer within
+   DURATION_TOLERANCE, and measures the error of the time base against
+   true time. The holdover error must stay below HOLDOVER_LIMIT when the
+   crystal is stable, and below HOLDOVER_LIMIT_WANDER when it follows
+   the temperature (whose drift over a day is not a frequency error
+   that syncs can learn).
+\* ======================================================================== */
+
+
+
+/* $PAGE */
+/* $TITLE=Definitions and include files. */
+/* ----------------------------------------------------------------- *\
+                    Definitions and include files
+\* ----------------------------------------------------------------- */
+#define _DEFAULT_SOURCE
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "time_base.h"
+
+
+#define BOOT_ERROR             600000LL     // DS3231 time behind true time at boot (in usec).
+#define DURATION_TOLERANCE     4            // error (in usec) allowed on one second of time_base_duration() (both corrections truncated to the usec, at both ends).
+#define HOLDOVER_HOURS         24
+#define HOLDOVER_LIMIT         50000LL      // holdover error (in usec) allowed after HOLDOVER_HOURS with a stable crystal.
+#define HOLDOVER_LIMIT_WANDER  100000LL     // holdover error (in usec) allowed after HOLDOVER_HOURS with the temperature wander.
+#define LATENCY                500000       // maximum time (in usec) between an NTP result and its use.
+#define SYNC_HOURS             24
+#define TEMPERATURE_PPM        2.0          // daily wander of the crystal frequency with the temperature (in ppm).
+#define UTC_START              1792800000000000ULL  // true UTC time at boot (in usec since 01-JAN-1970).
+
+/* Poll interval rules of ntp_poll_update() (picow_ntp_client.c / picow_ntp_client.h). */
+#define NTP_POLL_MAX           17
+#define NTP_POLL_MIN           6
+#define NTP_POLL_STABLE        5000
+#define NTP_POLL_STEP          128000
+#define NTP_POLL_UNSTABLE      20000
+
+
+/* One simulated clock. */
+struct sim_case
+{
+  double  Ppm;                 // frequency error of the Pico crystal (in ppm, positive: Pico timer runs fast).
+  double  Wander;              // daily temperature wander of the frequency (in ppm).
+  int32_t Noise;               // maximum phase noise of NTP results (in usec).
+};
+
+static const struct sim_case Case[] =
+{
+  {-50.0, 0.0,              1000},
+  {-50.0, 0.0,             10000},
+  {-20.0, 0.0,             10000},
+  {  0.0, 0.0,             10000},
+  { 20.0, 0.0,             10000},
+  { 50.0, 0.0,              1000},
+  { 50.0, 0.0,             10000},
+  {-50.0, TEMPERATURE_PPM, 10000},
+  { 50.0, TEMPERATURE_PPM,  1000},
+  { 50.0, TEMPERATURE_PPM, 10000},
+};
+#define CASE_COUNT             (sizeof(Case) / sizeof(Case[0]))
+
+
+static int64_t  abs64(int64_t Value);
+static uint32_t random32(void);
+static int64_t  random_range(int64_t Range);
+static uint64_t timer_at(const struct sim_case *Sim, int64_t TrueTime);
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=abs64() */
+/* ------------------------------------------------------------------ *\
+                         Absolute value.
+\* ------------------------------------------------------------------ */
+static int64_t abs64(int64_t Value)
+{
+  return (Value < 0) ? -Value : Value;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random32() */
+/* ------------------------------------------------------------------ *\
+      Pseudo-random numbers (xorshift), same sequence on every run.
+\* ------------------------------------------------------------------ */
+static uint32_t random32(void)
+{
+  static uint32_t State = 2463534242UL;
+
+
+  State ^= State << 13;
+  State ^= State >> 17;
+  State ^= State << 5;
+
+  return State;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=random_range() */
+/* ------------------------------------------------------------------ *\
+                Random value from -Range to +Range.
+\* ------------------------------------------------------------------ */
+static int64_t random_range(int64_t Range)
+{
+  return (int64_t)(random32() % (uint32_t)((2 * Range) + 1)) - Range;
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=timer_at() */
+/* ------------------------------------------------------------------ *\
+       Pico timer value (in usec) at true time "TrueTime" (in usec
+       since boot): true time, plus the constant frequency error,
+       plus the integral of the daily temperature wander.
+\* ------------------------------------------------------------------ */
+static uint64_t timer_at(const struct sim_case *Sim, int64_t TrueTime)
+{
+  double Day;
+  double Elapsed;
+
+
+  Day     = 86400.0 * 1000000.0;
+  Elapsed = (double)TrueTime;
+
+  return 1000000ULL + (uint64_t)llround(Elapsed + (Elapsed * Sim->Ppm / 1000000.0) + ((Sim->Wander / 1000000.0) * (Day / (2.0 * M_PI)) * sin(2.0 * M_PI * Elapsed / Day)));
+}
+
+
+
+
+
+/* $PAGE */
+/* $TITLE=main() */
+/* ------------------------------------------------------------------ *\
+                              Main test.
+\* ------------------------------------------------------------------ */
+int main(void)
+{
+  uint8_t  FlagSynced;
+  uint8_t  Loop1UInt8;
+  uint8_t  Poll;
+  uint32_t Errors;
+  uint32_t Syncs;
+  int64_t  Error;
+  int64_t  HoldoverError;
+  int64_t  HoldoverMax;
+  int64_t  Limit;
+  int64_t  Sample;
+  int64_t  SyncMax;
+  int64_t  TrueTime;
+  int64_t  NextSync;
+  uint64_t Now;
+  uint64_t Previous;
+  uint64_t Time;
+
+  struct time_base      Base;
+  struct time_base_sync Sync;
+
+
+  Errors = 0;
+  printf("  Crystal   Wander   Noise  Syncs   Correction   Synced max   Holdover 24h   Holdover max   Uncorrected\n");
+  printf("    (ppm)    (ppm)  (usec)             (ppb)       (usec)       (usec)          (usec)         (usec)\n");
+  for (Loop1UInt8 = 0; Loop1UInt8 < CASE_COUNT; ++Loop1UInt8)
+  {
+    /* Boot on DS3231 time, with no frequency correction saved in flash. */
+    Base.Freq      = 0;
+    Base.Slew      = 0;
+    Base.SlewEnd   = 0;
+    Base.SyncSteps = 0;
+    Base.SyncTimer = 0;
+    Base.Timer     = 0;
+    Base.Utc       = 0;
+    time_base_origin(&Base, UTC_START - BOOT_ERROR, timer_at(&Case[Loop1UInt8], 0));
+
+    FlagSynced    = 0;
+    Poll          = NTP_POLL_MIN;
+    NextSync      = 5 * 1000000LL;
+    Syncs         = 0;
+    SyncMax       = 0;
+    HoldoverMax   = 0;
+    HoldoverError = 0;
+    Previous      = 0;
+
+    for (TrueTime = 0; TrueTime <= ((SYNC_HOURS + HOLDOVER_HOURS) * 3600LL * 1000000LL); TrueTime += 1000000LL)
+    {
+      Now = timer_at(&Case[Loop1UInt8], TrueTime);
+
+      /* NTP result, as time_base_discipline() gets it, and poll interval as ntp_poll_update() sets it. */
+      if ((TrueTime == NextSync) && (TrueTime < (SYNC_HOURS * 3600LL * 1000000LL)))
+      {
+        Sample = TrueTime - (random32() % LATENCY);
+        time_base_adjust(&Base, UTC_START + (uint64_t)Sample + random_range(Case[Loop1UInt8].Noise), timer_at(&Case[Loop1UInt8], Sample), Now, &Sync);
+        ++Syncs;
+
+        if (abs64(Sync.Phase) > NTP_POLL_STEP)
+          Poll = NTP_POLL_MIN;
+        else if ((abs64(Sync.Phase) > NTP_POLL_UNSTABLE) && (Poll > NTP_POLL_MIN))
+          --Poll;
+        else if ((abs64(Sync.Phase) < NTP_POLL_STABLE) && (Poll < NTP_POLL_MAX))
+          ++Poll;
+        NextSync = TrueTime + ((1LL << Poll) * 1000000LL);
+
+        /* The first sync steps the time base (DS3231 time is up to one second off), it must never go back afterwards. */
+        if (FlagSynced == 0) Previous = 0;
+        FlagSynced = 1;
+      }
+
+      Time = time_base_at(&Base, Now);
+      if (Time <= Previous)
+      {
+        if (Errors < 20)
+          printf("%+6.1f ppm: time base goes back %lld usec at %lld sec\n", Case[Loop1UInt8].Ppm, (long long)(Previous - Time), (long long)(TrueTime / 1000000LL));
+        ++Errors;
+      }
+      Previous = Time;
+
+      /* One second of the time base, as timer_callback_s() programs it with time_base_timer_us(). */
+      Error = (int64_t)(time_base_at(&Base, Now + time_base_duration(&Base, Now, 1000000ULL)) - Time) - 1000000LL;
+      if (abs64(Error) > DURATION_TOLERANCE)
+      {
+        if (Errors < 20)
+          printf("%+6.1f ppm: one second of the time base lasts %lld usec too long at %lld sec\n", Case[Loop1UInt8].Ppm, (long long)Error, (long long)(TrueTime / 1000000LL));
+        ++Errors;
+      }
+
+      /* Error against true time: while synced (once the first hour of frequency estimation is over), then in holdover. */
+      Error = (int64_t)(Time - (UTC_START + (uint64_t)TrueTime));
+      if (TrueTime < (SYNC_HOURS * 3600LL * 1000000LL))
+      {
+        if ((TrueTime >= (3600LL * 1000000LL)) && (abs64(Error) > SyncMax)) SyncMax = abs64(Error);
+      }
+      else
+      {
+        if (abs64(Error) > HoldoverMax) HoldoverMax = abs64(Error);
+        HoldoverError = Error;
+      }
+    }
+
+    printf("  %+6.1f    %4.1f    %6d  %5u   %+10d   %10lld   %+12lld   %12lld   %+11.0f\n", Case[Loop1UInt8].Ppm, Case[Loop1UInt8].Wander, Case[Loop1UInt8].Noise, Syncs, Base.Freq, (long long)SyncMax, (long long)HoldoverError, (long long)HoldoverMax, Case[Loop1UInt8].Ppm * HOLDOVER_HOURS * 3600.0);
+
+    Limit = (Case[Loop1UInt8].Wander == 0.0) ? HOLDOVER_LIMIT : HOLDOVER_LIMIT_WANDER;
+    if (HoldoverMax > Limit)
+    {
+      printf("%+6.1f ppm: holdover error %lld usec over the %lld usec limit\n", Case[Loop1UInt8].Ppm, (long long)HoldoverMax, (long long)Limit);
+      ++Errors;
+    }
+  }
+
+  printf("%u clocks simulated over %u hours of NTP syncs and %u hours of holdover: %u errors.\n", (unsigned)CASE_COUNT, SYNC_HOURS, HOLDOVER_HOURS, Errors);
+
+  return (Errors == 0) ? 0 : 1;
+}